@@ -0,0 +1,240 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtWebEngine module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qwebenginecookierule.h"
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \class QWebEngineCookieRule
+    \since 6.4
+    \ingroup webengine
+    \inmodule QtWebEngineCore
+
+    \brief The QWebEngineCookieRule class describes whether sites may access cookies,
+    without a cookie filter callback.
+
+    A list of rules set with QWebEngineCookieStore::setCookieRules() is compiled once
+    and checked natively whenever a site reads or writes cookies, or uses one of the
+    storage features controlled by the cookie filter. No application code is called
+    for accesses decided by a rule.
+
+    An access matches a rule if all of the conditions set on the rule hold:
+
+    \list
+    \li domain(): the cookies belong to a URL on this domain or one of its subdomains.
+    \li party(): the access is a first-party or third-party one.
+    \li firstPartyDomain(): the site shown in the top-level frame is on this domain or
+        one of its subdomains.
+    \endlist
+
+    Conditions that are not set match any access. Rules are indexed by the registrable
+    domain of their domain(), such as \c example.co.uk for \c www.example.co.uk, so
+    that large rule sets are cheap to check regardless of their size.
+
+    When several rules match an access, the rule with the longest domain() applies, and
+    among those the first one in the list. Rules without a domain() apply only when no
+    rule with a domain matches. Accesses matching no rule are passed to the cookie
+    filter set with QWebEngineCookieStore::setCookieFilter(), if any, and are allowed
+    otherwise.
+
+    \code
+    QWebEngineCookieRule thirdParty(QWebEngineCookieRule::Block);
+    thirdParty.setParty(QWebEngineCookieRule::ThirdParty);
+    QWebEngineCookieRule payments(QWebEngineCookieRule::Allow, "payments.example.com");
+    QWebEngineCookieRule news(QWebEngineCookieRule::SessionOnly, "news.example.com");
+    profile->cookieStore()->setCookieRules({ thirdParty, payments, news });
+    \endcode
+
+    \sa QWebEngineCookieStore::setCookieFilter()
+*/
+
+/*!
+    \enum QWebEngineCookieRule::Action
+    \brief This enum type describes what happens to a matching access:
+
+    \value Block The access is denied.
+    \value Allow The access is allowed.
+    \value SessionOnly The access is allowed, but cookies of the domain do not
+        outlive the session.
+*/
+
+/*!
+    \enum QWebEngineCookieRule::Party
+    \brief This enum type describes which accesses a rule applies to:
+
+    \value AnyParty All accesses.
+    \value FirstParty Accesses from the site shown in the top-level frame.
+    \value ThirdParty Accesses from other sites, for example by embedded content.
+*/
+
+class QWebEngineCookieRulePrivate : public QSharedData
+{
+public:
+    bool operator==(const QWebEngineCookieRulePrivate &other) const
+    {
+        return action == other.action && domain == other.domain && party == other.party
+                && firstPartyDomain == other.firstPartyDomain;
+    }
+
+    QWebEngineCookieRule::Action action = QWebEngineCookieRule::Block;
+    QString domain;
+    QWebEngineCookieRule::Party party = QWebEngineCookieRule::AnyParty;
+    QString firstPartyDomain;
+};
+
+/*!
+    Constructs a rule that applies \a action to the cookies of \a domain and its
+    subdomains, or to all cookies if \a domain is empty.
+*/
+QWebEngineCookieRule::QWebEngineCookieRule(Action action, const QString &domain)
+    : d(new QWebEngineCookieRulePrivate)
+{
+    d->action = action;
+    d->domain = domain;
+}
+
+/*!
+    Creates a copy of \a other.
+*/
+QWebEngineCookieRule::QWebEngineCookieRule(const QWebEngineCookieRule &other) = default;
+
+/*!
+    Destroys the rule.
+*/
+QWebEngineCookieRule::~QWebEngineCookieRule() = default;
+
+/*!
+    Assigns \a other to this rule.
+*/
+QWebEngineCookieRule &QWebEngineCookieRule::operator=(const QWebEngineCookieRule &other) = default;
+
+/*!
+    \fn QWebEngineCookieRule &QWebEngineCookieRule::operator=(QWebEngineCookieRule &&other)
+    Moves \a other into this rule.
+*/
+
+/*!
+    \fn void QWebEngineCookieRule::swap(QWebEngineCookieRule &other)
+    Swaps this rule with \a other.
+*/
+
+/*!
+    Returns \c true if this rule has the same action and conditions as \a other.
+*/
+bool QWebEngineCookieRule::operator==(const QWebEngineCookieRule &other) const
+{
+    return d == other.d || *d == *other.d;
+}
+
+/*!
+    \fn bool QWebEngineCookieRule::operator!=(const QWebEngineCookieRule &other) const
+    Returns \c true if this rule differs from \a other.
+*/
+
+/*!
+    Returns what happens to the accesses matching the rule.
+*/
+QWebEngineCookieRule::Action QWebEngineCookieRule::action() const
+{
+    return d->action;
+}
+
+/*!
+    Sets what happens to the accesses matching the rule to \a action.
+*/
+void QWebEngineCookieRule::setAction(Action action)
+{
+    d->action = action;
+}
+
+/*!
+    Returns the domain to which the rule is restricted, together with its subdomains.
+*/
+QString QWebEngineCookieRule::domain() const
+{
+    return d->domain;
+}
+
+/*!
+    Restricts the rule to the cookies of \a domain and its subdomains.
+    An empty \a domain matches all cookies.
+*/
+void QWebEngineCookieRule::setDomain(const QString &domain)
+{
+    d->domain = domain;
+}
+
+/*!
+    Returns whether the rule applies to first-party or third-party accesses, or both.
+*/
+QWebEngineCookieRule::Party QWebEngineCookieRule::party() const
+{
+    return d->party;
+}
+
+/*!
+    Restricts the rule to first-party or third-party accesses, according to \a party.
+
+    An access is a third-party one if the cookies do not belong to the same registrable
+    domain as the site shown in the top-level frame.
+*/
+void QWebEngineCookieRule::setParty(Party party)
+{
+    d->party = party;
+}
+
+/*!
+    Returns the domain of the top-level sites to which the rule is restricted.
+*/
+QString QWebEngineCookieRule::firstPartyDomain() const
+{
+    return d->firstPartyDomain;
+}
+
+/*!
+    Restricts the rule to accesses while a site on \a domain or one of its subdomains
+    is shown in the top-level frame. An empty \a domain matches all accesses.
+*/
+void QWebEngineCookieRule::setFirstPartyDomain(const QString &domain)
+{
+    d->firstPartyDomain = domain;
+}
+
+QT_END_NAMESPACE
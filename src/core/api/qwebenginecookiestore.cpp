@@ -43,15 +43,22 @@
 #include "net/base/registry_controlled_domains/registry_controlled_domain.h"
 
 #include "net/cookie_monster_delegate_qt.h"
+#include "net/cookie_rule_set.h"
+#include "type_conversion.h"
 
 #include <QByteArray>
 #include <QUrl>
 
+#include <atomic>
+
 namespace {
 
-inline GURL toGurl(const QUrl &url)
+// How long changes are collected before cookiesChanged() is emitted
+const int cookieChangeBatchInterval = 100;
+
+inline QByteArray cookieKey(const QNetworkCookie &cookie)
 {
-    return GURL(url.toString().toStdString());
+    return cookie.name() + '\0' + cookie.domain().toUtf8() + '\0' + cookie.path().toUtf8();
 }
 
 } // namespace
@@ -65,8 +72,13 @@ QWebEngineCookieStorePrivate::QWebEngineCookieStorePrivate(QWebEngineCookieStore
     , m_deleteSessionCookiesPending(false)
     , m_deleteAllCookiesPending(false)
     , m_getAllCookiesPending(false)
+    , m_batchChangeNotifications(false)
     , delegate(nullptr)
-{}
+{
+    m_batchTimer.setSingleShot(true);
+    m_batchTimer.setInterval(cookieChangeBatchInterval);
+    m_batchTimer.callOnTimeout([this]() { deliverCookieChanges(); });
+}
 
 void QWebEngineCookieStorePrivate::processPendingUserCookies()
 {
@@ -78,6 +90,10 @@ void QWebEngineCookieStorePrivate::processPendingUserCookies()
         delegate->getAllCookies();
     }
 
+    for (CookieListCallback &callback : m_pendingGetAllCallbacks)
+        delegate->getAllCookies(std::move(callback));
+    m_pendingGetAllCallbacks.clear();
+
     if (m_deleteAllCookiesPending) {
         m_deleteAllCookiesPending = false;
         delegate->deleteAllCookies();
@@ -88,17 +104,34 @@ void QWebEngineCookieStorePrivate::processPendingUserCookies()
         delegate->deleteSessionCookies();
     }
 
-    if (bool(filterCallback))
+    if (hasCookieFilter())
         delegate->setHasFilter(true);
 
+    if (std::shared_ptr<const CookieRuleSet> rules = cookieRuleSet()) {
+        if (rules->hasSessionOnlyRules()) {
+            delegate->setSessionOnlyRules(rules.get());
+            // cookies of session-only sites left over from the last session
+            delegate->deleteSessionOnlyCookies(std::move(rules));
+        }
+    }
+
     if (m_pendingUserCookies.isEmpty())
         return;
 
-    for (const CookieData &cookieData : qAsConst(m_pendingUserCookies)) {
-        if (cookieData.wasDelete)
+    // hand consecutive cookies set for the same origin over together
+    QList<QNetworkCookie> cookies;
+    for (qsizetype i = 0; i < m_pendingUserCookies.size(); ++i) {
+        const CookieData &cookieData = m_pendingUserCookies.at(i);
+        if (cookieData.wasDelete) {
             delegate->deleteCookie(cookieData.cookie, cookieData.origin);
-        else
-            delegate->setCookie(cookieData.cookie, cookieData.origin);
+            continue;
+        }
+        cookies.append(cookieData.cookie);
+        if (i + 1 == m_pendingUserCookies.size() || m_pendingUserCookies.at(i + 1).wasDelete
+                || m_pendingUserCookies.at(i + 1).origin != cookieData.origin) {
+            delegate->setCookies(cookies, cookieData.origin);
+            cookies.clear();
+        }
     }
 
     m_pendingUserCookies.clear();
@@ -110,6 +143,7 @@ void QWebEngineCookieStorePrivate::rejectPendingUserCookies()
     m_deleteAllCookiesPending = false;
     m_deleteSessionCookiesPending = false;
     m_pendingUserCookies.clear();
+    m_pendingGetAllCallbacks.clear();
 }
 
 void QWebEngineCookieStorePrivate::setCookie(const QNetworkCookie &cookie, const QUrl &origin)
@@ -122,6 +156,18 @@ void QWebEngineCookieStorePrivate::setCookie(const QNetworkCookie &cookie, const
     delegate->setCookie(cookie, origin);
 }
 
+void QWebEngineCookieStorePrivate::setCookies(const QList<QNetworkCookie> &cookies, const QUrl &origin)
+{
+    if (!delegate || !delegate->hasCookieMonster()) {
+        m_pendingUserCookies.reserve(m_pendingUserCookies.size() + cookies.size());
+        for (const QNetworkCookie &cookie : cookies)
+            m_pendingUserCookies.append(CookieData{ false, cookie, origin });
+        return;
+    }
+
+    delegate->setCookies(cookies, origin);
+}
+
 void QWebEngineCookieStorePrivate::deleteCookie(const QNetworkCookie &cookie, const QUrl &url)
 {
     if (!delegate || !delegate->hasCookieMonster()) {
@@ -163,28 +209,94 @@ void QWebEngineCookieStorePrivate::getAllCookies()
     delegate->getAllCookies();
 }
 
+void QWebEngineCookieStorePrivate::getAllCookies(CookieListCallback &&callback)
+{
+    if (!delegate || !delegate->hasCookieMonster()) {
+        m_pendingGetAllCallbacks.append(std::move(callback));
+        return;
+    }
+
+    delegate->getAllCookies(std::move(callback));
+}
 
 void QWebEngineCookieStorePrivate::onCookieChanged(const QNetworkCookie &cookie, bool removed)
 {
+    if (m_batchChangeNotifications) {
+        const QByteArray key = cookieKey(cookie);
+        auto it = m_pendingChangeIndex.constFind(key);
+        if (it != m_pendingChangeIndex.constEnd()) {
+            m_pendingChanges[*it] = CookieChange{ cookie, removed };
+        } else {
+            m_pendingChangeIndex.insert(key, m_pendingChanges.size());
+            m_pendingChanges.append(CookieChange{ cookie, removed });
+        }
+        if (!m_batchTimer.isActive())
+            m_batchTimer.start();
+        return;
+    }
+
     if (removed)
         Q_EMIT q_ptr->cookieRemoved(cookie);
     else
         Q_EMIT q_ptr->cookieAdded(cookie);
 }
 
+void QWebEngineCookieStorePrivate::deliverCookieChanges()
+{
+    m_batchTimer.stop();
+    if (m_pendingChanges.isEmpty())
+        return;
+
+    QList<QNetworkCookie> added;
+    QList<QNetworkCookie> removed;
+    for (const CookieChange &change : qAsConst(m_pendingChanges))
+        (change.removed ? removed : added).append(change.cookie);
+    m_pendingChanges.clear();
+    m_pendingChangeIndex.clear();
+
+    Q_EMIT q_ptr->cookiesChanged(added, removed);
+}
+
+bool QWebEngineCookieStorePrivate::hasCookieFilter() const
+{
+    return bool(filterCallback) || !m_cookieRules.isEmpty();
+}
+
+std::shared_ptr<const CookieRuleSet> QWebEngineCookieStorePrivate::cookieRuleSet() const
+{
+    return std::atomic_load_explicit(&m_cookieRuleSet, std::memory_order_acquire);
+}
+
 bool QWebEngineCookieStorePrivate::canAccessCookies(const QUrl &firstPartyUrl, const QUrl &url) const
 {
-    if (!filterCallback)
-        return true;
+    return canAccessCookies(toGurl(firstPartyUrl), toGurl(url));
+}
 
-    // Empty first-party URL indicates a first-party request (see net/base/static_cookie_policy.cc)
-    bool thirdParty = !firstPartyUrl.isEmpty() &&
-            !net::registry_controlled_domains::SameDomainOrHost(toGurl(url),
-                                                                toGurl(firstPartyUrl),
-                                                                net::registry_controlled_domains::INCLUDE_PRIVATE_REGISTRIES);
+bool QWebEngineCookieStorePrivate::canAccessCookies(const GURL &firstPartyUrl, const GURL &url) const
+{
+    bool allowed = true;
+    CookieRuleSet::Decision decision = CookieRuleSet::NoMatch;
+    if (std::shared_ptr<const CookieRuleSet> rules = cookieRuleSet())
+        decision = rules->evaluate(firstPartyUrl, url);
+
+    if (decision != CookieRuleSet::NoMatch) {
+        allowed = decision != CookieRuleSet::Block;
+    } else if (filterCallback) {
+        // Empty first-party URL indicates a first-party request (see net/base/static_cookie_policy.cc)
+        bool thirdParty = !firstPartyUrl.is_empty() &&
+                !net::registry_controlled_domains::SameDomainOrHost(url,
+                                                                    firstPartyUrl,
+                                                                    net::registry_controlled_domains::INCLUDE_PRIVATE_REGISTRIES);
+
+        QWebEngineCookieStore::FilterRequest request = { toQt(firstPartyUrl), toQt(url), thirdParty, false, 0 };
+        allowed = filterCallback(request);
+    }
 
-    QWebEngineCookieStore::FilterRequest request = { firstPartyUrl, url, thirdParty, false, 0 };
-    return filterCallback(request);
+    if (allowed)
+        m_allowedCookieAccessCount.fetchAndAddRelaxed(1);
+    else
+        m_blockedCookieAccessCount.fetchAndAddRelaxed(1);
+    return allowed;
 }
 
 /*!
@@ -217,6 +329,19 @@ bool QWebEngineCookieStorePrivate::canAccessCookies(const QUrl &firstPartyUrl, c
     This signal is emitted whenever a \a cookie is deleted from the cookie store.
 */
 
+/*!
+    \fn void QWebEngineCookieStore::cookiesChanged(const QList<QNetworkCookie> &added, const QList<QNetworkCookie> &removed)
+    \since 6.4
+
+    This signal is emitted instead of cookieAdded() and cookieRemoved() when batched change
+    notifications are enabled. \a added holds the cookies that were added or updated, and
+    \a removed the cookies that were deleted since the signal was last emitted.
+
+    If a cookie changed several times in between, only its last change is reported.
+
+    \sa setBatchedChangeNotificationsEnabled()
+*/
+
 /*!
     Creates a new QWebEngineCookieStore object with \a parent.
 */
@@ -249,6 +374,26 @@ void QWebEngineCookieStore::setCookie(const QNetworkCookie &cookie, const QUrl &
     d_ptr->setCookie(cookie, origin);
 }
 
+/*!
+    \since 6.4
+
+    Adds all \a cookies to the cookie store. This is equivalent to calling setCookie()
+    for each of them with \a origin, except that invalid cookies produce a single warning
+    instead of one each. The cookies are still stored one at a time.
+
+    Cookies that are not valid for \a origin are skipped.
+
+    \note This operation is asynchronous.
+    \sa setCookie()
+*/
+
+void QWebEngineCookieStore::setCookies(const QList<QNetworkCookie> &cookies, const QUrl &origin)
+{
+    if (cookies.isEmpty())
+        return;
+    d_ptr->setCookies(cookies, origin);
+}
+
 /*!
     Deletes \a cookie from the cookie store.
     It is possible to provide an optional \a origin URL argument to limit the scope of the
@@ -279,6 +424,65 @@ void QWebEngineCookieStore::loadAllCookies()
     d_ptr->getAllCookies();
 }
 
+/*!
+    \since 6.4
+
+    Retrieves all the cookies in the cookie store and passes them to \a resultCallback
+    at once. Unlike loadAllCookies(), this does not emit a signal for each cookie.
+
+    The callback is called on the main thread. It is not called if the cookie store is
+    destroyed before the cookies have been retrieved.
+
+    \note This operation is asynchronous.
+    \sa loadAllCookies()
+*/
+
+void QWebEngineCookieStore::getAllCookies(const std::function<void(const QList<QNetworkCookie> &)> &resultCallback)
+{
+    if (!resultCallback)
+        return;
+    d_ptr->getAllCookies(QWebEngineCookieStorePrivate::CookieListCallback(resultCallback));
+}
+
+/*!
+    \since 6.4
+
+    Sets whether changes to the cookie store are reported in batches to \a enabled.
+
+    When enabled, cookieAdded() and cookieRemoved() are no longer emitted. Instead, changes
+    are collected for a short time and delivered together by cookiesChanged(). This avoids
+    emitting a signal for every single cookie when many cookies change at once, for example
+    after setCookies() or deleteAllCookies().
+
+    Disabling batched notifications delivers any changes that are still pending.
+
+    By default, batched change notifications are disabled.
+
+    \sa cookiesChanged()
+*/
+
+void QWebEngineCookieStore::setBatchedChangeNotificationsEnabled(bool enabled)
+{
+    if (d_ptr->m_batchChangeNotifications == enabled)
+        return;
+    if (!enabled)
+        d_ptr->deliverCookieChanges();
+    d_ptr->m_batchChangeNotifications = enabled;
+}
+
+/*!
+    \since 6.4
+
+    Returns whether changes to the cookie store are reported in batches.
+
+    \sa setBatchedChangeNotificationsEnabled()
+*/
+
+bool QWebEngineCookieStore::isBatchedChangeNotificationsEnabled() const
+{
+    return d_ptr->m_batchChangeNotifications;
+}
+
 /*!
     Deletes all the session cookies in the cookie store. Session cookies do not have an
     expiration date assigned to them.
@@ -337,10 +541,10 @@ void QWebEngineCookieStore::deleteAllCookies()
 */
 void QWebEngineCookieStore::setCookieFilter(const std::function<bool(const FilterRequest &)> &filterCallback)
 {
-    bool changed = bool(d_ptr->filterCallback) != bool(filterCallback);
+    bool hadFilter = d_ptr->hasCookieFilter();
     d_ptr->filterCallback = filterCallback;
-    if (changed && d_ptr->delegate)
-        d_ptr->delegate->setHasFilter(bool(d_ptr->filterCallback));
+    if (hadFilter != d_ptr->hasCookieFilter() && d_ptr->delegate)
+        d_ptr->delegate->setHasFilter(d_ptr->hasCookieFilter());
 }
 
 /*!
@@ -349,10 +553,84 @@ void QWebEngineCookieStore::setCookieFilter(const std::function<bool(const Filte
 */
 void QWebEngineCookieStore::setCookieFilter(std::function<bool(const FilterRequest &)> &&filterCallback)
 {
-    bool changed = bool(d_ptr->filterCallback) != bool(filterCallback);
+    bool hadFilter = d_ptr->hasCookieFilter();
     d_ptr->filterCallback = std::move(filterCallback);
-    if (changed && d_ptr->delegate)
-        d_ptr->delegate->setHasFilter(bool(d_ptr->filterCallback));
+    if (hadFilter != d_ptr->hasCookieFilter() && d_ptr->delegate)
+        d_ptr->delegate->setHasFilter(d_ptr->hasCookieFilter());
+}
+
+/*!
+    \since 6.4
+
+    Sets the rules deciding whether sites may access cookies to \a rules.
+
+    The rules are compiled once and checked natively whenever a site reads or writes
+    cookies, before the cookie filter. Accesses decided by a rule do not call the filter
+    callback, and large rule sets are cheap to check.
+
+    Cookies of domains with a \l{QWebEngineCookieRule::}{SessionOnly} rule are kept
+    for the current session only. Persistent cookies of such domains, whether set
+    later or already present when the rules are set, are deleted from the persistent
+    cookie store when the profile shuts down. Cookies of such domains left over from
+    an earlier session, for example after a crash, are deleted when the cookie store
+    is opened.
+
+    Setting an empty list removes all rules.
+
+    \sa cookieRules(), setCookieFilter(), QWebEngineCookieRule
+*/
+void QWebEngineCookieStore::setCookieRules(const QList<QWebEngineCookieRule> &rules)
+{
+    if (d_ptr->m_cookieRules == rules)
+        return;
+    bool hadFilter = d_ptr->hasCookieFilter();
+    d_ptr->m_cookieRules = rules;
+    std::shared_ptr<const CookieRuleSet> ruleSet;
+    if (!rules.isEmpty())
+        ruleSet = std::make_shared<const CookieRuleSet>(rules);
+    std::atomic_store_explicit(&d_ptr->m_cookieRuleSet, ruleSet, std::memory_order_release);
+    if (d_ptr->delegate && d_ptr->delegate->hasCookieMonster())
+        d_ptr->delegate->setSessionOnlyRules(ruleSet.get());
+    if (hadFilter != d_ptr->hasCookieFilter() && d_ptr->delegate)
+        d_ptr->delegate->setHasFilter(d_ptr->hasCookieFilter());
+}
+
+/*!
+    \since 6.4
+
+    Returns the rules deciding whether sites may access cookies.
+
+    \sa setCookieRules()
+*/
+QList<QWebEngineCookieRule> QWebEngineCookieStore::cookieRules() const
+{
+    return d_ptr->m_cookieRules;
+}
+
+/*!
+    \since 6.4
+
+    Returns how many times sites were allowed to access cookies, by a cookie rule,
+    the cookie filter, or for lack of both.
+
+    \sa blockedCookieAccessCount(), setCookieRules()
+*/
+quint64 QWebEngineCookieStore::allowedCookieAccessCount() const
+{
+    return d_ptr->m_allowedCookieAccessCount.loadRelaxed();
+}
+
+/*!
+    \since 6.4
+
+    Returns how many times sites were denied access to cookies by a cookie rule or
+    the cookie filter.
+
+    \sa allowedCookieAccessCount(), setCookieRules()
+*/
+quint64 QWebEngineCookieStore::blockedCookieAccessCount() const
+{
+    return d_ptr->m_blockedCookieAccessCount.loadRelaxed();
 }
 
 /*!
@@ -41,7 +41,9 @@
 #define QWEBENGINECOOKIESTORE_H
 
 #include <QtWebEngineCore/qtwebenginecoreglobal.h>
+#include <QtWebEngineCore/qwebenginecookierule.h>
 
+#include <QtCore/qlist.h>
 #include <QtCore/qobject.h>
 #include <QtCore/qscopedpointer.h>
 #include <QtCore/qurl.h>
@@ -74,15 +76,25 @@ public:
 
     void setCookieFilter(const std::function<bool(const FilterRequest &)> &filterCallback);
     void setCookieFilter(std::function<bool(const FilterRequest &)> &&filterCallback);
+    void setCookieRules(const QList<QWebEngineCookieRule> &rules);
+    QList<QWebEngineCookieRule> cookieRules() const;
+    quint64 allowedCookieAccessCount() const;
+    quint64 blockedCookieAccessCount() const;
     void setCookie(const QNetworkCookie &cookie, const QUrl &origin = QUrl());
+    void setCookies(const QList<QNetworkCookie> &cookies, const QUrl &origin = QUrl());
     void deleteCookie(const QNetworkCookie &cookie, const QUrl &origin = QUrl());
     void deleteSessionCookies();
     void deleteAllCookies();
     void loadAllCookies();
+    void getAllCookies(const std::function<void(const QList<QNetworkCookie> &)> &resultCallback);
+
+    void setBatchedChangeNotificationsEnabled(bool enabled);
+    bool isBatchedChangeNotificationsEnabled() const;
 
 Q_SIGNALS:
     void cookieAdded(const QNetworkCookie &cookie);
     void cookieRemoved(const QNetworkCookie &cookie);
+    void cookiesChanged(const QList<QNetworkCookie> &added, const QList<QNetworkCookie> &removed);
 
 private:
     explicit QWebEngineCookieStore(QObject *parent = nullptr);
@@ -55,12 +55,21 @@
 
 #include "qwebenginecookiestore.h"
 
+#include <QAtomicInteger>
+#include <QHash>
 #include <QList>
 #include <QNetworkCookie>
+#include <QTimer>
 #include <QUrl>
 
+#include <functional>
+#include <memory>
+
+class GURL;
+
 namespace QtWebEngineCore {
 class CookieMonsterDelegateQt;
+class CookieRuleSet;
 }
 
 QT_BEGIN_NAMESPACE
@@ -73,16 +82,36 @@ class Q_WEBENGINECORE_PRIVATE_EXPORT QWebEngineCookieStorePrivate
         QNetworkCookie cookie;
         QUrl origin;
     };
+    struct CookieChange {
+        QNetworkCookie cookie;
+        bool removed;
+    };
     friend class QTypeInfo<CookieData>;
+    friend class QTypeInfo<CookieChange>;
     QWebEngineCookieStore *q_ptr;
 
 public:
+    typedef std::function<void(const QList<QNetworkCookie> &)> CookieListCallback;
+
     std::function<bool(const QWebEngineCookieStore::FilterRequest &)> filterCallback;
     QList<CookieData> m_pendingUserCookies;
+    QList<CookieListCallback> m_pendingGetAllCallbacks;
     bool m_deleteSessionCookiesPending;
     bool m_deleteAllCookiesPending;
     bool m_getAllCookiesPending;
 
+    bool m_batchChangeNotifications;
+    // Changes not yet delivered by cookiesChanged(), the last one for each cookie
+    QList<CookieChange> m_pendingChanges;
+    QHash<QByteArray, qsizetype> m_pendingChangeIndex;
+    QTimer m_batchTimer;
+
+    QList<QWebEngineCookieRule> m_cookieRules;
+    // read on the IO thread, replaced on the UI thread; only accessed atomically
+    std::shared_ptr<const QtWebEngineCore::CookieRuleSet> m_cookieRuleSet;
+    mutable QAtomicInteger<quint64> m_allowedCookieAccessCount;
+    mutable QAtomicInteger<quint64> m_blockedCookieAccessCount;
+
     QtWebEngineCore::CookieMonsterDelegateQt *delegate;
 
     QWebEngineCookieStorePrivate(QWebEngineCookieStore *q);
@@ -90,17 +119,24 @@ public:
     void processPendingUserCookies();
     void rejectPendingUserCookies();
     void setCookie(const QNetworkCookie &cookie, const QUrl &origin);
+    void setCookies(const QList<QNetworkCookie> &cookies, const QUrl &origin);
     void deleteCookie(const QNetworkCookie &cookie, const QUrl &url);
     void deleteSessionCookies();
     void deleteAllCookies();
     void getAllCookies();
+    void getAllCookies(CookieListCallback &&callback);
 
+    bool hasCookieFilter() const;
+    std::shared_ptr<const QtWebEngineCore::CookieRuleSet> cookieRuleSet() const;
     bool canAccessCookies(const QUrl &firstPartyUrl, const QUrl &url) const;
+    bool canAccessCookies(const GURL &firstPartyUrl, const GURL &url) const;
 
     void onCookieChanged(const QNetworkCookie &cookie, bool removed);
+    void deliverCookieChanges();
 };
 
 Q_DECLARE_TYPEINFO(QWebEngineCookieStorePrivate::CookieData, Q_RELOCATABLE_TYPE);
+Q_DECLARE_TYPEINFO(QWebEngineCookieStorePrivate::CookieChange, Q_RELOCATABLE_TYPE);
 
 QT_END_NAMESPACE
 
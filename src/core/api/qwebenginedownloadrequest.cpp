@@ -155,6 +155,18 @@ static inline QWebEngineDownloadRequest::DownloadInterruptReason toDownloadInter
     into a special file format (\l savePageFormat). To check if a download is
     for a file or a web page, use \l isSavePageDownload.
 
+    \section2 Progress Updates and Parallel Downloads
+
+    Progress is reported by the receivedBytesChanged() signal. Applications handling
+    many concurrent downloads can reduce the rate of these updates with
+    \l progressUpdateInterval. Updates that change the state of a download are
+    delivered immediately regardless.
+
+    Passing \c{--enable-features=ParallelDownloading} in \c QTWEBENGINE_CHROMIUM_FLAGS
+    lets large files be downloaded over several connections at once, each requesting a
+    byte range of the file. This applies only to servers that support range requests
+    and provide an \c ETag or \c Last-Modified header for the file.
+
     \sa QWebEngineProfile, QWebEngineProfile::downloadRequested,
     QWebEnginePage::download, QWebEnginePage::save
 */
@@ -170,6 +182,7 @@ QWebEngineDownloadRequestPrivate::QWebEngineDownloadRequestPrivate(QtWebEngineCo
     , isCustomFileName(false)
     , totalBytes(-1)
     , receivedBytes(0)
+    , progressUpdateInterval(0)
     , isSavePageDownload(false)
     , profileAdapter(adapter)
     , adapterClient(nullptr)
@@ -545,6 +558,37 @@ void QWebEngineDownloadRequest::setDownloadFileName(const QString &fileName)
     }
 }
 
+/*!
+    \property QWebEngineDownloadRequest::progressUpdateInterval
+    \since 6.4
+
+    \brief The minimum time in milliseconds between two progress updates.
+
+    Changes of receivedBytes and totalBytes that happen sooner after the last update
+    are held back and delivered together when the interval has passed. Changes of any
+    other property, such as state or isFinished, are delivered immediately.
+
+    The default value is \c 0, which reports progress as often as \QWE receives data.
+*/
+
+int QWebEngineDownloadRequest::progressUpdateInterval() const
+{
+    Q_D(const QWebEngineDownloadRequest);
+    return d->progressUpdateInterval;
+}
+
+void QWebEngineDownloadRequest::setProgressUpdateInterval(int msec)
+{
+    Q_D(QWebEngineDownloadRequest);
+    msec = qMax(0, msec);
+    if (d->progressUpdateInterval == msec)
+        return;
+    d->progressUpdateInterval = msec;
+    if (d->profileAdapter)
+        d->profileAdapter->setDownloadProgressUpdateInterval(d->downloadId, msec);
+    Q_EMIT progressUpdateIntervalChanged();
+}
+
 /*!
     Returns the suggested file name.
 */
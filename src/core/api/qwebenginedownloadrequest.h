@@ -70,6 +70,7 @@ public:
     Q_PROPERTY(QString suggestedFileName READ suggestedFileName CONSTANT FINAL)
     Q_PROPERTY(QString downloadDirectory READ downloadDirectory WRITE setDownloadDirectory NOTIFY downloadDirectoryChanged FINAL)
     Q_PROPERTY(QString downloadFileName READ downloadFileName WRITE setDownloadFileName NOTIFY downloadFileNameChanged FINAL)
+    Q_PROPERTY(int progressUpdateInterval READ progressUpdateInterval WRITE setProgressUpdateInterval NOTIFY progressUpdateIntervalChanged FINAL)
 
     ~QWebEngineDownloadRequest() override;
 
@@ -139,6 +140,8 @@ public:
     void setDownloadDirectory(const QString &directory);
     QString downloadFileName() const;
     void setDownloadFileName(const QString &fileName);
+    int progressUpdateInterval() const;
+    void setProgressUpdateInterval(int msec);
 
     QWebEnginePage *page() const;
 
@@ -158,6 +161,7 @@ Q_SIGNALS:
     void isPausedChanged();
     void downloadDirectoryChanged();
     void downloadFileNameChanged();
+    void progressUpdateIntervalChanged();
 
 private:
     Q_DISABLE_COPY(QWebEngineDownloadRequest)
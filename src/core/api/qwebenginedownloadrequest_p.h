@@ -89,6 +89,7 @@ public:
     bool isCustomFileName;
     qint64 totalBytes;
     qint64 receivedBytes;
+    int progressUpdateInterval;
     bool isSavePageDownload;
     QWebEngineDownloadRequest *q_ptr;
     QPointer<QtWebEngineCore::ProfileAdapter> profileAdapter;
@@ -42,6 +42,8 @@
 
 #include "web_contents_adapter.h"
 
+#include <QtCore/qset.h>
+
 QT_BEGIN_NAMESPACE
 
 /*!
@@ -162,6 +164,33 @@ QtWebEngineCore::WebContentsAdapter *QWebEngineHistoryModelPrivate::adapter() co
     return history->adapter();
 }
 
+int QWebEngineHistoryModelPrivate::entryId(int row) const
+{
+    return adapter()->getNavigationEntryUniqueId(index(row));
+}
+
+void QWebEngineHistoryModelPrivate::load(Row &row, int rowIndex) const
+{
+    const int entryIndex = index(rowIndex);
+    row.title = adapter()->getNavigationEntryTitle(entryIndex);
+    row.url = adapter()->getNavigationEntryUrl(entryIndex);
+    row.iconUrl = adapter()->getNavigationEntryIconUrl(entryIndex);
+    row.loaded = true;
+}
+
+void QWebEngineHistoryModelPrivate::resetRows()
+{
+    const int rowCount = qMax(0, count());
+    rows.clear();
+    rows.reserve(rowCount);
+    for (int i = 0; i < rowCount; ++i) {
+        Row row;
+        row.entryId = entryId(i);
+        row.offset = offsetForIndex(i);
+        rows.append(row);
+    }
+}
+
 int QWebEngineHistoryModelPrivate::count() const
 {
     return adapter()->navigationEntryCount();
@@ -213,6 +242,7 @@ int QWebEngineForwardHistoryModelPrivate::offsetForIndex(int index) const
 QWebEngineHistoryModel::QWebEngineHistoryModel(QWebEngineHistoryModelPrivate *d)
     : d_ptr(d)
 {
+    d->resetRows();
 }
 
 QWebEngineHistoryModel::~QWebEngineHistoryModel()
@@ -235,32 +265,34 @@ int QWebEngineHistoryModel::rowCount(const QModelIndex &index) const
 {
     Q_UNUSED(index);
     Q_D(const QWebEngineHistoryModel);
-    return d->count();
+    return d->rows.size();
 }
 
 QVariant QWebEngineHistoryModel::data(const QModelIndex &index, int role) const
 {
     Q_D(const QWebEngineHistoryModel);
 
-    if (!index.isValid())
+    if (!index.isValid() || index.row() >= d->rows.size())
         return QVariant();
 
+    QWebEngineHistoryModelPrivate::Row &row = d->rows[index.row()];
+    if (role == OffsetRole)
+        return row.offset;
+    if (!row.loaded)
+        d->load(row, index.row());
+
     switch (role) {
         case Qt::DisplayRole:
         case TitleRole:
-            return d->adapter()->getNavigationEntryTitle(d->index(index.row()));
+            return row.title;
 
         case Qt::ToolTipRole:
         case UrlRole:
-            return d->adapter()->getNavigationEntryUrl(d->index(index.row()));
+            return row.url;
 
-        case OffsetRole:
-            return d->offsetForIndex(index.row());
+        case IconUrlRole:
+            return d->history->urlOrImageProviderUrl(row.iconUrl);
 
-        case IconUrlRole: {
-            QUrl url = QUrl(d->adapter()->getNavigationEntryIconUrl(d->index(index.row())));
-            return d->history->urlOrImageProviderUrl(url);
-        }
         default:
             break;
     }
@@ -270,10 +302,126 @@ QVariant QWebEngineHistoryModel::data(const QModelIndex &index, int role) const
 
 void QWebEngineHistoryModel::reset()
 {
+    Q_D(QWebEngineHistoryModel);
     beginResetModel();
+    d->resetRows();
     endResetModel();
 }
 
+// Brings the rows in line with the navigation entries, reporting removed and
+// inserted rows instead of resetting the model, so that views keep the delegates
+// of unchanged entries. Navigation never reorders entries, so the entries that
+// are still there keep their relative order.
+void QWebEngineHistoryModel::update()
+{
+    Q_D(QWebEngineHistoryModel);
+
+    const int rowCount = qMax(0, d->count());
+    QList<int> entryIds;
+    entryIds.reserve(rowCount);
+    for (int i = 0; i < rowCount; ++i)
+        entryIds.append(d->entryId(i));
+
+    QSet<int> oldEntryIds;
+    for (const QWebEngineHistoryModelPrivate::Row &row : qAsConst(d->rows))
+        oldEntryIds.insert(row.entryId);
+    const QSet<int> newEntryIds(entryIds.cbegin(), entryIds.cend());
+
+    QList<int> kept;
+    for (const QWebEngineHistoryModelPrivate::Row &row : qAsConst(d->rows)) {
+        if (newEntryIds.contains(row.entryId))
+            kept.append(row.entryId);
+    }
+    int keptIndex = 0;
+    for (int entryId : qAsConst(entryIds)) {
+        if (!oldEntryIds.contains(entryId))
+            continue;
+        if (kept.at(keptIndex++) != entryId) {
+            reset();
+            return;
+        }
+    }
+
+    // Remove the rows of entries that are gone, back to front.
+    for (int last = d->rows.size() - 1; last >= 0;) {
+        if (newEntryIds.contains(d->rows.at(last).entryId)) {
+            --last;
+            continue;
+        }
+        int first = last;
+        while (first > 0 && !newEntryIds.contains(d->rows.at(first - 1).entryId))
+            --first;
+        beginRemoveRows(QModelIndex(), first, last);
+        d->rows.remove(first, last - first + 1);
+        endRemoveRows();
+        last = first - 1;
+    }
+
+    // Insert the rows of new entries, front to back.
+    for (int first = 0; first < entryIds.size();) {
+        if (oldEntryIds.contains(entryIds.at(first))) {
+            ++first;
+            continue;
+        }
+        int last = first;
+        while (last + 1 < entryIds.size() && !oldEntryIds.contains(entryIds.at(last + 1)))
+            ++last;
+        beginInsertRows(QModelIndex(), first, last);
+        for (int i = first; i <= last; ++i) {
+            QWebEngineHistoryModelPrivate::Row row;
+            row.entryId = entryIds.at(i);
+            row.offset = d->offsetForIndex(i);
+            d->rows.insert(i, row);
+        }
+        endInsertRows();
+        first = last + 1;
+    }
+    Q_ASSERT(d->rows.size() == entryIds.size());
+
+    // Report what changed in the remaining rows. Rows that were never asked
+    // for are not loaded, so there is nothing to compare for them.
+    int top = -1;
+    int bottom = -1;
+    bool offsetChanged = false, titleChanged = false, urlChanged = false, iconUrlChanged = false;
+    for (int i = 0; i < d->rows.size(); ++i) {
+        QWebEngineHistoryModelPrivate::Row &row = d->rows[i];
+        bool changed = false;
+        const int offset = d->offsetForIndex(i);
+        if (row.offset != offset) {
+            row.offset = offset;
+            offsetChanged = changed = true;
+        }
+        if (row.loaded) {
+            const QWebEngineHistoryModelPrivate::Row previous = row;
+            d->load(row, i);
+            if (row.title != previous.title)
+                titleChanged = changed = true;
+            if (row.url != previous.url)
+                urlChanged = changed = true;
+            if (row.iconUrl != previous.iconUrl)
+                iconUrlChanged = changed = true;
+        }
+        if (changed) {
+            if (top < 0)
+                top = i;
+            bottom = i;
+        }
+    }
+    if (top < 0)
+        return;
+
+    QList<int> roles;
+    if (offsetChanged)
+        roles << OffsetRole;
+    if (titleChanged)
+        roles << Qt::DisplayRole << TitleRole;
+    if (urlChanged)
+        roles << Qt::ToolTipRole << UrlRole;
+    if (iconUrlChanged)
+        roles << IconUrlRole;
+    Q_EMIT dataChanged(index(top), index(bottom), roles);
+}
+
 QWebEngineHistory::QWebEngineHistory(QWebEngineHistoryPrivate *d) : d_ptr(d) { }
 
 QWebEngineHistory::~QWebEngineHistory() { }
@@ -420,11 +568,11 @@ void QWebEngineHistory::reset()
 {
     Q_D(QWebEngineHistory);
     if (d->navigationModel)
-        d->navigationModel->reset();
+        d->navigationModel->update();
     if (d->backNavigationModel)
-        d->backNavigationModel->reset();
+        d->backNavigationModel->update();
     if (d->forwardNavigationModel)
-        d->forwardNavigationModel->reset();
+        d->forwardNavigationModel->update();
 }
 
 QT_END_NAMESPACE
@@ -106,6 +106,7 @@ public:
 private:
     QWebEngineHistoryModel(QWebEngineHistoryModelPrivate *);
     virtual ~QWebEngineHistoryModel();
+    void update();
 
     Q_DISABLE_COPY(QWebEngineHistoryModel)
     Q_DECLARE_PRIVATE(QWebEngineHistoryModel)
@@ -82,8 +82,24 @@ public:
     virtual int index(int) const;
     virtual int offsetForIndex(int) const;
 
+    // The navigation entry shown in a row, as last reported to views.
+    struct Row {
+        int entryId = 0;
+        int offset = 0;
+        // Only filled in once data() asks for the row.
+        bool loaded = false;
+        QString title;
+        QUrl url;
+        QUrl iconUrl;
+    };
+
+    int entryId(int row) const;
+    void load(Row &row, int rowIndex) const;
+    void resetRows();
+
     QtWebEngineCore::WebContentsAdapter *adapter() const;
     const QWebEngineHistoryPrivate *history;
+    mutable QList<Row> rows;
 };
 
 class QWebEngineBackHistoryModelPrivate : public QWebEngineHistoryModelPrivate
@@ -233,6 +233,7 @@ void QWebEnginePagePrivate::initializationFinished()
 void QWebEnginePagePrivate::titleChanged(const QString &title)
 {
     Q_Q(QWebEnginePage);
+    history->reset();
     Q_EMIT q->titleChanged(title);
 }
 
@@ -252,6 +253,7 @@ void QWebEnginePagePrivate::iconChanged(const QUrl &url)
     if (iconUrl == url)
         return;
     iconUrl = url;
+    history->reset();
     Q_EMIT q->iconUrlChanged(iconUrl);
     Q_EMIT q->iconChanged(iconUrl.isEmpty() ? QIcon() : adapter->icon());
 }
@@ -303,6 +305,7 @@ void QWebEnginePagePrivate::loadStarted(QWebEngineLoadingInfo info)
 {
     Q_Q(QWebEnginePage);
     isLoading = true;
+    history->reset();
     QTimer::singleShot(0, q, [q, info = std::move(info)] () {
         Q_EMIT q->loadStarted();
         Q_EMIT q->loadingChanged(info);
@@ -313,12 +316,18 @@ void QWebEnginePagePrivate::loadFinished(QWebEngineLoadingInfo info)
 {
     Q_Q(QWebEnginePage);
     isLoading = false;
+    history->reset();
     QTimer::singleShot(0, q, [q, info = std::move(info)] () {
         Q_EMIT q->loadFinished(info.status() == QWebEngineLoadingInfo::LoadSucceededStatus);
         Q_EMIT q->loadingChanged(info);
     });
 }
 
+void QWebEnginePagePrivate::loadCommitted()
+{
+    history->reset();
+}
+
 void QWebEnginePagePrivate::didPrintPageToPdf(const QString &filePath, bool success)
 {
     Q_Q(QWebEnginePage);
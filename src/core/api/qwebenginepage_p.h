@@ -134,7 +134,7 @@ public:
     QRectF viewportRect() const override;
     QColor backgroundColor() const override;
     void loadStarted(QWebEngineLoadingInfo info) override;
-    void loadCommitted() override { }
+    void loadCommitted() override;
     void loadFinished(QWebEngineLoadingInfo info) override;
     void focusContainer() override;
     void unhandledKeyEvent(QKeyEvent *event) override;
@@ -46,7 +46,9 @@
 #include "qwebenginesettings.h"
 #include "qwebenginescriptcollection.h"
 #include "qwebenginescriptcollection_p.h"
+#include "qwebengineurlrequestrule.h"
 #include "qtwebenginecoreglobal.h"
+#include "favicon_cache_qt.h"
 #include "profile_adapter.h"
 #include "visited_links_manager_qt.h"
 #include "web_engine_settings.h"
@@ -602,6 +604,36 @@ void QWebEngineProfile::setUrlRequestInterceptor(QWebEngineUrlRequestInterceptor
     d->profileAdapter()->setRequestInterceptor(interceptor);
 }
 
+/*!
+    Returns the rules applied to the URL requests of the profile.
+
+    \since 6.4
+    \sa setUrlRequestRules()
+*/
+QList<QWebEngineUrlRequestRule> QWebEngineProfile::urlRequestRules() const
+{
+    const Q_D(QWebEngineProfile);
+    return d->profileAdapter()->requestRules();
+}
+
+/*!
+    Sets the rules that block, redirect or modify the URL requests of the profile
+    to \a rules, replacing the previous ones.
+
+    The rules are compiled when they are set and checked for every request before the
+    URL request interceptors are called, without calling back into application code.
+    Requests that are blocked or redirected by a rule do not reach the interceptors.
+    Prefer rules over an interceptor for static block lists and header changes.
+
+    \since 6.4
+    \sa QWebEngineUrlRequestRule, setUrlRequestInterceptor()
+*/
+void QWebEngineProfile::setUrlRequestRules(const QList<QWebEngineUrlRequestRule> &rules)
+{
+    Q_D(QWebEngineProfile);
+    d->profileAdapter()->setRequestRules(rules);
+}
+
 /*!
     Clears all links from the visited links database.
 
@@ -902,4 +934,75 @@ void QWebEngineProfile::requestIconForIconURL(const QUrl &url, int desiredSizeIn
                                                iconAvailableCallback);
 }
 
+/*!
+    \since 6.4
+
+    Returns the maximum size of the profile's in-memory icon cache in bytes.
+
+    Icons returned by QWebEnginePage::icon(), requestIconForPageURL(), and requestIconForIconURL()
+    are kept in this cache, keyed by icon URL and pixel size, so that pages sharing
+    an icon get the same implicitly shared QIcon instead of decoding it again.
+
+    \sa setIconCacheMaximumSize(), iconCacheHitCount(), clearIconCache()
+*/
+int QWebEngineProfile::iconCacheMaximumSize() const
+{
+    const Q_D(QWebEngineProfile);
+    return d->profileAdapter()->faviconCache()->maxSize();
+}
+
+/*!
+    \since 6.4
+
+    Sets the maximum size of the in-memory icon cache to \a maxSize bytes.
+    The least recently used icons are dropped first when the cache is full.
+
+    Setting it to \c 0 restores the default size.
+
+    \sa iconCacheMaximumSize()
+*/
+void QWebEngineProfile::setIconCacheMaximumSize(int maxSize)
+{
+    Q_D(QWebEngineProfile);
+    d->profileAdapter()->faviconCache()->setMaxSize(maxSize);
+}
+
+/*!
+    \since 6.4
+
+    Returns how many icon lookups were answered from the in-memory icon cache.
+
+    \sa iconCacheMissCount()
+*/
+qint64 QWebEngineProfile::iconCacheHitCount() const
+{
+    const Q_D(QWebEngineProfile);
+    return d->profileAdapter()->faviconCache()->hitCount();
+}
+
+/*!
+    \since 6.4
+
+    Returns how many icon lookups had to decode the icon because it was not in
+    the in-memory icon cache.
+
+    \sa iconCacheHitCount()
+*/
+qint64 QWebEngineProfile::iconCacheMissCount() const
+{
+    const Q_D(QWebEngineProfile);
+    return d->profileAdapter()->faviconCache()->missCount();
+}
+
+/*!
+    \since 6.4
+
+    Removes all icons from the in-memory icon cache. The icon database is not affected.
+*/
+void QWebEngineProfile::clearIconCache()
+{
+    Q_D(QWebEngineProfile);
+    d->profileAdapter()->faviconCache()->clear();
+}
+
 QT_END_NAMESPACE
@@ -60,6 +60,7 @@ class QWebEngineProfilePrivate;
 class QWebEngineSettings;
 class QWebEngineScriptCollection;
 class QWebEngineUrlRequestInterceptor;
+class QWebEngineUrlRequestRule;
 class QWebEngineUrlSchemeHandler;
 
 class Q_WEBENGINECORE_EXPORT QWebEngineProfile : public QObject
@@ -111,6 +112,9 @@ public:
     QWebEngineCookieStore *cookieStore();
     void setUrlRequestInterceptor(QWebEngineUrlRequestInterceptor *interceptor);
 
+    QList<QWebEngineUrlRequestRule> urlRequestRules() const;
+    void setUrlRequestRules(const QList<QWebEngineUrlRequestRule> &rules);
+
     void clearAllVisitedLinks();
     void clearVisitedLinks(const QList<QUrl> &urls);
     bool visitedLinksContainsUrl(const QUrl &url) const;
@@ -141,6 +145,12 @@ public:
     void requestIconForPageURL(const QUrl &url, int desiredSizeInPixel, std::function<void(const QIcon &, const QUrl &, const QUrl &)> iconAvailableCallback) const;
     void requestIconForIconURL(const QUrl &url, int desiredSizeInPixel, std::function<void(const QIcon &, const QUrl &)> iconAvailableCallback) const;
 
+    int iconCacheMaximumSize() const;
+    void setIconCacheMaximumSize(int maxSize);
+    qint64 iconCacheHitCount() const;
+    qint64 iconCacheMissCount() const;
+    void clearIconCache();
+
     static QWebEngineProfile *defaultProfile();
 
 Q_SIGNALS:
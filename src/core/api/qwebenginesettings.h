@@ -95,6 +95,7 @@ public:
         JavascriptCanPaste,
         DnsPrefetchEnabled,
         PdfViewerEnabled,
+        WebChannelBinaryTransportEnabled,
     };
 
     enum FontSize {
@@ -167,12 +167,31 @@ QMap<QByteArray, QByteArray> QWebEngineUrlRequestJob::requestHeaders() const
     \code
     connect(job, &QObject::destroyed, device, &QObject::deleteLater);
     \endcode
+
+    If \a device is a QBuffer that is not open for writing, or a QFile that
+    can be mapped into memory, its contents are passed on without reading the
+    device piece by piece.
  */
 void QWebEngineUrlRequestJob::reply(const QByteArray &contentType, QIODevice *device)
 {
     d_ptr->reply(contentType, device);
 }
 
+/*!
+    \since 6.4
+    \overload
+
+    Replies to the request with \a data and the content type \a contentType.
+
+    The data is not copied, and is passed on directly without going through
+    a QIODevice. This is the most efficient way to reply with content that is
+    already held in memory.
+ */
+void QWebEngineUrlRequestJob::reply(const QByteArray &contentType, const QByteArray &data)
+{
+    d_ptr->reply(contentType, data);
+}
+
 /*!
     Fails the request with the error \a r.
 
@@ -0,0 +1,316 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtWebEngine module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qwebengineurlrequestrule.h"
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \class QWebEngineUrlRequestRule
+    \since 6.4
+    \ingroup webengine
+    \inmodule QtWebEngineCore
+
+    \brief The QWebEngineUrlRequestRule class describes how matching URL requests are handled
+    without an interceptor.
+
+    A list of rules set with QWebEngineProfile::setUrlRequestRules() is compiled once and
+    checked for every request of the profile before any QWebEngineUrlRequestInterceptor
+    is called. Requests blocked or redirected by a rule never reach an interceptor, and
+    no QWebEngineUrlRequestInfo is created for them.
+
+    A request matches a rule if all of the conditions set on the rule hold:
+
+    \list
+    \li host(): the host of the requested URL is this host or one of its subdomains.
+    \li urlPattern(): the whole requested URL matches this pattern, in which \c * matches
+        any sequence of characters and \c ? any single character.
+    \li resourceTypes(): the request loads one of these types of resources.
+    \li initiatorHost(): the request was started by a document on this host or one of
+        its subdomains.
+    \endlist
+
+    Conditions that are not set match any request. Rules with a host() are indexed by it,
+    so that large block lists of hosts are cheap to check regardless of their size.
+
+    When several rules match a request, an \l Allow rule takes precedence over all others.
+    Otherwise a \l Block rule takes precedence over a \l Redirect rule, of which the first
+    one in the list is applied, and the headers of all matching \l ModifyHeaders rules are
+    applied in order.
+
+    \code
+    QWebEngineUrlRequestRule ads(QWebEngineUrlRequestRule::Block, "ads.example.com");
+    QWebEngineUrlRequestRule tracker(QWebEngineUrlRequestRule::Block);
+    tracker.setUrlPattern("*/tracker.js*");
+    tracker.setResourceTypes({ QWebEngineUrlRequestInfo::ResourceTypeScript });
+    QWebEngineUrlRequestRule header(QWebEngineUrlRequestRule::ModifyHeaders, "api.example.com");
+    header.setHeader("X-Client", "kiosk");
+    profile->setUrlRequestRules({ ads, tracker, header });
+    \endcode
+
+    \sa QWebEngineUrlRequestInterceptor
+*/
+
+/*!
+    \enum QWebEngineUrlRequestRule::Action
+    \brief This enum type describes what happens to a matching request:
+
+    \value Block The request fails as blocked by the client.
+    \value Allow No other rule applies to the request.
+    \value Redirect The request is redirected to redirectUrl(). A request is redirected
+        by rules at most once, and never to its own URL.
+    \value ModifyHeaders The headers() of the rule are set on the request.
+*/
+
+class QWebEngineUrlRequestRulePrivate : public QSharedData
+{
+public:
+    bool operator==(const QWebEngineUrlRequestRulePrivate &other) const
+    {
+        return action == other.action && host == other.host && urlPattern == other.urlPattern
+                && resourceTypes == other.resourceTypes && initiatorHost == other.initiatorHost
+                && redirectUrl == other.redirectUrl && headers == other.headers;
+    }
+
+    QWebEngineUrlRequestRule::Action action = QWebEngineUrlRequestRule::Block;
+    QString host;
+    QString urlPattern;
+    QList<QWebEngineUrlRequestInfo::ResourceType> resourceTypes;
+    QString initiatorHost;
+    QUrl redirectUrl;
+    QList<QPair<QByteArray, QByteArray>> headers;
+};
+
+/*!
+    Constructs a rule that applies \a action to the requests for URLs on \a host
+    and its subdomains, or to all requests if \a host is empty.
+*/
+QWebEngineUrlRequestRule::QWebEngineUrlRequestRule(Action action, const QString &host)
+    : d(new QWebEngineUrlRequestRulePrivate)
+{
+    d->action = action;
+    d->host = host;
+}
+
+/*!
+    Creates a copy of \a other.
+*/
+QWebEngineUrlRequestRule::QWebEngineUrlRequestRule(const QWebEngineUrlRequestRule &other) = default;
+
+/*!
+    Destroys the rule.
+*/
+QWebEngineUrlRequestRule::~QWebEngineUrlRequestRule() = default;
+
+/*!
+    Assigns \a other to this rule.
+*/
+QWebEngineUrlRequestRule &QWebEngineUrlRequestRule::operator=(const QWebEngineUrlRequestRule &other) = default;
+
+/*!
+    \fn QWebEngineUrlRequestRule &QWebEngineUrlRequestRule::operator=(QWebEngineUrlRequestRule &&other)
+    Moves \a other into this rule.
+*/
+
+/*!
+    \fn void QWebEngineUrlRequestRule::swap(QWebEngineUrlRequestRule &other)
+    Swaps this rule with \a other.
+*/
+
+/*!
+    Returns \c true if this rule has the same action, conditions and parameters as \a other.
+*/
+bool QWebEngineUrlRequestRule::operator==(const QWebEngineUrlRequestRule &other) const
+{
+    return d == other.d || *d == *other.d;
+}
+
+/*!
+    \fn bool QWebEngineUrlRequestRule::operator!=(const QWebEngineUrlRequestRule &other) const
+    Returns \c true if this rule differs from \a other.
+*/
+
+/*!
+    Returns what happens to the requests matching the rule.
+*/
+QWebEngineUrlRequestRule::Action QWebEngineUrlRequestRule::action() const
+{
+    return d->action;
+}
+
+/*!
+    Sets what happens to the requests matching the rule to \a action.
+*/
+void QWebEngineUrlRequestRule::setAction(Action action)
+{
+    d->action = action;
+}
+
+/*!
+    Returns the host to which the rule is restricted, together with its subdomains.
+*/
+QString QWebEngineUrlRequestRule::host() const
+{
+    return d->host;
+}
+
+/*!
+    Restricts the rule to requests for URLs on \a host and its subdomains.
+    An empty \a host matches all requests.
+*/
+void QWebEngineUrlRequestRule::setHost(const QString &host)
+{
+    d->host = host;
+}
+
+/*!
+    Returns the wildcard pattern that the whole requested URL must match.
+*/
+QString QWebEngineUrlRequestRule::urlPattern() const
+{
+    return d->urlPattern;
+}
+
+/*!
+    Restricts the rule to requests whose URL matches \a pattern, in which
+    \c * matches any sequence of characters and \c ? any single character.
+    An empty \a pattern matches all requests.
+*/
+void QWebEngineUrlRequestRule::setUrlPattern(const QString &pattern)
+{
+    d->urlPattern = pattern;
+}
+
+/*!
+    Returns the types of resources to which the rule is restricted.
+*/
+QList<QWebEngineUrlRequestInfo::ResourceType> QWebEngineUrlRequestRule::resourceTypes() const
+{
+    return d->resourceTypes;
+}
+
+/*!
+    Restricts the rule to requests loading resources of one of \a types.
+    An empty list matches all requests.
+
+    Types outside of the range up to QWebEngineUrlRequestInfo::ResourceTypeLast,
+    such as QWebEngineUrlRequestInfo::ResourceTypeUnknown, are never matched. A rule
+    restricted to such types only is ignored with a warning.
+*/
+void QWebEngineUrlRequestRule::setResourceTypes(const QList<QWebEngineUrlRequestInfo::ResourceType> &types)
+{
+    d->resourceTypes = types;
+}
+
+/*!
+    Returns the host of the documents whose requests the rule is restricted to.
+*/
+QString QWebEngineUrlRequestRule::initiatorHost() const
+{
+    return d->initiatorHost;
+}
+
+/*!
+    Restricts the rule to requests started by documents on \a host and its
+    subdomains. An empty \a host matches all requests.
+*/
+void QWebEngineUrlRequestRule::setInitiatorHost(const QString &host)
+{
+    d->initiatorHost = host;
+}
+
+/*!
+    Returns the URL that matching requests are redirected to by a \l Redirect rule.
+*/
+QUrl QWebEngineUrlRequestRule::redirectUrl() const
+{
+    return d->redirectUrl;
+}
+
+/*!
+    Sets the URL that matching requests are redirected to by a \l Redirect rule to \a url.
+
+    \note The redirected request is checked against the rules again, so \a url should not
+    match the rule itself.
+*/
+void QWebEngineUrlRequestRule::setRedirectUrl(const QUrl &url)
+{
+    d->redirectUrl = url;
+}
+
+/*!
+    Returns the names of the headers set on matching requests by a \l ModifyHeaders rule.
+*/
+QList<QByteArray> QWebEngineUrlRequestRule::headers() const
+{
+    QList<QByteArray> names;
+    names.reserve(d->headers.size());
+    for (const auto &header : d->headers)
+        names.append(header.first);
+    return names;
+}
+
+/*!
+    Returns the value that a \l ModifyHeaders rule sets for the header \a headerName.
+*/
+QByteArray QWebEngineUrlRequestRule::header(const QByteArray &headerName) const
+{
+    for (const auto &header : d->headers) {
+        if (header.first.compare(headerName, Qt::CaseInsensitive) == 0)
+            return header.second;
+    }
+    return QByteArray();
+}
+
+/*!
+    Makes a \l ModifyHeaders rule set the header \a headerName to \a value on matching
+    requests. An empty \a value removes the header from the requests.
+*/
+void QWebEngineUrlRequestRule::setHeader(const QByteArray &headerName, const QByteArray &value)
+{
+    for (auto &header : d->headers) {
+        if (header.first.compare(headerName, Qt::CaseInsensitive) == 0) {
+            header.second = value;
+            return;
+        }
+    }
+    d->headers.append(qMakePair(headerName, value));
+}
+
+QT_END_NAMESPACE
@@ -43,6 +43,9 @@
 
 #include <QtDebug>
 
+#include <set>
+#include <string>
+
 QT_BEGIN_NAMESPACE
 
 ASSERT_ENUMS_MATCH(QWebEngineUrlScheme::Syntax::Path, url::SCHEME_WITHOUT_AUTHORITY)
@@ -63,17 +66,31 @@ ASSERT_ENUMS_MATCH(QWebEngineUrlScheme::CorsEnabled, url::CustomScheme::CorsEnab
 
 static bool g_schemesLocked = false;
 
+// ThreadSafeHandler only concerns how the browser process dispatches to the
+// scheme handler and has no url::CustomScheme counterpart, so it is not stored
+// in the flags serialized for the other processes.
+static std::set<std::string> &threadSafeHandlerSchemes()
+{
+    static std::set<std::string> schemes;
+    return schemes;
+}
+
 class QWebEngineUrlSchemePrivate : public QSharedData
                                  , public url::CustomScheme
 {
 public:
     QWebEngineUrlSchemePrivate() {}
-    QWebEngineUrlSchemePrivate(const url::CustomScheme &cs) : url::CustomScheme(cs) {}
+    QWebEngineUrlSchemePrivate(const url::CustomScheme &cs)
+        : url::CustomScheme(cs)
+        , threadSafeHandler(threadSafeHandlerSchemes().count(cs.name) > 0)
+    {}
     static QSharedDataPointer<QWebEngineUrlSchemePrivate> defaultConstructed()
     {
         static QSharedDataPointer<QWebEngineUrlSchemePrivate> instance(new QWebEngineUrlSchemePrivate);
         return instance;
     }
+
+    bool threadSafeHandler = false;
 };
 
 /*!
@@ -198,6 +215,16 @@ public:
   this includes access from other schemes. The appropriate CORS headers are
   generated automatically by the QWebEngineUrlRequestJob class. By default only
   \c http and \c https are CORS enabled. (Added in Qt 5.14)
+
+  \value ThreadSafeHandler
+  Indicates that the QWebEngineUrlSchemeHandler installed for this scheme is
+  thread-safe. Its \l{QWebEngineUrlSchemeHandler::requestStarted()}{requestStarted()}
+  function is then called on one of a pool of threads running event loops
+  instead of the main thread, and the QWebEngineUrlRequestJob may be replied to
+  from any thread. This keeps custom scheme loads going while the main thread
+  is busy. Removing the handler from the profile waits for calls to
+  requestStarted() in progress, so these must not wait for the main thread.
+  The handler must be removed before it is deleted. (Added in Qt 6.4)
 */
 
 QWebEngineUrlScheme::QWebEngineUrlScheme(QWebEngineUrlSchemePrivate *d) : d(d) {}
@@ -253,7 +280,8 @@ bool QWebEngineUrlScheme::operator==(const QWebEngineUrlScheme &that) const
         || (d->name == that.d->name
             && d->type == that.d->type
             && d->default_port == that.d->default_port
-            && d->flags == that.d->flags);
+            && d->flags == that.d->flags
+            && d->threadSafeHandler == that.d->threadSafeHandler);
 }
 
 /*!
@@ -339,7 +367,9 @@ void QWebEngineUrlScheme::setDefaultPort(int newValue)
 */
 QWebEngineUrlScheme::Flags QWebEngineUrlScheme::flags() const
 {
-    return Flags(d->flags);
+    Flags flags(d->flags);
+    flags.setFlag(ThreadSafeHandler, d->threadSafeHandler);
+    return flags;
 }
 
 /*!
@@ -349,7 +379,8 @@ QWebEngineUrlScheme::Flags QWebEngineUrlScheme::flags() const
 */
 void QWebEngineUrlScheme::setFlags(Flags newValue)
 {
-    d->flags = newValue;
+    d->flags = newValue & ~ThreadSafeHandler;
+    d->threadSafeHandler = newValue.testFlag(ThreadSafeHandler);
 }
 
 /*!
@@ -393,6 +424,8 @@ void QWebEngineUrlScheme::registerScheme(const QWebEngineUrlScheme &scheme)
     }
 
     url::CustomScheme::AddScheme(*scheme.d);
+    if (scheme.d->threadSafeHandler)
+        threadSafeHandlerSchemes().insert(scheme.d->name);
 }
 
 /*!
@@ -78,6 +78,7 @@ public:
         ViewSourceAllowed = 0x20,
         ContentSecurityPolicyIgnored = 0x40,
         CorsEnabled = 0x80,
+        ThreadSafeHandler = 0x100,
     };
     Q_DECLARE_FLAGS(Flags, Flag)
     Q_FLAG(Flags)
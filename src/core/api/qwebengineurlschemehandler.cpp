@@ -41,6 +41,8 @@
 
 #include "qwebengineurlrequestjob.h"
 
+#include "net/url_request_custom_job_proxy.h"
+
 QT_BEGIN_NAMESPACE
 
 /*!
@@ -108,9 +110,17 @@ QWebEngineUrlSchemeHandler::QWebEngineUrlSchemeHandler(QObject *parent)
 
 /*!
     Deletes a custom URL scheme handler.
+
+    A handler of a scheme registered with the QWebEngineUrlScheme::ThreadSafeHandler
+    flag must be removed from the profiles it is installed in before it is
+    deleted, as requestStarted() may otherwise be called on another thread while
+    the subclass is being destroyed.
 */
 QWebEngineUrlSchemeHandler::~QWebEngineUrlSchemeHandler()
 {
+    if (QtWebEngineCore::ThreadSafeUrlSchemeHandler::revokeAll(this))
+        qWarning("QWebEngineUrlSchemeHandler: A thread-safe handler was deleted while still "
+                 "installed in a profile, remove it from the profile first.");
 }
 
 /*!
@@ -121,6 +131,12 @@ QWebEngineUrlSchemeHandler::~QWebEngineUrlSchemeHandler()
     This method must be reimplemented by all custom URL scheme handlers.
     The request is asynchronous and does not need to be handled right away.
 
+    The method is called on the main thread, unless the scheme was registered with
+    the QWebEngineUrlScheme::ThreadSafeHandler flag. In that case it is called on
+    one of a pool of threads shared by the handlers of all such schemes, which
+    run event loops. Concurrent requests may be started on different threads
+    at the same time.
+
     \sa QWebEngineUrlRequestJob
 */
 
@@ -39,6 +39,8 @@
 
 #include "browser_accessibility_manager_qt.h"
 
+#include "base/bind.h"
+#include "base/threading/thread_task_runner_handle.h"
 #include "content/browser/accessibility/browser_accessibility.h"
 #include "ui/accessibility/ax_enums.mojom.h"
 
@@ -47,6 +49,9 @@
 
 #include <QtGui/qaccessible.h>
 
+#include <algorithm>
+#include <cmath>
+
 using namespace blink;
 
 namespace content {
@@ -109,6 +114,59 @@ QAccessibleInterface *BrowserAccessibilityManagerQt::rootParentAccessible()
 
 void BrowserAccessibilityManagerQt::FireBlinkEvent(ax::mojom::Event event_type,
                                                    BrowserAccessibility* node)
+{
+    switch (event_type) {
+    case ax::mojom::Event::kFocus:
+    case ax::mojom::Event::kCheckedStateChanged:
+    case ax::mojom::Event::kValueChanged:
+    case ax::mojom::Event::kTextChanged:
+    case ax::mojom::Event::kTextSelectionChanged:
+        queueEvent(event_type, node);
+        break;
+    default:
+        break;
+    }
+}
+
+void BrowserAccessibilityManagerQt::queueEvent(ax::mojom::Event event_type, BrowserAccessibility *node)
+{
+    if (event_type == ax::mojom::Event::kFocus) {
+        // only the last focus change of an update matters
+        auto previous = std::find_if(m_pendingEvents.begin(), m_pendingEvents.end(),
+                                     [](const std::pair<int32_t, ax::mojom::Event> &event) {
+                                         return event.second == ax::mojom::Event::kFocus;
+                                     });
+        if (previous != m_pendingEvents.end()) {
+            m_pendingEventSet.erase(*previous);
+            m_pendingEvents.erase(previous);
+        }
+    }
+
+    const auto event = std::make_pair(node->GetId(), event_type);
+    if (!m_pendingEventSet.insert(event).second)
+        return;
+    if (m_pendingEvents.empty()) {
+        base::ThreadTaskRunnerHandle::Get()->PostTask(
+                FROM_HERE,
+                base::BindOnce(&BrowserAccessibilityManagerQt::deliverEvents,
+                               m_weakFactory.GetWeakPtr()));
+    }
+    m_pendingEvents.push_back(event);
+}
+
+void BrowserAccessibilityManagerQt::deliverEvents()
+{
+    std::vector<std::pair<int32_t, ax::mojom::Event>> events;
+    events.swap(m_pendingEvents);
+    m_pendingEventSet.clear();
+    for (const auto &event : events) {
+        // the node may be gone by now
+        if (BrowserAccessibility *node = GetFromID(event.first))
+            deliverEvent(event.second, node);
+    }
+}
+
+void BrowserAccessibilityManagerQt::deliverEvent(ax::mojom::Event event_type, BrowserAccessibility *node)
 {
     auto *iface = toQAccessibleInterface(node);
 
@@ -133,12 +191,6 @@ void BrowserAccessibilityManagerQt::FireBlinkEvent(ax::mojom::Event event_type,
         QAccessible::updateAccessibility(&event);
         break;
     }
-    case ax::mojom::Event::kChildrenChanged:
-        break;
-    case ax::mojom::Event::kLayoutComplete:
-        break;
-    case ax::mojom::Event::kLoadComplete:
-        break;
     case ax::mojom::Event::kTextChanged: {
         QAccessibleTextUpdateEvent event(iface, -1, QString(), QString());
         QAccessible::updateAccessibility(&event);
@@ -172,16 +224,105 @@ void BrowserAccessibilityManagerQt::FireGeneratedEvent(ui::AXEventGenerator::Eve
 
     switch (event_type) {
     case ui::AXEventGenerator::Event::VALUE_IN_TEXT_FIELD_CHANGED:
-        if (iface->role() == QAccessible::EditableText) {
-            QAccessibleTextUpdateEvent event(iface, -1, QString(), QString());
-            QAccessible::updateAccessibility(&event);
-        }
+        // delivered like, and merged with, a text change from Blink
+        if (iface->role() == QAccessible::EditableText)
+            queueEvent(ax::mojom::Event::kTextChanged, node);
         break;
     default:
         break;
     }
 }
 
+void BrowserAccessibilityManagerQt::OnAtomicUpdateFinished(ui::AXTree *tree, bool root_changed,
+                                                           const std::vector<ui::AXTreeObserver::Change> &changes)
+{
+    m_childIndexes.clear();
+    BrowserAccessibilityManager::OnAtomicUpdateFinished(tree, root_changed, changes);
+}
+
+static QRect screenRect(BrowserAccessibility *node)
+{
+    gfx::Rect bounds = node->GetUnclippedScreenBoundsRect();
+    return QRect(bounds.x(), bounds.y(), bounds.width(), bounds.height());
+}
+
+// Nodes with fewer children are hit-tested by checking each of them.
+static const uint32_t MinIndexedChildren = 32;
+
+void BrowserAccessibilityManagerQt::buildChildIndex(BrowserAccessibility *parent, ChildIndex &index)
+{
+    const uint32_t count = parent->PlatformChildCount();
+    index = ChildIndex();
+    index.built = true;
+    index.parentRect = screenRect(parent);
+    index.rects.reserve(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        BrowserAccessibility *child = parent->PlatformGetChild(i);
+        // children from other trees are not invalidated with this one
+        if (!child || child->manager() != this)
+            return;
+        index.rects.push_back(screenRect(child));
+        index.bounds |= index.rects.back();
+    }
+    if (index.bounds.isEmpty())
+        return;
+
+    const int side = std::max(1, int(std::ceil(std::sqrt(double(count)))));
+    index.columns = std::min(side, index.bounds.width());
+    index.rows = std::min(side, index.bounds.height());
+    index.cellSize = QSize((index.bounds.width() + index.columns - 1) / index.columns,
+                           (index.bounds.height() + index.rows - 1) / index.rows);
+    index.cells.resize(index.columns * index.rows);
+    for (uint32_t i = 0; i < count; ++i) {
+        const QRect &rect = index.rects[i];
+        if (rect.isEmpty())
+            continue;
+        const int left = (rect.left() - index.bounds.left()) / index.cellSize.width();
+        const int right = (rect.right() - index.bounds.left()) / index.cellSize.width();
+        const int top = (rect.top() - index.bounds.top()) / index.cellSize.height();
+        const int bottom = (rect.bottom() - index.bounds.top()) / index.cellSize.height();
+        for (int row = top; row <= bottom; ++row) {
+            for (int column = left; column <= right; ++column)
+                index.cells[row * index.columns + column].push_back(i);
+        }
+    }
+    index.indexed = true;
+}
+
+// Returns the first child of parent whose screen rectangle contains point.
+BrowserAccessibility *BrowserAccessibilityManagerQt::childAt(BrowserAccessibility *parent, const QPoint &point)
+{
+    const uint32_t count = parent->PlatformChildCount();
+    if (count >= MinIndexedChildren && parent->manager() == this) {
+        ChildIndex &index = m_childIndexes[parent->GetId()];
+        QRect parentRect = screenRect(parent);
+        // the tree does not change when the window is moved, follow it
+        if (!index.built || index.parentRect.size() != parentRect.size()) {
+            buildChildIndex(parent, index);
+            parentRect = index.parentRect;
+        }
+        if (index.indexed) {
+            const QPoint p = point - parentRect.topLeft() + index.parentRect.topLeft();
+            if (!index.bounds.contains(p))
+                return nullptr;
+            const int column = (p.x() - index.bounds.left()) / index.cellSize.width();
+            const int row = (p.y() - index.bounds.top()) / index.cellSize.height();
+            for (uint32_t i : index.cells[row * index.columns + column]) {
+                if (index.rects[i].contains(p))
+                    return parent->PlatformGetChild(i);
+            }
+            return nullptr;
+        }
+    }
+
+    for (uint32_t i = 0; i < count; ++i) {
+        BrowserAccessibility *child = parent->PlatformGetChild(i);
+        if (child && screenRect(child).contains(point))
+            return child;
+    }
+    return nullptr;
+}
+
 #endif // QT_CONFIG(accessibility)
 
 }
@@ -40,11 +40,18 @@
 #ifndef BROWSER_ACCESSIBILITY_MANAGER_QT_H
 #define BROWSER_ACCESSIBILITY_MANAGER_QT_H
 
+#include "base/memory/weak_ptr.h"
 #include "content/browser/accessibility/browser_accessibility_manager.h"
 
 #include <QtCore/qobject.h>
+#include <QtCore/qrect.h>
 #include <QtGui/qtgui-config.h>
 
+#include <set>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
 #if QT_CONFIG(accessibility)
 
 QT_FORWARD_DECLARE_CLASS(QAccessibleInterface)
@@ -66,14 +73,45 @@ public:
                         BrowserAccessibility* node) override;
     void FireGeneratedEvent(ui::AXEventGenerator::Event event_type,
                             BrowserAccessibility* node) override;
+    void OnAtomicUpdateFinished(ui::AXTree *tree, bool root_changed,
+                                const std::vector<ui::AXTreeObserver::Change> &changes) override;
 
     QAccessibleInterface *rootParentAccessible();
     bool isValid() const { return m_valid; }
 
+    BrowserAccessibility *childAt(BrowserAccessibility *parent, const QPoint &point);
+
 private:
     Q_DISABLE_COPY(BrowserAccessibilityManagerQt)
+
+    // Grid of the screen rectangles of the children of a node, for hit-testing
+    // nodes with many children. Valid until the tree changes.
+    struct ChildIndex
+    {
+        bool built = false; // also when the children cannot be indexed
+        bool indexed = false;
+        QRect parentRect; // when built, so that moving the window can be followed
+        QRect bounds;
+        int columns = 0;
+        int rows = 0;
+        QSize cellSize;
+        std::vector<QRect> rects;
+        std::vector<std::vector<uint32_t>> cells;
+    };
+
+    void buildChildIndex(BrowserAccessibility *parent, ChildIndex &index);
+    void queueEvent(ax::mojom::Event event_type, BrowserAccessibility *node);
+    void deliverEvents();
+    void deliverEvent(ax::mojom::Event event_type, BrowserAccessibility *node);
+
     QtWebEngineCore::WebContentsAccessibilityQt *m_webContentsAccessibility;
     bool m_valid = false;
+    std::unordered_map<int32_t, ChildIndex> m_childIndexes;
+    // Events are delivered once the tree update that caused them is done,
+    // at most one per node and type, and only the last focus change.
+    std::vector<std::pair<int32_t, ax::mojom::Event>> m_pendingEvents;
+    std::set<std::pair<int32_t, ax::mojom::Event>> m_pendingEventSet;
+    base::WeakPtrFactory<BrowserAccessibilityManagerQt> m_weakFactory{this};
 };
 
 }
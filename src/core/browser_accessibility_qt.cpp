@@ -212,13 +212,11 @@ QObject *BrowserAccessibilityInterface::object() const
 
 QAccessibleInterface *BrowserAccessibilityInterface::childAt(int x, int y) const
 {
-    for (int i = 0; i < childCount(); ++i) {
-        QAccessibleInterface *childIface = child(i);
-        Q_ASSERT(childIface);
-        if (childIface->rect().contains(x,y))
-            return childIface;
-    }
-    return nullptr;
+    auto managerQt = static_cast<content::BrowserAccessibilityManagerQt *>(q->manager());
+    if (!managerQt)
+        return nullptr;
+    content::BrowserAccessibility *chromiumChild = managerQt->childAt(q, QPoint(x, y));
+    return chromiumChild ? toQAccessibleInterface(chromiumChild) : nullptr;
 }
 
 void *BrowserAccessibilityInterface::interface_cast(QAccessible::InterfaceType type)
@@ -40,12 +40,15 @@
 #include "browser_message_filter_qt.h"
 
 #include "chrome/browser/profiles/profile.h"
+#include "content/public/browser/browser_task_traits.h"
+#include "content/public/browser/browser_thread.h"
 #include "net/url_request/url_request_context.h"
 #include "net/url_request/url_request_context_getter.h"
 
 #include "common/qt_messages.h"
+#include "profile_adapter.h"
 #include "profile_io_data_qt.h"
-#include "type_conversion.h"
+#include "renderer_host/user_resource_controller_host.h"
 
 namespace QtWebEngineCore {
 
@@ -63,6 +66,8 @@ bool BrowserMessageFilterQt::OnMessageReceived(const IPC::Message& message)
                                         OnRequestStorageAccessSync)
         IPC_MESSAGE_HANDLER(QtWebEngineHostMsg_RequestStorageAccessAsync,
                             OnRequestStorageAccessAsync)
+        IPC_MESSAGE_HANDLER(QtWebEngineHostMsg_StoreUserScriptCodeCache,
+                            OnStoreUserScriptCodeCache)
         IPC_MESSAGE_UNHANDLED(return false)
     IPC_END_MESSAGE_MAP()
     return true;
@@ -74,7 +79,7 @@ void BrowserMessageFilterQt::OnAllowStorageAccess(int /*render_frame_id*/,
                                                   int /*storage_type*/,
                                                   bool *allowed)
 {
-    *allowed = m_profileData->canGetCookies(toQt(top_origin_url), toQt(origin_url));
+    *allowed = m_profileData->canGetCookies(top_origin_url, origin_url);
 }
 
 void BrowserMessageFilterQt::OnRequestStorageAccessSync(int render_frame_id,
@@ -124,6 +129,18 @@ void BrowserMessageFilterQt::OnRequestStorageAccessAsyncResponse(int render_fram
     Send(new QtWebEngineMsg_RequestStorageAccessAsyncResponse(render_frame_id, request_id, allowed));
 }
 
+void BrowserMessageFilterQt::OnStoreUserScriptCodeCache(uint64_t script_id, const std::vector<uint8_t> &data)
+{
+    DCHECK_CURRENTLY_ON(content::BrowserThread::IO);
+    content::GetUIThreadTaskRunner({})->PostTask(
+            FROM_HERE,
+            base::BindOnce([](QPointer<ProfileAdapter> profileAdapter, uint64_t scriptId,
+                              std::vector<uint8_t> data) {
+                if (profileAdapter)
+                    profileAdapter->userResourceController()->storeCodeCache(scriptId, data);
+            }, m_profileData->profileAdapter(), script_id, data));
+}
+
 void BrowserMessageFilterQt::OnRequestStorageAccess(int /*render_frame_id*/,
                                                     const GURL &origin_url,
                                                     const GURL &top_origin_url,
@@ -131,7 +148,7 @@ void BrowserMessageFilterQt::OnRequestStorageAccess(int /*render_frame_id*/,
                                                     base::OnceCallback<void(bool)> callback)
 {
     DCHECK_CURRENTLY_ON(content::BrowserThread::IO);
-    bool allowed = m_profileData->canGetCookies(toQt(top_origin_url), toQt(origin_url));
+    bool allowed = m_profileData->canGetCookies(top_origin_url, origin_url);
 
     std::move(callback).Run(allowed);
 }
@@ -80,6 +80,7 @@ private:
     void OnRequestStorageAccessAsyncResponse(int render_frame_id,
                                              int request_id,
                                              bool allowed);
+    void OnStoreUserScriptCodeCache(uint64_t script_id, const std::vector<uint8_t> &data);
     void OnRequestStorageAccess(int render_frame_id,
                                 const GURL &origin_url,
                                 const GURL &top_origin_url,
@@ -4,6 +4,7 @@
 
 // Multiply-included file, no traditional include guard.
 
+#include "base/memory/read_only_shared_memory_region.h"
 #include "content/public/common/common_param_traits.h"
 #include "ipc/ipc_message_macros.h"
 #include "ipc/ipc_message_start.h"
@@ -19,6 +20,12 @@ IPC_MESSAGE_ROUTED2(QtWebEngineMsg_RequestStorageAccessAsyncResponse,
                     int  /* request_id */,
                     bool /* allowed */)
 
+// Hands the V8 code cache of a user script to the renderer, before the script
+// itself. The region is shared by all render processes.
+IPC_MESSAGE_CONTROL2(QtWebEngineMsg_SetUserScriptCodeCache,
+                     uint64_t /* script_id */,
+                     base::ReadOnlySharedMemoryRegion /* data */)
+
 //-----------------------------------------------------------------------------
 // These are messages sent from the renderer to the browser process.
 
@@ -45,3 +52,9 @@ IPC_MESSAGE_CONTROL5(QtWebEngineHostMsg_RequestStorageAccessAsync,
                      GURL /* top origin url */,
                      int /* storage_type */)
 
+// Sent by the renderer process after it has compiled a user script that it
+// did not get a code cache for.
+IPC_MESSAGE_CONTROL2(QtWebEngineHostMsg_StoreUserScriptCodeCache,
+                     uint64_t /* script_id */,
+                     std::vector<uint8_t> /* data */)
+
@@ -45,6 +45,10 @@
 #include <QHash>
 #include <QImage>
 #include <QMutex>
+#include <QRegion>
+#include <QThread>
+
+#include <atomic>
 
 namespace QtWebEngineCore {
 
@@ -67,16 +71,55 @@ static bool operator==(Compositor::Id id1, Compositor::Id id2)
 
 // Compositor::Binding and Compositor::Bindings
 
+// Links a compositor and an observer with the same id.
+//
+// Each side is guarded by a count of live handles: acquiring a handle
+// bumps the count before looking at the pointer, and unbinding clears
+// the pointer before waiting for the count to drop to zero, so neither
+// side can go away while the other one is using it. Releasing a handle
+// is the last access to the binding, which may be deleted right after.
 struct Compositor::Binding
 {
+    template<typename T>
+    struct Side
+    {
+        std::atomic<T *> data { nullptr };
+        std::atomic<int> users { 0 };
+        // Guarded by the registry lock, stays set until clear() returned.
+        bool bound = false;
+
+        T *acquire()
+        {
+            users.fetch_add(1);
+            if (T *ptr = data.load())
+                return ptr;
+            release();
+            return nullptr;
+        }
+
+        void release() { users.fetch_sub(1); }
+
+        void clear()
+        {
+            data.store(nullptr);
+            // Handles are only held for the duration of a swap.
+            while (users.load() != 0)
+                QThread::yieldCurrentThread();
+        }
+    };
+
     const Id id;
-    Compositor *compositor = nullptr;
-    Observer *observer = nullptr;
+    Side<Compositor> compositor;
+    Side<Observer> observer;
 
     Binding(Id id) : id(id) { }
     ~Binding();
 };
 
+// Registry of bindings by id.
+//
+// Only bind() and unbind() go through here, handles never touch the
+// registry lock.
 class Compositor::BindingMap
 {
 public:
@@ -111,18 +154,25 @@ void Compositor::Observer::bind(Id id)
     DCHECK(!m_binding);
     g_bindings.lock();
     m_binding = g_bindings.findOrCreate(id);
-    DCHECK(!m_binding->observer);
-    m_binding->observer = this;
+    DCHECK(!m_binding->observer.bound);
+    m_binding->observer.data.store(this);
+    m_binding->observer.bound = true;
     g_bindings.unlock();
 }
 
 void Compositor::Observer::unbind()
 {
     DCHECK(m_binding);
+    // Wait for handles outside of the registry lock, so that other
+    // bindings are not held up meanwhile.
+    m_binding->observer.clear();
     g_bindings.lock();
-    m_binding->observer = nullptr;
-    if (m_binding->compositor == nullptr)
+    m_binding->observer.bound = false;
+    if (!m_binding->compositor.bound) {
+        // Failed attempts at acquiring the compositor may still be in flight.
+        m_binding->compositor.clear();
         delete m_binding;
+    }
     m_binding = nullptr;
     g_bindings.unlock();
 }
@@ -131,10 +181,8 @@ Compositor::Handle<Compositor> Compositor::Observer::compositor()
 {
     if (!m_binding)
         return nullptr;
-    g_bindings.lock();
-    if (m_binding->compositor)
-        return m_binding->compositor; // delay unlock
-    g_bindings.unlock();
+    if (Compositor *compositor = m_binding->compositor.acquire())
+        return { compositor, m_binding };
     return nullptr;
 }
 
@@ -145,18 +193,25 @@ void Compositor::bind(Id id)
     DCHECK(!m_binding);
     g_bindings.lock();
     m_binding = g_bindings.findOrCreate(id);
-    DCHECK(!m_binding->compositor);
-    m_binding->compositor = this;
+    DCHECK(!m_binding->compositor.bound);
+    m_binding->compositor.data.store(this);
+    m_binding->compositor.bound = true;
     g_bindings.unlock();
 }
 
 void Compositor::unbind()
 {
     DCHECK(m_binding);
+    // Wait for handles outside of the registry lock, so that other
+    // bindings are not held up meanwhile.
+    m_binding->compositor.clear();
     g_bindings.lock();
-    m_binding->compositor = nullptr;
-    if (m_binding->observer == nullptr)
+    m_binding->compositor.bound = false;
+    if (!m_binding->observer.bound) {
+        // Failed attempts at acquiring the observer may still be in flight.
+        m_binding->observer.clear();
         delete m_binding;
+    }
     m_binding = nullptr;
     g_bindings.unlock();
 }
@@ -165,10 +220,8 @@ Compositor::Handle<Compositor::Observer> Compositor::observer()
 {
     if (!m_binding)
         return nullptr;
-    g_bindings.lock();
-    if (m_binding->observer)
-        return m_binding->observer; // delay unlock
-    g_bindings.unlock();
+    if (Observer *observer = m_binding->observer.acquire())
+        return { observer, m_binding };
     return nullptr;
 }
 
@@ -178,6 +231,12 @@ QImage Compositor::image()
     return {};
 }
 
+QRegion Compositor::damage()
+{
+    Q_UNREACHABLE();
+    return {};
+}
+
 void Compositor::waitForTexture()
 {
     Q_UNREACHABLE();
@@ -190,8 +249,14 @@ int Compositor::textureId()
 }
 
 // static
-void Compositor::unlockBindings()
+void Compositor::releaseBinding(Binding *binding, Compositor *)
 {
-    g_bindings.unlock();
+    binding->compositor.release();
+}
+
+// static
+void Compositor::releaseBinding(Binding *binding, Observer *)
+{
+    binding->observer.release();
 }
 } // namespace QtWebEngineCore
@@ -44,6 +44,7 @@
 
 QT_BEGIN_NAMESPACE
 class QImage;
+class QRegion;
 class QSize;
 QT_END_NAMESPACE
 
@@ -83,21 +84,26 @@ public:
         quint32 sink_id;
 
         Id(viz::FrameSinkId);
+        Id(quint32 client_id, quint32 sink_id) : client_id(client_id), sink_id(sink_id) { }
     };
 
-    // Pointer to Compositor or Observer that holds a lock to prevent
-    // either from being unbound and destroyed.
+    // Pointer to Compositor or Observer that prevents it from being
+    // unbound and destroyed while the handle is alive.
+    //
+    // Acquiring and releasing a handle is lock-free and only affects
+    // the binding it came from, so an unbind() blocks just until the
+    // handles to its own binding are gone.
     template<typename T>
     class Handle
     {
     public:
-        Handle(std::nullptr_t) : m_data(nullptr) { }
-        Handle(T *data) : m_data(data) { }
-        Handle(Handle &&that) : m_data(that.m_data) { that.m_data = nullptr; }
+        Handle(std::nullptr_t) : m_data(nullptr), m_binding(nullptr) { }
+        Handle(T *data, Binding *binding) : m_data(data), m_binding(binding) { }
+        Handle(Handle &&that) : m_data(that.m_data), m_binding(that.m_binding) { that.m_data = nullptr; }
         ~Handle()
         {
             if (m_data)
-                Compositor::unlockBindings();
+                Compositor::releaseBinding(m_binding, m_data);
         }
         T *operator->() const { return m_data; }
         T &operator*() const { return *m_data; }
@@ -105,6 +111,7 @@ public:
 
     private:
         T *m_data;
+        Binding *m_binding;
     };
 
     // Observes the compositor corresponding to the given id.
@@ -164,11 +171,18 @@ public:
     // (Software) QImage of the frame.
     //
     // This is a big image so we should try not to make copies of it.
-    // In particular, the client should drop its QImage reference
-    // before calling swapFrame(), otherwise each swap will cause a
-    // detach.
+    // The image is the very buffer the frame was rendered into and is
+    // recycled for later frames. The client should drop its QImage
+    // reference once done with it, otherwise a new buffer has to be
+    // allocated for rendering.
     virtual QImage image();
 
+    // (Software) Region of image() that changed in the last swapFrame().
+    //
+    // Empty if there was no new frame to swap in, covers the whole
+    // image whenever its size changed.
+    virtual QRegion damage();
+
     // (OpenGL) Wait on texture fence in Qt's current OpenGL context.
     virtual void waitForTexture();
 
@@ -184,7 +198,8 @@ private:
     friend class Handle;
 
     class BindingMap;
-    static void unlockBindings();
+    static void releaseBinding(Binding *binding, Compositor *compositor);
+    static void releaseBinding(Binding *binding, Observer *observer);
 
     const Type m_type;
     Binding *m_binding = nullptr;
@@ -49,9 +49,23 @@
 
 #include <QMutex>
 #include <QPainter>
+#include <QRegion>
 
 namespace QtWebEngineCore {
 
+inline QImage::Format imageFormat(SkColorType colorType)
+{
+    switch (colorType) {
+    case kBGRA_8888_SkColorType:
+        return QImage::Format_ARGB32_Premultiplied;
+    case kRGBA_8888_SkColorType:
+        return QImage::Format_RGBA8888_Premultiplied;
+    default:
+        Q_UNREACHABLE();
+        return QImage::Format_ARGB32_Premultiplied;
+    }
+}
+
 class DisplaySoftwareOutputSurface::Device final : public viz::SoftwareOutputDevice,
                                                    public Compositor
 {
@@ -60,22 +74,42 @@ public:
 
     // Overridden from viz::SoftwareOutputDevice.
     void Resize(const gfx::Size &sizeInPixels, float devicePixelRatio) override;
+    SkCanvas *BeginPaint(const gfx::Rect &damageRect) override;
     void OnSwapBuffers(SwapBuffersCallback swap_ack_callback) override;
 
     // Overridden from Compositor.
     void swapFrame() override;
     QImage image() override;
+    QRegion damage() override;
     float devicePixelRatio() override;
     QSize size() override;
     bool hasAlphaChannel() override;
 
 private:
+    // Skia renders directly into the buffers, which are then handed to
+    // the client as they are: one is displayed, one holds the latest
+    // frame waiting for swapFrame() and one is being rendered into.
+    static constexpr int BufferCount = 3;
+
+    struct Buffer
+    {
+        QImage image;
+        sk_sp<SkSurface> surface;
+        // Parts of image that are out of date compared to the latest frame.
+        QRegion staleRegion;
+        float devicePixelRatio = 1.0;
+    };
+
     mutable QMutex m_mutex;
     float m_devicePixelRatio = 1.0;
     scoped_refptr<base::SingleThreadTaskRunner> m_taskRunner;
     SwapBuffersCallback m_swapCompletionCallback;
-    QImage m_image;
-    float m_imageDevicePixelRatio = 1.0;
+    Buffer m_buffers[BufferCount];
+    int m_frontIndex = -1;
+    int m_pendingIndex = -1;
+    int m_backIndex = -1;
+    QRegion m_pendingDamage;
+    QRegion m_damage;
 };
 
 DisplaySoftwareOutputSurface::Device::Device()
@@ -88,79 +122,140 @@ void DisplaySoftwareOutputSurface::Device::Resize(const gfx::Size &sizeInPixels,
         return;
     m_devicePixelRatio = devicePixelRatio;
     viewport_pixel_size_ = sizeInPixels;
-    surface_ = SkSurface::MakeRaster(SkImageInfo::MakeN32Premul(sizeInPixels.width(), sizeInPixels.height()));
+    // Buffers are reallocated by BeginPaint once they are no longer in use.
+    surface_.reset();
 }
 
-void DisplaySoftwareOutputSurface::Device::OnSwapBuffers(SwapBuffersCallback swap_ack_callback)
+SkCanvas *DisplaySoftwareOutputSurface::Device::BeginPaint(const gfx::Rect &damageRect)
 {
-    { // MEMO don't hold a lock together with an 'observer', as the call from Qt's scene graph may come at the same time
+    damage_rect_ = damageRect;
+
+    int latestIndex;
+    {
         QMutexLocker locker(&m_mutex);
-        m_taskRunner = base::ThreadTaskRunnerHandle::Get();
-        m_swapCompletionCallback = std::move(swap_ack_callback);
+        m_backIndex = 0;
+        while (m_backIndex == m_frontIndex || m_backIndex == m_pendingIndex)
+            ++m_backIndex;
+        latestIndex = m_pendingIndex != -1 ? m_pendingIndex : m_frontIndex;
     }
 
-    if (auto obs = observer())
-        obs->readyToSwap();
+    // The latest frame is not written to until another frame replaces it,
+    // which can only happen on this thread, so no need to hold the lock.
+    Buffer &buffer = m_buffers[m_backIndex];
+    const QSize size = toQt(viewport_pixel_size_);
+
+    // If the client still holds on to an earlier frame, leave the image to
+    // it and render into a new one instead.
+    if (buffer.image.size() != size || !buffer.image.isDetached()) {
+        SkImageInfo info = SkImageInfo::MakeN32Premul(size.width(), size.height());
+        buffer.image = QImage(size, imageFormat(info.colorType()));
+        buffer.surface = SkSurface::MakeRasterDirect(info, buffer.image.bits(), buffer.image.bytesPerLine());
+        buffer.staleRegion = buffer.image.rect();
+    }
+
+    // Viz only redraws the damaged part, bring the rest up to date.
+    const QRegion staleRegion = buffer.staleRegion - toQt(damageRect);
+    if (latestIndex != -1 && !staleRegion.isEmpty() && m_buffers[latestIndex].image.size() == size) {
+        QPainter painter(&buffer.image);
+        painter.setCompositionMode(QPainter::CompositionMode_Source);
+        for (const QRect &rect : staleRegion)
+            painter.drawImage(rect, m_buffers[latestIndex].image, rect);
+    }
+    buffer.staleRegion = QRegion();
+
+    surface_ = buffer.surface;
+    return surface_ ? surface_->getCanvas() : nullptr;
 }
 
-inline QImage::Format imageFormat(SkColorType colorType)
+void DisplaySoftwareOutputSurface::Device::OnSwapBuffers(SwapBuffersCallback swap_ack_callback)
 {
-    switch (colorType) {
-    case kBGRA_8888_SkColorType:
-        return QImage::Format_ARGB32_Premultiplied;
-    case kRGBA_8888_SkColorType:
-        return QImage::Format_RGBA8888_Premultiplied;
-    default:
-        Q_UNREACHABLE();
-        return QImage::Format_ARGB32_Premultiplied;
+    { // MEMO don't hold a lock together with an 'observer', as the call from Qt's scene graph may come at the same time
+        QMutexLocker locker(&m_mutex);
+        if (m_backIndex == -1) {
+            base::ThreadTaskRunnerHandle::Get()->PostTask(
+                    FROM_HERE, base::BindOnce(std::move(swap_ack_callback), viewport_pixel_size_));
+            return;
+        }
+
+        const QRect damageRect = toQt(damage_rect_);
+        for (int i = 0; i < BufferCount; ++i) {
+            if (i != m_backIndex)
+                m_buffers[i].staleRegion += damageRect;
+        }
+        m_buffers[m_backIndex].devicePixelRatio = m_devicePixelRatio;
+        m_pendingDamage += damageRect;
+
+        // A frame that was never swapped in is dropped in favor of the new
+        // one. Only then does viz have to wait for the client to catch up.
+        const bool dropped = m_pendingIndex != -1;
+        m_pendingIndex = m_backIndex;
+        m_backIndex = -1;
+        if (dropped) {
+            m_taskRunner = base::ThreadTaskRunnerHandle::Get();
+            m_swapCompletionCallback = std::move(swap_ack_callback);
+        } else {
+            base::ThreadTaskRunnerHandle::Get()->PostTask(
+                    FROM_HERE, base::BindOnce(std::move(swap_ack_callback), viewport_pixel_size_));
+        }
     }
+
+    if (auto obs = observer())
+        obs->readyToSwap();
 }
 
 void DisplaySoftwareOutputSurface::Device::swapFrame()
 {
     QMutexLocker locker(&m_mutex);
 
-    if (!m_swapCompletionCallback)
+    m_damage = QRegion();
+    if (m_pendingIndex == -1)
         return;
 
-    SkPixmap skPixmap;
-    surface_->peekPixels(&skPixmap);
-    QImage image(reinterpret_cast<const uchar *>(skPixmap.addr()), viewport_pixel_size_.width(),
-                 viewport_pixel_size_.height(), skPixmap.rowBytes(),
-                 imageFormat(skPixmap.colorType()));
-    if (m_image.size() == image.size()) {
-        QRect damageRect = toQt(damage_rect_);
-        QPainter painter(&m_image);
-        painter.setCompositionMode(QPainter::CompositionMode_Source);
-        painter.drawImage(damageRect, image, damageRect);
-    } else {
-        m_image = image;
-        m_image.detach();
+    const QSize oldSize = m_frontIndex != -1 ? m_buffers[m_frontIndex].image.size() : QSize();
+    m_frontIndex = m_pendingIndex;
+    m_pendingIndex = -1;
+
+    const QImage &image = m_buffers[m_frontIndex].image;
+    if (image.size() == oldSize)
+        m_damage = m_pendingDamage & image.rect();
+    else
+        m_damage = image.rect();
+    m_pendingDamage = QRegion();
+
+    if (m_swapCompletionCallback) {
+        m_taskRunner->PostTask(
+                FROM_HERE, base::BindOnce(std::move(m_swapCompletionCallback), toGfx(image.size())));
+        m_taskRunner.reset();
     }
-    m_imageDevicePixelRatio = m_devicePixelRatio;
-    m_taskRunner->PostTask(
-            FROM_HERE, base::BindOnce(std::move(m_swapCompletionCallback), toGfx(m_image.size())));
-    m_taskRunner.reset();
 }
 
 QImage DisplaySoftwareOutputSurface::Device::image()
 {
-    return m_image;
+    if (m_frontIndex == -1)
+        return QImage();
+    return m_buffers[m_frontIndex].image;
+}
+
+QRegion DisplaySoftwareOutputSurface::Device::damage()
+{
+    return m_damage;
 }
 
 float DisplaySoftwareOutputSurface::Device::devicePixelRatio()
 {
-    return m_imageDevicePixelRatio;
+    if (m_frontIndex == -1)
+        return m_devicePixelRatio;
+    return m_buffers[m_frontIndex].devicePixelRatio;
 }
 
 QSize DisplaySoftwareOutputSurface::Device::size()
 {
-    return m_image.size();
+    return image().size();
 }
 
 bool DisplaySoftwareOutputSurface::Device::hasAlphaChannel()
 {
-    return m_image.format() == QImage::Format_ARGB32_Premultiplied;
+    return image().format() == QImage::Format_ARGB32_Premultiplied;
 }
 
 DisplaySoftwareOutputSurface::DisplaySoftwareOutputSurface()
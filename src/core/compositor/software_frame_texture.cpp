@@ -0,0 +1,190 @@
+/****************************************************************************
+**
+** Copyright (C) 2021 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtWebEngine module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "software_frame_texture.h"
+
+#include <QtCore/qloggingcategory.h>
+#include <QtGui/private/qrhi_p.h>
+
+#include <cstring>
+
+namespace QtWebEngineCore {
+
+Q_LOGGING_CATEGORY(lcSoftwareFrameTexture, "qt.webengine.compositor")
+
+// Upload the bounding rect instead if the damage is too fragmented.
+static const int MaxDirtyRects = 16;
+
+SoftwareFrameTexture::~SoftwareFrameTexture()
+{
+    delete m_texture;
+}
+
+void SoftwareFrameTexture::setImage(const QImage &image, const QRegion &damage)
+{
+    if (image.size() != m_size || image.format() != m_format) {
+        m_size = image.size();
+        m_format = image.format();
+        m_dirty = QRect(QPoint(), m_size);
+    } else {
+        m_dirty += damage;
+    }
+    m_image = image;
+    m_uploadedBytes = 0;
+}
+
+qint64 SoftwareFrameTexture::comparisonKey() const
+{
+    if (m_texture)
+        return qint64(qintptr(m_texture));
+    return qint64(qintptr(this));
+}
+
+QRhiTexture *SoftwareFrameTexture::rhiTexture() const
+{
+    return m_texture;
+}
+
+QSize SoftwareFrameTexture::textureSize() const
+{
+    return m_size;
+}
+
+bool SoftwareFrameTexture::hasAlphaChannel() const
+{
+    return m_format == QImage::Format_ARGB32_Premultiplied
+            || m_format == QImage::Format_RGBA8888_Premultiplied;
+}
+
+bool SoftwareFrameTexture::hasMipmaps() const
+{
+    return false;
+}
+
+void SoftwareFrameTexture::commitTextureOperations(QRhi *rhi, QRhiResourceUpdateBatch *resourceUpdates)
+{
+    if (m_image.isNull())
+        return;
+
+    // QImage::Format_ARGB32_Premultiplied is BGRA in memory, which not
+    // every backend can sample from directly.
+    QRhiTexture::Format format = QRhiTexture::RGBA8;
+    bool convertToRgba = false;
+    if (m_format == QImage::Format_ARGB32_Premultiplied) {
+        if (rhi->isTextureFormatSupported(QRhiTexture::BGRA8))
+            format = QRhiTexture::BGRA8;
+        else
+            convertToRgba = true;
+    }
+
+    if (!m_texture || m_texture->pixelSize() != m_size || m_texture->format() != format) {
+        delete m_texture;
+        m_texture = rhi->newTexture(format, m_size);
+        if (!m_texture->create()) {
+            qWarning("Failed to create texture for software compositor frame");
+            delete m_texture;
+            m_texture = nullptr;
+            m_image = QImage();
+            return;
+        }
+        m_dirty = QRect(QPoint(), m_size);
+    }
+
+    QRegion dirty = m_dirty & QRect(QPoint(), m_size);
+    if (dirty.rectCount() > MaxDirtyRects)
+        dirty = dirty.boundingRect();
+
+    const int bytesPerPixel = m_image.depth() / 8;
+    for (const QRect &rect : dirty) {
+        QRhiTextureSubresourceUploadDescription desc;
+        if (convertToRgba) {
+            desc.setImage(m_image.copy(rect).convertToFormat(QImage::Format_RGBA8888_Premultiplied));
+        } else {
+            desc.setImage(m_image);
+            desc.setSourceTopLeft(rect.topLeft());
+            desc.setSourceSize(rect.size());
+        }
+        desc.setDestinationTopLeft(rect.topLeft());
+        resourceUpdates->uploadTexture(m_texture, QRhiTextureUploadEntry(0, 0, desc));
+        m_uploadedBytes += qint64(rect.width()) * rect.height() * bytesPerPixel;
+    }
+
+    qCDebug(lcSoftwareFrameTexture, "Uploaded %lld of %lld bytes in %d rects", m_uploadedBytes,
+            qint64(m_size.width()) * m_size.height() * bytesPerPixel, dirty.rectCount());
+    if (m_uploadCounter)
+        *m_uploadCounter += m_uploadedBytes;
+
+    // Drop the reference so that the next swap does not detach the
+    // compositor's image.
+    m_image = QImage();
+    m_dirty = QRegion();
+}
+
+void SoftwareFrameImageTexture::setFrame(const QImage &image, const QRegion &damage)
+{
+    // Only a frame that is not shared can be written to without a copy.
+    QImage frame = QSGPlainTexture::image();
+    QSGPlainTexture::setImage(QImage());
+
+    if (frame.size() != image.size() || frame.format() != image.format()) {
+        frame = image.copy();
+        m_uploadedBytes = frame.sizeInBytes();
+    } else {
+        m_uploadedBytes = 0;
+        const int bytesPerPixel = frame.depth() / 8;
+        const qsizetype bytesPerLine = frame.bytesPerLine();
+        uchar *bits = frame.bits();
+        const uchar *sourceBits = image.constBits();
+        const qsizetype sourceBytesPerLine = image.bytesPerLine();
+        for (const QRect &rect : damage & frame.rect()) {
+            const qsizetype offset = qsizetype(rect.left()) * bytesPerPixel;
+            const qsizetype length = qsizetype(rect.width()) * bytesPerPixel;
+            for (int y = rect.top(); y <= rect.bottom(); ++y)
+                memcpy(bits + y * bytesPerLine + offset, sourceBits + y * sourceBytesPerLine + offset, length);
+            m_uploadedBytes += length * rect.height();
+        }
+    }
+
+    qCDebug(lcSoftwareFrameTexture, "Copied %lld of %lld bytes", m_uploadedBytes, qint64(frame.sizeInBytes()));
+    if (m_uploadCounter)
+        *m_uploadCounter += m_uploadedBytes;
+    QSGPlainTexture::setImage(frame);
+}
+
+} // namespace QtWebEngineCore
@@ -0,0 +1,126 @@
+/****************************************************************************
+**
+** Copyright (C) 2021 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtWebEngine module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef SOFTWARE_FRAME_TEXTURE_H
+#define SOFTWARE_FRAME_TEXTURE_H
+
+#include <QtWebEngineCore/private/qtwebenginecoreglobal_p.h>
+
+#include <QtGui/qimage.h>
+#include <QtGui/qregion.h>
+#include <QtQuick/qsgtexture.h>
+#include <QtQuick/private/qsgplaintexture_p.h>
+
+#include <atomic>
+#include <memory>
+
+namespace QtWebEngineCore {
+
+// Adds up the bytes uploaded by the textures below. Shared, as the textures
+// are deleted by the scene graph, possibly after whoever reads the count.
+using UploadCounter = std::shared_ptr<std::atomic<qint64>>;
+
+// Persistent scene graph texture for software compositor frames.
+//
+// Used by quick/widgets delegates in place of createTextureFromImage()
+// so that the texture survives across frames and only the damaged
+// parts of each new frame are uploaded.
+class Q_WEBENGINECORE_PRIVATE_EXPORT SoftwareFrameTexture final : public QSGTexture
+{
+    Q_OBJECT
+public:
+    SoftwareFrameTexture() = default;
+    ~SoftwareFrameTexture() override;
+
+    // Schedules the damaged region of image for upload.
+    //
+    // Everything is uploaded if the size or format of the image changed
+    // since the previous frame. The image reference is dropped again
+    // once the upload has been recorded, see Compositor::image().
+    void setImage(const QImage &image, const QRegion &damage);
+
+    // Number of bytes uploaded for the most recent frame.
+    qint64 uploadedBytes() const { return m_uploadedBytes; }
+    void setUploadCounter(UploadCounter counter) { m_uploadCounter = std::move(counter); }
+
+    // Overridden from QSGTexture.
+    qint64 comparisonKey() const override;
+    QRhiTexture *rhiTexture() const override;
+    QSize textureSize() const override;
+    bool hasAlphaChannel() const override;
+    bool hasMipmaps() const override;
+    void commitTextureOperations(QRhi *rhi, QRhiResourceUpdateBatch *resourceUpdates) override;
+
+private:
+    QImage m_image;
+    QRegion m_dirty;
+    QSize m_size;
+    QImage::Format m_format = QImage::Format_Invalid;
+    QRhiTexture *m_texture = nullptr;
+    qint64 m_uploadedBytes = 0;
+    UploadCounter m_uploadCounter;
+};
+
+// The same for the software scene graph, which paints the image of a
+// QSGPlainTexture as it is. The texture keeps a copy of the frame of its
+// own, and only the damaged parts of each new frame are copied into it.
+class Q_WEBENGINECORE_PRIVATE_EXPORT SoftwareFrameImageTexture final : public QSGPlainTexture
+{
+    Q_OBJECT
+public:
+    SoftwareFrameImageTexture() = default;
+
+    // Copies the damaged region of image into the frame.
+    //
+    // Everything is copied if the size or format of the image changed
+    // since the previous frame. No reference to image is kept.
+    void setFrame(const QImage &image, const QRegion &damage);
+
+    // Number of bytes copied for the most recent frame.
+    qint64 uploadedBytes() const { return m_uploadedBytes; }
+    void setUploadCounter(UploadCounter counter) { m_uploadCounter = std::move(counter); }
+
+private:
+    qint64 m_uploadedBytes = 0;
+    UploadCounter m_uploadCounter;
+};
+
+} // namespace QtWebEngineCore
+
+#endif // !SOFTWARE_FRAME_TEXTURE_H
@@ -629,7 +629,7 @@ ContentBrowserClientQt::AllowServiceWorker(const GURL &scope,
         return content::AllowServiceWorkerResult::No();
     // FIXME: Chrome also checks if javascript is enabled here to check if has been disabled since the service worker
     // was started.
-    return static_cast<ProfileQt *>(context)->profileAdapter()->cookieStore()->d_func()->canAccessCookies(toQt(site_for_cookies.first_party_url()), toQt(scope))
+    return static_cast<ProfileQt *>(context)->profileAdapter()->cookieStore()->d_func()->canAccessCookies(site_for_cookies.first_party_url(), scope)
          ? content::AllowServiceWorkerResult::Yes()
          : content::AllowServiceWorkerResult::No();
 }
@@ -644,7 +644,7 @@ void ContentBrowserClientQt::AllowWorkerFileSystem(const GURL &url,
     if (!context || context->ShutdownStarted())
         return std::move(callback).Run(false);
     std::move(callback).Run(
-            static_cast<ProfileQt *>(context)->profileAdapter()->cookieStore()->d_func()->canAccessCookies(toQt(url), toQt(url)));
+            static_cast<ProfileQt *>(context)->profileAdapter()->cookieStore()->d_func()->canAccessCookies(url, url));
 }
 
 
@@ -655,7 +655,7 @@ bool ContentBrowserClientQt::AllowWorkerIndexedDB(const GURL &url,
     DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
     if (!context || context->ShutdownStarted())
         return false;
-    return static_cast<ProfileQt *>(context)->profileAdapter()->cookieStore()->d_func()->canAccessCookies(toQt(url), toQt(url));
+    return static_cast<ProfileQt *>(context)->profileAdapter()->cookieStore()->d_func()->canAccessCookies(url, url);
 }
 
 static void LaunchURL(const GURL& url,
@@ -1038,7 +1038,7 @@ void ContentBrowserClientQt::RegisterNonNetworkNavigationURLLoaderFactories(int
     ProfileAdapter *profileAdapter = static_cast<ProfileQt *>(profile)->profileAdapter();
 
     for (const QByteArray &scheme : profileAdapter->customUrlSchemes())
-        factories->emplace(scheme.toStdString(), CreateCustomURLLoaderFactory(profileAdapter));
+        factories->emplace(scheme.toStdString(), CreateCustomURLLoaderFactory(profileAdapter, scheme));
 
 #if BUILDFLAG(ENABLE_EXTENSIONS)
     factories->emplace(
@@ -1055,7 +1055,7 @@ void ContentBrowserClientQt::RegisterNonNetworkWorkerMainResourceURLLoaderFactor
     ProfileAdapter *profileAdapter = static_cast<ProfileQt *>(profile)->profileAdapter();
 
     for (const QByteArray &scheme : profileAdapter->customUrlSchemes())
-        factories->emplace(scheme.toStdString(), CreateCustomURLLoaderFactory(profileAdapter));
+        factories->emplace(scheme.toStdString(), CreateCustomURLLoaderFactory(profileAdapter, scheme));
 
 #if BUILDFLAG(ENABLE_EXTENSIONS)
     factories->emplace(
@@ -1073,7 +1073,7 @@ void ContentBrowserClientQt::RegisterNonNetworkServiceWorkerUpdateURLLoaderFacto
     for (const QByteArray &scheme : profileAdapter->customUrlSchemes()) {
         if (const url::CustomScheme *cs = url::CustomScheme::FindScheme(scheme.toStdString())) {
             if (cs->flags & url::CustomScheme::ServiceWorkersAllowed)
-                factories->emplace(scheme.toStdString(), CreateCustomURLLoaderFactory(profileAdapter));
+                factories->emplace(scheme.toStdString(), CreateCustomURLLoaderFactory(profileAdapter, scheme));
         }
     }
 
@@ -1092,7 +1092,7 @@ void ContentBrowserClientQt::RegisterNonNetworkSubresourceURLLoaderFactories(int
     ProfileAdapter *profileAdapter = static_cast<ProfileQt *>(profile)->profileAdapter();
 
     for (const QByteArray &scheme : profileAdapter->customUrlSchemes())
-        factories->emplace(scheme.toStdString(), CreateCustomURLLoaderFactory(profileAdapter));
+        factories->emplace(scheme.toStdString(), CreateCustomURLLoaderFactory(profileAdapter, scheme));
 
     content::RenderFrameHost *frame_host = content::RenderFrameHost::FromID(render_process_id, render_frame_id);
     content::WebContents *web_contents = content::WebContents::FromRenderFrameHost(frame_host);
@@ -40,6 +40,7 @@
 #include "download_manager_delegate_qt.h"
 
 #include "base/files/file_util.h"
+#include "base/threading/thread_task_runner_handle.h"
 #include "base/time/time_to_iso8601.h"
 #include "content/public/browser/download_item_utils.h"
 #include "content/public/browser/download_manager.h"
@@ -122,6 +123,11 @@ void DownloadManagerDelegateQt::removeDownload(quint32 downloadId)
         download->Remove();
 }
 
+void DownloadManagerDelegateQt::setProgressUpdateInterval(quint32 downloadId, int msec)
+{
+    m_updateStates[downloadId].progressUpdateInterval = msec;
+}
+
 bool DownloadManagerDelegateQt::DetermineDownloadTarget(download::DownloadItem *item,
                                                         content::DownloadTargetCallback *callback)
 {
@@ -326,8 +332,63 @@ void DownloadManagerDelegateQt::savePackageDownloadCreated(download::DownloadIte
     item->AddObserver(this);
 }
 
+bool DownloadManagerDelegateQt::UpdateState::sameExceptProgress(download::DownloadItem *download) const
+{
+    return sent
+            && url == download->GetURL()
+            && state == download->GetState()
+            && mimeType == download->GetMimeType()
+            && targetPath == download->GetTargetFilePath()
+            && paused == download->IsPaused()
+            && done == download->IsDone()
+            && interruptReason == download->GetLastReason()
+            && webContents == content::DownloadItemUtils::GetWebContents(download)
+            && suggestedFileName == download->GetSuggestedFilename()
+            && startTime == download->GetStartTime();
+}
+
+void DownloadManagerDelegateQt::UpdateState::record(download::DownloadItem *download)
+{
+    sent = true;
+    url = download->GetURL();
+    state = download->GetState();
+    mimeType = download->GetMimeType();
+    targetPath = download->GetTargetFilePath();
+    paused = download->IsPaused();
+    done = download->IsDone();
+    interruptReason = download->GetLastReason();
+    webContents = content::DownloadItemUtils::GetWebContents(download);
+    suggestedFileName = download->GetSuggestedFilename();
+    startTime = download->GetStartTime();
+    receivedBytes = download->GetReceivedBytes();
+    totalBytes = download->GetTotalBytes();
+    lastUpdate = base::TimeTicks::Now();
+}
+
 void DownloadManagerDelegateQt::OnDownloadUpdated(download::DownloadItem *download)
 {
+    UpdateState &update = m_updateStates[download->GetId()];
+    if (update.sameExceptProgress(download)) {
+        if (update.receivedBytes == download->GetReceivedBytes() && update.totalBytes == download->GetTotalBytes())
+            return;
+        if (update.progressUpdateInterval > 0) {
+            const base::TimeDelta wait = update.lastUpdate + base::Milliseconds(update.progressUpdateInterval)
+                    - base::TimeTicks::Now();
+            if (wait.is_positive()) {
+                if (!update.delayedUpdatePending) {
+                    update.delayedUpdatePending = true;
+                    base::ThreadTaskRunnerHandle::Get()->PostDelayedTask(
+                            FROM_HERE,
+                            base::BindOnce(&DownloadManagerDelegateQt::sendDelayedUpdate,
+                                           m_weakPtrFactory.GetWeakPtr(), download->GetId()),
+                            wait);
+                }
+                return;
+            }
+        }
+    }
+    update.record(download);
+
     QList<ProfileAdapterClient*> clients = m_profileAdapter->clients();
     if (!clients.isEmpty()) {
         WebContentsAdapterClient *adapterClient = nullptr;
@@ -360,8 +421,19 @@ void DownloadManagerDelegateQt::OnDownloadUpdated(download::DownloadItem *downlo
     }
 }
 
+void DownloadManagerDelegateQt::sendDelayedUpdate(quint32 downloadId)
+{
+    auto it = m_updateStates.find(downloadId);
+    if (it == m_updateStates.end())
+        return;
+    it->second.delayedUpdatePending = false;
+    if (download::DownloadItem *download = findDownloadById(downloadId))
+        OnDownloadUpdated(download);
+}
+
 void DownloadManagerDelegateQt::OnDownloadDestroyed(download::DownloadItem *download)
 {
+    m_updateStates.erase(download->GetId());
     download->RemoveObserver(this);
     download->Cancel(/* user_cancel */ false);
 }
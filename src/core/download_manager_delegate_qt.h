@@ -42,9 +42,13 @@
 
 #include "content/public/browser/download_manager_delegate.h"
 #include <base/memory/weak_ptr.h>
+#include <base/time/time.h>
+#include "url/gurl.h"
 
 #include <QtGlobal>
 
+#include <map>
+
 namespace base {
 class FilePath;
 }
@@ -88,6 +92,7 @@ public:
     void pauseDownload(quint32 downloadId);
     void resumeDownload(quint32 downloadId);
     void removeDownload(quint32 downloadId);
+    void setProgressUpdateInterval(quint32 downloadId, int msec);
 
     // Inherited from content::DownloadItem::Observer
     void OnDownloadUpdated(download::DownloadItem *download) override;
@@ -97,7 +102,36 @@ private:
     void cancelDownload(content::DownloadTargetCallback callback);
     download::DownloadItem *findDownloadById(quint32 downloadId);
     void savePackageDownloadCreated(download::DownloadItem *download);
+    void sendDelayedUpdate(quint32 downloadId);
+
+    // What the clients were last told about a download, so that updates
+    // changing nothing they see are dropped, and progress can be throttled.
+    // Covers everything ProfileAdapterClient::DownloadItemInfo carries.
+    struct UpdateState
+    {
+        bool sameExceptProgress(download::DownloadItem *download) const;
+        void record(download::DownloadItem *download);
+
+        bool sent = false;
+        GURL url;
+        int state = 0;
+        std::string mimeType;
+        base::FilePath targetPath;
+        bool paused = false;
+        bool done = false;
+        int interruptReason = 0;
+        content::WebContents *webContents = nullptr;
+        std::string suggestedFileName;
+        base::Time startTime;
+        int64_t receivedBytes = 0;
+        int64_t totalBytes = 0;
+        int progressUpdateInterval = 0;
+        base::TimeTicks lastUpdate;
+        bool delayedUpdatePending = false;
+    };
+
     ProfileAdapter *m_profileAdapter;
+    std::map<quint32, UpdateState> m_updateStates;
 
     uint32_t m_currentId;
     base::WeakPtrFactory<DownloadManagerDelegateQt> m_weakPtrFactory;
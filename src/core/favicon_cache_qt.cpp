@@ -0,0 +1,107 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtWebEngine module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "favicon_cache_qt.h"
+
+namespace QtWebEngineCore {
+
+namespace {
+// Enough for a few hundred 32x32 icons at both 1x and 2x.
+constexpr int defaultMaxSize = 8 * 1024 * 1024;
+
+qsizetype iconCost(const QIcon &icon)
+{
+    qsizetype cost = 0;
+    for (const QSize &size : icon.availableSizes())
+        cost += qsizetype(size.width()) * size.height() * 4;
+    return qMax(cost, qsizetype(1));
+}
+} // namespace
+
+FaviconCacheQt::FaviconCacheQt()
+    : m_icons(defaultMaxSize)
+{
+}
+
+QIcon FaviconCacheQt::find(const QUrl &iconUrl, int pixelSize)
+{
+    if (iconUrl.isEmpty())
+        return QIcon();
+    if (const QIcon *icon = m_icons.object(Key(iconUrl, pixelSize))) {
+        ++m_hitCount;
+        return *icon;
+    }
+    ++m_missCount;
+    return QIcon();
+}
+
+QIcon FaviconCacheQt::peek(const QUrl &iconUrl, int pixelSize) const
+{
+    if (const QIcon *icon = m_icons.object(Key(iconUrl, pixelSize)))
+        return *icon;
+    return QIcon();
+}
+
+void FaviconCacheQt::insert(const QUrl &iconUrl, int pixelSize, const QIcon &icon)
+{
+    if (iconUrl.isEmpty() || icon.isNull())
+        return;
+    m_icons.insert(Key(iconUrl, pixelSize), new QIcon(icon), iconCost(icon));
+}
+
+void FaviconCacheQt::remove(const QUrl &iconUrl)
+{
+    const QList<Key> keys = m_icons.keys();
+    for (const Key &key : keys) {
+        if (key.first == iconUrl)
+            m_icons.remove(key);
+    }
+}
+
+void FaviconCacheQt::clear()
+{
+    m_icons.clear();
+}
+
+void FaviconCacheQt::setMaxSize(int maxSize)
+{
+    m_icons.setMaxCost(maxSize > 0 ? maxSize : defaultMaxSize);
+}
+
+} // namespace QtWebEngineCore
@@ -0,0 +1,95 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtWebEngine module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#ifndef FAVICON_CACHE_QT_H
+#define FAVICON_CACHE_QT_H
+
+#include <QtWebEngineCore/private/qtwebenginecoreglobal_p.h>
+
+#include <QtCore/qcache.h>
+#include <QtCore/qpair.h>
+#include <QtCore/qurl.h>
+#include <QtGui/qicon.h>
+
+namespace QtWebEngineCore {
+
+// Keeps the icons handed out by a profile, so that pages and icon requests
+// sharing an icon URL reuse one implicitly shared QIcon instead of decoding
+// and converting the same bitmaps again. Only used on the UI thread.
+class FaviconCacheQt
+{
+public:
+    FaviconCacheQt();
+
+    // Returns a null icon on a miss. Unlike find(), peek() is not counted
+    // in the hit and miss statistics.
+    QIcon find(const QUrl &iconUrl, int pixelSize);
+    QIcon peek(const QUrl &iconUrl, int pixelSize) const;
+    void insert(const QUrl &iconUrl, int pixelSize, const QIcon &icon);
+    void remove(const QUrl &iconUrl);
+    void clear();
+
+    int maxSize() const { return int(m_icons.maxCost()); }
+    void setMaxSize(int maxSize);
+
+    qint64 hitCount() const { return m_hitCount; }
+    qint64 missCount() const { return m_missCount; }
+
+private:
+    typedef QPair<QUrl, int> Key;
+
+    QCache<Key, QIcon> m_icons;
+    qint64 m_hitCount = 0;
+    qint64 m_missCount = 0;
+};
+
+} // namespace QtWebEngineCore
+
+#endif // FAVICON_CACHE_QT_H
@@ -38,6 +38,8 @@
 ****************************************************************************/
 
 #include "favicon_driver_qt.h"
+#include "favicon_cache_qt.h"
+#include "profile_adapter.h"
 #include "type_conversion.h"
 #include "web_contents_adapter_client.h"
 #include "web_engine_settings.h"
@@ -180,6 +182,7 @@ int FaviconDriverQt::DownloadImage(const GURL &url, int max_image_size,
 {
     bool bypass_cache = (m_bypassCachePageURL == GetActiveURL());
     m_bypassCachePageURL = GURL();
+    m_downloadedIconUrls.insert(url);
 
     return web_contents()->DownloadImage(url, true, /*preferred_size=*/ {max_image_size, max_image_size},
                                          /*max_bitmap_size=*/max_image_size, bypass_cache,
@@ -204,6 +207,10 @@ void FaviconDriverQt::OnFaviconUpdated(
 {
     Q_UNUSED(page_url);
 
+    // Sites can change the image behind an icon URL, do not keep handing out the old one.
+    if (m_downloadedIconUrls.erase(icon_url) && !image.IsEmpty())
+        m_viewClient->profileAdapter()->faviconCache()->remove(toQt(icon_url));
+
     QWebEngineSettings *settings = m_viewClient->webEngineSettings();
     bool touchIconsEnabled = settings->testAttribute(QWebEngineSettings::TouchIconsEnabled);
 
@@ -299,7 +306,9 @@ void FaviconDriverQt::DidStartNavigation(content::NavigationHandle *navigation_h
     if (!navigation_handle->IsInMainFrame())
         return;
 
+    const GURL previousIconUrl = m_latestFavicon.url;
     m_faviconUrls.reset();
+    m_downloadedIconUrls.clear();
     m_completedHandlersCount = 0;
     m_latestFavicon = FaviconStatusQt();
 
@@ -311,6 +320,10 @@ void FaviconDriverQt::DidStartNavigation(content::NavigationHandle *navigation_h
     m_viewClient->iconChanged(QUrl());
 
     content::ReloadType reload_type = navigation_handle->GetReloadType();
+    // The icon is going to be downloaded again, do not keep handing out the old one.
+    if (reload_type == content::ReloadType::BYPASSING_CACHE && previousIconUrl.is_valid())
+        m_viewClient->profileAdapter()->faviconCache()->remove(toQt(previousIconUrl));
+
     if (reload_type == content::ReloadType::NONE || IsOffTheRecord())
         return;
 
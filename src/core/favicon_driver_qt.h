@@ -53,6 +53,7 @@
 
 #include "qtwebenginecoreglobal_p.h"
 
+#include "base/containers/flat_set.h"
 #include "components/favicon/core/favicon_driver.h"
 #include "components/favicon/core/favicon_handler.h"
 #include "content/public/browser/favicon_status.h"
@@ -150,6 +151,9 @@ private:
 
     GURL m_bypassCachePageURL;
     bool m_documentOnLoadCompleted = false;
+    // Icons downloaded for the current page, rather than read from the
+    // database, which may differ from the ones in the profile's icon cache.
+    base::flat_set<GURL> m_downloadedIconUrls;
 
     // nullopt until the actual list is reported via DidUpdateFaviconURL().
     absl::optional<std::vector<blink::mojom::FaviconURLPtr>> m_faviconUrls;
@@ -42,6 +42,8 @@
 #include "base/bind.h"
 #include "base/memory/ptr_util.h"
 #include "base/task/post_task.h"
+#include "components/content_settings/core/common/content_settings.h"
+#include "components/content_settings/core/common/content_settings_pattern.h"
 #include "content/public/browser/browser_task_traits.h"
 #include "content/public/browser/browser_thread.h"
 #include "net/cookies/cookie_util.h"
@@ -49,8 +51,11 @@
 
 #include "api/qwebenginecookiestore.h"
 #include "api/qwebenginecookiestore_p.h"
+#include "net/cookie_rule_set.h"
 #include "type_conversion.h"
 
+#include <QDateTime>
+
 namespace QtWebEngineCore {
 
 class CookieChangeListener : public network::mojom::CookieChangeListener
@@ -77,7 +82,7 @@ public:
 
     void AllowedAccess(const GURL &url, const net::SiteForCookies &site_for_cookies, AllowedAccessCallback callback) override
     {
-        bool allow = m_delegate->canGetCookies(toQt(site_for_cookies.first_party_url()), toQt(url));
+        bool allow = m_delegate->canGetCookies(site_for_cookies.first_party_url(), url);
         std::move(callback).Run(allow);
     }
 
@@ -92,6 +97,32 @@ static GURL sourceUrlForCookie(const QNetworkCookie &cookie)
     return net::cookie_util::CookieOriginToURL(urlFragment.toStdString(), /* is_https */ cookie.isSecure());
 }
 
+static std::unique_ptr<net::CanonicalCookie> canonicalCookie(const QNetworkCookie &cookie, const QUrl &origin,
+                                                             const base::Time &now, GURL *gurl)
+{
+    *gurl = origin.isEmpty() ? sourceUrlForCookie(cookie) : toGurl(origin);
+    std::string cookie_line = cookie.toRawForm().toStdString();
+
+    net::CookieInclusionStatus inclusion;
+    auto canonCookie = net::CanonicalCookie::Create(*gurl, cookie_line, now, absl::nullopt, absl::nullopt, &inclusion);
+    if (!inclusion.IsInclude())
+        return nullptr;
+    return canonCookie;
+}
+
+static net::CookieOptions userCookieOptions()
+{
+    net::CookieOptions options;
+    options.set_include_httponly();
+    options.set_same_site_cookie_context(net::CookieOptions::SameSiteCookieContext::MakeInclusiveForSet());
+    return options;
+}
+
+static GURL originUrlForCookie(const net::CanonicalCookie &cookie)
+{
+    return net::cookie_util::CookieOriginToURL(cookie.Domain(), cookie.IsSecure());
+}
+
 CookieMonsterDelegateQt::CookieMonsterDelegateQt()
     : m_client(nullptr)
     , m_listener(new CookieChangeListener(this))
@@ -126,24 +157,64 @@ void CookieMonsterDelegateQt::getAllCookies()
     m_mojoCookieManager->GetAllCookies(net::CookieStore::GetAllCookiesCallback());
 }
 
+void CookieMonsterDelegateQt::getAllCookies(std::function<void(const QList<QNetworkCookie> &)> &&callback)
+{
+    Q_ASSERT(hasCookieMonster());
+
+    m_mojoCookieManager->GetAllCookies(base::BindOnce(&CookieMonsterDelegateQt::allCookiesLoaded,
+                                                      scoped_refptr<CookieMonsterDelegateQt>(this),
+                                                      std::move(callback)));
+}
+
+void CookieMonsterDelegateQt::allCookiesLoaded(std::function<void(const QList<QNetworkCookie> &)> callback,
+                                               const net::CookieList &cookies)
+{
+    // the cookie store is gone, and most likely whatever the callback refers to
+    if (!m_client)
+        return;
+
+    QList<QNetworkCookie> result;
+    result.reserve(cookies.size());
+    for (const net::CanonicalCookie &cookie : cookies)
+        result.append(toQt(cookie));
+    callback(result);
+}
+
 void CookieMonsterDelegateQt::setCookie(const QNetworkCookie &cookie, const QUrl &origin)
 {
     Q_ASSERT(hasCookieMonster());
     Q_ASSERT(m_client);
 
-    GURL gurl = origin.isEmpty() ? sourceUrlForCookie(cookie) : toGurl(origin);
-    std::string cookie_line = cookie.toRawForm().toStdString();
-
-    net::CookieInclusionStatus inclusion;
-    auto canonCookie = net::CanonicalCookie::Create(gurl, cookie_line, base::Time::Now(), absl::nullopt, absl::nullopt, &inclusion);
-    if (!inclusion.IsInclude()) {
+    GURL gurl;
+    auto canonCookie = canonicalCookie(cookie, origin, base::Time::Now(), &gurl);
+    if (!canonCookie) {
         LOG(WARNING) << "QWebEngineCookieStore::setCookie() - Tried to set invalid cookie";
         return;
     }
-    net::CookieOptions options;
-    options.set_include_httponly();
-    options.set_same_site_cookie_context(net::CookieOptions::SameSiteCookieContext::MakeInclusiveForSet());
-    m_mojoCookieManager->SetCanonicalCookie(*canonCookie.get(), gurl, options, net::CookieStore::SetCookiesCallback());
+    m_mojoCookieManager->SetCanonicalCookie(*canonCookie.get(), gurl, userCookieOptions(), net::CookieStore::SetCookiesCallback());
+}
+
+void CookieMonsterDelegateQt::setCookies(const QList<QNetworkCookie> &cookies, const QUrl &origin)
+{
+    Q_ASSERT(hasCookieMonster());
+    Q_ASSERT(m_client);
+
+    // The cookie manager interface has no batch setter, so this still costs one
+    // SetCanonicalCookie() call per cookie.
+    const base::Time now = base::Time::Now();
+    const net::CookieOptions options = userCookieOptions();
+    int invalid = 0;
+    for (const QNetworkCookie &cookie : cookies) {
+        GURL gurl;
+        auto canonCookie = canonicalCookie(cookie, origin, now, &gurl);
+        if (!canonCookie) {
+            ++invalid;
+            continue;
+        }
+        m_mojoCookieManager->SetCanonicalCookie(*canonCookie.get(), gurl, options, net::CookieStore::SetCookiesCallback());
+    }
+    if (invalid)
+        LOG(WARNING) << "QWebEngineCookieStore::setCookies() - Skipped " << invalid << " invalid cookies";
 }
 
 void CookieMonsterDelegateQt::deleteCookie(const QNetworkCookie &cookie, const QUrl &origin)
@@ -178,6 +249,53 @@ void CookieMonsterDelegateQt::deleteAllCookies()
     m_mojoCookieManager->DeleteCookies(std::move(filter), network::mojom::CookieManager::DeleteCookiesCallback());
 }
 
+// Cookies of session-only sites left over from the last session.
+void CookieMonsterDelegateQt::deleteSessionOnlyCookies(std::shared_ptr<const CookieRuleSet> rules)
+{
+    Q_ASSERT(hasCookieMonster());
+
+    m_mojoCookieManager->GetAllCookies(base::BindOnce(&CookieMonsterDelegateQt::sessionOnlyCookiesLoaded,
+                                                      scoped_refptr<CookieMonsterDelegateQt>(this),
+                                                      std::move(rules)));
+}
+
+void CookieMonsterDelegateQt::sessionOnlyCookiesLoaded(std::shared_ptr<const CookieRuleSet> rules,
+                                                       const net::CookieList &cookies)
+{
+    if (!hasCookieMonster())
+        return;
+
+    for (const net::CanonicalCookie &cookie : cookies) {
+        if (rules->isSessionOnly(originUrlForCookie(cookie)))
+            m_mojoCookieManager->DeleteCanonicalCookie(cookie, network::mojom::CookieManager::DeleteCanonicalCookieCallback());
+    }
+}
+
+// The network service deletes the cookies of session-only sites from the
+// persistent store when it shuts down.
+void CookieMonsterDelegateQt::setSessionOnlyRules(const CookieRuleSet *rules)
+{
+    Q_ASSERT(hasCookieMonster());
+
+    ContentSettingsForOneType settings;
+    if (rules && rules->hasSessionOnlyRules()) {
+        for (const auto &domain : rules->sessionOnlyDomains()) {
+            ContentSettingsPattern pattern = domain.first.empty()
+                    ? ContentSettingsPattern::Wildcard()
+                    : ContentSettingsPattern::FromString("[*.]" + domain.first);
+            if (!pattern.IsValid())
+                continue;
+            settings.emplace_back(pattern, ContentSettingsPattern::Wildcard(),
+                                  base::Value(domain.second ? CONTENT_SETTING_SESSION_ONLY : CONTENT_SETTING_ALLOW),
+                                  std::string(), false);
+        }
+    }
+    // access itself is decided by the remote filter
+    settings.emplace_back(ContentSettingsPattern::Wildcard(), ContentSettingsPattern::Wildcard(),
+                          base::Value(CONTENT_SETTING_ALLOW), std::string(), false);
+    m_mojoCookieManager->SetContentSettings(ContentSettingsType::COOKIES, std::move(settings));
+}
+
 void CookieMonsterDelegateQt::setMojoCookieManager(network::mojom::CookieManagerPtrInfo cookie_manager_info)
 {
     if (m_mojoCookieManager.is_bound())
@@ -246,6 +364,14 @@ bool CookieMonsterDelegateQt::canGetCookies(const QUrl &firstPartyUrl, const QUr
     return m_client->d_func()->canAccessCookies(firstPartyUrl, url);
 }
 
+bool CookieMonsterDelegateQt::canGetCookies(const GURL &firstPartyUrl, const GURL &url) const
+{
+    if (!m_client)
+        return true;
+
+    return m_client->d_func()->canAccessCookies(firstPartyUrl, url);
+}
+
 void CookieMonsterDelegateQt::OnCookieChanged(const net::CookieChangeInfo &change)
 {
     if (!m_client)
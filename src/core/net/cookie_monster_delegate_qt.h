@@ -69,14 +69,19 @@
 #undef StAsH_signals
 #endif
 
+#include <QList>
 #include <QNetworkCookie>
 #include <QPointer>
 
+#include <functional>
+#include <memory>
+
 QT_FORWARD_DECLARE_CLASS(QWebEngineCookieStore)
 
 namespace QtWebEngineCore {
 
 class CookieMonsterDelegateQtPrivate;
+class CookieRuleSet;
 
 class Q_WEBENGINECORE_PRIVATE_EXPORT CookieMonsterDelegateQt : public base::RefCountedThreadSafe<CookieMonsterDelegateQt>
 {
@@ -96,10 +101,14 @@ public:
     bool hasCookieMonster();
 
     void setCookie(const QNetworkCookie &cookie, const QUrl &origin);
+    void setCookies(const QList<QNetworkCookie> &cookies, const QUrl &origin);
     void deleteCookie(const QNetworkCookie &cookie, const QUrl &origin);
     void getAllCookies();
+    void getAllCookies(std::function<void(const QList<QNetworkCookie> &)> &&callback);
     void deleteSessionCookies();
     void deleteAllCookies();
+    void deleteSessionOnlyCookies(std::shared_ptr<const CookieRuleSet> rules);
+    void setSessionOnlyRules(const CookieRuleSet *rules);
 
     void setClient(QWebEngineCookieStore *client);
     void setMojoCookieManager(network::mojom::CookieManagerPtrInfo cookie_manager_info);
@@ -108,9 +117,15 @@ public:
 
     bool canSetCookie(const QUrl &firstPartyUrl, const QByteArray &cookieLine, const QUrl &url) const;
     bool canGetCookies(const QUrl &firstPartyUrl, const QUrl &url) const;
+    bool canGetCookies(const GURL &firstPartyUrl, const GURL &url) const;
 
     void AddStore(net::CookieStore *store);
     void OnCookieChanged(const net::CookieChangeInfo &change);
+
+private:
+    void allCookiesLoaded(std::function<void(const QList<QNetworkCookie> &)> callback,
+                          const net::CookieList &cookies);
+    void sessionOnlyCookiesLoaded(std::shared_ptr<const CookieRuleSet> rules, const net::CookieList &cookies);
 };
 
 }
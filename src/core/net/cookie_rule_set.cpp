@@ -0,0 +1,191 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtWebEngine module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "cookie_rule_set.h"
+
+#include "net/base/registry_controlled_domains/registry_controlled_domain.h"
+
+#include "api/qwebenginecookierule.h"
+
+#include <algorithm>
+#include <unordered_set>
+
+namespace QtWebEngineCore {
+
+using namespace net::registry_controlled_domains;
+
+static std::string canonicalDomain(const QString &domain)
+{
+    QString canonical = domain.trimmed().toLower();
+    // cookie domains may come with a leading dot
+    if (canonical.startsWith(QLatin1Char('.')))
+        canonical.remove(0, 1);
+    return canonical.toStdString();
+}
+
+// Whether host is domain or one of its subdomains.
+static bool isDomainOrSubdomain(const std::string &host, const std::string &domain)
+{
+    if (host.size() < domain.size() || host.compare(host.size() - domain.size(), domain.size(), domain) != 0)
+        return false;
+    return host.size() == domain.size() || host[host.size() - domain.size() - 1] == '.';
+}
+
+CookieRuleSet::CookieRuleSet(const QList<QWebEngineCookieRule> &rules)
+{
+    m_rules.reserve(rules.size());
+    for (const QWebEngineCookieRule &rule : rules) {
+        Rule compiled;
+        compiled.action = rule.action();
+        compiled.party = rule.party();
+        compiled.domain = canonicalDomain(rule.domain());
+        compiled.firstPartyDomain = canonicalDomain(rule.firstPartyDomain());
+        if (rule.action() == QWebEngineCookieRule::SessionOnly)
+            m_hasSessionOnlyRules = true;
+
+        const size_t index = m_rules.size();
+        // rules for a registry like co.uk have no registrable domain to be found under
+        const std::string registrableDomain = compiled.domain.empty()
+                ? std::string()
+                : GetDomainAndRegistry(compiled.domain, INCLUDE_PRIVATE_REGISTRIES);
+        m_rules.push_back(std::move(compiled));
+        if (registrableDomain.empty())
+            m_otherRules.push_back(index);
+        else
+            m_rulesByDomain[registrableDomain].push_back(index);
+    }
+
+    for (auto &entry : m_rulesByDomain) {
+        std::stable_sort(entry.second.begin(), entry.second.end(), [this](size_t a, size_t b) {
+            return m_rules[a].domain.size() > m_rules[b].domain.size();
+        });
+    }
+    std::stable_sort(m_otherRules.begin(), m_otherRules.end(), [this](size_t a, size_t b) {
+        return m_rules[a].domain.size() > m_rules[b].domain.size();
+    });
+}
+
+// Without a firstPartyHost, the party conditions of the rules are ignored.
+const CookieRuleSet::Rule *CookieRuleSet::findRule(const std::vector<size_t> &candidates, const std::string &host,
+                                                   const std::string *firstPartyHost, bool thirdParty) const
+{
+    for (size_t index : candidates) {
+        const Rule &rule = m_rules[index];
+        if (!rule.domain.empty() && !isDomainOrSubdomain(host, rule.domain))
+            continue;
+        if (firstPartyHost) {
+            if (rule.party == QWebEngineCookieRule::FirstParty && thirdParty)
+                continue;
+            if (rule.party == QWebEngineCookieRule::ThirdParty && !thirdParty)
+                continue;
+            if (!rule.firstPartyDomain.empty() && !isDomainOrSubdomain(*firstPartyHost, rule.firstPartyDomain))
+                continue;
+        }
+        return &rule;
+    }
+    return nullptr;
+}
+
+const CookieRuleSet::Rule *CookieRuleSet::findRule(const std::string &registrableDomain, const std::string &host,
+                                                   const std::string *firstPartyHost, bool thirdParty) const
+{
+    if (!m_rulesByDomain.empty()) {
+        auto it = m_rulesByDomain.find(registrableDomain);
+        if (it != m_rulesByDomain.end()) {
+            if (const Rule *rule = findRule(it->second, host, firstPartyHost, thirdParty))
+                return rule;
+        }
+    }
+    return findRule(m_otherRules, host, firstPartyHost, thirdParty);
+}
+
+CookieRuleSet::Decision CookieRuleSet::evaluate(const GURL &firstPartyUrl, const GURL &url) const
+{
+    if (m_rules.empty())
+        return NoMatch;
+
+    // An empty first-party URL indicates a first-party access, see QWebEngineCookieStorePrivate::canAccessCookies()
+    const bool thirdParty = !firstPartyUrl.is_empty()
+            && !SameDomainOrHost(url, firstPartyUrl, INCLUDE_PRIVATE_REGISTRIES);
+    const std::string firstPartyHost = firstPartyUrl.host();
+    const Rule *rule = findRule(GetDomainAndRegistry(url, INCLUDE_PRIVATE_REGISTRIES), url.host(),
+                                &firstPartyHost, thirdParty);
+    if (!rule)
+        return NoMatch;
+
+    switch (rule->action) {
+    case QWebEngineCookieRule::Allow:
+        return Allow;
+    case QWebEngineCookieRule::SessionOnly:
+        return SessionOnly;
+    default:
+        return Block;
+    }
+}
+
+bool CookieRuleSet::isSessionOnly(const GURL &url) const
+{
+    if (!m_hasSessionOnlyRules)
+        return false;
+    const Rule *rule = findRule(GetDomainAndRegistry(url, INCLUDE_PRIVATE_REGISTRIES), url.host(), nullptr, false);
+    return rule && rule->action == QWebEngineCookieRule::SessionOnly;
+}
+
+std::vector<std::pair<std::string, bool>> CookieRuleSet::sessionOnlyDomains() const
+{
+    std::vector<size_t> order(m_rules.size());
+    for (size_t i = 0; i < order.size(); ++i)
+        order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [this](size_t a, size_t b) {
+        return m_rules[a].domain.size() > m_rules[b].domain.size();
+    });
+
+    std::vector<std::pair<std::string, bool>> domains;
+    std::unordered_set<std::string> seen;
+    for (size_t index : order) {
+        const Rule &rule = m_rules[index];
+        // only the first rule of a domain is ever found
+        if (!seen.insert(rule.domain).second)
+            continue;
+        domains.emplace_back(rule.domain, rule.action == QWebEngineCookieRule::SessionOnly);
+    }
+    return domains;
+}
+
+} // namespace QtWebEngineCore
@@ -0,0 +1,102 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtWebEngine module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef COOKIE_RULE_SET_H
+#define COOKIE_RULE_SET_H
+
+#include "url/gurl.h"
+
+#include <QtCore/QList>
+
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+QT_BEGIN_NAMESPACE
+class QWebEngineCookieRule;
+QT_END_NAMESPACE
+
+namespace QtWebEngineCore {
+
+// The QWebEngineCookieRules of a cookie store, compiled once into plain
+// Chromium types and indexed by registrable domain. Immutable after
+// construction, so it can be used on the IO thread while the UI thread
+// replaces it.
+class CookieRuleSet
+{
+public:
+    explicit CookieRuleSet(const QList<QWebEngineCookieRule> &rules);
+
+    enum Decision { NoMatch, Allow, Block, SessionOnly };
+
+    Decision evaluate(const GURL &firstPartyUrl, const GURL &url) const;
+    // Whether the persistent cookies of url are to be deleted. Only the
+    // domains of the rules count here, not who accesses the cookies.
+    bool isSessionOnly(const GURL &url) const;
+    bool isEmpty() const { return m_rules.empty(); }
+    bool hasSessionOnlyRules() const { return m_hasSessionOnlyRules; }
+    // The domains of the rules in the order isSessionOnly() checks them, each
+    // with whether its cookies are session-only. An empty domain matches all.
+    std::vector<std::pair<std::string, bool>> sessionOnlyDomains() const;
+
+private:
+    struct Rule
+    {
+        int action;
+        int party;
+        std::string domain;
+        std::string firstPartyDomain;
+    };
+
+    const Rule *findRule(const std::string &registrableDomain, const std::string &host,
+                         const std::string *firstPartyHost, bool thirdParty) const;
+    const Rule *findRule(const std::vector<size_t> &candidates, const std::string &host,
+                         const std::string *firstPartyHost, bool thirdParty) const;
+
+    std::vector<Rule> m_rules;
+    // by the registrable domain of the rule's domain, longest domains first
+    std::unordered_map<std::string, std::vector<size_t>> m_rulesByDomain;
+    std::vector<size_t> m_otherRules;
+    bool m_hasSessionOnlyRules = false;
+};
+
+} // namespace QtWebEngineCore
+
+#endif // COOKIE_RULE_SET_H
@@ -63,6 +63,7 @@
 #include "profile_adapter.h"
 #include "type_conversion.h"
 
+#include <QtCore/qbuffer.h>
 #include <QtCore/qbytearray.h>
 #include <QtCore/qfile.h>
 #include <QtCore/qfileinfo.h>
@@ -75,6 +76,29 @@ namespace QtWebEngineCore {
 
 namespace {
 
+// Returns the contents of device if they already are in memory or can be
+// mapped into it, so that they can be written to the pipe without reading
+// the device chunk by chunk. Returns a null QByteArray otherwise.
+QByteArray mappedData(QIODevice *device)
+{
+    if (device->isTextModeEnabled())
+        return QByteArray();
+    if (QBuffer *buffer = qobject_cast<QBuffer *>(device)) {
+        // A buffer still open for writing can grow after the reply.
+        if (buffer->isWritable())
+            return QByteArray();
+        return buffer->data();
+    }
+    if (QFile *file = qobject_cast<QFile *>(device)) {
+        const qint64 size = file->size();
+        if (size <= 0 || size > std::numeric_limits<qsizetype>::max())
+            return QByteArray();
+        if (uchar *data = file->map(0, size))
+            return QByteArray::fromRawData(reinterpret_cast<const char *>(data), qsizetype(size));
+    }
+    return QByteArray();
+}
+
 class CustomURLLoader : public network::mojom::URLLoader
                       , private URLRequestCustomJobProxy::Client
 {
@@ -82,11 +106,12 @@ public:
     static void CreateAndStart(const network::ResourceRequest &request,
                                network::mojom::URLLoaderRequest loader,
                                network::mojom::URLLoaderClientPtrInfo client_info,
-                               QPointer<ProfileAdapter> profileAdapter)
+                               QPointer<ProfileAdapter> profileAdapter,
+                               QSharedPointer<ThreadSafeUrlSchemeHandler> threadSafeHandler)
     {
         // CustomURLLoader will handle its own life-cycle, and delete when
         // the client lets go.
-        auto *customUrlLoader = new CustomURLLoader(request, std::move(loader), std::move(client_info), profileAdapter);
+        auto *customUrlLoader = new CustomURLLoader(request, std::move(loader), std::move(client_info), profileAdapter, threadSafeHandler);
         customUrlLoader->Start();
     }
 
@@ -97,11 +122,10 @@ public:
                         const absl::optional<GURL> &new_url) override
     {
         // We can be asked for follow our own redirect
-        scoped_refptr<URLRequestCustomJobProxy> proxy = new URLRequestCustomJobProxy(this, m_proxy->m_scheme, m_proxy->m_profileAdapter);
+        scoped_refptr<URLRequestCustomJobProxy> proxy = new URLRequestCustomJobProxy(this, m_proxy->m_scheme, m_proxy->m_profileAdapter,
+                                                                                 m_proxy->m_threadSafeHandler);
         m_proxy->m_client = nullptr;
-//        m_taskRunner->PostTask(FROM_HERE, base::BindOnce(&URLRequestCustomJobProxy::release, m_proxy));
-        base::PostTask(FROM_HERE, { content::BrowserThread::UI },
-                       base::BindOnce(&URLRequestCustomJobProxy::release, m_proxy));
+        m_proxy->postToHandler(base::BindOnce(&URLRequestCustomJobProxy::release, m_proxy));
         m_proxy = std::move(proxy);
         if (new_url)
             m_request.url = *new_url;
@@ -121,10 +145,11 @@ private:
     CustomURLLoader(const network::ResourceRequest &request,
                     network::mojom::URLLoaderRequest loader,
                     network::mojom::URLLoaderClientPtrInfo client_info,
-                    QPointer<ProfileAdapter> profileAdapter)
+                    QPointer<ProfileAdapter> profileAdapter,
+                    QSharedPointer<ThreadSafeUrlSchemeHandler> threadSafeHandler)
         // ### We can opt to run the url-loader on the UI thread instead
         : m_taskRunner(base::CreateSingleThreadTaskRunner({ content::BrowserThread::IO }))
-        , m_proxy(new URLRequestCustomJobProxy(this, request.url.scheme(), profileAdapter))
+        , m_proxy(new URLRequestCustomJobProxy(this, request.url.scheme(), profileAdapter, threadSafeHandler))
         , m_receiver(this, std::move(loader))
         , m_client(std::move(client_info))
         , m_request(request)
@@ -186,10 +211,9 @@ private:
         if (ParseRange(m_request.headers))
             m_firstBytePosition = m_byteRange.first_byte_position();
 
-//        m_taskRunner->PostTask(FROM_HERE,
-        base::PostTask(FROM_HERE, { content::BrowserThread::UI },
-                       base::BindOnce(&URLRequestCustomJobProxy::initialize, m_proxy,
-                                      m_request.url, m_request.method, m_request.request_initiator, std::move(headers)));
+        m_proxy->postToHandler(base::BindOnce(&URLRequestCustomJobProxy::initialize, m_proxy,
+                                              m_request.url, m_request.method, m_request.request_initiator,
+                                              std::move(headers)));
     }
 
     void CompleteWithFailure(network::CorsErrorStatus cors_error)
@@ -236,12 +260,11 @@ private:
         DCHECK(m_taskRunner->RunsTasksInCurrentSequence());
         m_proxy->m_client = nullptr;
         m_client.reset();
+        m_data = QByteArray(); // before unmapping it by closing the device
         if (m_device && m_device->isOpen())
             m_device->close();
         m_device = nullptr;
-//        m_taskRunner->PostTask(FROM_HERE, base::BindOnce(&URLRequestCustomJobProxy::release, m_proxy));
-        base::PostTask(FROM_HERE, { content::BrowserThread::UI },
-                       base::BindOnce(&URLRequestCustomJobProxy::release, m_proxy));
+        m_proxy->postToHandler(base::BindOnce(&URLRequestCustomJobProxy::release, m_proxy));
         if (!wait_for_loader_error || !m_receiver.is_bound())
             delete this;
     }
@@ -326,6 +349,9 @@ private:
         m_client->OnStartLoadingResponseBody(std::move(m_pipeConsumerHandle));
         m_head = nullptr;
 
+        m_data = mappedData(m_device);
+        m_dataPosition = m_device->pos();
+
         if (readAvailableData()) // May delete this
             return;
 
@@ -394,6 +420,8 @@ private:
     bool readAvailableData()
     {
         DCHECK(m_taskRunner->RunsTasksInCurrentSequence());
+        if (!m_data.isNull())
+            return writeMappedData();
         for (;;) {
             if (m_error || !m_device)
                 break;
@@ -429,6 +457,37 @@ private:
         CompleteWithFailure(m_error ? net::Error(m_error) : net::ERR_FAILED);
         return true; // Done with reading
     }
+
+    // Like readAvailableData(), but writes to the pipe straight from m_data.
+    bool writeMappedData()
+    {
+        for (;;) {
+            if (m_error || !m_device)
+                break;
+
+            int64_t remaining = m_data.size() - m_dataPosition;
+            if (m_maxBytesToRead > 0)
+                remaining = std::min(remaining, m_maxBytesToRead - m_totalBytesRead);
+            if (remaining <= 0) {
+                OnTransferComplete(MOJO_RESULT_OK);
+                return true; // Done with writing
+            }
+
+            uint32_t bytesWritten = uint32_t(std::min(remaining, int64_t{std::numeric_limits<uint32_t>::max()}));
+            MojoResult writeResult = m_pipeProducerHandle->WriteData(
+                    m_data.constData() + m_dataPosition, &bytesWritten, MOJO_WRITE_DATA_FLAG_NONE);
+            if (writeResult == MOJO_RESULT_SHOULD_WAIT)
+                return false; // Wait for pipe watcher
+            if (writeResult != MOJO_RESULT_OK)
+                break;
+            m_dataPosition += bytesWritten;
+            m_totalBytesRead += bytesWritten;
+            m_client->OnTransferSizeUpdated(m_totalBytesRead);
+        }
+
+        CompleteWithFailure(m_error ? net::Error(m_error) : net::ERR_FAILED);
+        return true; // Done with writing
+    }
     bool ParseRange(const net::HttpRequestHeaders &headers)
     {
         std::string range_header;
@@ -459,6 +518,10 @@ private:
     mojo::ScopedDataPipeConsumerHandle m_pipeConsumerHandle;
     std::unique_ptr<mojo::SimpleWatcher> m_watcher;
 
+    // Contents of m_device if it can be bypassed, see mappedData().
+    QByteArray m_data;
+    int64_t m_dataPosition = 0;
+
     net::HttpByteRange m_byteRange;
     int64_t m_totalSize = 0;
     int64_t m_maxBytesToRead = -1;
@@ -474,9 +537,13 @@ private:
 
 class CustomURLLoaderFactory : public network::mojom::URLLoaderFactory {
 public:
-    CustomURLLoaderFactory(ProfileAdapter *profileAdapter, mojo::PendingReceiver<network::mojom::URLLoaderFactory> receiver)
+    CustomURLLoaderFactory(QPointer<ProfileAdapter> profileAdapter,
+                           QSharedPointer<ThreadSafeUrlSchemeHandler> threadSafeHandler,
+                           mojo::PendingReceiver<network::mojom::URLLoaderFactory> receiver)
         : m_taskRunner(base::CreateSequencedTaskRunner({ content::BrowserThread::IO }))
         , m_profileAdapter(profileAdapter)
+        , m_threadSafeHandler(threadSafeHandler)
+        , m_boundOnIO(!threadSafeHandler.isNull())
     {
         m_receivers.set_disconnect_handler(base::BindRepeating(
             &CustomURLLoaderFactory::OnDisconnect, base::Unretained(this)));
@@ -492,15 +559,24 @@ public:
                               mojo::PendingRemote<network::mojom::URLLoaderClient> client,
                               const net::MutableNetworkTrafficAnnotationTag &traffic_annotation) override
     {
-        DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
         Q_UNUSED(request_id);
         Q_UNUSED(options);
         Q_UNUSED(traffic_annotation);
 
+        if (m_boundOnIO) {
+            // See Create(). Should the handler have been removed meanwhile, the
+            // loader falls back to looking it up on the UI thread.
+            DCHECK(m_taskRunner->RunsTasksInCurrentSequence());
+            CustomURLLoader::CreateAndStart(request, std::move(loader), std::move(client),
+                                            m_profileAdapter, m_threadSafeHandler);
+            return;
+        }
+
+        DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
         m_taskRunner->PostTask(FROM_HERE,
                                base::BindOnce(&CustomURLLoader::CreateAndStart, request,
                                               std::move(loader), std::move(client),
-                                              m_profileAdapter));
+                                              m_profileAdapter, QSharedPointer<ThreadSafeUrlSchemeHandler>()));
 
     }
 
@@ -515,23 +591,45 @@ public:
             delete this;
     }
 
-    static mojo::PendingRemote<network::mojom::URLLoaderFactory> Create(ProfileAdapter *profileAdapter)
+    static void CreateOnIO(QPointer<ProfileAdapter> profileAdapter,
+                           QSharedPointer<ThreadSafeUrlSchemeHandler> threadSafeHandler,
+                           mojo::PendingReceiver<network::mojom::URLLoaderFactory> receiver)
+    {
+        DCHECK_CURRENTLY_ON(content::BrowserThread::IO);
+        new CustomURLLoaderFactory(profileAdapter, threadSafeHandler, std::move(receiver));
+    }
+
+    static mojo::PendingRemote<network::mojom::URLLoaderFactory> Create(ProfileAdapter *profileAdapter, const QByteArray &scheme)
     {
+        DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
         mojo::PendingRemote<network::mojom::URLLoaderFactory> pending_remote;
-        new CustomURLLoaderFactory(profileAdapter, pending_remote.InitWithNewPipeAndPassReceiver());
+        QSharedPointer<ThreadSafeUrlSchemeHandler> threadSafeHandler = profileAdapter->threadSafeUrlSchemeHandler(scheme);
+        if (threadSafeHandler) {
+            // Requests for this scheme never need the UI thread, so bind the
+            // factory on the IO thread where the loaders live. The factories
+            // are recreated whenever the installed handlers change.
+            base::PostTask(FROM_HERE, { content::BrowserThread::IO },
+                           base::BindOnce(&CustomURLLoaderFactory::CreateOnIO,
+                                          QPointer<ProfileAdapter>(profileAdapter), threadSafeHandler,
+                                          pending_remote.InitWithNewPipeAndPassReceiver()));
+        } else {
+            new CustomURLLoaderFactory(profileAdapter, nullptr, pending_remote.InitWithNewPipeAndPassReceiver());
+        }
         return pending_remote;
     }
 
     const scoped_refptr<base::SequencedTaskRunner> m_taskRunner;
     mojo::ReceiverSet<network::mojom::URLLoaderFactory> m_receivers;
     QPointer<ProfileAdapter> m_profileAdapter;
+    QSharedPointer<ThreadSafeUrlSchemeHandler> m_threadSafeHandler;
+    const bool m_boundOnIO;
 };
 
 } // namespace
 
-mojo::PendingRemote<network::mojom::URLLoaderFactory> CreateCustomURLLoaderFactory(ProfileAdapter *profileAdapter)
+mojo::PendingRemote<network::mojom::URLLoaderFactory> CreateCustomURLLoaderFactory(ProfileAdapter *profileAdapter, const QByteArray &scheme)
 {
-    return CustomURLLoaderFactory::Create(profileAdapter);
+    return CustomURLLoaderFactory::Create(profileAdapter, scheme);
 }
 
 } // namespace QtWebEngineCore
@@ -53,6 +53,8 @@
 
 #include "mojo/public/cpp/bindings/pending_remote.h"
 
+#include <QtCore/qbytearray.h>
+
 namespace network {
 namespace mojom {
 class URLLoaderFactory;
@@ -62,7 +64,7 @@ class URLLoaderFactory;
 namespace QtWebEngineCore {
 class ProfileAdapter;
 
-mojo::PendingRemote<network::mojom::URLLoaderFactory> CreateCustomURLLoaderFactory(ProfileAdapter *profileAdapter);
+mojo::PendingRemote<network::mojom::URLLoaderFactory> CreateCustomURLLoaderFactory(ProfileAdapter *profileAdapter, const QByteArray &scheme);
 
 } // namespace QtWebEngineCore
 
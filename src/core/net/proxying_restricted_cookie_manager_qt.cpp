@@ -48,7 +48,6 @@
 #include "api/qwebenginecookiestore_p.h"
 #include "profile_adapter.h"
 #include "profile_qt.h"
-#include "type_conversion.h"
 
 #include "base/memory/ptr_util.h"
 #include "base/task/post_task.h"
@@ -183,7 +182,7 @@ bool ProxyingRestrictedCookieManagerQt::allowCookies(const GURL &url, const net:
 {
     if (!m_profileIoData)
         return false;
-    return m_profileIoData->canGetCookies(toQt(site_for_cookies.first_party_url()), toQt(url));
+    return m_profileIoData->canGetCookies(site_for_cookies.first_party_url(), url);
 }
 
 }  // namespace QtWebEngineCore
@@ -57,6 +57,7 @@
 #include "url/url_util_qt.h"
 
 #include "api/qwebengineurlrequestinfo_p.h"
+#include "net/url_request_rule_set.h"
 #include "type_conversion.h"
 #include "web_contents_adapter.h"
 #include "web_contents_adapter_client.h"
@@ -146,8 +147,10 @@ public:
     static inline void cleanup(QWebEngineUrlRequestInfo *info) { delete info; }
 
 private:
+    bool ApplyRequestRules();
     void InterceptOnUIThread();
     void ContinueAfterIntercept();
+    void RedirectTo(const GURL &url);
 
     // This is called when the original URLLoaderClient has a connection error.
     void OnURLLoaderClientError();
@@ -174,6 +177,8 @@ private:
     bool allow_remote_ = true;
     bool local_access_ = false;
     bool remote_access_ = true;
+    // a redirect target matching the rule again must not loop
+    bool redirected_by_rule_ = false;
 
     // If the |target_loader_| called OnComplete with an error this stores it.
     // That way the destructor can send it to OnReceivedError if safe browsing
@@ -300,6 +305,9 @@ void InterceptedRequest::Restart()
         }
     }
 
+    if (ApplyRequestRules())
+        return;
+
     // MEMO since all codepatch leading to Restart scheduled and executed as asynchronous tasks in main thread,
     //      interceptors may change in meantime and also during intercept call, so they should be resolved anew.
     //      Set here only profile's interceptor since it runs first without going to user code.
@@ -331,6 +339,37 @@ void InterceptedRequest::Restart()
     ContinueAfterIntercept();
 }
 
+// Applies the declarative rules of the profile, which need neither a
+// QWebEngineUrlRequestInfo nor a call into application code. Returns true if
+// the request was blocked or redirected.
+bool InterceptedRequest::ApplyRequestRules()
+{
+    const QSharedPointer<const UrlRequestRuleSet> rules =
+            profile_adapter_ ? profile_adapter_->requestRuleSet() : nullptr;
+    if (!rules)
+        return false;
+
+    const UrlRequestRuleSet::Result result = rules->evaluate(request_);
+    if (result.block) {
+        SendErrorAndCompleteImmediately(net::ERR_BLOCKED_BY_CLIENT);
+        return true;
+    }
+    for (const auto &header : result.headers) {
+        if (base::LowerCaseEqualsASCII(header.first, "referer"))
+            request_.referrer = GURL(header.second);
+        else if (header.second.empty())
+            request_.headers.RemoveHeader(header.first);
+        else
+            request_.headers.SetHeader(header.first, header.second);
+    }
+    if (result.redirectUrl.is_valid() && !redirected_by_rule_ && result.redirectUrl != request_.url) {
+        redirected_by_rule_ = true;
+        RedirectTo(result.redirectUrl);
+        return true;
+    }
+    return false;
+}
+
 void InterceptedRequest::InterceptOnUIThread()
 {
     DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
@@ -365,28 +404,8 @@ void InterceptedRequest::ContinueAfterIntercept()
                 }
             }
 
-            if (info.shouldRedirectRequest) {
-                net::RedirectInfo::FirstPartyURLPolicy first_party_url_policy =
-                        request_.update_first_party_url_on_redirect ? net::RedirectInfo::FirstPartyURLPolicy::UPDATE_URL_ON_REDIRECT
-                                                                    : net::RedirectInfo::FirstPartyURLPolicy::NEVER_CHANGE_URL;
-                net::RedirectInfo redirectInfo = net::RedirectInfo::ComputeRedirectInfo(
-                        request_.method, request_.url, request_.site_for_cookies,
-                        first_party_url_policy, request_.referrer_policy, request_.referrer.spec(),
-                        net::HTTP_TEMPORARY_REDIRECT, toGurl(info.url), absl::nullopt,
-                        false /*insecure_scheme_was_upgraded*/);
-
-                // FIXME: Should probably create a new header.
-                current_response_->encoded_data_length = 0;
-                request_.method = redirectInfo.new_method;
-                request_.url = redirectInfo.new_url;
-                request_.site_for_cookies = redirectInfo.new_site_for_cookies;
-                request_.referrer = GURL(redirectInfo.new_referrer);
-                request_.referrer_policy = redirectInfo.new_referrer_policy;
-                if (request_.method == net::HttpRequestHeaders::kGetMethod)
-                    request_.request_body = nullptr;
-                target_client_->OnReceiveRedirect(redirectInfo, std::move(current_response_));
-                return;
-            }
+            if (info.shouldRedirectRequest)
+                return RedirectTo(toGurl(info.url));
         }
     }
 
@@ -397,6 +416,29 @@ void InterceptedRequest::ContinueAfterIntercept()
     }
 }
 
+void InterceptedRequest::RedirectTo(const GURL &url)
+{
+    net::RedirectInfo::FirstPartyURLPolicy first_party_url_policy =
+            request_.update_first_party_url_on_redirect ? net::RedirectInfo::FirstPartyURLPolicy::UPDATE_URL_ON_REDIRECT
+                                                        : net::RedirectInfo::FirstPartyURLPolicy::NEVER_CHANGE_URL;
+    net::RedirectInfo redirectInfo = net::RedirectInfo::ComputeRedirectInfo(
+            request_.method, request_.url, request_.site_for_cookies,
+            first_party_url_policy, request_.referrer_policy, request_.referrer.spec(),
+            net::HTTP_TEMPORARY_REDIRECT, url, absl::nullopt,
+            false /*insecure_scheme_was_upgraded*/);
+
+    // FIXME: Should probably create a new header.
+    current_response_->encoded_data_length = 0;
+    request_.method = redirectInfo.new_method;
+    request_.url = redirectInfo.new_url;
+    request_.site_for_cookies = redirectInfo.new_site_for_cookies;
+    request_.referrer = GURL(redirectInfo.new_referrer);
+    request_.referrer_policy = redirectInfo.new_referrer_policy;
+    if (request_.method == net::HttpRequestHeaders::kGetMethod)
+        request_.request_body = nullptr;
+    target_client_->OnReceiveRedirect(redirectInfo, std::move(current_response_));
+}
+
 // URLLoaderClient methods.
 
 void InterceptedRequest::OnReceiveResponse(network::mojom::URLResponseHeadPtr head)
@@ -39,15 +39,151 @@
 
 #include "qrc_url_scheme_handler.h"
 
+#include "third_party/brotli/include/brotli/decode.h"
+#include "third_party/zlib/google/compression_utils.h"
+
 #include <QtWebEngineCore/qwebengineurlrequestjob.h>
 
-#include <QFile>
 #include <QFileInfo>
 #include <QMimeDatabase>
 #include <QMimeType>
+#include <QResource>
 
 namespace QtWebEngineCore {
 
+namespace {
+
+// Upper bound in bytes for keeping decoded pre-compressed resources around.
+const qsizetype decodedDataCacheSize = 32 * 1024 * 1024;
+
+// Resources rcc stored uncompressed are served from where they are mapped.
+QByteArray resourceData(const QResource &resource)
+{
+    if (resource.compressionAlgorithm() == QResource::NoCompression)
+        return QByteArray::fromRawData(reinterpret_cast<const char *>(resource.data()), qsizetype(resource.size()));
+    return resource.uncompressedData();
+}
+
+QByteArray gzipUncompress(const QByteArray &data)
+{
+    const base::StringPiece input(data.constData(), size_t(data.size()));
+    QByteArray output(qsizetype(compression::GetUncompressedSize(input)), Qt::Uninitialized);
+    if (!compression::GzipUncompress(input, base::StringPiece(output.data(), size_t(output.size()))))
+        return QByteArray();
+    return output;
+}
+
+QByteArray brotliUncompress(const QByteArray &data)
+{
+    BrotliDecoderState *state = BrotliDecoderCreateInstance(nullptr, nullptr, nullptr);
+    if (!state)
+        return QByteArray();
+
+    QByteArray output;
+    size_t availableIn = size_t(data.size());
+    const uint8_t *nextIn = reinterpret_cast<const uint8_t *>(data.constData());
+    BrotliDecoderResult result = BROTLI_DECODER_RESULT_NEEDS_MORE_OUTPUT;
+    while (result == BROTLI_DECODER_RESULT_NEEDS_MORE_OUTPUT) {
+        const qsizetype offset = output.size();
+        output.resize(offset + qMax(offset, qMax(data.size() * 4, qsizetype(4096))));
+        size_t availableOut = size_t(output.size() - offset);
+        uint8_t *nextOut = reinterpret_cast<uint8_t *>(output.data()) + offset;
+        result = BrotliDecoderDecompressStream(state, &availableIn, &nextIn, &availableOut, &nextOut, nullptr);
+        output.resize(output.size() - qsizetype(availableOut));
+    }
+    BrotliDecoderDestroyInstance(state);
+    if (result != BROTLI_DECODER_RESULT_SUCCESS)
+        return QByteArray();
+    return output;
+}
+
+} // namespace
+
+QrcUrlSchemeHandler::QrcUrlSchemeHandler()
+    : m_decodedData(decodedDataCacheSize)
+{
+}
+
+// Resolves path to the resource to serve. A resource can also be shipped only
+// as a pre-compressed variant named path.br or path.gz, which is served decoded:
+// the data pipe of custom schemes does not go through the network stack's
+// content decoding.
+bool QrcUrlSchemeHandler::lookup(const QString &path, Entry *entry)
+{
+    // Whether the resource is still registered is checked by readData().
+    auto it = m_entries.constFind(path);
+    if (it != m_entries.constEnd()) {
+        *entry = *it;
+        return true;
+    }
+
+    static const struct {
+        QLatin1String suffix;
+        Encoding encoding;
+    } variants[] = {
+        { QLatin1String(""), Encoding::Identity },
+        { QLatin1String(".br"), Encoding::Brotli },
+        { QLatin1String(".gz"), Encoding::Gzip },
+    };
+
+    Entry found;
+    const QString resourcePath = QLatin1Char(':') + path;
+    for (const auto &variant : variants) {
+        QResource resource(resourcePath + variant.suffix);
+        if (resource.isValid() && !resource.isDir() && resource.uncompressedSize() > 0) {
+            found.resourcePath = resource.absoluteFilePath();
+            found.encoding = variant.encoding;
+            break;
+        }
+    }
+    // Misses are not cached, resources can also be registered at runtime.
+    if (found.resourcePath.isEmpty())
+        return false;
+
+    QMimeDatabase mimeDatabase;
+    if (found.encoding == Encoding::Identity)
+        found.mimeType = mimeDatabase.mimeTypeForFile(QFileInfo(found.resourcePath)).name().toUtf8();
+    else
+        found.mimeType = mimeDatabase.mimeTypeForFile(path, QMimeDatabase::MatchExtension).name().toUtf8();
+
+    m_entries.insert(path, found);
+    *entry = found;
+    return true;
+}
+
+// Reads the data to serve for the entry of path. Returns false if the resource
+// was unregistered since the entry was made; resources can be unregistered at
+// runtime. Decoded data is kept until it is evicted from the cache, though.
+bool QrcUrlSchemeHandler::readData(const QString &path, const Entry &entry, QByteArray *data)
+{
+    if (entry.encoding != Encoding::Identity) {
+        if (const QByteArray *decoded = m_decodedData.object(entry.resourcePath)) {
+            *data = *decoded;
+            return true;
+        }
+    }
+
+    const QResource resource(entry.resourcePath);
+    if (!resource.isValid()) {
+        m_entries.remove(path);
+        return false;
+    }
+    if (entry.encoding == Encoding::Identity) {
+        *data = resourceData(resource);
+        return true;
+    }
+
+    const QByteArray encoded = resourceData(resource);
+    *data = entry.encoding == Encoding::Brotli ? brotliUncompress(encoded) : gzipUncompress(encoded);
+    if (data->isEmpty()) {
+        qWarning("QResource '%s' could not be decoded", qUtf8Printable(entry.resourcePath));
+        return true;
+    }
+
+    m_decodedData.insert(entry.resourcePath, new QByteArray(*data), data->size());
+    return true;
+}
+
 void QrcUrlSchemeHandler::requestStarted(QWebEngineUrlRequestJob *job)
 {
     QByteArray requestMethod = job->requestMethod();
@@ -58,16 +194,18 @@ void QrcUrlSchemeHandler::requestStarted(QWebEngineUrlRequestJob *job)
 
     QUrl requestUrl = job->requestUrl();
     QString requestPath = requestUrl.path();
-    QScopedPointer<QFile> file(new QFile(':' + requestPath, job));
-    if (!file->exists() || file->size() == 0) {
+    Entry entry;
+    QByteArray content;
+    if (!lookup(requestPath, &entry) || !readData(requestPath, entry, &content)) {
         qWarning("QResource '%s' not found or is empty", qUtf8Printable(requestPath));
         job->fail(QWebEngineUrlRequestJob::UrlNotFound);
         return;
     }
-    QFileInfo fileInfo(*file);
-    QMimeDatabase mimeDatabase;
-    QMimeType mimeType = mimeDatabase.mimeTypeForFile(fileInfo);
-    job->reply(mimeType.name().toUtf8(), file.take());
+    if (content.isEmpty()) {
+        job->fail(QWebEngineUrlRequestJob::RequestFailed);
+        return;
+    }
+    job->reply(entry.mimeType, content);
 }
 
 } // namespace QtWebEngineCore
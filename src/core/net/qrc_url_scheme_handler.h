@@ -43,12 +43,34 @@
 #include <QtWebEngineCore/private/qtwebenginecoreglobal_p.h>
 #include <QtWebEngineCore/qwebengineurlschemehandler.h>
 
+#include <QtCore/qcache.h>
+#include <QtCore/qhash.h>
+
 namespace QtWebEngineCore {
 
 class QrcUrlSchemeHandler final : public QWebEngineUrlSchemeHandler
 {
 public:
+    QrcUrlSchemeHandler();
+
     void requestStarted(QWebEngineUrlRequestJob *) override;
+
+private:
+    enum class Encoding { Identity, Gzip, Brotli };
+
+    // What is known about a requested path, so that existence checks and
+    // MIME type detection only happen on the first request for it.
+    struct Entry {
+        QString resourcePath; // the resource served, might be a pre-compressed variant
+        QByteArray mimeType;
+        Encoding encoding = Encoding::Identity;
+    };
+
+    bool lookup(const QString &path, Entry *entry);
+    bool readData(const QString &path, const Entry &entry, QByteArray *data);
+
+    QHash<QString, Entry> m_entries;
+    QCache<QString, QByteArray> m_decodedData;
 };
 
 } // namespace QtWebEngineCore
@@ -47,6 +47,7 @@
 
 #include "type_conversion.h"
 
+#include <QBuffer>
 #include <QByteArray>
 
 namespace QtWebEngineCore {
@@ -97,6 +98,14 @@ void URLRequestCustomJobDelegate::reply(const QByteArray &contentType, QIODevice
                                                      m_proxy, contentType.toStdString(),device));
 }
 
+void URLRequestCustomJobDelegate::reply(const QByteArray &contentType, const QByteArray &data)
+{
+    // The loader writes the contents of a QBuffer to the pipe directly.
+    QBuffer *buffer = new QBuffer(this);
+    buffer->setData(data);
+    reply(contentType, buffer);
+}
+
 void URLRequestCustomJobDelegate::slotReadyRead()
 {
     m_proxy->m_ioTaskRunner->PostTask(FROM_HERE,
@@ -85,6 +85,7 @@ public:
     QMap<QByteArray, QByteArray> requestHeaders() const;
 
     void reply(const QByteArray &contentType, QIODevice *device);
+    void reply(const QByteArray &contentType, const QByteArray &data);
     void redirect(const QUrl &url);
     void abort();
     void fail(Error);
@@ -40,36 +40,197 @@
 #include "url_request_custom_job_proxy.h"
 #include "url_request_custom_job_delegate.h"
 
+#include "base/task/post_task.h"
+#include "content/public/browser/browser_task_traits.h"
 #include "content/public/browser/browser_thread.h"
 #include "net/base/net_errors.h"
 
 #include "api/qwebengineurlrequestjob.h"
+#include "api/qwebengineurlschemehandler.h"
 #include "profile_adapter.h"
 #include "type_conversion.h"
 #include "web_engine_context.h"
 
+#include <QAtomicInteger>
+#include <QMultiHash>
+#include <QMutex>
+#include <QThread>
+
+#include <memory>
+#include <vector>
+
 namespace QtWebEngineCore {
 
+namespace {
+// A thread thread-safe scheme handlers are called on. It runs an event loop,
+// so that request jobs and the objects users create on it work as anywhere else.
+class HandlerThread : public QThread
+{
+public:
+    explicit HandlerThread(int index)
+    {
+        setObjectName(QStringLiteral("QtWebEngineUrlSchemeHandler%1").arg(index));
+        context.moveToThread(this);
+        start();
+    }
+    ~HandlerThread() override
+    {
+        quit();
+        wait();
+    }
+
+    QObject context;
+};
+
+// Requests are spread over the threads round-robin, so that a handler busy
+// with one request does not hold up the requests of other handlers or its
+// own other requests. All tasks of one request stay on the same thread.
+class HandlerThreadPool
+{
+public:
+    HandlerThreadPool()
+    {
+        const int count = qMax(2, QThread::idealThreadCount());
+        m_threads.reserve(count);
+        for (int i = 0; i < count; ++i)
+            m_threads.push_back(std::make_unique<HandlerThread>(i));
+    }
+
+    int nextIndex() { return int(m_next.fetchAndAddRelaxed(1) % m_threads.size()); }
+    HandlerThread *thread(int index) const { return m_threads[index].get(); }
+
+private:
+    std::vector<std::unique_ptr<HandlerThread>> m_threads;
+    QAtomicInteger<quint32> m_next;
+};
+} // namespace
+
+Q_GLOBAL_STATIC(HandlerThreadPool, handlerThreads)
+
+namespace {
+struct ThreadSafeUrlSchemeHandlerRegistry
+{
+    QMutex mutex;
+    QMultiHash<QWebEngineUrlSchemeHandler *, ThreadSafeUrlSchemeHandler *> handlers;
+};
+} // namespace
+
+Q_GLOBAL_STATIC(ThreadSafeUrlSchemeHandlerRegistry, threadSafeHandlerRegistry)
+
+ThreadSafeUrlSchemeHandler::ThreadSafeUrlSchemeHandler(QWebEngineUrlSchemeHandler *handler)
+    : m_handler(handler)
+    , m_installedHandler(handler)
+{
+    ThreadSafeUrlSchemeHandlerRegistry *registry = threadSafeHandlerRegistry();
+    const QMutexLocker locker(&registry->mutex);
+    registry->handlers.insert(m_installedHandler, this);
+}
+
+// The last reference may be dropped on the IO thread.
+ThreadSafeUrlSchemeHandler::~ThreadSafeUrlSchemeHandler()
+{
+    if (ThreadSafeUrlSchemeHandlerRegistry *registry = threadSafeHandlerRegistry()) {
+        const QMutexLocker locker(&registry->mutex);
+        registry->handlers.remove(m_installedHandler, this);
+    }
+}
+
+bool ThreadSafeUrlSchemeHandler::revokeAll(QWebEngineUrlSchemeHandler *handler)
+{
+    ThreadSafeUrlSchemeHandlerRegistry *registry = threadSafeHandlerRegistry();
+    if (!registry)
+        return false;
+    bool wasInstalled = false;
+    const QMutexLocker locker(&registry->mutex);
+    for (auto it = registry->handlers.constFind(handler); it != registry->handlers.cend() && it.key() == handler; ++it) {
+        if (!it.value()->isRevoked()) {
+            it.value()->revoke();
+            wasInstalled = true;
+        }
+    }
+    return wasInstalled;
+}
+
+bool ThreadSafeUrlSchemeHandler::isRevoked() const
+{
+    const QReadLocker locker(&m_lock);
+    return !m_handler;
+}
+
+void ThreadSafeUrlSchemeHandler::revoke()
+{
+    DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+    const QWriteLocker locker(&m_lock);
+    m_handler = nullptr;
+}
+
+bool ThreadSafeUrlSchemeHandler::requestStarted(QWebEngineUrlRequestJob *job)
+{
+    const QReadLocker locker(&m_lock);
+    if (!m_handler)
+        return false;
+    m_handler->requestStarted(job);
+    return true;
+}
+
 URLRequestCustomJobProxy::URLRequestCustomJobProxy(URLRequestCustomJobProxy::Client *client,
                                                    const std::string &scheme,
-                                                   QPointer<ProfileAdapter> profileAdapter)
+                                                   QPointer<ProfileAdapter> profileAdapter,
+                                                   QSharedPointer<ThreadSafeUrlSchemeHandler> threadSafeHandler)
     : m_client(client)
     , m_started(false)
     , m_scheme(scheme)
     , m_delegate(nullptr)
     , m_profileAdapter(profileAdapter)
+    // should the handler have been removed meanwhile, look up its successor on the UI thread
+    , m_threadSafeHandler(threadSafeHandler && !threadSafeHandler->isRevoked() ? threadSafeHandler : nullptr)
     , m_ioTaskRunner(m_client->taskRunner())
+    , m_handlerThreadIndex(-1)
 {
     DCHECK(m_ioTaskRunner && m_ioTaskRunner->RunsTasksInCurrentSequence());
+    if (m_threadSafeHandler) {
+        if (HandlerThreadPool *pool = handlerThreads())
+            m_handlerThreadIndex = pool->nextIndex();
+    }
 }
 
 URLRequestCustomJobProxy::~URLRequestCustomJobProxy()
 {
 }
 
+void URLRequestCustomJobProxy::postToHandler(base::OnceClosure task)
+{
+    if (!m_threadSafeHandler) {
+        base::PostTask(FROM_HERE, { content::BrowserThread::UI }, std::move(task));
+        return;
+    }
+    HandlerThreadPool *pool = handlerThreads();
+    if (pool && m_handlerThreadIndex >= 0) {
+        QMetaObject::invokeMethod(&pool->thread(m_handlerThreadIndex)->context,
+                                  [task = std::make_shared<base::OnceClosure>(std::move(task))]() {
+                                      std::move(*task).Run();
+                                  }, Qt::QueuedConnection);
+        return;
+    }
+    // The handler threads are gone at exit, fail the request instead of leaving it hanging.
+    m_ioTaskRunner->PostTask(FROM_HERE,
+                             base::BindOnce(&URLRequestCustomJobProxy::fail,
+                                            base::WrapRefCounted(this), int(net::ERR_ABORTED)));
+}
+
+bool URLRequestCustomJobProxy::onHandlerThread() const
+{
+    if (m_threadSafeHandler) {
+        HandlerThreadPool *pool = handlerThreads();
+        return pool && m_handlerThreadIndex >= 0
+                && QThread::currentThread() == pool->thread(m_handlerThreadIndex);
+    }
+    return content::BrowserThread::CurrentlyOn(content::BrowserThread::UI);
+}
+
 void URLRequestCustomJobProxy::release()
 {
-    DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+    DCHECK(onHandlerThread());
     if (m_delegate) {
         m_delegate->deleteLater();
         m_delegate = nullptr;
@@ -162,21 +323,38 @@ void URLRequestCustomJobProxy::initialize(GURL url, std::string method,
                                           absl::optional<url::Origin> initiator,
                                           std::map<std::string, std::string> headers)
 {
-    DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+    DCHECK(onHandlerThread());
     Q_ASSERT(!m_delegate);
 
     QUrl initiatorOrigin;
     if (initiator.has_value())
         initiatorOrigin = QUrl::fromEncoded(QByteArray::fromStdString(initiator.value().Serialize()));
 
-    QWebEngineUrlSchemeHandler *schemeHandler = nullptr;
-
-    if (m_profileAdapter)
-        schemeHandler = m_profileAdapter->urlSchemeHandler(toQByteArray(m_scheme));
     QMap<QByteArray, QByteArray> qHeaders;
     for (auto it = headers.cbegin(); it != headers.cend(); ++it)
         qHeaders.insert(toQByteArray(it->first), toQByteArray(it->second));
 
+    if (m_threadSafeHandler) {
+        m_delegate = new URLRequestCustomJobDelegate(this, toQt(url),
+                                                     QByteArray::fromStdString(method),
+                                                     initiatorOrigin,
+                                                     qHeaders);
+        QWebEngineUrlRequestJob *requestJob = new QWebEngineUrlRequestJob(m_delegate);
+        if (!m_threadSafeHandler->requestStarted(requestJob)) {
+            // The handler has been removed since the request was made.
+            delete m_delegate;
+            m_delegate = nullptr;
+            m_ioTaskRunner->PostTask(FROM_HERE,
+                                     base::BindOnce(&URLRequestCustomJobProxy::fail,
+                                                    base::WrapRefCounted(this), int(net::ERR_ABORTED)));
+        }
+        return;
+    }
+
+    QWebEngineUrlSchemeHandler *schemeHandler = nullptr;
+    if (m_profileAdapter)
+        schemeHandler = m_profileAdapter->urlSchemeHandler(toQByteArray(m_scheme));
+
     if (schemeHandler) {
         m_delegate = new URLRequestCustomJobDelegate(this, toQt(url),
                                                      QByteArray::fromStdString(method),
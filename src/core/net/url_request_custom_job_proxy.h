@@ -46,8 +46,12 @@
 #include "url/gurl.h"
 #include "url/origin.h"
 #include <QtCore/QPointer>
+#include <QtCore/QReadWriteLock>
+#include <QtCore/QSharedPointer>
 
 QT_FORWARD_DECLARE_CLASS(QIODevice)
+QT_FORWARD_DECLARE_CLASS(QWebEngineUrlRequestJob)
+QT_FORWARD_DECLARE_CLASS(QWebEngineUrlSchemeHandler)
 
 namespace QtWebEngineCore {
 
@@ -55,8 +59,39 @@ class URLRequestCustomJob;
 class URLRequestCustomJobDelegate;
 class ProfileAdapter;
 
+// Gives the handler thread access to a QWebEngineUrlSchemeHandler installed
+// for a scheme registered with QWebEngineUrlScheme::ThreadSafeHandler. The
+// handler lives on the UI thread, which revokes access when the handler is
+// removed; revoke() waits for calls in progress to return.
+class ThreadSafeUrlSchemeHandler
+{
+public:
+    explicit ThreadSafeUrlSchemeHandler(QWebEngineUrlSchemeHandler *handler);
+    ~ThreadSafeUrlSchemeHandler();
+
+    // Called by ~QWebEngineUrlSchemeHandler. Returns true if access to the
+    // handler had not been revoked yet, as it should have been by removing it
+    // from its profiles before destroying it.
+    static bool revokeAll(QWebEngineUrlSchemeHandler *handler);
+
+    // UI thread only, which is the only one to change it
+    QWebEngineUrlSchemeHandler *handler() const { return m_handler; }
+    bool isRevoked() const;
+    void revoke();
+    // Returns false if access has been revoked.
+    bool requestStarted(QWebEngineUrlRequestJob *job);
+
+private:
+    mutable QReadWriteLock m_lock;
+    QWebEngineUrlSchemeHandler *m_handler;
+    QWebEngineUrlSchemeHandler *const m_installedHandler;
+};
+
 // Used to comunicate between URLRequestCustomJob living on the IO thread
-// and URLRequestCustomJobDelegate living on the UI thread.
+// and URLRequestCustomJobDelegate living on the handler thread. That is the
+// UI thread, unless the scheme is registered with
+// QWebEngineUrlScheme::ThreadSafeHandler, in which case it is one of a pool
+// of threads shared by all thread-safe handlers, which run Qt event loops.
 class URLRequestCustomJobProxy : public base::RefCountedThreadSafe<URLRequestCustomJobProxy>
 {
 
@@ -80,9 +115,14 @@ public:
 
     URLRequestCustomJobProxy(Client *client,
                              const std::string &scheme,
-                             QPointer<ProfileAdapter> profileAdapter);
+                             QPointer<ProfileAdapter> profileAdapter,
+                             QSharedPointer<ThreadSafeUrlSchemeHandler> threadSafeHandler = {});
     ~URLRequestCustomJobProxy();
 
+    // Runs task on the handler thread.
+    void postToHandler(base::OnceClosure task);
+    bool onHandlerThread() const;
+
     // Called from URLRequestCustomJobDelegate via post:
     //void setReplyCharset(const std::string &);
     void reply(std::string mimeType, QIODevice *device);
@@ -97,11 +137,13 @@ public:
     Client *m_client;
     bool m_started;
 
-    // UI thread owned:
+    // Handler sequence owned:
     std::string m_scheme;
     URLRequestCustomJobDelegate *m_delegate;
     QPointer<ProfileAdapter> m_profileAdapter;
+    QSharedPointer<ThreadSafeUrlSchemeHandler> m_threadSafeHandler;
     scoped_refptr<base::SequencedTaskRunner> m_ioTaskRunner;
+    int m_handlerThreadIndex;
 };
 
 } // namespace QtWebEngineCore
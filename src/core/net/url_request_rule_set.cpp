@@ -0,0 +1,180 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtWebEngine module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "url_request_rule_set.h"
+
+#include "base/strings/pattern.h"
+#include "services/network/public/cpp/resource_request.h"
+
+#include "api/qwebengineurlrequestrule.h"
+#include "type_conversion.h"
+
+namespace QtWebEngineCore {
+
+static std::string canonicalHost(const QString &host)
+{
+    return host.trimmed().toLower().toStdString();
+}
+
+// Whether host is ruleHost or one of its subdomains.
+static bool isHostOrSubdomain(const std::string &host, const std::string &ruleHost)
+{
+    if (host.size() < ruleHost.size() || host.compare(host.size() - ruleHost.size(), ruleHost.size(), ruleHost) != 0)
+        return false;
+    return host.size() == ruleHost.size() || host[host.size() - ruleHost.size() - 1] == '.';
+}
+
+UrlRequestRuleSet::UrlRequestRuleSet(const QList<QWebEngineUrlRequestRule> &rules)
+{
+    m_rules.reserve(rules.size());
+    for (const QWebEngineUrlRequestRule &rule : rules) {
+        Rule compiled;
+        compiled.action = rule.action();
+        compiled.urlPattern = rule.urlPattern().toStdString();
+        compiled.initiatorHost = canonicalHost(rule.initiatorHost());
+        for (QWebEngineUrlRequestInfo::ResourceType type : rule.resourceTypes()) {
+            if (type >= 0 && type <= QWebEngineUrlRequestInfo::ResourceTypeLast)
+                compiled.resourceTypes |= uint64_t(1) << type;
+            else
+                qWarning("URL request rules cannot match resource type %d, ignoring it.", int(type));
+        }
+        // an empty mask matches all types, not none
+        if (!rule.resourceTypes().isEmpty() && !compiled.resourceTypes) {
+            qWarning("Ignoring URL request rule that matches none of its resource types.");
+            continue;
+        }
+        if (rule.action() == QWebEngineUrlRequestRule::Redirect) {
+            compiled.redirectUrl = toGurl(rule.redirectUrl());
+            if (!compiled.redirectUrl.is_valid()) {
+                qWarning("Ignoring URL request rule redirecting to invalid URL %ls.",
+                         qUtf16Printable(rule.redirectUrl().toString()));
+                continue;
+            }
+        }
+        if (rule.action() == QWebEngineUrlRequestRule::ModifyHeaders) {
+            for (const QByteArray &name : rule.headers())
+                compiled.headers.emplace_back(name.toStdString(), rule.header(name).toStdString());
+        }
+
+        const size_t index = m_rules.size();
+        m_rules.push_back(std::move(compiled));
+        const std::string host = canonicalHost(rule.host());
+        if (host.empty())
+            m_rulesForAnyHost.push_back(index);
+        else
+            m_rulesByHost[host].push_back(index);
+    }
+}
+
+bool UrlRequestRuleSet::matches(const Rule &rule, const network::ResourceRequest &request,
+                                const std::string &initiatorHost) const
+{
+    if (rule.resourceTypes && (request.resource_type < 0 || request.resource_type >= 64
+                               || !(rule.resourceTypes & (uint64_t(1) << request.resource_type))))
+        return false;
+    if (!rule.initiatorHost.empty() && !isHostOrSubdomain(initiatorHost, rule.initiatorHost))
+        return false;
+    if (!rule.urlPattern.empty() && !base::MatchPattern(request.url.spec(), rule.urlPattern))
+        return false;
+    return true;
+}
+
+UrlRequestRuleSet::Result UrlRequestRuleSet::evaluate(const network::ResourceRequest &request) const
+{
+    Result result;
+    if (m_rules.empty())
+        return result;
+
+    // Rules for example.com are indexed under it and also apply to its
+    // subdomains, so look up the host and all of its parent domains. Each
+    // list is in the order of the rules, so merge them instead of sorting.
+    std::vector<const std::vector<size_t> *> lists;
+    if (!m_rulesForAnyHost.empty())
+        lists.push_back(&m_rulesForAnyHost);
+    if (!m_rulesByHost.empty() && request.url.has_host()) {
+        std::string host = request.url.host();
+        while (!host.empty()) {
+            auto it = m_rulesByHost.find(host);
+            if (it != m_rulesByHost.end())
+                lists.push_back(&it->second);
+            const size_t dot = host.find('.');
+            if (dot == std::string::npos)
+                break;
+            host.erase(0, dot + 1);
+        }
+    }
+    if (lists.empty())
+        return result;
+    std::vector<size_t> positions(lists.size(), 0);
+
+    const std::string initiatorHost = request.request_initiator
+            ? request.request_initiator->GetTupleOrPrecursorTupleIfOpaque().host()
+            : std::string();
+    // redirects and headers apply in the order of the rules
+    while (true) {
+        size_t next = lists.size();
+        for (size_t i = 0; i < lists.size(); ++i) {
+            if (positions[i] < lists[i]->size()
+                && (next == lists.size() || (*lists[i])[positions[i]] < (*lists[next])[positions[next]]))
+                next = i;
+        }
+        if (next == lists.size())
+            break;
+        const Rule &rule = m_rules[(*lists[next])[positions[next]++]];
+        if (!matches(rule, request, initiatorHost))
+            continue;
+        switch (rule.action) {
+        case QWebEngineUrlRequestRule::Allow:
+            return Result();
+        case QWebEngineUrlRequestRule::Block:
+            result.block = true;
+            break;
+        case QWebEngineUrlRequestRule::Redirect:
+            if (!result.redirectUrl.is_valid())
+                result.redirectUrl = rule.redirectUrl;
+            break;
+        case QWebEngineUrlRequestRule::ModifyHeaders:
+            result.headers.insert(result.headers.end(), rule.headers.begin(), rule.headers.end());
+            break;
+        }
+    }
+    return result;
+}
+
+} // namespace QtWebEngineCore
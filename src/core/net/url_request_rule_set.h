@@ -0,0 +1,103 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtWebEngine module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef URL_REQUEST_RULE_SET_H
+#define URL_REQUEST_RULE_SET_H
+
+#include "url/gurl.h"
+
+#include <QtCore/QList>
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+QT_BEGIN_NAMESPACE
+class QWebEngineUrlRequestRule;
+QT_END_NAMESPACE
+
+namespace network {
+struct ResourceRequest;
+}
+
+namespace QtWebEngineCore {
+
+// The QWebEngineUrlRequestRules of a profile, compiled once into plain
+// Chromium types and indexed by host. Immutable after construction, so it can
+// be shared with the requests in flight while the profile gets a new set.
+class UrlRequestRuleSet
+{
+public:
+    explicit UrlRequestRuleSet(const QList<QWebEngineUrlRequestRule> &rules);
+
+    struct Result
+    {
+        bool block = false;
+        GURL redirectUrl; // valid if the request is to be redirected
+        // headers to set, in order; an empty value removes the header
+        std::vector<std::pair<std::string, std::string>> headers;
+    };
+
+    Result evaluate(const network::ResourceRequest &request) const;
+    bool isEmpty() const { return m_rules.empty(); }
+
+private:
+    struct Rule
+    {
+        int action;
+        std::string urlPattern;
+        std::string initiatorHost;
+        uint64_t resourceTypes = 0; // bit per blink::mojom::ResourceType, 0 for all
+        GURL redirectUrl;
+        std::vector<std::pair<std::string, std::string>> headers;
+    };
+
+    bool matches(const Rule &rule, const network::ResourceRequest &request,
+                 const std::string &initiatorHost) const;
+
+    std::vector<Rule> m_rules;
+    std::unordered_map<std::string, std::vector<size_t>> m_rulesByHost;
+    std::vector<size_t> m_rulesForAnyHost;
+};
+
+} // namespace QtWebEngineCore
+
+#endif // URL_REQUEST_RULE_SET_H
@@ -60,7 +60,9 @@ PdfiumDocumentWrapperQt::PdfiumDocumentWrapperQt(const void *pdfData, size_t siz
     m_pageCount = FPDF_GetPageCount((FPDF_DOCUMENT)m_documentHandle);
 }
 
-QImage PdfiumDocumentWrapperQt::pageAsQImage(size_t pageIndex,int width , int height)
+// Renders the page scaled to \a width x \a height; if \a band is valid, only
+// that part of it is rendered, into an image of the band's size.
+QImage PdfiumDocumentWrapperQt::pageAsQImage(size_t pageIndex,int width , int height, const QRect &band)
 {
     if (!m_documentHandle || !m_pageCount) {
         qWarning("Failure to generate QImage from invalid or empty PDF document.");
@@ -72,17 +74,29 @@ QImage PdfiumDocumentWrapperQt::pageAsQImage(size_t pageIndex,int width , int he
         return QImage();
     }
 
+    const QRect area = band.isValid() ? band.intersected(QRect(0, 0, width, height))
+                                      : QRect(0, 0, width, height);
+    if (area.isEmpty()) {
+        qWarning("Failure to generate QImage from PDF data: band outside of the page.");
+        return QImage();
+    }
+
     FPDF_PAGE pageData(FPDF_LoadPage((FPDF_DOCUMENT)m_documentHandle, pageIndex));
-    QImage image(width, height, QImage::Format_ARGB32);
-    Q_ASSERT(!image.isNull());
+    QImage image(area.size(), QImage::Format_ARGB32);
+    if (image.isNull()) {
+        qWarning("Failure to generate QImage from PDF data: out of memory.");
+        FPDF_ClosePage(pageData);
+        return QImage();
+    }
     image.fill(0xFFFFFFFF);
 
-    FPDF_BITMAP bitmap = FPDFBitmap_CreateEx(width, height,
+    FPDF_BITMAP bitmap = FPDFBitmap_CreateEx(area.width(), area.height(),
                                              FPDFBitmap_BGRA,
                                              image.scanLine(0), image.bytesPerLine());
     Q_ASSERT(bitmap);
+    // the whole page is laid out relative to the band, pdfium clips to the bitmap
     FPDF_RenderPageBitmap(bitmap, pageData,
-                          0, 0, width, height,
+                          -area.x(), -area.y(), width, height,
                           0, 0);
     FPDFBitmap_Destroy(bitmap);
     bitmap = nullptr;
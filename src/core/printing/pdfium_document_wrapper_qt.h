@@ -62,7 +62,7 @@ class Q_WEBENGINECORE_PRIVATE_EXPORT PdfiumDocumentWrapperQt
 public:
     PdfiumDocumentWrapperQt(const void *pdfData, size_t size, const char *password = nullptr);
     virtual ~PdfiumDocumentWrapperQt();
-    QImage pageAsQImage(size_t index, int width , int height);
+    QImage pageAsQImage(size_t index, int width , int height, const QRect &band = QRect());
     QSizeF pageSize(size_t index);
     int pageCount() const { return m_pageCount; }
 
@@ -41,11 +41,133 @@
 
 #include "printing/pdfium_document_wrapper_qt.h"
 
+#include <QList>
+#include <QMutex>
 #include <QPainter>
 #include <QPagedPaintDevice>
+#include <QQueue>
+#include <QSaveFile>
+#include <QScopedPointer>
+#include <QThread>
+#include <QWaitCondition>
 
 namespace QtWebEngineCore {
 
+namespace {
+
+// Pages whose image would be larger than this are rendered and painted in
+// horizontal bands, so that a poster at printer resolution does not need one
+// huge image.
+const qint64 BandingThreshold = 64 * 1024 * 1024;
+const qint64 BandBytes = 16 * 1024 * 1024;
+// How many rendered pages, or bands of large pages, may wait to be painted.
+const int PagesInFlight = 3;
+
+// A page as it is printed, in order; copies are painted one after the other.
+struct PrintedPage
+{
+    int index;
+    QSize size;
+    bool landscape;
+    int copies;
+    int bandHeight; // 0 if the page is rendered as one image
+};
+
+// A rendered page, or one band of it.
+struct RenderedImage
+{
+    QImage image;
+    int top;
+};
+
+// Renders the printed pages ahead in its own thread while the printer thread
+// paints, keeping at most a given number of images in flight. pdfium is not
+// thread-safe, so this is the only thread using the document until it is
+// done; it still takes rasterization off the painting path.
+class PageRasterizer
+{
+public:
+    PageRasterizer(PdfiumDocumentWrapperQt *document, const QList<PrintedPage> &pages, int budget)
+        : m_document(document), m_pages(pages), m_budget(qMax(1, budget))
+    {
+        m_thread.reset(QThread::create([this]() { run(); }));
+        m_thread->setObjectName(QStringLiteral("PrinterRasterizer"));
+        m_thread->start();
+    }
+
+    ~PageRasterizer()
+    {
+        {
+            QMutexLocker locker(&m_mutex);
+            m_cancelled = true;
+            m_notFull.wakeAll();
+        }
+        m_thread->wait();
+    }
+
+    // Blocks until the next image is rendered; returns a null image on failure.
+    RenderedImage take()
+    {
+        QMutexLocker locker(&m_mutex);
+        while (m_queue.isEmpty())
+            m_notEmpty.wait(&m_mutex);
+        RenderedImage image = m_queue.dequeue();
+        m_notFull.wakeOne();
+        return image;
+    }
+
+private:
+    void run()
+    {
+        for (const PrintedPage &page : qAsConst(m_pages)) {
+            if (!page.bandHeight) {
+                // rendered once, however many copies are painted
+                if (!render(page, QRect()))
+                    return;
+                continue;
+            }
+            // bands are not kept around, so each copy renders them again
+            for (int copy = 0; copy < page.copies; ++copy) {
+                for (int top = 0; top < page.size.height(); top += page.bandHeight) {
+                    if (!render(page, QRect(0, top, page.size.width(), page.bandHeight)))
+                        return;
+                }
+            }
+        }
+    }
+
+    bool render(const PrintedPage &page, const QRect &band)
+    {
+        {
+            QMutexLocker locker(&m_mutex);
+            while (m_queue.count() >= m_budget && !m_cancelled)
+                m_notFull.wait(&m_mutex);
+            if (m_cancelled)
+                return false;
+        }
+        RenderedImage rendered { m_document->pageAsQImage(page.index, page.size.width(),
+                                                          page.size.height(), band),
+                                 band.top() };
+        const bool ok = !rendered.image.isNull();
+        QMutexLocker locker(&m_mutex);
+        m_queue.enqueue(std::move(rendered));
+        m_notEmpty.wakeOne();
+        return ok;
+    }
+
+    PdfiumDocumentWrapperQt *m_document;
+    const QList<PrintedPage> m_pages;
+    const int m_budget;
+    QScopedPointer<QThread> m_thread;
+    QMutex m_mutex;
+    QWaitCondition m_notEmpty;
+    QWaitCondition m_notFull;
+    QQueue<RenderedImage> m_queue;
+    bool m_cancelled = false;
+};
+
+} // namespace
+
 PrinterWorker::PrinterWorker(QSharedPointer<QByteArray> data, QPagedPaintDevice *device)
     : m_data(data), m_device(device)
 {
@@ -61,6 +183,11 @@ void PrinterWorker::print()
         return;
     }
 
+    if (!m_pdfOutputFileName.isEmpty()) {
+        Q_EMIT resultReady(writePdf());
+        return;
+    }
+
     PdfiumDocumentWrapperQt pdfiumWrapper(m_data->constData(), m_data->size());
 
     const QPageRanges ranges = m_device->pageRanges();
@@ -74,6 +201,11 @@ void PrinterWorker::print()
     }
     fromPage = qMax(1, fromPage);
     toPage = qMin(pdfiumWrapper.pageCount(), toPage);
+    if (fromPage > toPage) {
+        qWarning("Failed to print: No pages to print.");
+        Q_EMIT resultReady(false);
+        return;
+    }
 
     if (!m_firstPageFirst) {
         qSwap(fromPage, toPage);
@@ -87,55 +219,74 @@ void PrinterWorker::print()
     }
 
     qreal resolution = m_deviceResolution / 72.0; // pdfium uses points so 1/72 inch
+    // the paper size does not depend on the orientation
+    const QRectF pageRect = m_device->pageLayout().pageSize().rectPixels(m_deviceResolution);
+
+    // Lay out all pages up front, so that they can be rendered ahead.
+    QList<PrintedPage> pages;
+    for (int printedDocuments = 0; printedDocuments < m_documentCopies; printedDocuments++) {
+        for (int currentPageIndex = fromPage; true;
+             ascendingOrder ? currentPageIndex++ : currentPageIndex--) {
+            QSizeF documentSize = (pdfiumWrapper.pageSize(currentPageIndex - 1) * resolution);
+            const bool isLandscape = documentSize.width() > documentSize.height();
+            const QSize size = documentSize.scaled(pageRect.size(), Qt::KeepAspectRatio).toSize();
+            const qint64 bytesPerLine = qint64(size.width()) * 4;
+            int bandHeight = 0;
+            if (bytesPerLine * size.height() > BandingThreshold)
+                bandHeight = qMax<qint64>(1, BandBytes / qMax<qint64>(1, bytesPerLine));
+            pages.append({ currentPageIndex - 1, size, isLandscape, pageCopies, bandHeight });
+            if (currentPageIndex == toPage)
+                break;
+        }
+    }
 
+    PageRasterizer rasterizer(&pdfiumWrapper, pages, PagesInFlight);
     QPainter painter;
 
-    for (int printedDocuments = 0; printedDocuments < m_documentCopies; printedDocuments++) {
-        if (printedDocuments > 0)
-            m_device->newPage();
+    for (int i = 0; i < pages.count(); i++) {
+        const PrintedPage &page = pages.at(i);
+        m_device->setPageOrientation(page.landscape ? QPageLayout::Landscape
+                                                    : QPageLayout::Portrait);
 
-        int currentPageIndex = fromPage;
+        // setPageOrientation has to be called before qpainter.begin() or before
+        // qprinter.newPage() so correct metrics is used, therefore call begin now for only
+        // first page
+        if (!painter.isActive() && !painter.begin(m_device)) {
+            qWarning("Failure to print on device: Could not open printer for painting.");
+            Q_EMIT resultReady(false);
+            return;
+        }
 
-        for (int i = 0; true; i++) {
-            QSizeF documentSize = (pdfiumWrapper.pageSize(currentPageIndex - 1) * resolution);
-            bool isLandscape = documentSize.width() > documentSize.height();
-            m_device->setPageOrientation(isLandscape ? QPageLayout::Landscape
-                                                      : QPageLayout::Portrait);
-            QRectF pageRect = m_device->pageLayout().pageSize().rectPixels(m_deviceResolution);
-            documentSize = documentSize.scaled(pageRect.size(), Qt::KeepAspectRatio);
-
-            // setPageOrientation has to be called before qpainter.begin() or before
-            // qprinter.newPage() so correct metrics is used, therefore call begin now for only
-            // first page
-            if (!painter.isActive() && !painter.begin(m_device)) {
-                qWarning("Failure to print on device: Could not open printer for painting.");
-                Q_EMIT resultReady(false);
-                return;
-            }
+        if (i > 0)
+            m_device->newPage();
 
-            if (i > 0)
+        QImage currentImage;
+        for (int printedPages = 0; printedPages < page.copies; printedPages++) {
+            if (printedPages > 0)
                 m_device->newPage();
 
-            for (int printedPages = 0; printedPages < pageCopies; printedPages++) {
-                if (printedPages > 0)
-                    m_device->newPage();
+            if (page.bandHeight) {
+                for (int top = 0; top < page.size.height(); top += page.bandHeight) {
+                    const RenderedImage band = rasterizer.take();
+                    if (band.image.isNull()) {
+                        painter.end();
+                        Q_EMIT resultReady(false);
+                        return;
+                    }
+                    painter.drawImage(0, band.top, band.image);
+                }
+                continue;
+            }
 
-                QImage currentImage = pdfiumWrapper.pageAsQImage(
-                        currentPageIndex - 1, documentSize.width(), documentSize.height());
+            if (currentImage.isNull()) {
+                currentImage = rasterizer.take().image;
                 if (currentImage.isNull()) {
+                    painter.end();
                     Q_EMIT resultReady(false);
                     return;
                 }
-                painter.drawImage(0, 0, currentImage);
             }
-
-            if (currentPageIndex == toPage)
-                break;
-
-            if (ascendingOrder)
-                currentPageIndex++;
-            else
-                currentPageIndex--;
+            painter.drawImage(0, 0, currentImage);
         }
     }
     painter.end();
@@ -144,4 +295,16 @@ void PrinterWorker::print()
     return;
 }
 
+bool PrinterWorker::writePdf()
+{
+    QSaveFile file(m_pdfOutputFileName);
+    if (!file.open(QIODevice::WriteOnly) || file.write(*m_data) != m_data->size()
+        || !file.commit()) {
+        qWarning("Failed to print to %ls: %ls", qUtf16Printable(m_pdfOutputFileName),
+                 qUtf16Printable(file.errorString()));
+        return false;
+    }
+    return true;
+}
+
 } // namespace QtWebEngineCore
@@ -55,6 +55,7 @@
 
 #include <QtCore/qobject.h>
 #include <QtCore/qsharedpointer.h>
+#include <QtCore/qstring.h>
 
 QT_BEGIN_NAMESPACE
 class QPagedPaintDevice;
@@ -73,6 +74,9 @@ public:
     bool m_firstPageFirst;
     int m_documentCopies;
     bool m_collateCopies;
+    // if set, the PDF is written to this file as it is instead of being
+    // rasterized onto the device, keeping its vector content
+    QString m_pdfOutputFileName;
 
 public Q_SLOTS:
     void print();
@@ -83,6 +87,8 @@ Q_SIGNALS:
 private:
     Q_DISABLE_COPY(PrinterWorker)
 
+    bool writePdf();
+
     QSharedPointer<QByteArray> m_data;
     QPagedPaintDevice *m_device;
 };
@@ -42,6 +42,7 @@
 #include "base/files/file_util.h"
 #include "base/task/cancelable_task_tracker.h"
 #include "base/threading/thread_restrictions.h"
+#include "base/threading/thread_task_runner_handle.h"
 #include "base/time/time_to_iso8601.h"
 #include "components/favicon/core/favicon_service.h"
 #include "components/history/content/browser/history_database_helper.h"
@@ -58,7 +59,10 @@
 #include "api/qwebengineurlscheme.h"
 #include "content_browser_client_qt.h"
 #include "download_manager_delegate_qt.h"
+#include "favicon_cache_qt.h"
 #include "favicon_service_factory_qt.h"
+#include "net/url_request_custom_job_proxy.h"
+#include "net/url_request_rule_set.h"
 #include "permission_manager_qt.h"
 #include "profile_adapter_client.h"
 #include "profile_io_data_qt.h"
@@ -101,6 +105,7 @@ ProfileAdapter::ProfileAdapter(const QString &storageName):
     , m_visitedLinksPolicy(TrackVisitedLinksOnDisk)
     , m_httpCacheMaxSize(0)
 {
+    m_faviconCache.reset(new FaviconCacheQt);
     WebEngineContext::current()->addProfileAdapter(this);
     // creation of profile requires webengine context
     m_profile.reset(new ProfileQt(this));
@@ -116,6 +121,8 @@ ProfileAdapter::ProfileAdapter(const QString &storageName):
 
 ProfileAdapter::~ProfileAdapter()
 {
+    for (const auto &handler : qAsConst(m_threadSafeUrlSchemeHandlers))
+        handler->revoke();
     m_cancelableTaskTracker->TryCancelAll();
     m_profile->NotifyWillBeDestroyed();
     while (!m_webContentsAdapterClients.isEmpty()) {
@@ -225,6 +232,16 @@ void ProfileAdapter::setRequestInterceptor(QWebEngineUrlRequestInterceptor *inte
     m_requestInterceptor = interceptor;
 }
 
+void ProfileAdapter::setRequestRules(const QList<QWebEngineUrlRequestRule> &rules)
+{
+    m_requestRules = rules;
+    // Requests in flight keep the rule set they started with.
+    if (rules.isEmpty())
+        m_requestRuleSet.reset();
+    else
+        m_requestRuleSet.reset(new UrlRequestRuleSet(rules));
+}
+
 void ProfileAdapter::addClient(ProfileAdapterClient *adapterClient)
 {
     m_clients.append(adapterClient);
@@ -255,6 +272,11 @@ void ProfileAdapter::removeDownload(quint32 downloadId)
     downloadManagerDelegate()->removeDownload(downloadId);
 }
 
+void ProfileAdapter::setDownloadProgressUpdateInterval(quint32 downloadId, int msec)
+{
+    downloadManagerDelegate()->setProgressUpdateInterval(downloadId, msec);
+}
+
 ProfileAdapter *ProfileAdapter::createDefaultProfileAdapter()
 {
     return WebEngineContext::current()->createDefaultProfileAdapter();
@@ -496,8 +518,40 @@ const QList<QByteArray> ProfileAdapter::customUrlSchemes() const
     return m_customUrlSchemeHandlers.keys();
 }
 
+/*
+    Returns the handler of a scheme registered with
+    QWebEngineUrlScheme::ThreadSafeHandler, as shared with the thread it is
+    called on, or null if the scheme is not thread-safe or has no handler.
+*/
+QSharedPointer<ThreadSafeUrlSchemeHandler> ProfileAdapter::threadSafeUrlSchemeHandler(const QByteArray &scheme)
+{
+    const QByteArray canonicalScheme = scheme.toLower();
+    if (!QWebEngineUrlScheme::schemeByName(canonicalScheme).flags().testFlag(QWebEngineUrlScheme::ThreadSafeHandler))
+        return nullptr;
+    QWebEngineUrlSchemeHandler *handler = urlSchemeHandler(canonicalScheme);
+    if (!handler)
+        return nullptr;
+
+    QSharedPointer<ThreadSafeUrlSchemeHandler> &shared = m_threadSafeUrlSchemeHandlers[canonicalScheme];
+    if (!shared || shared->handler() != handler) {
+        if (shared)
+            shared->revoke();
+        shared.reset(new ThreadSafeUrlSchemeHandler(handler));
+    }
+    return shared;
+}
+
 void ProfileAdapter::updateCustomUrlSchemeHandlers()
 {
+    // requests in flight must not reach handlers that have been removed
+    for (auto it = m_threadSafeUrlSchemeHandlers.begin(); it != m_threadSafeUrlSchemeHandlers.end();) {
+        if (urlSchemeHandler(it.key()) != it.value()->handler()) {
+            it.value()->revoke();
+            it = m_threadSafeUrlSchemeHandlers.erase(it);
+        } else {
+            ++it;
+        }
+    }
     m_profile->ForEachStoragePartition(
         base::BindRepeating([](content::StoragePartition *storage_partition) {
             storage_partition->ResetURLLoaderFactories();
@@ -572,7 +626,7 @@ void ProfileAdapter::removeAllUrlSchemeHandlers()
 UserResourceControllerHost *ProfileAdapter::userResourceController()
 {
     if (!m_userResourceController)
-        m_userResourceController.reset(new UserResourceControllerHost);
+        m_userResourceController.reset(new UserResourceControllerHost(this));
     return m_userResourceController.data();
 }
 
@@ -727,7 +781,27 @@ QWebEngineClientCertificateStore *ProfileAdapter::clientCertificateStore()
 }
 #endif
 
+// Decodes the bitmap of a favicon database result, unless the profile's icon cache
+// already holds the icon for the same icon URL and pixel size.
+static QIcon iconFromRawBitmapResult(ProfileAdapter *profileAdapter,
+                                     const favicon_base::FaviconRawBitmapResult &result,
+                                     bool countLookup)
+{
+    FaviconCacheQt *cache = profileAdapter->faviconCache();
+    const QUrl iconUrl = toQt(result.icon_url);
+    const int pixelSize = result.pixel_size.width();
+    QIcon icon = countLookup ? cache->find(iconUrl, pixelSize) : cache->peek(iconUrl, pixelSize);
+    if (icon.isNull()) {
+        QPixmap pixmap(toQt(result.pixel_size));
+        pixmap.loadFromData(result.bitmap_data->data(), result.bitmap_data->size());
+        icon = QIcon(pixmap);
+        cache->insert(iconUrl, pixelSize, icon);
+    }
+    return icon;
+}
+
 static void callbackOnIconAvailableForPageURL(std::function<void (const QIcon &, const QUrl &, const QUrl &)> iconAvailableCallback,
+                                              ProfileAdapter *profileAdapter,
                                               const QUrl &pageUrl,
                                               const favicon_base::FaviconRawBitmapResult &result)
 {
@@ -735,9 +809,7 @@ static void callbackOnIconAvailableForPageURL(std::function<void (const QIcon &,
         iconAvailableCallback(QIcon(), toQt(result.icon_url), pageUrl);
         return;
     }
-    QPixmap pixmap(toQt(result.pixel_size));
-    pixmap.loadFromData(result.bitmap_data->data(), result.bitmap_data->size());
-    iconAvailableCallback(QIcon(pixmap), toQt(result.icon_url), pageUrl);
+    iconAvailableCallback(iconFromRawBitmapResult(profileAdapter, result, true), toQt(result.icon_url), pageUrl);
 }
 
 void ProfileAdapter::requestIconForPageURL(const QUrl &pageUrl,
@@ -749,7 +821,7 @@ void ProfileAdapter::requestIconForPageURL(const QUrl &pageUrl,
     favicon::FaviconService *service = FaviconServiceFactoryQt::GetForBrowserContext(m_profile.data());
 
     if (!service->HistoryService()) {
-        callbackOnIconAvailableForPageURL(iconAvailableCallback, pageUrl,
+        callbackOnIconAvailableForPageURL(iconAvailableCallback, this, pageUrl,
                                           favicon_base::FaviconRawBitmapResult());
         return;
     }
@@ -762,7 +834,7 @@ void ProfileAdapter::requestIconForPageURL(const QUrl &pageUrl,
     }
     service->GetRawFaviconForPageURL(
             toGurl(pageUrl), types, desiredSizeInPixel, true /* fallback_to_host */,
-            base::BindOnce(&callbackOnIconAvailableForPageURL, iconAvailableCallback, pageUrl),
+            base::BindOnce(&callbackOnIconAvailableForPageURL, iconAvailableCallback, this, pageUrl),
             m_cancelableTaskTracker.get());
 }
 
@@ -794,9 +866,12 @@ static void callbackOnIconAvailableForIconURL(std::function<void (const QIcon &,
         iconAvailableCallback(QIcon(), iconUrl);
         return;
     }
-    QPixmap pixmap(toQt(result.pixel_size));
-    pixmap.loadFromData(result.bitmap_data->data(), result.bitmap_data->size());
-    iconAvailableCallback(QIcon(pixmap), toQt(result.icon_url));
+    // The lookup under the requested size was already counted by requestIconForIconURL().
+    const QIcon icon = iconFromRawBitmapResult(profileAdapter, result, false);
+    // Also remember the icon under the requested size, so that repeated requests
+    // for this icon URL are answered without querying the favicon database.
+    profileAdapter->faviconCache()->insert(iconUrl, desiredSizeInPixel, icon);
+    iconAvailableCallback(icon, toQt(result.icon_url));
 }
 
 void ProfileAdapter::requestIconForIconURL(const QUrl &iconUrl,
@@ -805,6 +880,17 @@ void ProfileAdapter::requestIconForIconURL(const QUrl &iconUrl,
                                            std::function<void (const QIcon &, const QUrl &)> iconAvailableCallback)
 {
     DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+    const QIcon cachedIcon = m_faviconCache->find(iconUrl, desiredSizeInPixel);
+    if (!cachedIcon.isNull()) {
+        // Still answer asynchronously, as documented for the public API.
+        m_cancelableTaskTracker->PostTask(
+                base::ThreadTaskRunnerHandle::Get().get(), FROM_HERE,
+                base::BindOnce([](std::function<void (const QIcon &, const QUrl &)> callback,
+                               const QIcon &icon, const QUrl &url) { callback(icon, url); },
+                               iconAvailableCallback, cachedIcon, iconUrl));
+        return;
+    }
+
     favicon::FaviconService *service = FaviconServiceFactoryQt::GetForBrowserContext(m_profile.data());
 
     if (!service->HistoryService()) {
@@ -63,6 +63,7 @@
 #include <QtWebEngineCore/qwebengineclientcertificatestore.h>
 #include <QtWebEngineCore/qwebenginecookiestore.h>
 #include <QtWebEngineCore/qwebengineurlrequestinterceptor.h>
+#include <QtWebEngineCore/qwebengineurlrequestrule.h>
 #include <QtWebEngineCore/qwebengineurlschemehandler.h>
 #include "net/qrc_url_scheme_handler.h"
 
@@ -76,8 +77,11 @@ namespace QtWebEngineCore {
 
 class UserNotificationController;
 class DownloadManagerDelegateQt;
+class FaviconCacheQt;
 class ProfileAdapterClient;
 class ProfileQt;
+class ThreadSafeUrlSchemeHandler;
+class UrlRequestRuleSet;
 class UserResourceControllerHost;
 class VisitedLinksManagerQt;
 class WebContentsAdapterClient;
@@ -100,6 +104,10 @@ public:
     QWebEngineUrlRequestInterceptor* requestInterceptor();
     void setRequestInterceptor(QWebEngineUrlRequestInterceptor *interceptor);
 
+    QList<QWebEngineUrlRequestRule> requestRules() const { return m_requestRules; }
+    void setRequestRules(const QList<QWebEngineUrlRequestRule> &rules);
+    QSharedPointer<const UrlRequestRuleSet> requestRuleSet() const { return m_requestRuleSet; }
+
     QList<ProfileAdapterClient*> clients() { return m_clients; }
     void addClient(ProfileAdapterClient *adapterClient);
     void removeClient(ProfileAdapterClient *adapterClient);
@@ -108,6 +116,7 @@ public:
     void pauseDownload(quint32 downloadId);
     void resumeDownload(quint32 downloadId);
     void removeDownload(quint32 downloadId);
+    void setDownloadProgressUpdateInterval(quint32 downloadId, int msec);
 
     ProfileQt *profile();
     bool ensureDataPathExists();
@@ -190,6 +199,7 @@ public:
     bool trackVisitedLinks() const;
 
     QWebEngineUrlSchemeHandler *urlSchemeHandler(const QByteArray &scheme);
+    QSharedPointer<ThreadSafeUrlSchemeHandler> threadSafeUrlSchemeHandler(const QByteArray &scheme);
     void installUrlSchemeHandler(const QByteArray &scheme, QWebEngineUrlSchemeHandler *handler);
     void removeUrlScheme(const QByteArray &scheme);
     void removeUrlSchemeHandler(QWebEngineUrlSchemeHandler *handler);
@@ -223,6 +233,7 @@ public:
     void requestIconForIconURL(const QUrl &iconUrl, int desiredSizeInPixel, bool touchIconsEnabled,
                                std::function<void (const QIcon &, const QUrl &)> iconAvailableCallback);
     base::CancelableTaskTracker *cancelableTaskTracker() { return m_cancelableTaskTracker.get(); }
+    FaviconCacheQt *faviconCache() { return m_faviconCache.data(); }
 
 private:
     void updateCustomUrlSchemeHandlers();
@@ -237,10 +248,13 @@ private:
     QScopedPointer<DownloadManagerDelegateQt> m_downloadManagerDelegate;
     QScopedPointer<UserResourceControllerHost> m_userResourceController;
     QScopedPointer<QWebEngineCookieStore> m_cookieStore;
+    QScopedPointer<FaviconCacheQt> m_faviconCache;
 #if QT_CONFIG(ssl)
     QWebEngineClientCertificateStore *m_clientCertificateStore = nullptr;
 #endif
     QPointer<QWebEngineUrlRequestInterceptor> m_requestInterceptor;
+    QList<QWebEngineUrlRequestRule> m_requestRules;
+    QSharedPointer<const UrlRequestRuleSet> m_requestRuleSet;
 
     QString m_dataPath;
     QString m_downloadPath;
@@ -251,6 +265,7 @@ private:
     PersistentCookiesPolicy m_persistentCookiesPolicy;
     VisitedLinksPolicy m_visitedLinksPolicy;
     QHash<QByteArray, QPointer<QWebEngineUrlSchemeHandler>> m_customUrlSchemeHandlers;
+    QHash<QByteArray, QSharedPointer<ThreadSafeUrlSchemeHandler>> m_threadSafeUrlSchemeHandlers;
     QHash<QByteArray, QWeakPointer<UserNotificationController>> m_ephemeralNotifications;
     QHash<QByteArray, QSharedPointer<UserNotificationController>> m_persistentNotifications;
 
@@ -206,7 +206,7 @@ void ProfileIODataQt::resetNetworkContext()
             }));
 }
 
-bool ProfileIODataQt::canGetCookies(const QUrl &firstPartyUrl, const QUrl &url) const
+bool ProfileIODataQt::canGetCookies(const GURL &firstPartyUrl, const GURL &url) const
 {
     return m_cookieDelegate->canGetCookies(firstPartyUrl, url);
 }
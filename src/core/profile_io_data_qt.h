@@ -43,6 +43,7 @@
 #include "content/public/browser/browsing_data_remover.h"
 #include "chrome/browser/profiles/profile.h"
 #include "extensions/buildflags/buildflags.h"
+#include "url/gurl.h"
 
 #include "net/proxy_config_monitor.h"
 #include "profile_adapter.h"
@@ -100,7 +101,7 @@ public:
     void initializeOnUIThread(); // runs on ui thread
     void shutdownOnUIThread(); // runs on ui thread
 
-    bool canGetCookies(const QUrl &firstPartyUrl, const QUrl &url) const;
+    bool canGetCookies(const GURL &firstPartyUrl, const GURL &url) const;
 
     void setFullConfiguration(); // runs on ui thread
     void resetNetworkContext(); // runs on ui thread
@@ -41,26 +41,25 @@
 
 #include "base/memory/weak_ptr.h"
 #include "base/pending_task.h"
-#include "base/strings/pattern.h"
 #include "content/public/renderer/render_frame.h"
+#include "content/public/renderer/render_thread.h"
 #include "content/public/renderer/render_view.h"
 #include "content/public/renderer/render_frame_observer.h"
-#include "extensions/common/url_pattern.h"
+#include "ipc/ipc_message_macros.h"
+#include "third_party/blink/public/web/blink.h"
 #include "third_party/blink/public/web/web_document.h"
 #include "third_party/blink/public/web/web_local_frame.h"
-#include "third_party/blink/public/web/web_script_source.h"
 #include "third_party/blink/public/web/web_view.h"
 #include "v8/include/v8.h"
 #include "mojo/public/cpp/bindings/associated_receiver.h"
 #include "third_party/blink/public/common/associated_interfaces/associated_interface_provider.h"
 #include "third_party/blink/public/common/associated_interfaces/associated_interface_registry.h"
 
+#include "common/qt_messages.h"
 #include "qtwebengine/userscript/user_script_data.h"
 #include "type_conversion.h"
 #include "user_script.h"
 
-#include <QRegularExpression>
-
 #include <bitset>
 
 namespace QtWebEngineCore {
@@ -70,69 +69,6 @@ static content::RenderFrame *const globalScriptsIndex = nullptr;
 // Scripts meant to run after the load event will be run 500ms after DOMContentLoaded if the load event doesn't come within that delay.
 static const int afterLoadTimeout = 500;
 
-static int validUserScriptSchemes()
-{
-    return URLPattern::SCHEME_HTTP | URLPattern::SCHEME_HTTPS | URLPattern::SCHEME_FILE | URLPattern::SCHEME_QRC;
-}
-
-static bool regexMatchesURL(const std::string &pat, const GURL &url)
-{
-    QRegularExpression qre(QtWebEngineCore::toQt(pat));
-    qre.setPatternOptions(QRegularExpression::CaseInsensitiveOption);
-    if (!qre.isValid())
-        return false;
-    return qre.match(QtWebEngineCore::toQt(url.spec())).hasMatch();
-}
-
-static bool includeRuleMatchesURL(const std::string &pat, const GURL &url)
-{
-    // Match patterns for greasemonkey's @include and @exclude rules which can
-    // be either strings with wildcards or regular expressions.
-    if (pat.front() == '/' && pat.back() == '/') {
-        std::string re(++pat.cbegin(), --pat.cend());
-        if (regexMatchesURL(re, url))
-            return true;
-    } else if (base::MatchPattern(url.spec(), pat)) {
-        return true;
-    }
-    return false;
-}
-
-static bool scriptMatchesURL(const QtWebEngineCore::UserScriptData &scriptData, const GURL &url)
-{
-    // Logic taken from Chromium (extensions/common/user_script.cc)
-    bool matchFound;
-    if (!scriptData.urlPatterns.empty()) {
-        matchFound = false;
-        for (auto it = scriptData.urlPatterns.begin(), end = scriptData.urlPatterns.end(); it != end; ++it) {
-            URLPattern urlPattern(validUserScriptSchemes());
-            if (urlPattern.Parse(*it) == URLPattern::ParseResult::kSuccess && urlPattern.MatchesURL(url))
-                matchFound = true;
-        }
-        if (!matchFound)
-            return false;
-    }
-
-    if (!scriptData.globs.empty()) {
-        matchFound = false;
-        for (auto it = scriptData.globs.begin(), end = scriptData.globs.end(); it != end; ++it) {
-            if (includeRuleMatchesURL(*it, url))
-                matchFound = true;
-        }
-        if (!matchFound)
-            return false;
-    }
-
-    if (!scriptData.excludeGlobs.empty()) {
-        for (auto it = scriptData.excludeGlobs.begin(), end = scriptData.excludeGlobs.end(); it != end; ++it) {
-            if (includeRuleMatchesURL(*it, url))
-                return false;
-        }
-    }
-
-    return true;
-}
-
 // using UserScriptDataPtr = mojo::StructPtr<qtwebengine::mojom::UserScriptData>;
 
 class UserResourceController::RenderFrameObserverHelper
@@ -198,18 +134,88 @@ void UserResourceController::runScripts(QtWebEngineCore::UserScriptData::Injecti
 
     QList<uint64_t> scriptsToRun = m_frameUserScriptMap.value(globalScriptsIndex);
     scriptsToRun.append(m_frameUserScriptMap.value(renderFrame));
+    if (scriptsToRun.isEmpty())
+        return;
+
+    const QSet<uint64_t> matchingScripts = m_scripts.matchingScripts(frame->GetDocument().Url(), p, isMainFrame);
+    if (matchingScripts.isEmpty())
+        return;
 
     for (uint64_t id : qAsConst(scriptsToRun)) {
-        const QtWebEngineCore::UserScriptData &script = m_scripts.value(id);
-        if (script.injectionPoint != p || (!script.injectForSubframes && !isMainFrame))
-            continue;
-        if (!scriptMatchesURL(script, frame->GetDocument().Url()))
-            continue;
-        blink::WebScriptSource source(blink::WebString::FromUTF8(script.source), script.url);
-        if (script.worldId)
-            frame->ExecuteScriptInIsolatedWorld(script.worldId, source, blink::BackForwardCacheAware::kAllow); // FIXME, check
-        else
-            frame->ExecuteScript(source);
+        if (matchingScripts.contains(id))
+            executeScript(frame, id);
+    }
+}
+
+// Scripts are compiled with V8 directly, because blink::WebScriptSource
+// cannot carry cached data. Within a process, V8 finds the compiled code of
+// an identical source and URL in its compilation cache; the code cache from
+// the host saves compiling a script in every new process.
+void UserResourceController::executeScript(blink::WebLocalFrame *frame, uint64_t scriptId)
+{
+    const QtWebEngineCore::UserScriptData &script = m_scripts.script(scriptId);
+    v8::Isolate *isolate = blink::MainThreadIsolate();
+    v8::HandleScope handleScope(isolate);
+    v8::Local<v8::Context> context = script.worldId
+            ? frame->GetScriptContextFromWorldId(isolate, script.worldId)
+            : frame->MainWorldScriptContext();
+    if (context.IsEmpty())
+        return;
+    v8::Context::Scope contextScope(context);
+    v8::MicrotasksScope microtasks(isolate, context->GetMicrotaskQueue(),
+                                   v8::MicrotasksScope::kRunMicrotasks);
+    v8::TryCatch tryCatch(isolate);
+    tryCatch.SetVerbose(true); // uncaught exceptions are reported to the console
+
+    // The source was decoded once, and is shared with the matcher.
+    const blink::WebString source = m_scripts.source(scriptId);
+    v8::Local<v8::String> code;
+    const bool decoded = source.Is8Bit()
+            ? v8::String::NewFromOneByte(isolate, source.Data8(), v8::NewStringType::kNormal,
+                                         int(source.length())).ToLocal(&code)
+            : v8::String::NewFromTwoByte(isolate, reinterpret_cast<const uint16_t *>(source.Data16()),
+                                         v8::NewStringType::kNormal, int(source.length())).ToLocal(&code);
+    if (!decoded)
+        return;
+    const std::string url = script.url.spec();
+    v8::Local<v8::String> resourceName =
+            v8::String::NewFromUtf8(isolate, url.data(), v8::NewStringType::kNormal, int(url.size()))
+                    .ToLocalChecked();
+    v8::ScriptOrigin origin(isolate, resourceName);
+
+    v8::ScriptCompiler::CachedData *cachedData = nullptr;
+    auto cache = m_codeCaches.find(scriptId);
+    if (cache != m_codeCaches.end()) {
+        cachedData = new v8::ScriptCompiler::CachedData(cache->second.GetMemoryAs<uint8_t>(),
+                                                        int(cache->second.size()),
+                                                        v8::ScriptCompiler::CachedData::BufferNotOwned);
+    }
+    v8::ScriptCompiler::Source compilerSource(code, origin, cachedData); // owns cachedData
+    v8::Local<v8::Script> compiled;
+    if (!v8::ScriptCompiler::Compile(context, &compilerSource,
+                                     cachedData ? v8::ScriptCompiler::kConsumeCodeCache
+                                                : v8::ScriptCompiler::kNoCompileOptions)
+                 .ToLocal(&compiled)) {
+        return;
+    }
+    // A cache made by another version of V8, or with other flags, is rejected.
+    const bool produceCache = !cachedData || compilerSource.GetCachedData()->rejected;
+    if (cachedData && compilerSource.GetCachedData()->rejected)
+        m_codeCaches.erase(cache);
+
+    v8::Local<v8::Value> result;
+    if (!compiled->Run(context).ToLocal(&result))
+        return;
+
+    // After running, the cache includes the functions that ran.
+    if (produceCache && !m_producedCodeCaches.contains(scriptId)) {
+        std::unique_ptr<v8::ScriptCompiler::CachedData> produced(
+                v8::ScriptCompiler::CreateCodeCache(compiled->GetUnboundScript()));
+        if (produced && produced->length > 0) {
+            content::RenderThread::Get()->Send(new QtWebEngineHostMsg_StoreUserScriptCodeCache(
+                    scriptId, std::vector<uint8_t>(produced->data, produced->data + produced->length)));
+            m_producedCodeCaches.insert(scriptId);
+        }
     }
 }
 
@@ -332,7 +338,7 @@ void UserResourceController::renderFrameDestroyed(content::RenderFrame *renderFr
     if (it == m_frameUserScriptMap.end()) // ASSERT maybe?
         return;
     for (uint64_t id : qAsConst(it.value())) {
-        m_scripts.remove(id);
+        m_scripts.removeScript(id);
     }
     m_frameUserScriptMap.remove(renderFrame);
 }
@@ -346,7 +352,7 @@ void UserResourceController::addScriptForFrame(const QtWebEngineCore::UserScript
 
     if (!(*it).contains(script.scriptId))
         (*it).append(script.scriptId);
-    m_scripts.insert(script.scriptId, script);
+    m_scripts.addScript(script);
 }
 
 void UserResourceController::removeScriptForFrame(const QtWebEngineCore::UserScriptData &script,
@@ -357,7 +363,7 @@ void UserResourceController::removeScriptForFrame(const QtWebEngineCore::UserScr
         return;
 
     (*it).removeOne(script.scriptId);
-    m_scripts.remove(script.scriptId);
+    m_scripts.removeScript(script.scriptId);
 }
 
 void UserResourceController::clearScriptsForFrame(content::RenderFrame *frame)
@@ -366,7 +372,7 @@ void UserResourceController::clearScriptsForFrame(content::RenderFrame *frame)
     if (it == m_frameUserScriptMap.end())
         return;
     for (uint64_t id : qAsConst(it.value()))
-        m_scripts.remove(id);
+        m_scripts.removeScript(id);
 
     m_frameUserScriptMap.remove(frame);
 }
@@ -386,6 +392,24 @@ void UserResourceController::ClearScripts()
     clearScriptsForFrame(globalScriptsIndex);
 }
 
+bool UserResourceController::OnControlMessageReceived(const IPC::Message &message)
+{
+    bool handled = true;
+    IPC_BEGIN_MESSAGE_MAP(UserResourceController, message)
+        IPC_MESSAGE_HANDLER(QtWebEngineMsg_SetUserScriptCodeCache, OnSetUserScriptCodeCache)
+        IPC_MESSAGE_UNHANDLED(handled = false)
+    IPC_END_MESSAGE_MAP()
+    return handled;
+}
+
+void UserResourceController::OnSetUserScriptCodeCache(uint64_t scriptId,
+                                                       base::ReadOnlySharedMemoryRegion data)
+{
+    base::ReadOnlySharedMemoryMapping mapping = data.Map();
+    if (mapping.IsValid())
+        m_codeCaches[scriptId] = std::move(mapping);
+}
+
 void UserResourceController::RegisterMojoInterfaces(
         blink::AssociatedInterfaceRegistry *associated_interfaces)
 {
@@ -40,14 +40,18 @@
 #ifndef USER_RESOURCE_CONTROLLER_H
 #define USER_RESOURCE_CONTROLLER_H
 
+#include "base/memory/read_only_shared_memory_region.h"
 #include "content/public/renderer/render_thread_observer.h"
 #include "qtwebengine/userscript/userscript.mojom.h"
 #include "qtwebengine/userscript/user_script_data.h"
+#include "renderer/user_script_matcher.h"
 #include "mojo/public/cpp/bindings/associated_receiver.h"
 
 #include <QtCore/QHash>
 #include <QtCore/QSet>
 
+#include <map>
+
 namespace blink {
 class WebLocalFrame;
 }
@@ -79,9 +83,12 @@ private:
     Q_DISABLE_COPY(UserResourceController)
 
     // content::RenderThreadObserver:
+    bool OnControlMessageReceived(const IPC::Message &message) override;
     void RegisterMojoInterfaces(blink::AssociatedInterfaceRegistry *associated_interfaces) override;
     void UnregisterMojoInterfaces(blink::AssociatedInterfaceRegistry *associated_interfaces) override;
 
+    void OnSetUserScriptCodeCache(uint64_t scriptId, base::ReadOnlySharedMemoryRegion data);
+
     class RenderFrameObserverHelper;
     class RenderViewObserverHelper;
 
@@ -90,11 +97,16 @@ private:
     void ClearScripts() override;
 
     void runScripts(QtWebEngineCore::UserScriptData::InjectionPoint, blink::WebLocalFrame *);
+    void executeScript(blink::WebLocalFrame *, uint64_t scriptId);
 
     typedef QList<uint64_t> UserScriptSet;
     typedef QHash<const content::RenderFrame *, UserScriptSet> FrameUserScriptMap;
     FrameUserScriptMap m_frameUserScriptMap;
-    QHash<uint64_t, QtWebEngineCore::UserScriptData> m_scripts;
+    UserScriptMatcher m_scripts;
+    // Code caches are kept for the lifetime of the process, as the host only
+    // sends them once, but per-page scripts are sent again for every frame.
+    std::map<uint64_t, base::ReadOnlySharedMemoryMapping> m_codeCaches;
+    QSet<uint64_t> m_producedCodeCaches; // sent to the host already
     mojo::AssociatedReceiver<qtwebengine::mojom::UserResourceController> m_binding;
     friend class RenderFrameObserverHelper;
 };
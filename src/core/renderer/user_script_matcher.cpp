@@ -0,0 +1,256 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtWebEngine module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "user_script_matcher.h"
+
+#include "base/strings/pattern.h"
+#include "url/gurl.h"
+
+#include "type_conversion.h"
+
+namespace QtWebEngineCore {
+
+static int validUserScriptSchemes()
+{
+    return URLPattern::SCHEME_HTTP | URLPattern::SCHEME_HTTPS | URLPattern::SCHEME_FILE | URLPattern::SCHEME_QRC;
+}
+
+// Whether the pattern only matches URLs on its host or on its subdomains.
+static bool isIndexable(const URLPattern &pattern)
+{
+    if (pattern.match_all_urls() || pattern.host().empty())
+        return false;
+    const std::string &scheme = pattern.scheme();
+    return scheme == "http" || scheme == "https" || scheme == "*";
+}
+
+UserScriptMatcher::Rule::Rule(const std::string &pattern)
+{
+    // Match patterns for greasemonkey's @include and @exclude rules which can
+    // be either strings with wildcards or regular expressions.
+    if (pattern.size() >= 2 && pattern.front() == '/' && pattern.back() == '/') {
+        isRegex = true;
+        regex.setPattern(toQt(std::string(++pattern.cbegin(), --pattern.cend())));
+        regex.setPatternOptions(QRegularExpression::CaseInsensitiveOption);
+        regex.optimize();
+    } else {
+        glob = pattern;
+    }
+}
+
+bool UserScriptMatcher::Rule::matches(const std::string &spec, const QString &qSpec) const
+{
+    if (!isRegex)
+        return base::MatchPattern(spec, glob);
+    return regex.isValid() && regex.match(qSpec).hasMatch();
+}
+
+bool UserScriptMatcher::CompiledScript::matches(const GURL &url, const QString &qSpec) const
+{
+    // Logic taken from Chromium (extensions/common/user_script.cc)
+    if (!data.urlPatterns.empty()) {
+        bool matchFound = false;
+        for (const URLPattern &pattern : urlPatterns) {
+            if (pattern.MatchesURL(url)) {
+                matchFound = true;
+                break;
+            }
+        }
+        if (!matchFound)
+            return false;
+    }
+
+    if (!includes.empty()) {
+        bool matchFound = false;
+        for (const Rule &rule : includes) {
+            if (rule.matches(url.spec(), qSpec)) {
+                matchFound = true;
+                break;
+            }
+        }
+        if (!matchFound)
+            return false;
+    }
+
+    for (const Rule &rule : excludes) {
+        if (rule.matches(url.spec(), qSpec))
+            return false;
+    }
+
+    return true;
+}
+
+// Whether two versions of a script with the same id can share everything
+// compiled for it.
+static bool isSameScript(const UserScriptData &a, const UserScriptData &b)
+{
+    return a.source == b.source && a.url == b.url && a.injectionPoint == b.injectionPoint
+            && a.injectForSubframes == b.injectForSubframes && a.worldId == b.worldId
+            && a.globs == b.globs && a.excludeGlobs == b.excludeGlobs
+            && a.urlPatterns == b.urlPatterns;
+}
+
+void UserScriptMatcher::addScript(const UserScriptData &script)
+{
+    // Per-page scripts are sent again for every frame created.
+    auto existing = m_scripts.constFind(script.scriptId);
+    if (existing != m_scripts.cend() && isSameScript(existing->data, script))
+        return;
+    removeScript(script.scriptId);
+
+    CompiledScript compiled;
+    compiled.data = script;
+    compiled.source = blink::WebString::FromUTF8(script.source);
+    bool indexable = !script.urlPatterns.empty();
+    for (const std::string &pattern : script.urlPatterns) {
+        URLPattern urlPattern(validUserScriptSchemes());
+        if (urlPattern.Parse(pattern) != URLPattern::ParseResult::kSuccess)
+            continue;
+        if (isIndexable(urlPattern))
+            compiled.hosts.push_back(urlPattern.host());
+        else
+            indexable = false;
+        compiled.urlPatterns.push_back(std::move(urlPattern));
+    }
+    for (const std::string &glob : script.globs)
+        compiled.includes.emplace_back(glob);
+    for (const std::string &glob : script.excludeGlobs)
+        compiled.excludes.emplace_back(glob);
+    for (const std::vector<Rule> *rules : { &compiled.includes, &compiled.excludes }) {
+        for (const Rule &rule : *rules)
+            compiled.hasRegex |= rule.isRegex;
+    }
+
+    if (indexable) {
+        for (const std::string &host : compiled.hosts) {
+            QList<uint64_t> &ids = m_scriptsByHost[host];
+            if (!ids.contains(script.scriptId))
+                ids.append(script.scriptId);
+        }
+    } else {
+        compiled.hosts.clear();
+        m_unindexedScripts.append(script.scriptId);
+    }
+    m_scripts.insert(script.scriptId, std::move(compiled));
+}
+
+void UserScriptMatcher::removeScript(uint64_t scriptId)
+{
+    auto it = m_scripts.find(scriptId);
+    if (it == m_scripts.end())
+        return;
+    unindex(*it);
+    m_scripts.erase(it);
+}
+
+void UserScriptMatcher::unindex(const CompiledScript &script)
+{
+    const uint64_t id = script.data.scriptId;
+    if (script.hosts.empty()) {
+        m_unindexedScripts.removeOne(id);
+        return;
+    }
+    for (const std::string &host : script.hosts) {
+        auto it = m_scriptsByHost.find(host);
+        if (it == m_scriptsByHost.end())
+            continue;
+        it->second.removeOne(id);
+        if (it->second.isEmpty())
+            m_scriptsByHost.erase(it);
+    }
+}
+
+const UserScriptData &UserScriptMatcher::script(uint64_t scriptId) const
+{
+    static const UserScriptData noScript;
+    auto it = m_scripts.constFind(scriptId);
+    return it != m_scripts.cend() ? it->data : noScript;
+}
+
+blink::WebString UserScriptMatcher::source(uint64_t scriptId) const
+{
+    auto it = m_scripts.constFind(scriptId);
+    return it != m_scripts.cend() ? it->source : blink::WebString();
+}
+
+QSet<uint64_t> UserScriptMatcher::matchingScripts(const GURL &url,
+                                                  UserScriptData::InjectionPoint injectionPoint,
+                                                  bool isMainFrame) const
+{
+    QSet<uint64_t> result;
+    if (m_scripts.isEmpty())
+        return result;
+
+    QString qSpec; // only converted if a script has a regular expression to match
+    auto check = [&](uint64_t id) {
+        if (result.contains(id))
+            return;
+        auto it = m_scripts.constFind(id);
+        if (it == m_scripts.cend() || it->data.injectionPoint != injectionPoint
+                || (!isMainFrame && !it->data.injectForSubframes))
+            return;
+        if (qSpec.isNull() && it->hasRegex)
+            qSpec = toQt(url.spec());
+        if (it->matches(url, qSpec))
+            result.insert(id);
+    };
+
+    for (uint64_t id : m_unindexedScripts)
+        check(id);
+
+    // Patterns for *.example.com are indexed under example.com, so look up
+    // the host and all of its parent domains.
+    if (!m_scriptsByHost.empty() && url.has_host()) {
+        std::string host = url.host();
+        while (!host.empty()) {
+            auto it = m_scriptsByHost.find(host);
+            if (it != m_scriptsByHost.end()) {
+                for (uint64_t id : it->second)
+                    check(id);
+            }
+            const size_t dot = host.find('.');
+            if (dot == std::string::npos)
+                break;
+            host.erase(0, dot + 1);
+        }
+    }
+    return result;
+}
+
+} // namespace QtWebEngineCore
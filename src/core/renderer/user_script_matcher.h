@@ -0,0 +1,116 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtWebEngine module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef USER_SCRIPT_MATCHER_H
+#define USER_SCRIPT_MATCHER_H
+
+#include "extensions/common/url_pattern.h"
+#include "qtwebengine/userscript/user_script_data.h"
+#include "third_party/blink/public/platform/web_string.h"
+
+#include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtCore/QRegularExpression>
+#include <QtCore/QSet>
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class GURL;
+
+namespace QtWebEngineCore {
+
+// Holds the user scripts of the renderer with their URL patterns parsed and
+// their @include/@exclude regular expressions compiled once when they arrive.
+// The source of each script is also decoded once and shared by all frames.
+// Scripts whose @match patterns all name a host are indexed by it, so that
+// matching a URL only looks at the scripts that can apply to its host.
+class UserScriptMatcher
+{
+public:
+    void addScript(const UserScriptData &script);
+    void removeScript(uint64_t scriptId);
+
+    bool contains(uint64_t scriptId) const { return m_scripts.contains(scriptId); }
+    const UserScriptData &script(uint64_t scriptId) const;
+    blink::WebString source(uint64_t scriptId) const;
+
+    // The ids of the scripts injected at the injection point of a main frame
+    // or subframe that apply to the url, in no particular order. Scripts for
+    // other injection points or frames are skipped before matching the url.
+    QSet<uint64_t> matchingScripts(const GURL &url, UserScriptData::InjectionPoint injectionPoint,
+                                   bool isMainFrame) const;
+
+private:
+    // A greasemonkey @include or @exclude rule, either a string with
+    // wildcards or a regular expression between slashes.
+    struct Rule
+    {
+        explicit Rule(const std::string &pattern);
+        bool matches(const std::string &spec, const QString &qSpec) const;
+
+        std::string glob;
+        QRegularExpression regex;
+        bool isRegex = false;
+    };
+
+    struct CompiledScript
+    {
+        bool matches(const GURL &url, const QString &qSpec) const;
+
+        UserScriptData data;
+        blink::WebString source;
+        std::vector<URLPattern> urlPatterns;
+        std::vector<Rule> includes;
+        std::vector<Rule> excludes;
+        std::vector<std::string> hosts; // empty if not indexed
+        bool hasRegex = false;
+    };
+
+    void unindex(const CompiledScript &script);
+
+    QHash<uint64_t, CompiledScript> m_scripts;
+    std::unordered_map<std::string, QList<uint64_t>> m_scriptsByHost;
+    QList<uint64_t> m_unindexedScripts;
+};
+
+} // namespace QtWebEngineCore
+
+#endif // USER_SCRIPT_MATCHER_H
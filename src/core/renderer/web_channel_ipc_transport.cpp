@@ -55,10 +55,122 @@
 #include "services/service_manager/public/cpp/interface_provider.h"
 #include "qtwebengine/browser/qtwebchannel.mojom.h"
 
+#include <QCborArray>
+#include <QCborMap>
+#include <QCborValue>
 #include <QJsonDocument>
 
 namespace QtWebEngineCore {
 
+// Messages of the binary transport are CBOR with the self-describe tag, see
+// WebChannelIPCTransportHost. They are turned into JavaScript values directly
+// and vice versa, skipping JSON text and JSON.parse() altogether.
+
+static const int kMaxMessageDepth = 64;
+
+static bool isCborMessage(const std::vector<uint8_t> &message)
+{
+    return message.size() > 3 && message[0] == 0xd9 && message[1] == 0xd9 && message[2] == 0xf7;
+}
+
+static v8::Local<v8::String> toV8String(v8::Isolate *isolate, const QString &string)
+{
+    return v8::String::NewFromTwoByte(isolate, reinterpret_cast<const uint16_t *>(string.utf16()),
+                                      v8::NewStringType::kNormal, string.size())
+            .ToLocalChecked();
+}
+
+static v8::Local<v8::Value> toV8(v8::Isolate *isolate, v8::Local<v8::Context> context, const QCborValue &value)
+{
+    switch (value.type()) {
+    case QCborValue::Integer:
+        return v8::Number::New(isolate, double(value.toInteger()));
+    case QCborValue::Double:
+        return v8::Number::New(isolate, value.toDouble());
+    case QCborValue::True:
+        return v8::True(isolate);
+    case QCborValue::False:
+        return v8::False(isolate);
+    case QCborValue::String:
+        return toV8String(isolate, value.toString());
+    case QCborValue::Array: {
+        const QCborArray array = value.toArray();
+        v8::Local<v8::Array> result = v8::Array::New(isolate, int(array.size()));
+        for (qsizetype i = 0; i < array.size(); ++i)
+            result->CreateDataProperty(context, uint32_t(i), toV8(isolate, context, array.at(i))).Check();
+        return result;
+    }
+    case QCborValue::Map: {
+        const QCborMap map = value.toMap();
+        v8::Local<v8::Object> result = v8::Object::New(isolate);
+        for (auto it = map.cbegin(); it != map.cend(); ++it)
+            result->CreateDataProperty(context, toV8String(isolate, it.key().toString()),
+                                       toV8(isolate, context, it.value())).Check();
+        return result;
+    }
+    default:
+        return v8::Null(isolate);
+    }
+}
+
+static QString toQString(v8::Isolate *isolate, v8::Local<v8::Value> string)
+{
+    v8::String::Value value(isolate, string);
+    return QString(reinterpret_cast<const QChar *>(*value), value.length());
+}
+
+// Follows what JSON.stringify() would do with the message.
+static bool fromV8(v8::Isolate *isolate, v8::Local<v8::Context> context, v8::Local<v8::Value> value,
+                   QCborValue *result, int depth = 0)
+{
+    if (depth > kMaxMessageDepth)
+        return false;
+    if (value->IsNull() || value->IsUndefined()) {
+        *result = QCborValue(QCborValue::Null);
+    } else if (value->IsBoolean()) {
+        *result = QCborValue(value->BooleanValue(isolate));
+    } else if (value->IsInt32()) {
+        *result = QCborValue(qint64(value.As<v8::Int32>()->Value()));
+    } else if (value->IsNumber()) {
+        *result = QCborValue(value.As<v8::Number>()->Value());
+    } else if (value->IsString()) {
+        *result = QCborValue(toQString(isolate, value));
+    } else if (value->IsArray()) {
+        v8::Local<v8::Array> array = value.As<v8::Array>();
+        QCborArray cborArray;
+        for (uint32_t i = 0; i < array->Length(); ++i) {
+            v8::Local<v8::Value> element;
+            QCborValue cborElement;
+            if (!array->Get(context, i).ToLocal(&element) || !fromV8(isolate, context, element, &cborElement, depth + 1))
+                return false;
+            cborArray.append(cborElement);
+        }
+        *result = cborArray;
+    } else if (value->IsObject() && !value->IsFunction()) {
+        v8::Local<v8::Object> object = value.As<v8::Object>();
+        v8::Local<v8::Array> keys;
+        if (!object->GetOwnPropertyNames(context).ToLocal(&keys))
+            return false;
+        QCborMap cborMap;
+        for (uint32_t i = 0; i < keys->Length(); ++i) {
+            v8::Local<v8::Value> key;
+            v8::Local<v8::Value> property;
+            if (!keys->Get(context, i).ToLocal(&key) || !object->Get(context, key).ToLocal(&property))
+                return false;
+            if (property->IsUndefined() || property->IsFunction())
+                continue;
+            QCborValue cborProperty;
+            if (!fromV8(isolate, context, property, &cborProperty, depth + 1))
+                return false;
+            cborMap.insert(toQString(isolate, key), cborProperty);
+        }
+        *result = cborMap;
+    } else {
+        return false;
+    }
+    return true;
+}
+
 class WebChannelTransport : public gin::Wrappable<WebChannelTransport>
 {
 public:
@@ -148,14 +260,25 @@ void WebChannelTransport::NativeQtSendMessage(gin::Arguments *args)
     v8::Isolate *isolate = blink::MainThreadIsolate();
     v8::HandleScope handleScope(isolate);
 
-    if (!jsonValue->IsString()) {
-        args->ThrowTypeError("Expected string");
+    std::vector<uint8_t> json;
+    if (jsonValue->IsObject() && !jsonValue->IsFunction()) {
+        // Binary transport, the message is passed as an object instead of JSON text.
+        QCborValue message;
+        if (!fromV8(isolate, isolate->GetCurrentContext(), jsonValue, &message) || !message.isMap()) {
+            args->ThrowTypeError("Expected JSON compatible object");
+            return;
+        }
+        const QByteArray cbor = QCborValue(QCborKnownTags::Signature, message).toCbor();
+        json.assign(cbor.cbegin(), cbor.cend());
+    } else if (jsonValue->IsString()) {
+        v8::Local<v8::String> jsonString = v8::Local<v8::String>::Cast(jsonValue);
+        json.resize(jsonString->Utf8Length(isolate));
+        jsonString->WriteUtf8(isolate, reinterpret_cast<char *>(json.data()), json.size(), nullptr,
+                              v8::String::REPLACE_INVALID_UTF8);
+    } else {
+        args->ThrowTypeError("Expected string or object");
         return;
     }
-    v8::Local<v8::String> jsonString = v8::Local<v8::String>::Cast(jsonValue);
-    std::vector<uint8_t> json(jsonString->Utf8Length(isolate), 0);
-    jsonString->WriteUtf8(isolate, reinterpret_cast<char *>(json.data()), json.size(), nullptr,
-                          v8::String::REPLACE_INVALID_UTF8);
 
     if (!m_remote) {
         renderFrame->GetRemoteAssociatedInterfaces()->GetInterface(&m_remote);
@@ -230,36 +353,64 @@ void WebChannelIPCTransport::DispatchWebChannelMessage(const std::vector<uint8_t
         context = frame->IsolatedWorldScriptContext(worldId);
     v8::Context::Scope contextScope(context);
 
-    v8::Local<v8::Object> global(context->Global());
-    v8::Local<v8::Value> qtObjectValue;
-    if (!global->Get(context, gin::StringToV8(isolate, "qt")).ToLocal(&qtObjectValue) || !qtObjectValue->IsObject())
-        return;
-    v8::Local<v8::Object> qtObject = v8::Local<v8::Object>::Cast(qtObjectValue);
-    v8::Local<v8::Value> webChannelObjectValue;
-    if (!qtObject->Get(context, gin::StringToV8(isolate, "webChannelTransport")).ToLocal(&webChannelObjectValue)
-            || !webChannelObjectValue->IsObject())
-        return;
-    v8::Local<v8::Object> webChannelObject = v8::Local<v8::Object>::Cast(webChannelObjectValue);
-    v8::Local<v8::Value> callbackValue;
-    if (!webChannelObject->Get(context, gin::StringToV8(isolate, "onmessage")).ToLocal(&callbackValue)
-            || !callbackValue->IsFunction()) {
-        LOG(WARNING) << "onmessage is not a callable property of qt.webChannelTransport. Some things might not work as "
-                        "expected.";
-        return;
+    // qwebchannel.js only runs JSON.parse() on string data. A batch is a CBOR
+    // array of messages, each either a map or JSON text, see
+    // WebChannelIPCTransportHost::flushMessages(). Its messages are passed to
+    // onmessage one by one, within this one task.
+    std::vector<v8::Local<v8::Value>> messages;
+    if (isCborMessage(json)) {
+        const QCborValue value = QCborValue::fromCbor(
+                QByteArray::fromRawData(reinterpret_cast<const char *>(json.data()), json.size()));
+        const QCborValue content = value.taggedValue();
+        if (!value.isTag() || !(content.isMap() || content.isArray())) {
+            LOG(WARNING) << "Received invalid binary webchannel message.";
+            return;
+        }
+        if (content.isArray()) {
+            const QCborArray batch = content.toArray();
+            messages.reserve(batch.size());
+            for (const QCborValue &message : batch)
+                messages.push_back(toV8(isolate, context, message));
+        } else {
+            messages.push_back(toV8(isolate, context, content));
+        }
+    } else {
+        messages.push_back(v8::String::NewFromUtf8(isolate, reinterpret_cast<const char *>(json.data()),
+                                                   v8::NewStringType::kNormal, json.size())
+                                   .ToLocalChecked());
     }
 
-    v8::Local<v8::Object> messageObject(v8::Object::New(isolate));
-    v8::Maybe<bool> wasSet = messageObject->DefineOwnProperty(
-            context, v8::String::NewFromUtf8(isolate, "data").ToLocalChecked(),
-            v8::String::NewFromUtf8(isolate, reinterpret_cast<const char *>(json.data()),
-                                    v8::NewStringType::kNormal, json.size())
-                    .ToLocalChecked(),
-            v8::PropertyAttribute(v8::ReadOnly | v8::DontDelete));
-    DCHECK(!wasSet.IsNothing() && wasSet.FromJust());
-
-    v8::Local<v8::Function> callback = v8::Local<v8::Function>::Cast(callbackValue);
-    v8::Local<v8::Value> argv[] = { messageObject };
-    frame->CallFunctionEvenIfScriptDisabled(callback, webChannelObject, 1, argv);
+    for (v8::Local<v8::Value> data : messages) {
+        // Looked up for every message, as if each had been delivered on its
+        // own, because a handler may replace qt.webChannelTransport.onmessage.
+        v8::Local<v8::Object> global(context->Global());
+        v8::Local<v8::Value> qtObjectValue;
+        if (!global->Get(context, gin::StringToV8(isolate, "qt")).ToLocal(&qtObjectValue) || !qtObjectValue->IsObject())
+            return;
+        v8::Local<v8::Object> qtObject = v8::Local<v8::Object>::Cast(qtObjectValue);
+        v8::Local<v8::Value> webChannelObjectValue;
+        if (!qtObject->Get(context, gin::StringToV8(isolate, "webChannelTransport")).ToLocal(&webChannelObjectValue)
+                || !webChannelObjectValue->IsObject())
+            return;
+        v8::Local<v8::Object> webChannelObject = v8::Local<v8::Object>::Cast(webChannelObjectValue);
+        v8::Local<v8::Value> callbackValue;
+        if (!webChannelObject->Get(context, gin::StringToV8(isolate, "onmessage")).ToLocal(&callbackValue)
+                || !callbackValue->IsFunction()) {
+            LOG(WARNING) << "onmessage is not a callable property of qt.webChannelTransport. Some things might not work as "
+                            "expected.";
+            return;
+        }
+        v8::Local<v8::Function> callback = v8::Local<v8::Function>::Cast(callbackValue);
+
+        v8::Local<v8::Object> messageObject(v8::Object::New(isolate));
+        v8::Maybe<bool> wasSet = messageObject->DefineOwnProperty(
+                context, v8::String::NewFromUtf8(isolate, "data").ToLocalChecked(), data,
+                v8::PropertyAttribute(v8::ReadOnly | v8::DontDelete));
+        DCHECK(!wasSet.IsNothing() && wasSet.FromJust());
+
+        v8::Local<v8::Value> argv[] = { messageObject };
+        frame->CallFunctionEvenIfScriptDisabled(callback, webChannelObject, 1, argv);
+    }
 }
 
 void WebChannelIPCTransport::DidCreateScriptContext(v8::Local<v8::Context> context, int32_t worldId)
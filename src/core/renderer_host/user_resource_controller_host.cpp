@@ -39,7 +39,10 @@
 
 #include "user_resource_controller_host.h"
 
+#include "common/qt_messages.h"
+#include "profile_adapter.h"
 #include "type_conversion.h"
+#include "user_script_code_cache.h"
 #include "web_contents_adapter.h"
 #include "content/public/browser/render_process_host.h"
 #include "content/public/browser/render_process_host_observer.h"
@@ -79,8 +82,10 @@ void UserResourceControllerHost::WebContentsObserverHelper::RenderFrameCreated(c
     content::WebContents *contents = web_contents();
     auto &remote = m_controllerHost->GetUserResourceControllerRenderFrame(renderFrameHost);
     const QList<UserScript> scripts = m_controllerHost->m_perContentsScripts.value(contents);
-    for (const UserScript &script : scripts)
+    for (const UserScript &script : scripts) {
+        m_controllerHost->sendCodeCache(renderFrameHost->GetProcess(), script);
         remote->AddScript(script.data());
+    }
 }
 
 void UserResourceControllerHost::WebContentsObserverHelper::RenderFrameHostChanged(content::RenderFrameHost *oldHost,
@@ -124,6 +129,7 @@ void UserResourceControllerHost::RenderProcessObserverHelper::RenderProcessHostD
     Q_ASSERT(m_controllerHost);
     delete m_controllerHost->m_observedProcesses[renderer];
     m_controllerHost->m_observedProcesses.remove(renderer);
+    m_controllerHost->m_sentCodeCaches.remove(renderer);
 }
 
 void UserResourceControllerHost::addUserScript(const UserScript &script, WebContentsAdapter *adapter)
@@ -133,8 +139,10 @@ void UserResourceControllerHost::addUserScript(const UserScript &script, WebCont
     if (isProfileWideScript) {
         if (!m_profileWideScripts.contains(script)) {
             m_profileWideScripts.append(script);
-            for (auto controller : m_observedProcesses.values())
-                (*controller)->AddScript(script.data());
+            for (auto it = m_observedProcesses.cbegin(); it != m_observedProcesses.cend(); ++it) {
+                sendCodeCache(it.key(), script);
+                (*it.value())->AddScript(script.data());
+            }
         }
     } else {
         content::WebContents *contents = adapter->webContents();
@@ -151,6 +159,7 @@ void UserResourceControllerHost::addUserScript(const UserScript &script, WebCont
                 m_perContentsScripts.insert(contents, currentScripts);
             }
         }
+        sendCodeCache(contents->GetMainFrame()->GetProcess(), script);
         GetUserResourceControllerRenderFrame(contents->GetMainFrame())
                 ->AddScript(script.data());
     }
@@ -219,16 +228,64 @@ void UserResourceControllerHost::renderProcessStartedWithHost(content::RenderPro
     renderer->GetChannel()->GetRemoteAssociatedInterface(userResourceController);
     m_observedProcesses.insert(renderer, userResourceController);
     for (const UserScript &script : qAsConst(m_profileWideScripts)) {
+        sendCodeCache(renderer, script);
         (*userResourceController)->AddScript(script.data());
     }
 }
 
+// The code cache goes over the legacy IPC channel, which the
+// UserResourceController interfaces are associated with, so it arrives
+// before the script it is for.
+void UserResourceControllerHost::sendCodeCache(content::RenderProcessHost *renderer, const UserScript &script)
+{
+    QSet<uint64_t> &sent = m_sentCodeCaches[renderer];
+    const uint64_t scriptId = script.data().scriptId;
+    if (sent.contains(scriptId))
+        return;
+    base::ReadOnlySharedMemoryRegion region = codeCache()->get(script.codeCacheKey());
+    if (!region.IsValid())
+        return;
+    renderer->Send(new QtWebEngineMsg_SetUserScriptCodeCache(scriptId, std::move(region)));
+    sent.insert(scriptId);
+}
+
+// A render process produced the code cache of a script it was sent.
+void UserResourceControllerHost::storeCodeCache(uint64_t scriptId, const std::vector<uint8_t> &data)
+{
+    auto hasId = [scriptId](const UserScript &script) { return script.data().scriptId == scriptId; };
+    auto it = std::find_if(m_profileWideScripts.cbegin(), m_profileWideScripts.cend(), hasId);
+    if (it != m_profileWideScripts.cend()) {
+        codeCache()->store(it->codeCacheKey(), data);
+        return;
+    }
+    for (const QList<UserScript> &scripts : qAsConst(m_perContentsScripts)) {
+        it = std::find_if(scripts.cbegin(), scripts.cend(), hasId);
+        if (it != scripts.cend()) {
+            codeCache()->store(it->codeCacheKey(), data);
+            return;
+        }
+    }
+}
+
+UserScriptCodeCache *UserResourceControllerHost::codeCache()
+{
+    if (!m_codeCache) {
+        // off the record, the cache is only shared by the running render processes
+        base::FilePath directory;
+        if (m_profileAdapter && !m_profileAdapter->isOffTheRecord() && !m_profileAdapter->dataPath().isEmpty())
+            directory = toFilePath(m_profileAdapter->dataPath()).AppendASCII("UserScriptCodeCache");
+        m_codeCache.reset(new UserScriptCodeCache(directory));
+    }
+    return m_codeCache.get();
+}
+
 void UserResourceControllerHost::webContentsDestroyed(content::WebContents *contents)
 {
     m_perContentsScripts.remove(contents);
 }
 
-UserResourceControllerHost::UserResourceControllerHost()
+UserResourceControllerHost::UserResourceControllerHost(ProfileAdapter *profileAdapter)
+    : m_profileAdapter(profileAdapter)
 {
 }
 
@@ -55,7 +55,10 @@
 
 #include <QtCore/QHash>
 #include <QtCore/QScopedPointer>
+#include <QtCore/QSet>
 #include <map>
+#include <memory>
+#include <vector>
 #include "user_script.h"
 
 namespace content {
@@ -78,7 +81,9 @@ class UserResourceControllerRenderFrame;
 
 namespace QtWebEngineCore {
 
+class ProfileAdapter;
 class UserScript;
+class UserScriptCodeCache;
 using UserResourceControllerRemote = mojo::AssociatedRemote<qtwebengine::mojom::UserResourceController>;
 using UserResourceControllerRenderFrameRemote = mojo::AssociatedRemote<qtwebengine::mojom::UserResourceControllerRenderFrame>;
 class WebContentsAdapter;
@@ -87,7 +92,7 @@ class Q_WEBENGINECORE_PRIVATE_EXPORT UserResourceControllerHost
 {
 
 public:
-    UserResourceControllerHost();
+    explicit UserResourceControllerHost(ProfileAdapter *profileAdapter);
     ~UserResourceControllerHost();
 
     void addUserScript(const UserScript &script, WebContentsAdapter *adapter);
@@ -96,6 +101,7 @@ public:
     void reserve(WebContentsAdapter *adapter, int count);
 
     void renderProcessStartedWithHost(content::RenderProcessHost *renderer);
+    void storeCodeCache(uint64_t scriptId, const std::vector<uint8_t> &data);
 
 private:
     Q_DISABLE_COPY(UserResourceControllerHost)
@@ -105,7 +111,12 @@ private:
     void webContentsDestroyed(content::WebContents *);
     const UserResourceControllerRenderFrameRemote &
     GetUserResourceControllerRenderFrame(content::RenderFrameHost *rfh);
+    UserScriptCodeCache *codeCache();
+    void sendCodeCache(content::RenderProcessHost *renderer, const UserScript &script);
 
+    ProfileAdapter *m_profileAdapter;
+    std::unique_ptr<UserScriptCodeCache> m_codeCache;
+    QHash<content::RenderProcessHost *, QSet<uint64_t>> m_sentCodeCaches;
     QList<UserScript> m_profileWideScripts;
     typedef QHash<content::WebContents *, QList<UserScript>> ContentsScriptsMap;
     ContentsScriptsMap m_perContentsScripts;
@@ -0,0 +1,162 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtWebEngine module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "user_script_code_cache.h"
+
+#include "base/files/file_enumerator.h"
+#include "base/files/file_util.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_util.h"
+#include "base/task/task_traits.h"
+#include "base/task/thread_pool.h"
+#include "crypto/sha2.h"
+
+#include <algorithm>
+
+namespace QtWebEngineCore {
+
+// Code cache data is a few times the size of the source; more than this is
+// not what a render process should be sending.
+static const size_t maxEntrySize = 64 * 1024 * 1024;
+// Entries of scripts that are no longer used are only dropped from the
+// directory when there are more than this.
+static const size_t maxPersistedEntries = 64;
+
+static bool isKey(const std::string &name)
+{
+    return name.size() == 2 * crypto::kSHA256Length
+            && std::all_of(name.cbegin(), name.cend(), base::IsHexDigit<char>);
+}
+
+// Runs on the file task runner.
+static std::map<std::string, std::vector<uint8_t>> loadEntries(const base::FilePath &directory)
+{
+    struct File {
+        base::FilePath path;
+        base::Time lastModified;
+    };
+    std::vector<File> files;
+    base::FileEnumerator enumerator(directory, false, base::FileEnumerator::FILES);
+    for (base::FilePath path = enumerator.Next(); !path.empty(); path = enumerator.Next()) {
+        if (isKey(path.BaseName().MaybeAsASCII()))
+            files.push_back({ path, enumerator.GetInfo().GetLastModifiedTime() });
+        else
+            base::DeleteFile(path);
+    }
+    std::sort(files.begin(), files.end(), [](const File &a, const File &b) {
+        return a.lastModified > b.lastModified;
+    });
+    while (files.size() > maxPersistedEntries) {
+        base::DeleteFile(files.back().path);
+        files.pop_back();
+    }
+
+    std::map<std::string, std::vector<uint8_t>> entries;
+    for (const File &file : files) {
+        std::string contents;
+        if (base::ReadFileToStringWithMaxSize(file.path, &contents, maxEntrySize) && !contents.empty())
+            entries[file.path.BaseName().MaybeAsASCII()].assign(contents.cbegin(), contents.cend());
+    }
+    return entries;
+}
+
+// Runs on the file task runner.
+static void writeEntry(const base::FilePath &directory, const std::string &key,
+                       const std::vector<uint8_t> &data)
+{
+    if (!base::CreateDirectory(directory))
+        return;
+    base::WriteFile(directory.AppendASCII(key), reinterpret_cast<const char *>(data.data()), data.size());
+}
+
+UserScriptCodeCache::UserScriptCodeCache(const base::FilePath &directory)
+    : m_directory(directory)
+{
+    if (m_directory.empty())
+        return;
+    m_fileTaskRunner = base::ThreadPool::CreateSequencedTaskRunner(
+            { base::MayBlock(), base::TaskPriority::USER_VISIBLE,
+              base::TaskShutdownBehavior::SKIP_ON_SHUTDOWN });
+    m_fileTaskRunner->PostTaskAndReplyWithResult(
+            FROM_HERE, base::BindOnce(&loadEntries, m_directory),
+            base::BindOnce(&UserScriptCodeCache::loaded, m_weakPtrFactory.GetWeakPtr()));
+}
+
+UserScriptCodeCache::~UserScriptCodeCache() = default;
+
+std::string UserScriptCodeCache::key(const std::string &source)
+{
+    return base::HexEncode(crypto::SHA256HashString(source).data(), crypto::kSHA256Length);
+}
+
+base::ReadOnlySharedMemoryRegion UserScriptCodeCache::get(const std::string &key) const
+{
+    auto it = m_entries.find(key);
+    return it != m_entries.cend() ? it->second.Duplicate() : base::ReadOnlySharedMemoryRegion();
+}
+
+void UserScriptCodeCache::store(const std::string &key, const std::vector<uint8_t> &data)
+{
+    if (data.empty() || data.size() > maxEntrySize)
+        return;
+    insert(key, data);
+    if (m_fileTaskRunner)
+        m_fileTaskRunner->PostTask(FROM_HERE, base::BindOnce(&writeEntry, m_directory, key, data));
+}
+
+void UserScriptCodeCache::loaded(Entries entries)
+{
+    // what was stored while loading is newer
+    for (const auto &entry : entries) {
+        if (!m_entries.count(entry.first))
+            insert(entry.first, entry.second);
+    }
+}
+
+void UserScriptCodeCache::insert(const std::string &key, const std::vector<uint8_t> &data)
+{
+    base::MappedReadOnlyRegion mapped = base::ReadOnlySharedMemoryRegion::Create(data.size());
+    if (!mapped.IsValid())
+        return;
+    memcpy(mapped.mapping.memory(), data.data(), data.size());
+    m_entries[key] = std::move(mapped.region);
+}
+
+} // namespace QtWebEngineCore
@@ -0,0 +1,100 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtWebEngine module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#ifndef USER_SCRIPT_CODE_CACHE_H
+#define USER_SCRIPT_CODE_CACHE_H
+
+#include "base/files/file_path.h"
+#include "base/memory/read_only_shared_memory_region.h"
+#include "base/memory/weak_ptr.h"
+#include "base/task/sequenced_task_runner.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace QtWebEngineCore {
+
+// The V8 code cache of the user scripts of a profile, keyed by the hash of
+// the script source. A render process produces the data the first time it
+// runs a script; every process the script is sent to afterwards gets it
+// along, so that V8 deserializes the code instead of compiling the script.
+//
+// The data is held in read-only shared memory that all render processes map,
+// and is persisted in a directory of the profile, unless that is empty. What
+// was persisted is loaded in the background, and is only handed out once it
+// has been loaded.
+class UserScriptCodeCache
+{
+public:
+    explicit UserScriptCodeCache(const base::FilePath &directory);
+    ~UserScriptCodeCache();
+
+    static std::string key(const std::string &source);
+
+    // invalid if nothing is cached for key
+    base::ReadOnlySharedMemoryRegion get(const std::string &key) const;
+    void store(const std::string &key, const std::vector<uint8_t> &data);
+
+private:
+    using Entries = std::map<std::string, std::vector<uint8_t>>;
+    void loaded(Entries entries);
+    void insert(const std::string &key, const std::vector<uint8_t> &data);
+
+    const base::FilePath m_directory;
+    scoped_refptr<base::SequencedTaskRunner> m_fileTaskRunner;
+    std::map<std::string, base::ReadOnlySharedMemoryRegion> m_entries;
+    base::WeakPtrFactory<UserScriptCodeCache> m_weakPtrFactory{this};
+};
+
+} // namespace QtWebEngineCore
+
+#endif // USER_SCRIPT_CODE_CACHE_H
@@ -47,9 +47,16 @@
 #include "services/service_manager/public/cpp/interface_provider.h"
 #include "qtwebengine/browser/qtwebchannel.mojom.h"
 
+#include "web_contents_delegate_qt.h"
+#include "web_engine_settings.h"
+
+#include <QCborArray>
+#include <QCborMap>
+#include <QCborValue>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QLoggingCategory>
+#include <QTimer>
 
 namespace QtWebEngineCore {
 
@@ -60,6 +67,13 @@ inline QDebug operator<<(QDebug stream, content::RenderFrameHost *frame)
     return stream << "frame " << frame->GetRoutingID() << " in process " << frame->GetProcess()->GetID();
 }
 
+// Binary messages are CBOR with the self-describe tag, which makes them start
+// with 0xd9d9f7 and thus tells them apart from JSON text, see WebChannelIPCTransport.
+static bool isCborMessage(const std::vector<uint8_t> &message)
+{
+    return message.size() > 3 && message[0] == 0xd9 && message[1] == 0xd9 && message[2] == 0xf7;
+}
+
 WebChannelIPCTransportHost::WebChannelIPCTransportHost(content::WebContents *contents, uint worldId, QObject *parent)
     : QWebChannelAbstractTransport(parent)
     , content::WebContentsObserver(contents)
@@ -74,6 +88,7 @@ WebChannelIPCTransportHost::WebChannelIPCTransportHost(content::WebContents *con
 
 WebChannelIPCTransportHost::~WebChannelIPCTransportHost()
 {
+    flushMessages();
     resetWorldId();
 }
 
@@ -82,20 +97,70 @@ uint WebChannelIPCTransportHost::worldId() const
     return m_worldId;
 }
 
+bool WebChannelIPCTransportHost::testAttribute(QWebEngineSettings::WebAttribute attribute) const
+{
+    auto *delegate = static_cast<WebContentsDelegateQt *>(web_contents()->GetDelegate());
+    return delegate && delegate->webEngineSettings()->testAttribute(attribute);
+}
+
 void WebChannelIPCTransportHost::sendMessage(const QJsonObject &message)
 {
-    QJsonDocument doc(message);
-    QByteArray json = doc.toJson(QJsonDocument::Compact);
-    content::RenderFrameHost *frame = web_contents()->GetMainFrame();
-    qCDebug(log).nospace() << "sending webchannel message to " << frame << ": " << doc;
+    const content::GlobalRenderFrameHostId frame = web_contents()->GetMainFrame()->GetGlobalId();
+    if (!m_pendingMessages.isEmpty() && m_pendingFrame != frame)
+        flushMessages();
+    if (m_pendingMessages.isEmpty()) {
+        m_pendingFrame = frame;
+        QTimer::singleShot(0, this, &WebChannelIPCTransportHost::flushMessages);
+    }
+    m_pendingMessages.append(message);
+}
+
+void WebChannelIPCTransportHost::flushMessages()
+{
+    if (m_pendingMessages.isEmpty())
+        return;
+    const QList<QJsonObject> messages = std::exchange(m_pendingMessages, QList<QJsonObject>());
+    content::RenderFrameHost *frame = content::RenderFrameHost::FromID(m_pendingFrame);
+    if (!frame) {
+        qCDebug(log).nospace() << "dropping batch of " << messages.size()
+                               << " webchannel messages, their frame is gone";
+        return;
+    }
+
+    m_batchStatistics.batches++;
+    m_batchStatistics.messages += messages.size();
+    m_batchStatistics.largestBatch = qMax(m_batchStatistics.largestBatch, int(messages.size()));
+
+    const bool binary = testAttribute(QWebEngineSettings::WebChannelBinaryTransportEnabled);
+    qCDebug(log).nospace() << "sending batch of " << messages.size() << (binary ? " binary" : "")
+                           << " webchannel messages to " << frame << ": " << messages;
+
+    QByteArray data;
+    if (messages.size() == 1 && binary) {
+        data = QCborValue(QCborKnownTags::Signature, QCborMap::fromJsonObject(messages.first())).toCbor();
+    } else if (messages.size() == 1) {
+        data = QJsonDocument(messages.first()).toJson(QJsonDocument::Compact);
+    } else {
+        // See WebChannelIPCTransport::DispatchWebChannelMessage().
+        QCborArray batch;
+        for (const QJsonObject &message : qAsConst(messages)) {
+            if (binary)
+                batch.append(QCborMap::fromJsonObject(message));
+            else
+                batch.append(QString::fromUtf8(QJsonDocument(message).toJson(QJsonDocument::Compact)));
+        }
+        data = QCborValue(QCborKnownTags::Signature, batch).toCbor();
+    }
     GetWebChannelIPCTransportRemote(frame)->DispatchWebChannelMessage(
-            std::vector<uint8_t>(json.begin(), json.end()), m_worldId);
+            std::vector<uint8_t>(data.begin(), data.end()), m_worldId);
 }
 
 void WebChannelIPCTransportHost::setWorldId(uint32_t worldId)
 {
     if (m_worldId == worldId)
         return;
+    // Pending messages belong to the world they were sent to.
+    flushMessages();
     web_contents()->ForEachFrame(base::BindRepeating([](WebChannelIPCTransportHost *that, uint32_t worldId, content::RenderFrameHost *frame) {
                                                          that->setWorldId(frame, worldId);
                                                      },
@@ -128,8 +193,20 @@ void WebChannelIPCTransportHost::DispatchWebChannelMessage(const std::vector<uin
         return;
     }
 
-    QJsonDocument doc = QJsonDocument::fromJson(
-            QByteArray(reinterpret_cast<const char *>(json.data()), json.size()));
+    const QByteArray data = QByteArray::fromRawData(reinterpret_cast<const char *>(json.data()), json.size());
+    if (isCborMessage(json)) {
+        const QCborValue value = QCborValue::fromCbor(data);
+        if (!value.isTag() || !value.taggedValue().isMap()) {
+            qCCritical(log).nospace() << "received invalid binary webchannel message from " << frame;
+            return;
+        }
+        const QJsonObject message = value.taggedValue().toMap().toJsonObject();
+        qCDebug(log).nospace() << "received binary webchannel message from " << frame << ": " << message;
+        Q_EMIT messageReceived(message, this);
+        return;
+    }
+
+    QJsonDocument doc = QJsonDocument::fromJson(data);
 
     if (!doc.isObject()) {
         qCCritical(log).nospace() << "received invalid webchannel message from " << frame;
@@ -150,6 +227,13 @@ void WebChannelIPCTransportHost::RenderFrameDeleted(content::RenderFrameHost *rf
     m_renderFrames.erase(rfh);
 }
 
+void WebChannelIPCTransportHost::RenderFrameHostChanged(content::RenderFrameHost *oldHost, content::RenderFrameHost *)
+{
+    // Deliver what was sent to the old main frame before it is swapped out.
+    if (oldHost && !m_pendingMessages.isEmpty() && oldHost->GetGlobalId() == m_pendingFrame)
+        flushMessages();
+}
+
 void WebChannelIPCTransportHost::BindReceiver(
         mojo::PendingAssociatedReceiver<qtwebchannel::mojom::WebChannelTransportHost> receiver,
         content::RenderFrameHost *rfh)
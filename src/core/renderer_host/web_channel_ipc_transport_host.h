@@ -42,10 +42,14 @@
 
 #include "qtwebenginecoreglobal.h"
 
+#include "content/public/browser/global_routing_id.h"
 #include "content/public/browser/render_frame_host_receiver_set.h"
 #include "content/public/browser/web_contents_observer.h"
 #include "qtwebengine/browser/qtwebchannel.mojom.h"
 
+#include <QtWebEngineCore/qwebenginesettings.h>
+#include <QJsonObject>
+#include <QList>
 #include <QWebChannelAbstractTransport>
 #include <map>
 
@@ -68,11 +72,21 @@ public:
     // QWebChannelAbstractTransport
     void sendMessage(const QJsonObject &message) override;
 
+    // Counts the batches sent to the render frames and the messages in them.
+    struct BatchStatistics {
+        quint64 batches = 0;
+        quint64 messages = 0;
+        int largestBatch = 0;
+    };
+    const BatchStatistics &batchStatistics() const { return m_batchStatistics; }
+
     void BindReceiver(
         mojo::PendingAssociatedReceiver<qtwebchannel::mojom::WebChannelTransportHost> receiver,
         content::RenderFrameHost *rfh);
 
 private:
+    bool testAttribute(QWebEngineSettings::WebAttribute attribute) const;
+    void flushMessages();
     void setWorldId(content::RenderFrameHost *frame, uint32_t worldId);
     void resetWorldId();
 
@@ -82,6 +96,7 @@ private:
     // WebContentsObserver
     void RenderFrameCreated(content::RenderFrameHost *frame) override;
     void RenderFrameDeleted(content::RenderFrameHost *render_frame_host) override;
+    void RenderFrameHostChanged(content::RenderFrameHost *oldHost, content::RenderFrameHost *newHost) override;
 
     // qtwebchannel::mojom::WebChannelTransportHost
     void DispatchWebChannelMessage(const std::vector<uint8_t> &json) override;
@@ -93,6 +108,11 @@ private:
     std::map<content::RenderFrameHost *,
              mojo::AssociatedRemote<qtwebchannel::mojom::WebChannelTransportRender>>
             m_renderFrames;
+    // Messages are sent in batches, one IPC per event loop turn, to the main
+    // frame at the time they were sent.
+    QList<QJsonObject> m_pendingMessages;
+    content::GlobalRenderFrameHostId m_pendingFrame;
+    BatchStatistics m_batchStatistics;
 };
 
 } // namespace
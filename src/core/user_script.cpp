@@ -40,6 +40,7 @@
 #include "base/strings/string_util.h"
 
 #include "qtwebengine/userscript/user_script_data.h"
+#include "renderer_host/user_script_code_cache.h"
 #include "user_script.h"
 #include "type_conversion.h"
 
@@ -85,6 +86,7 @@ UserScript::~UserScript() = default;
 UserScript &UserScript::operator=(const UserScript &other)
 {
     m_scriptData = other.m_scriptData;
+    m_codeCacheKey = other.m_codeCacheKey;
     m_name = other.m_name;
     m_url = other.m_url;
     return *this;
@@ -109,6 +111,7 @@ QString UserScript::sourceCode() const
 void UserScript::setSourceCode(const QString &source)
 {
     m_scriptData.source = source.toStdString();
+    m_codeCacheKey = UserScriptCodeCache::key(m_scriptData.source);
     parseMetadataHeader();
 }
 
@@ -100,10 +100,12 @@ public:
 
 private:
     const UserScriptData &data() const;
+    const std::string &codeCacheKey() const { return m_codeCacheKey; }
     void parseMetadataHeader();
     friend class UserResourceControllerHost;
 
     UserScriptData m_scriptData;
+    std::string m_codeCacheKey; // hashes the source, which can be large
     QString m_name;
     QUrl m_url;
 };
@@ -45,6 +45,7 @@
 
 #include "devtools_frontend_qt.h"
 #include "download_manager_delegate_qt.h"
+#include "favicon_cache_qt.h"
 #include "favicon_driver_qt.h"
 #include "favicon_service_factory_qt.h"
 #include "media_capture_devices_dispatcher.h"
@@ -813,7 +814,15 @@ QIcon WebContentsAdapter::icon() const
 {
     CHECK_INITIALIZED(QIcon());
     FaviconDriverQt *driver = FaviconDriverQt::FromWebContents(webContents());
-    return toQIcon(driver->GetFavicon());
+    const QUrl iconUrl = toQt(driver->GetFaviconURL());
+    const gfx::Image image = driver->GetFavicon();
+    FaviconCacheQt *cache = m_profileAdapter->faviconCache();
+    QIcon icon = cache->find(iconUrl, image.Width());
+    if (icon.isNull()) {
+        icon = toQIcon(image);
+        cache->insert(iconUrl, image.Width(), icon);
+    }
+    return icon;
 }
 
 QString WebContentsAdapter::pageTitle() const
@@ -979,6 +988,13 @@ QUrl WebContentsAdapter::getNavigationEntryIconUrl(int index)
     return favicon.valid ? toQt(favicon.url) : QUrl();
 }
 
+int WebContentsAdapter::getNavigationEntryUniqueId(int index)
+{
+    CHECK_INITIALIZED(0);
+    content::NavigationEntry *entry = m_webContents->GetController().GetEntryAtIndex(index);
+    return entry ? entry->GetUniqueID() : 0;
+}
+
 void WebContentsAdapter::clearNavigationHistory()
 {
     CHECK_INITIALIZED();
@@ -156,6 +156,7 @@ public:
     QString getNavigationEntryTitle(int index);
     QDateTime getNavigationEntryTimestamp(int index);
     QUrl getNavigationEntryIconUrl(int index);
+    int getNavigationEntryUniqueId(int index);
     void clearNavigationHistory();
     void serializeNavigationHistory(QDataStream &output);
     void setZoomFactor(qreal);
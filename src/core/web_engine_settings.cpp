@@ -292,6 +292,7 @@ void WebEngineSettings::initDefaults()
         s_defaultAttributes.insert(QWebEngineSettings::WebRTCPublicInterfacesOnly, false);
         s_defaultAttributes.insert(QWebEngineSettings::JavascriptCanPaste, false);
         s_defaultAttributes.insert(QWebEngineSettings::DnsPrefetchEnabled, false);
+        s_defaultAttributes.insert(QWebEngineSettings::WebChannelBinaryTransportEnabled, false);
 #if QT_CONFIG(webengine_extensions) && QT_CONFIG(webengine_printing_and_pdf)
         s_defaultAttributes.insert(QWebEngineSettings::PdfViewerEnabled, true);
 #else
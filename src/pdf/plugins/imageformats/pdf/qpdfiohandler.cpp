@@ -41,6 +41,7 @@
 #include <QLoggingCategory>
 #include <QPainter>
 #include <QtPdf/private/qpdffile_p.h>
+#include <QtPdf/private/qpdftilecache_p.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -146,7 +147,10 @@ bool QPdfIOHandler::read(QImage *image)
             options.setScaledSize(pageSize);
             image->fill(m_backColor.rgba());
             QPainter p(image);
-            QImage pageImage = m_doc->render(m_page, finalSize, options);
+            // the cache is gone when images are read during application exit
+            QPdfTileCache *cache = QPdfTileCache::instance();
+            const QImage pageImage = cache ? cache->render(m_doc, m_page, finalSize, options)
+                                           : m_doc->render(m_page, finalSize, options);
             p.drawImage(0, 0, pageImage);
             p.end();
         }
@@ -39,6 +39,10 @@
 
 #include "qpdfdocument.h"
 #include "qpdfdocument_p.h"
+#include "qpdfrangeloader_p.h"
+#include "qpdfrenderprocess_p.h"
+#include "qpdftextindex_p.h"
+#include "qpdftilecache_p.h"
 
 #include "third_party/pdfium/public/fpdf_doc.h"
 #include "third_party/pdfium/public/fpdf_text.h"
@@ -50,6 +54,7 @@
 #include <QHash>
 #include <QLoggingCategory>
 #include <QMutex>
+#include <QThread>
 #include <QVector2D>
 
 QT_BEGIN_NAMESPACE
@@ -57,6 +62,11 @@ QT_BEGIN_NAMESPACE
 Q_GLOBAL_STATIC(QRecursiveMutex, pdfMutex)
 static int libraryRefCount;
 static const double CharacterHitTolerance = 16.0;
+// pdfium does not tell how much memory a loaded page takes, so the page
+// cache is bounded by the number of pages instead
+static const int MaxCachedPages = 16;
+// how long rendering off the document's thread waits for a page to be fetched
+static const int PageFetchTimeout = 30000;
 Q_LOGGING_CATEGORY(qLcDoc, "qt.pdf.document")
 
 QPdfMutexLocker::QPdfMutexLocker()
@@ -71,6 +81,7 @@ QPdfDocumentPrivate::QPdfDocumentPrivate()
     , status(QPdfDocument::Null)
     , lastError(QPdfDocument::NoError)
     , pageCount(0)
+    , pageCache(MaxCachedPages)
 {
     asyncBuffer.setData(QByteArray());
     asyncBuffer.open(QIODevice::ReadWrite);
@@ -114,6 +125,13 @@ void QPdfDocumentPrivate::clear()
 {
     QPdfMutexLocker lock;
 
+    clearPageCache();
+
+    if (textIndex) {
+        textIndex->cancel();
+        textIndex.reset();
+    }
+
     if (doc)
         FPDF_CloseDocument(doc);
     doc = nullptr;
@@ -121,14 +139,32 @@ void QPdfDocumentPrivate::clear()
     if (avail)
         FPDFAvail_Destroy(avail);
     avail = nullptr;
+
+    // threads waiting for data notice that the loader is gone under the lock
+    if (rangeLoader) {
+        rangeLoader->cancel();
+        rangeLoader.reset();
+    }
     lock.unlock();
 
+    {
+        const QMutexLocker locker(&pageSizeMutex);
+        pageSizes.clear();
+    }
+    // null when a document outlives the cache at exit
+    if (QPdfTileCache *tileCache = QPdfTileCache::instance())
+        tileCache->removeDocument(q);
+
     if (pageCount != 0) {
         pageCount = 0;
         emit q->pageCountChanged(pageCount);
     }
 
     loadComplete = false;
+    {
+        const QMutexLocker locker(&pendingPagesMutex);
+        pendingPages.clear();
+    }
 
     asyncBuffer.close();
     asyncBuffer.setData(QByteArray());
@@ -163,13 +199,35 @@ void QPdfDocumentPrivate::updateLastError()
         qCDebug(qLcDoc) << "FPDF error" << error << "->" << lastError;
 }
 
+void QPdfDocumentPrivate::mapFile(QFileDevice *file)
+{
+    const qint64 size = file->size();
+    if (size <= 0)
+        return;
+
+    mappedData = file->map(0, size);
+    if (mappedData)
+        mappedSize = size;
+    qCDebug(qLcDoc) << "mapping" << file->fileName() << (mappedData ? "succeeded" : "failed");
+}
+
 void QPdfDocumentPrivate::load(QIODevice *newDevice, bool transferDeviceOwnership)
 {
+    mappedData = nullptr;
+    mappedSize = 0;
+
     if (transferDeviceOwnership)
         ownDevice.reset(newDevice);
     else
         ownDevice.reset();
 
+    // pdfium reads lots of small blocks; if we own a local file, serve them
+    // straight from memory rather than with a seek() and read() for each one
+    if (transferDeviceOwnership) {
+        if (QFileDevice *file = qobject_cast<QFileDevice *>(newDevice))
+            mapFile(file);
+    }
+
     if (newDevice->isSequential()) {
         sequentialSourceDevice = newDevice;
         device = &asyncBuffer;
@@ -249,6 +307,33 @@ void QPdfDocumentPrivate::_q_tryLoadingWithSizeFromContentHeader()
         return;
     }
 
+    if (QPdfRangeLoader::supportsRanges(networkReply)) {
+        QNetworkReply *reply = qobject_cast<QNetworkReply *>(sequentialSourceDevice);
+        QSharedPointer<QPdfRangeLoader> loader(new QPdfRangeLoader(reply, contentLength.toLongLong()),
+                                               &QObject::deleteLater);
+        if (loader->isValid()) {
+            qCDebug(qLcDoc) << "loading" << reply->url() << "with range requests";
+            // the loader takes over the reply, including its errors
+            reply->disconnect(q);
+            device = nullptr;
+            QObject::connect(loader.data(), &QPdfRangeLoader::dataAvailable, q, [this]() { checkComplete(); });
+            QObject::connect(loader.data(), &QPdfRangeLoader::failed, q,
+                             [this](QNetworkReply::NetworkError error) {
+                // once Ready, only the pages that needed the range are missing
+                if (loadComplete || status != QPdfDocument::Loading)
+                    return;
+                lastError = (error == QNetworkReply::ContentNotFoundError)
+                        ? QPdfDocument::FileNotFoundError : QPdfDocument::UnknownError;
+                rangeLoader->cancel();
+                setStatus(QPdfDocument::Error);
+            });
+            rangeLoader = loader;
+            initiateAsyncLoadWithTotalSizeKnown(contentLength.toULongLong());
+            checkComplete();
+            return;
+        }
+    }
+
     QObject::connect(sequentialSourceDevice, SIGNAL(readyRead()), q, SLOT(_q_copyFromSequentialSourceDevice()));
 
     initiateAsyncLoadWithTotalSizeKnown(contentLength.toULongLong());
@@ -285,7 +370,8 @@ void QPdfDocumentPrivate::_q_copyFromSequentialSourceDevice()
 void QPdfDocumentPrivate::tryLoadDocument()
 {
     QPdfMutexLocker lock;
-    switch (FPDFAvail_IsDocAvail(avail, this)) {
+    const int docAvail = FPDFAvail_IsDocAvail(avail, this);
+    switch (docAvail) {
         case PDF_DATA_ERROR:
             qCDebug(qLcDoc) << "error loading";
             break;
@@ -298,6 +384,11 @@ void QPdfDocumentPrivate::tryLoadDocument()
             break;
     }
 
+    // The hints given while checking have been turned into range requests;
+    // try again once they have been answered.
+    if (rangeLoader && docAvail == PDF_DATA_NOTAVAIL)
+        return;
+
     Q_ASSERT(!doc);
 
     doc = FPDFAvail_GetDocument(avail, password);
@@ -327,6 +418,29 @@ void QPdfDocumentPrivate::checkComplete()
     if (!doc)
         return;
 
+    if (rangeLoader) {
+        if (status == QPdfDocument::Error)
+            return;
+        // Pages are fetched when they are needed, so the document is ready
+        // as soon as its page count is known. Pages asked for on this thread
+        // before they arrived are announced with pageAvailable().
+        if (status != QPdfDocument::Ready) {
+            QPdfMutexLocker lock;
+            const int newPageCount = FPDF_GetPageCount(doc);
+            qCDebug(qLcDoc) << "document is" << (FPDFAvail_IsLinearized(avail) == PDF_LINEARIZED ? "" : "not")
+                            << "linearized," << newPageCount << "pages";
+            lock.unlock();
+            if (newPageCount != pageCount) {
+                pageCount = newPageCount;
+                emit q->pageCountChanged(pageCount);
+            }
+            setStatus(QPdfDocument::Ready);
+        }
+        loadComplete = rangeLoader->isComplete();
+        emitAvailablePages();
+        return;
+    }
+
     loadComplete = true;
 
     QPdfMutexLocker lock;
@@ -362,6 +476,9 @@ bool QPdfDocumentPrivate::checkPageComplete(int page)
     if (loadComplete)
         return true;
 
+    if (rangeLoader)
+        return waitForPage(page);
+
     QPdfMutexLocker lock;
     int result = PDF_DATA_NOTAVAIL;
     while (result == PDF_DATA_NOTAVAIL)
@@ -374,6 +491,121 @@ bool QPdfDocumentPrivate::checkPageComplete(int page)
     return (result != PDF_DATA_ERROR);
 }
 
+/*!
+    \internal
+    Checks whether the data of \a page has been fetched, requesting what is
+    missing. Off the document's thread, e.g. in the render thread of
+    QPdfPageRenderer, this blocks until the page has arrived; on the
+    document's thread it returns \c false right away instead.
+*/
+bool QPdfDocumentPrivate::waitForPage(int page)
+{
+    const QSharedPointer<QPdfRangeLoader> loader = rangeLoader;
+    if (!loader)
+        return false;
+
+    const bool mayBlock = QThread::currentThread() != loader->thread();
+    const QDeadlineTimer deadline(PageFetchTimeout);
+    forever {
+        const quint64 generation = loader->generation();
+
+        QPdfMutexLocker lock;
+        if (rangeLoader != loader)
+            return false; // the document was closed meanwhile
+        const int result = FPDFAvail_IsPageAvail(avail, page, this);
+        lock.unlock();
+
+        if (result == PDF_DATA_AVAIL)
+            return true;
+        if (result == PDF_DATA_ERROR) {
+            updateLastError();
+            return false;
+        }
+        // The check above has requested what is missing. Whoever waits for
+        // pageAvailable() learns when it is there, even if this thread gives up.
+        addPendingPage(page);
+        if (!mayBlock || !loader->waitForData(generation, deadline)) {
+            qCDebug(qLcDoc) << "page" << page << "is not available yet";
+            return false;
+        }
+    }
+}
+
+static void ignoreSegment(FX_DOWNLOADHINTS *, size_t, size_t)
+{
+}
+
+/*!
+    \internal
+    Returns whether \a page can be used without waiting. Unlike
+    checkPageComplete(), this does not fetch anything.
+*/
+bool QPdfDocumentPrivate::isPageAvailable(int page)
+{
+    if (page < 0 || page >= pageCount)
+        return false;
+    if (loadComplete || !rangeLoader)
+        return loadComplete;
+    {
+        const QMutexLocker locker(&pageSizeMutex);
+        if (page < pageSizes.size() && pageSizes.at(page).isValid())
+            return true;
+    }
+
+    FX_DOWNLOADHINTS noHints = { 1, ignoreSegment };
+    const QPdfMutexLocker lock;
+    return FPDFAvail_IsPageAvail(avail, page, &noHints) == PDF_DATA_AVAIL;
+}
+
+void QPdfDocumentPrivate::addPendingPage(int page)
+{
+    const QMutexLocker locker(&pendingPagesMutex);
+    if (!pendingPages.contains(page))
+        pendingPages.append(page);
+}
+
+/*!
+    \internal
+    Returns whether \a page is being fetched because it was asked for.
+*/
+bool QPdfDocumentPrivate::isPagePending(int page)
+{
+    const QMutexLocker locker(&pendingPagesMutex);
+    return pendingPages.contains(page);
+}
+
+void QPdfDocumentPrivate::emitAvailablePages()
+{
+    QList<int> pages;
+    {
+        const QMutexLocker locker(&pendingPagesMutex);
+        pages = pendingPages;
+    }
+    if (pages.isEmpty())
+        return;
+
+    QList<int> arrived;
+    {
+        const QPdfMutexLocker lock;
+        for (int page : qAsConst(pages)) {
+            // Checking a page again also requests what it still lacks, in
+            // case an earlier request for it failed. A page that cannot be
+            // loaded is announced too: queries on it fail instead of waiting.
+            if (FPDFAvail_IsPageAvail(avail, page, this) != PDF_DATA_NOTAVAIL)
+                arrived.append(page);
+        }
+    }
+    if (arrived.isEmpty())
+        return;
+    {
+        const QMutexLocker locker(&pendingPagesMutex);
+        for (int page : qAsConst(arrived))
+            pendingPages.removeOne(page);
+    }
+    for (int page : qAsConst(arrived))
+        emit q->pageAvailable(page);
+}
+
 void QPdfDocumentPrivate::setStatus(QPdfDocument::Status documentStatus)
 {
     if (status == documentStatus)
@@ -386,12 +618,23 @@ void QPdfDocumentPrivate::setStatus(QPdfDocument::Status documentStatus)
 FPDF_BOOL QPdfDocumentPrivate::fpdf_IsDataAvail(_FX_FILEAVAIL *pThis, size_t offset, size_t size)
 {
     QPdfDocumentPrivate *d = static_cast<QPdfDocumentPrivate*>(pThis);
+    if (d->rangeLoader)
+        return d->rangeLoader->isAvailable(offset, size);
     return offset + size <= static_cast<quint64>(d->device->size());
 }
 
 int QPdfDocumentPrivate::fpdf_GetBlock(void *param, unsigned long position, unsigned char *pBuf, unsigned long size)
 {
     QPdfDocumentPrivate *d = static_cast<QPdfDocumentPrivate*>(reinterpret_cast<FPDF_FILEACCESS*>(param));
+    if (d->mappedData) {
+        if (qint64(position) >= d->mappedSize)
+            return 0;
+        const qint64 available = qMin(qint64(size), d->mappedSize - qint64(position));
+        memcpy(pBuf, d->mappedData + position, available);
+        return int(available);
+    }
+    if (d->rangeLoader)
+        return int(d->rangeLoader->read(position, reinterpret_cast<char *>(pBuf), size));
     d->device->seek(position);
     return qMax(qint64(0), d->device->read(reinterpret_cast<char *>(pBuf), size));
 
@@ -399,9 +642,102 @@ int QPdfDocumentPrivate::fpdf_GetBlock(void *param, unsigned long position, unsi
 
 void QPdfDocumentPrivate::fpdf_AddSegment(_FX_DOWNLOADHINTS *pThis, size_t offset, size_t size)
 {
-    Q_UNUSED(pThis);
-    Q_UNUSED(offset);
-    Q_UNUSED(size);
+    QPdfDocumentPrivate *d = static_cast<QPdfDocumentPrivate*>(pThis);
+    if (d->rangeLoader)
+        d->rangeLoader->request(offset, size);
+}
+
+QPdfDocumentPrivate::CachedPage::~CachedPage()
+{
+    if (textPage)
+        FPDFText_ClosePage(textPage);
+    if (page)
+        FPDF_ClosePage(page);
+}
+
+/*!
+    \internal
+    Returns the handle of \a page, loading it if it is not in the page cache.
+    The handle is owned by the cache and stays valid until the next page is
+    loaded; it must only be used with the pdfium lock held.
+*/
+FPDF_PAGE QPdfDocumentPrivate::cachedPage(int page)
+{
+    if (CachedPage *cached = pageCache.object(page)) {
+        ++pageCacheStatistics.pageHits;
+        return cached->page;
+    }
+
+    ++pageCacheStatistics.pageMisses;
+    FPDF_PAGE pdfPage = FPDF_LoadPage(doc, page);
+    if (!pdfPage)
+        return nullptr;
+
+    CachedPage *cached = new CachedPage;
+    cached->page = pdfPage;
+    pageCache.insert(page, cached);
+    return pdfPage;
+}
+
+/*!
+    \internal
+    Returns the text page handle of \a page, loading the page and its text if
+    they are not in the page cache. The same rules as for cachedPage() apply.
+*/
+FPDF_TEXTPAGE QPdfDocumentPrivate::cachedTextPage(int page)
+{
+    if (!cachedPage(page))
+        return nullptr;
+
+    CachedPage *cached = pageCache.object(page);
+    Q_ASSERT(cached);
+    if (cached->textPage) {
+        ++pageCacheStatistics.textPageHits;
+        return cached->textPage;
+    }
+
+    ++pageCacheStatistics.textPageMisses;
+    cached->textPage = FPDFText_LoadPage(cached->page);
+    return cached->textPage;
+}
+
+void QPdfDocumentPrivate::clearPageCache()
+{
+    if (!pageCache.isEmpty()) {
+        qCDebug(qLcDoc) << "page cache: pages" << pageCacheStatistics.pageHits << "hits"
+                        << pageCacheStatistics.pageMisses << "misses; text pages"
+                        << pageCacheStatistics.textPageHits << "hits"
+                        << pageCacheStatistics.textPageMisses << "misses";
+    }
+    pageCache.clear();
+}
+
+/*!
+    \internal
+    Returns how often page and text page handles were found in the page
+    cache, and how often they had to be loaded, since the document was
+    created.
+*/
+QPdfDocumentPrivate::PageCacheStatistics QPdfDocumentPrivate::cacheStatistics() const
+{
+    const QPdfMutexLocker lock;
+    return pageCacheStatistics;
+}
+
+/*!
+    \internal
+    Returns the text index of the document, starting to build it if there is
+    none yet. \a fileName is where the index is persisted, if not empty.
+    Returns null while the document is still being fetched: pages that are
+    not available yet would be indexed as empty.
+*/
+QSharedPointer<QPdfTextIndex> QPdfDocumentPrivate::ensureTextIndex(const QString &fileName)
+{
+    if (!textIndex && doc && loadComplete) {
+        textIndex = QSharedPointer<QPdfTextIndex>(new QPdfTextIndex(this), &QObject::deleteLater);
+        textIndex->build(fileName);
+    }
+    return textIndex;
 }
 
 QString QPdfDocumentPrivate::getText(FPDF_TEXTPAGE textPage, int startIndex, int count)
@@ -437,9 +773,10 @@ QPdfDocumentPrivate::TextPosition QPdfDocumentPrivate::hitTest(int page, QPointF
     const QPdfMutexLocker lock;
 
     TextPosition result;
-    FPDF_PAGE pdfPage = FPDF_LoadPage(doc, page);
-    double pageHeight = FPDF_GetPageHeight(pdfPage);
-    FPDF_TEXTPAGE textPage = FPDFText_LoadPage(pdfPage);
+    FPDF_TEXTPAGE textPage = cachedTextPage(page);
+    if (!textPage)
+        return result;
+    double pageHeight = FPDF_GetPageHeight(cachedPage(page));
     int hitIndex = FPDFText_GetCharIndexAtPos(textPage, position.x(), pageHeight - position.y(),
                                               CharacterHitTolerance, CharacterHitTolerance);
     if (hitIndex >= 0) {
@@ -457,9 +794,6 @@ QPdfDocumentPrivate::TextPosition QPdfDocumentPrivate::hitTest(int page, QPointF
         }
     }
 
-    FPDFText_ClosePage(textPage);
-    FPDF_ClosePage(pdfPage);
-
     return result;
 }
 
@@ -469,6 +803,12 @@ QPdfDocumentPrivate::TextPosition QPdfDocumentPrivate::hitTest(int page, QPointF
     \inmodule QtPdf
 
     \brief The QPdfDocument class loads a PDF document and renders pages from it.
+
+    Different documents can be rendered from different threads. The PDF
+    engine keeps process-wide state, however, so the rasterization itself is
+    serialized; only the preparation of the target image and cached queries
+    such as pageSize() run concurrently. To render on several cores at once,
+    enable rendering in worker processes with setRenderWorkerProcessEnabled().
 */
 
 /*!
@@ -529,6 +869,8 @@ QString QPdfDocument::fileName() const
     \value Null The initial status after the document has been created or after it has been closed.
     \value Loading The status after load() has been called and before the document is fully loaded.
     \value Ready The status when the document is fully loaded and its data can be accessed.
+                 A document fetched with range requests is Ready before its pages
+                 have been fetched; see load().
     \value Unloading The status after close() has been called on an open document.
                      At this point the document is still valid and all its data can be accessed.
     \value Error The status after Loading, if loading has failed.
@@ -548,6 +890,17 @@ QPdfDocument::Status QPdfDocument::status() const
 
 /*!
     Loads the document contents from \a device.
+
+    If \a device is a QNetworkReply for an HTTP server that accepts range
+    requests, the document does not wait for the whole file: it becomes
+    \l Ready as soon as its page count is known, and the data of each page
+    is fetched when the page is first used. Until then, queries on the page
+    made in the thread of the document return empty results, and
+    pageAvailable() is emitted when the page has arrived. Rendering in other
+    threads, as QPdfPageRenderer does, waits for the page instead.
+
+    The range requests carry the headers and attributes of the request of
+    \a device.
 */
 void QPdfDocument::load(QIODevice *device)
 {
@@ -558,6 +911,16 @@ void QPdfDocument::load(QIODevice *device)
     d->load(device, /*transfer ownership*/false);
 }
 
+/*!
+    \fn void QPdfDocument::pageAvailable(int page)
+    \since 6.4
+
+    This signal is emitted when the data of \a page has been fetched, after
+    the page was used before it was available.
+
+    \sa load()
+*/
+
 /*!
     \property QPdfDocument::password
 
@@ -740,9 +1103,20 @@ QSizeF QPdfDocument::pageSize(int page) const
     if (!d->doc || !d->checkPageComplete(page))
         return result;
 
+    {
+        const QMutexLocker locker(&d->pageSizeMutex);
+        if (page < d->pageSizes.size() && d->pageSizes.at(page).isValid())
+            return d->pageSizes.at(page);
+    }
+
     const QPdfMutexLocker lock;
 
     FPDF_GetPageSizeByIndex(d->doc, page, &result.rwidth(), &result.rheight());
+
+    const QMutexLocker locker(&d->pageSizeMutex);
+    if (d->pageSizes.size() < d->pageCount)
+        d->pageSizes.resize(d->pageCount);
+    d->pageSizes[page] = result;
     return result;
 }
 
@@ -761,18 +1135,20 @@ QImage QPdfDocument::render(int page, QSize imageSize, QPdfDocumentRenderOptions
     if (!d->doc || !d->checkPageComplete(page))
         return QImage();
 
-    const QPdfMutexLocker lock;
-
-    QElapsedTimer timer;
-    if (Q_UNLIKELY(qLcDoc().isDebugEnabled()))
-        timer.start();
-    FPDF_PAGE pdfPage = FPDF_LoadPage(d->doc, page);
-    if (!pdfPage)
-        return QImage();
+    if (d->renderWorkerProcessEnabled) {
+        const QString file = fileName();
+        QImage result;
+        if (!file.isEmpty() && QPdfRenderProcess::forCurrentThread()->render(
+                    { file, QString::fromUtf8(d->password), page, imageSize, renderOptions }, &result)) {
+            return result;
+        }
+    }
 
+    // Everything that does not touch pdfium is prepared before taking the
+    // process-wide lock, so that threads rendering other documents only
+    // wait for the rasterization itself.
     QImage result(imageSize, QImage::Format_ARGB32);
     result.fill(Qt::transparent);
-    FPDF_BITMAP bitmap = FPDFBitmap_CreateEx(result.width(), result.height(), FPDFBitmap_BGRA, result.bits(), result.bytesPerLine());
 
     int rotation = 0;
     switch (renderOptions.rotation()) {
@@ -790,24 +1166,11 @@ QImage QPdfDocument::render(int page, QSize imageSize, QPdfDocumentRenderOptions
         break;
     }
 
-    const QPdf::RenderFlags renderFlags = renderOptions.renderFlags();
-    int flags = 0;
-    if (renderFlags & QPdf::RenderAnnotations)
-        flags |= FPDF_ANNOT;
-    if (renderFlags & QPdf::RenderOptimizedForLcd)
-        flags |= FPDF_LCD_TEXT;
-    if (renderFlags & QPdf::RenderGrayscale)
-        flags |= FPDF_GRAYSCALE;
-    if (renderFlags & QPdf::RenderForceHalftone)
-        flags |= FPDF_RENDER_FORCEHALFTONE;
-    if (renderFlags & QPdf::RenderTextAliased)
-        flags |= FPDF_RENDER_NO_SMOOTHTEXT;
-    if (renderFlags & QPdf::RenderImageAliased)
-        flags |= FPDF_RENDER_NO_SMOOTHIMAGE;
-    if (renderFlags & QPdf::RenderPathAliased)
-        flags |= FPDF_RENDER_NO_SMOOTHPATH;
+    const int flags = QPdfDocumentPrivate::pdfiumRenderFlags(renderOptions.renderFlags());
 
-    if (renderOptions.scaledClipRect().isValid()) {
+    const bool clipped = renderOptions.scaledClipRect().isValid();
+    FS_MATRIX matrix {1, 0, 0, 1, 0, 0};
+    if (clipped) {
         const QRect &clipRect = renderOptions.scaledClipRect();
 
         // TODO take rotation into account, like cpdf_page.cpp lines 145-178
@@ -817,17 +1180,34 @@ QImage QPdfDocument::render(int page, QSize imageSize, QPdfDocumentRenderOptions
         float y1 = clipRect.bottom();
         float x2 = clipRect.right();
         float y2 = clipRect.top();
-        QSizeF origSize = pageSize(page);
         QVector2D pageScale(1, 1);
         if (!renderOptions.scaledSize().isNull()) {
+            const QSizeF origSize = pageSize(page);
             pageScale = QVector2D(renderOptions.scaledSize().width() / float(origSize.width()),
                                   renderOptions.scaledSize().height() / float(origSize.height()));
         }
-        FS_MATRIX matrix {(x2 - x0) / result.width() * pageScale.x(),
-                          (y2 - y0) / result.width() * pageScale.x(),
-                          (x1 - x0) / result.height() * pageScale.y(),
-                          (y1 - y0) / result.height() * pageScale.y(), -x0, -y0};
+        matrix = FS_MATRIX {(x2 - x0) / result.width() * pageScale.x(),
+                            (y2 - y0) / result.width() * pageScale.x(),
+                            (x1 - x0) / result.height() * pageScale.y(),
+                            (y1 - y0) / result.height() * pageScale.y(), -x0, -y0};
+    }
+
+    QElapsedTimer timer;
+    if (Q_UNLIKELY(qLcDoc().isDebugEnabled()))
+        timer.start();
+
+    const QPdfMutexLocker lock;
+
+    if (Q_UNLIKELY(qLcDoc().isDebugEnabled()))
+        qCDebug(qLcDoc) << "page" << page << "waited" << timer.restart() << "ms for the pdfium lock";
+
+    FPDF_PAGE pdfPage = d->cachedPage(page);
+    if (!pdfPage)
+        return QImage();
+
+    FPDF_BITMAP bitmap = FPDFBitmap_CreateEx(result.width(), result.height(), FPDFBitmap_BGRA, result.bits(), result.bytesPerLine());
 
+    if (clipped) {
         FS_RECTF clipRectF { 0, 0, float(imageSize.width()), float(imageSize.height()) };
 
         FPDF_RenderPageBitmapWithMatrix(bitmap, pdfPage, &matrix, &clipRectF, flags);
@@ -841,20 +1221,137 @@ QImage QPdfDocument::render(int page, QSize imageSize, QPdfDocumentRenderOptions
 
     FPDFBitmap_Destroy(bitmap);
 
-    FPDF_ClosePage(pdfPage);
+    return result;
+}
+
+int QPdfDocumentPrivate::pdfiumRenderFlags(QPdf::RenderFlags renderFlags)
+{
+    int flags = 0;
+    if (renderFlags & QPdf::RenderAnnotations)
+        flags |= FPDF_ANNOT;
+    if (renderFlags & QPdf::RenderOptimizedForLcd)
+        flags |= FPDF_LCD_TEXT;
+    if (renderFlags & QPdf::RenderGrayscale)
+        flags |= FPDF_GRAYSCALE;
+    if (renderFlags & QPdf::RenderForceHalftone)
+        flags |= FPDF_RENDER_FORCEHALFTONE;
+    if (renderFlags & QPdf::RenderTextAliased)
+        flags |= FPDF_RENDER_NO_SMOOTHTEXT;
+    if (renderFlags & QPdf::RenderImageAliased)
+        flags |= FPDF_RENDER_NO_SMOOTHIMAGE;
+    if (renderFlags & QPdf::RenderPathAliased)
+        flags |= FPDF_RENDER_NO_SMOOTHPATH;
+    return flags;
+}
+
+QImage QPdfDocumentPrivate::renderTile(int page, QSize scaledSize, const QRect &rect,
+                                       QPdfDocumentRenderOptions options)
+{
+    if (!doc || rect.isEmpty() || scaledSize.isEmpty() || !checkPageComplete(page))
+        return QImage();
+    const QSizeF pointSize = q->pageSize(page);
+    if (pointSize.isEmpty())
+        return QImage();
+
+    QImage result(rect.size(), QImage::Format_ARGB32);
+    result.fill(Qt::transparent);
+
+    // pdfium applies the matrix to page coordinates in points with the origin
+    // at the top left. Rotate them, scale them to scaledSize and move the
+    // rect to the origin of the image, so that every pixel of the tile is the
+    // pixel of the whole page image at the same position.
+    const qreal w = pointSize.width();
+    const qreal h = pointSize.height();
+    qreal a = 1, b = 0, c = 0, d = 1, e = 0, f = 0;
+    QSizeF rotatedSize = pointSize;
+    switch (options.rotation()) {
+    case QPdf::Rotate0:
+        break;
+    case QPdf::Rotate90:
+        a = 0; b = 1; c = -1; d = 0; e = h;
+        rotatedSize.transpose();
+        break;
+    case QPdf::Rotate180:
+        a = -1; d = -1; e = w; f = h;
+        break;
+    case QPdf::Rotate270:
+        a = 0; b = -1; c = 1; d = 0; f = w;
+        rotatedSize.transpose();
+        break;
+    }
+    const qreal sx = scaledSize.width() / rotatedSize.width();
+    const qreal sy = scaledSize.height() / rotatedSize.height();
+    const FS_MATRIX matrix { float(a * sx), float(b * sy), float(c * sx), float(d * sy),
+                             float(e * sx - rect.x()), float(f * sy - rect.y()) };
+    const FS_RECTF clip { 0, 0, float(rect.width()), float(rect.height()) };
+    const int flags = pdfiumRenderFlags(options.renderFlags());
+
+    const QPdfMutexLocker lock;
+
+    FPDF_PAGE pdfPage = cachedPage(page);
+    if (!pdfPage)
+        return QImage();
+
+    FPDF_BITMAP bitmap = FPDFBitmap_CreateEx(result.width(), result.height(), FPDFBitmap_BGRA,
+                                             result.bits(), result.bytesPerLine());
+    FPDF_RenderPageBitmapWithMatrix(bitmap, pdfPage, &matrix, &clip, flags);
+    FPDFBitmap_Destroy(bitmap);
+    qCDebug(qLcDoc) << "page" << page << "tile" << rect << "of" << scaledSize;
+
     return result;
 }
 
+/*!
+    \since 6.4
+
+    Returns whether render() rasterizes pages in a worker process.
+
+    \sa setRenderWorkerProcessEnabled()
+*/
+bool QPdfDocument::isRenderWorkerProcessEnabled() const
+{
+    return d->renderWorkerProcessEnabled;
+}
+
+/*!
+    \since 6.4
+
+    Sets whether render() rasterizes pages in a worker process to \a enabled.
+    The default is \c false.
+
+    The PDF engine of a process renders one page at a time. With worker
+    processes enabled, every thread that calls render() gets a worker of its
+    own, which loads the document again and renders with an engine of its
+    own; threads rendering at the same time then run on several cores. The
+    worker of a thread exits when the thread finishes.
+
+    Only documents loaded from a file are rendered in a worker. Others, and
+    all documents if the \c QtPdfRenderProcess executable cannot be found or
+    started, are rendered in this process. The executable is looked for among
+    the library executables of Qt and next to the application, unless the
+    environment variable \c QTPDF_RENDERPROCESS_PATH is set to its path.
+
+    \sa render()
+*/
+void QPdfDocument::setRenderWorkerProcessEnabled(bool enabled)
+{
+    d->renderWorkerProcessEnabled = enabled;
+}
+
 /*!
     Returns information about the text on the given \a page that can be found
     between the given \a start and \a end points, if any.
 */
 QPdfSelection QPdfDocument::getSelection(int page, QPointF start, QPointF end)
 {
+    if (!d->doc || !d->checkPageComplete(page))
+        return {};
+
     const QPdfMutexLocker lock;
-    FPDF_PAGE pdfPage = FPDF_LoadPage(d->doc, page);
-    double pageHeight = FPDF_GetPageHeight(pdfPage);
-    FPDF_TEXTPAGE textPage = FPDFText_LoadPage(pdfPage);
+    FPDF_TEXTPAGE textPage = d->cachedTextPage(page);
+    if (!textPage)
+        return {};
+    double pageHeight = FPDF_GetPageHeight(d->cachedPage(page));
     int startIndex = FPDFText_GetCharIndexAtPos(textPage, start.x(), pageHeight - start.y(),
                                                 CharacterHitTolerance, CharacterHitTolerance);
     int endIndex = FPDFText_GetCharIndexAtPos(textPage, end.x(), pageHeight - end.y(),
@@ -893,9 +1390,6 @@ QPdfSelection QPdfDocument::getSelection(int page, QPointF start, QPointF end)
         qCDebug(qLcDoc) << page << start << "->" << end << "nothing found";
     }
 
-    FPDFText_ClosePage(textPage);
-    FPDF_ClosePage(pdfPage);
-
     return result;
 }
 
@@ -908,10 +1402,13 @@ QPdfSelection QPdfDocument::getSelectionAtIndex(int page, int startIndex, int ma
 
     if (page < 0 || startIndex < 0 || maxLength < 0)
         return {};
+    if (!d->doc || !d->checkPageComplete(page))
+        return {};
     const QPdfMutexLocker lock;
-    FPDF_PAGE pdfPage = FPDF_LoadPage(d->doc, page);
-    double pageHeight = FPDF_GetPageHeight(pdfPage);
-    FPDF_TEXTPAGE textPage = FPDFText_LoadPage(pdfPage);
+    FPDF_TEXTPAGE textPage = d->cachedTextPage(page);
+    if (!textPage)
+        return {};
+    double pageHeight = FPDF_GetPageHeight(d->cachedPage(page));
     int pageCount = FPDFText_CountChars(textPage);
     if (startIndex >= pageCount)
         return QPdfSelection();
@@ -938,9 +1435,6 @@ QPdfSelection QPdfDocument::getSelectionAtIndex(int page, int startIndex, int ma
     qCDebug(qLcDoc) << "on page" << page << "at index" << startIndex << "maxLength" << maxLength
                     << "got" << text.length() << "chars," << rectCount << "rects within" << hull;
 
-    FPDFText_ClosePage(textPage);
-    FPDF_ClosePage(pdfPage);
-
     return QPdfSelection(text, bounds, hull, startIndex, startIndex + text.length());
 }
 
@@ -949,10 +1443,14 @@ QPdfSelection QPdfDocument::getSelectionAtIndex(int page, int startIndex, int ma
 */
 QPdfSelection QPdfDocument::getAllText(int page)
 {
+    if (!d->doc || !d->checkPageComplete(page))
+        return {};
+
     const QPdfMutexLocker lock;
-    FPDF_PAGE pdfPage = FPDF_LoadPage(d->doc, page);
-    double pageHeight = FPDF_GetPageHeight(pdfPage);
-    FPDF_TEXTPAGE textPage = FPDFText_LoadPage(pdfPage);
+    FPDF_TEXTPAGE textPage = d->cachedTextPage(page);
+    if (!textPage)
+        return {};
+    double pageHeight = FPDF_GetPageHeight(d->cachedPage(page));
     int count = FPDFText_CountChars(textPage);
     if (count < 1)
         return QPdfSelection();
@@ -972,9 +1470,6 @@ QPdfSelection QPdfDocument::getAllText(int page)
     }
     qCDebug(qLcDoc) << "on page" << page << "got" << count << "chars," << rectCount << "rects within" << hull;
 
-    FPDFText_ClosePage(textPage);
-    FPDF_ClosePage(pdfPage);
-
     return QPdfSelection(text, bounds, hull, 0, count);
 }
 
@@ -117,6 +117,9 @@ public:
 
     QImage render(int page, QSize imageSize, QPdfDocumentRenderOptions options = QPdfDocumentRenderOptions());
 
+    bool isRenderWorkerProcessEnabled() const;
+    void setRenderWorkerProcessEnabled(bool enabled);
+
     Q_INVOKABLE QPdfSelection getSelection(int page, QPointF start, QPointF end);
     Q_INVOKABLE QPdfSelection getSelectionAtIndex(int page, int startIndex, int maxLength);
     Q_INVOKABLE QPdfSelection getAllText(int page);
@@ -126,13 +129,17 @@ Q_SIGNALS:
     void passwordRequired();
     void statusChanged(QPdfDocument::Status status);
     void pageCountChanged(int pageCount);
+    void pageAvailable(int page);
 
 private:
     friend struct QPdfBookmarkModelPrivate;
+    friend class QPdfDocumentPrivate;
     friend class QPdfFile;
     friend class QPdfLinkModelPrivate;
     friend class QPdfSearchModel;
     friend class QPdfSearchModelPrivate;
+    friend class QPdfTileCache;
+    friend class QPdfViewPrivate;
     friend class QQuickPdfSelection;
 
     QString fileName() const;
@@ -57,14 +57,21 @@
 #include "third_party/pdfium/public/fpdf_dataavail.h"
 
 #include <QtCore/qbuffer.h>
+#include <QtCore/qcache.h>
+#include <QtCore/qlist.h>
 #include <QtCore/qmutex.h>
 #include <QtCore/qpointer.h>
+#include <QtCore/qsharedpointer.h>
 #include <QtNetwork/qnetworkreply.h>
 
 #include <mutex>
 
 QT_BEGIN_NAMESPACE
 
+class QFileDevice;
+class QPdfRangeLoader;
+class QPdfTextIndex;
+
 class QPdfMutexLocker : public std::unique_lock<QRecursiveMutex>
 {
 public:
@@ -87,15 +94,53 @@ public:
     QScopedPointer<QIODevice> ownDevice;
     QBuffer asyncBuffer;
     QPointer<QIODevice> sequentialSourceDevice;
+    // set instead of device if a remote file is fetched with range requests
+    QSharedPointer<QPdfRangeLoader> rangeLoader;
+    // pages that were asked for before they had been fetched; pageAvailable()
+    // is emitted for them once they arrive
+    QMutex pendingPagesMutex;
+    QList<int> pendingPages;
+    // the whole file, if the document was loaded from a local file that could be mapped
+    const uchar *mappedData = nullptr;
+    qint64 mappedSize = 0;
     QByteArray password;
+    bool renderWorkerProcessEnabled = false;
 
     QPdfDocument::Status status;
     QPdfDocument::DocumentError lastError;
     int pageCount;
 
+    // Page sizes are immutable once a page is available, so they are cached
+    // behind a per-document lock to keep them out of the global pdfium lock.
+    QMutex pageSizeMutex;
+    QList<QSizeF> pageSizes;
+
+    // Recently used page and text page handles, so that rendering, hit
+    // testing, selection, link and search queries on the same page do not
+    // parse it over and over. Only to be used with the pdfium lock held.
+    struct CachedPage
+    {
+        ~CachedPage();
+        FPDF_PAGE page = nullptr;
+        FPDF_TEXTPAGE textPage = nullptr;
+    };
+    struct PageCacheStatistics
+    {
+        quint64 pageHits = 0;
+        quint64 pageMisses = 0;
+        quint64 textPageHits = 0;
+        quint64 textPageMisses = 0;
+    };
+    QCache<int, CachedPage> pageCache;
+    PageCacheStatistics pageCacheStatistics;
+
+    // built on demand for QPdfSearchModel, dropped when the document is closed
+    QSharedPointer<QPdfTextIndex> textIndex;
+
     void clear();
 
     void load(QIODevice *device, bool ownDevice);
+    void mapFile(QFileDevice *file);
     void loadAsync(QIODevice *device);
 
     void _q_tryLoadingWithSizeFromContentHeader();
@@ -104,12 +149,23 @@ public:
     void tryLoadDocument();
     void checkComplete();
     bool checkPageComplete(int page);
+    bool waitForPage(int page);
+    bool isPageAvailable(int page);
+    void addPendingPage(int page);
+    bool isPagePending(int page);
+    void emitAvailablePages();
     void setStatus(QPdfDocument::Status status);
 
     static FPDF_BOOL fpdf_IsDataAvail(struct _FX_FILEAVAIL* pThis, size_t offset, size_t size);
     static int fpdf_GetBlock(void* param, unsigned long position, unsigned char* pBuf, unsigned long size);
     static void fpdf_AddSegment(struct _FX_DOWNLOADHINTS* pThis, size_t offset, size_t size);
     void updateLastError();
+    FPDF_PAGE cachedPage(int page);
+    FPDF_TEXTPAGE cachedTextPage(int page);
+    void clearPageCache();
+    PageCacheStatistics cacheStatistics() const;
+    static QPdfDocumentPrivate *get(QPdfDocument *document) { return document->d.data(); }
+    QSharedPointer<QPdfTextIndex> ensureTextIndex(const QString &fileName);
     QString getText(FPDF_TEXTPAGE textPage, int startIndex, int count);
     QPointF getCharPosition(FPDF_TEXTPAGE textPage, double pageHeight, int charIndex);
     QRectF getCharBox(FPDF_TEXTPAGE textPage, double pageHeight, int charIndex);
@@ -120,6 +176,11 @@ public:
         int charIndex = -1;
     };
     TextPosition hitTest(int page, QPointF position);
+
+    // Renders the area rect of the page scaled to scaledSize, mapping the page
+    // exactly onto the pixels of rect so that adjacent tiles line up.
+    QImage renderTile(int page, QSize scaledSize, const QRect &rect, QPdfDocumentRenderOptions options);
+    static int pdfiumRenderFlags(QPdf::RenderFlags renderFlags);
 };
 
 QT_END_NAMESPACE
@@ -38,6 +38,7 @@
 ****************************************************************************/
 
 #include "qpdfpagerenderer.h"
+#include "qpdftilecache_p.h"
 
 #include <private/qobject_p.h>
 #include <QMutex>
@@ -128,7 +129,10 @@ void RenderWorker::requestPage(quint64 requestId, int pageNumber, QSize imageSiz
     if (!m_document || m_document->status() != QPdfDocument::Ready)
         return;
 
-    const QImage image = m_document->render(pageNumber, imageSize, options);
+    // the cache is gone when pages are rendered during application exit
+    QPdfTileCache *cache = QPdfTileCache::instance();
+    const QImage image = cache ? cache->render(m_document, pageNumber, imageSize, options)
+                               : m_document->render(pageNumber, imageSize, options);
 
     emit pageRendered(pageNumber, imageSize, image, options, requestId);
 }
@@ -181,6 +185,12 @@ void QPdfPageRendererPrivate::requestFinished(int page, QSize imageSize, const Q
     (\c RenderMode::MultiThreaded) and emits the result through the pageRendered() signal for each request once
     the rendering is done.
 
+    Rendered images are kept in a cache shared with QPdfView and the PDF image
+    format plugin, so repeated requests for the same page, size and options
+    are answered without rendering the page again. A page can be rendered in
+    tiles by passing a QPdfDocumentRenderOptions with a scaled size and a
+    scaled clip rectangle.
+
     \sa QPdfDocument
 */
 
@@ -0,0 +1,442 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtPDF module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qpdfrangeloader_p.h"
+
+#include <QLoggingCategory>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QNetworkRequest>
+#include <QThread>
+#include <QTimer>
+
+QT_BEGIN_NAMESPACE
+
+Q_LOGGING_CATEGORY(qLcRange, "qt.pdf.rangeloader")
+
+// Ranges are fetched in multiples of this, so that pdfium's many small
+// hints do not turn into as many requests.
+static const qint64 ChunkSize = 64 * 1024;
+// Data this close ahead of what the initial reply has delivered is left to
+// that reply instead of being requested again.
+static const qint64 StreamLookahead = 1024 * 1024;
+// A failed range request is retried this many times, after a growing delay.
+static const int MaxAttempts = 3;
+static const int RetryDelay = 500;
+
+// If-Range only accepts a strong entity tag or a date.
+static QByteArray validator(const QNetworkReply *reply)
+{
+    const QByteArray etag = reply->rawHeader("ETag").trimmed();
+    if (!etag.isEmpty() && !etag.startsWith("W/"))
+        return etag;
+    return reply->rawHeader("Last-Modified").trimmed();
+}
+
+QPdfRangeLoader::QPdfRangeLoader(QNetworkReply *initialReply, qint64 totalSize, QObject *parent)
+    : QObject(parent)
+    , m_manager(initialReply->manager())
+    , m_url(initialReply->url())
+    , m_size(totalSize)
+    , m_request(initialReply->request())
+    , m_validator(validator(initialReply))
+    , m_initialReply(initialReply)
+{
+    // after redirects, the file is where the reply ended up
+    m_request.setUrl(m_url);
+    // a not modified response would carry no data
+    m_request.setRawHeader("If-None-Match", QByteArray());
+    m_request.setRawHeader("If-Modified-Since", QByteArray());
+
+    if (!m_cache.open() || !m_cache.resize(m_size)) {
+        qCWarning(qLcRange) << "cannot create a cache file for" << m_url << m_cache.errorString();
+        m_cache.close();
+        return;
+    }
+
+    connect(initialReply, &QNetworkReply::readyRead, this, &QPdfRangeLoader::readFromInitialReply);
+    connect(initialReply, &QNetworkReply::finished, this, &QPdfRangeLoader::initialReplyFinished);
+    // what the reply did not deliver has to be requested if it goes away early
+    connect(initialReply, &QObject::destroyed, this, &QPdfRangeLoader::dataAvailable);
+    if (initialReply->isFinished())
+        initialReplyFinished();
+    else if (initialReply->bytesAvailable())
+        readFromInitialReply();
+}
+
+QPdfRangeLoader::~QPdfRangeLoader()
+{
+    cancel();
+}
+
+bool QPdfRangeLoader::supportsRanges(const QNetworkReply *reply)
+{
+    const QString scheme = reply->url().scheme();
+    if (scheme != QLatin1String("http") && scheme != QLatin1String("https"))
+        return false;
+    // a Content-Length of an encoded body is not the size of the file
+    if (reply->hasRawHeader("Content-Encoding"))
+        return false;
+    return reply->rawHeader("Accept-Ranges").trimmed().toLower() == "bytes"
+            && reply->header(QNetworkRequest::ContentLengthHeader).isValid()
+            && reply->manager();
+}
+
+bool QPdfRangeLoader::isComplete() const
+{
+    const QMutexLocker locker(&m_mutex);
+    return m_available.size() == 1 && m_available.firstKey() == 0
+            && m_available.first() >= m_size;
+}
+
+bool QPdfRangeLoader::isCancelled() const
+{
+    const QMutexLocker locker(&m_mutex);
+    return m_cancelled;
+}
+
+bool QPdfRangeLoader::isAvailable(qint64 offset, qint64 size) const
+{
+    if (size <= 0)
+        return true;
+
+    const QMutexLocker locker(&m_mutex);
+    auto it = m_available.upperBound(offset);
+    if (it == m_available.cbegin())
+        return false;
+    --it;
+    return it.value() >= offset + size;
+}
+
+qint64 QPdfRangeLoader::read(qint64 offset, char *data, qint64 size)
+{
+    const QMutexLocker locker(&m_mutex);
+    if (!m_cache.seek(offset))
+        return 0;
+    return qMax(qint64(0), m_cache.read(data, size));
+}
+
+void QPdfRangeLoader::request(qint64 offset, qint64 size)
+{
+    if (isAvailable(offset, size))
+        return;
+    // pdfium gives its hints from whatever thread it runs on; the network
+    // requests have to be made in ours
+    QMetaObject::invokeMethod(this, [this, offset, size] { startRequest(offset, size); },
+                              Qt::QueuedConnection);
+}
+
+quint64 QPdfRangeLoader::generation() const
+{
+    const QMutexLocker locker(&m_mutex);
+    return m_generation;
+}
+
+/*
+    Blocks until more data has been stored than at \a sinceGeneration, a range
+    failed to load, the loader was cancelled, or the \a deadline expired.
+    Returns \c true if new data arrived. Must not be called from the thread of
+    the loader.
+*/
+bool QPdfRangeLoader::waitForData(quint64 sinceGeneration, QDeadlineTimer deadline)
+{
+    Q_ASSERT(QThread::currentThread() != thread());
+
+    QMutexLocker locker(&m_mutex);
+    const quint64 failures = m_failures;
+    while (m_generation == sinceGeneration && m_failures == failures && !m_cancelled) {
+        if (!m_dataArrived.wait(&m_mutex, deadline))
+            return false;
+    }
+    return m_generation != sinceGeneration;
+}
+
+void QPdfRangeLoader::cancel()
+{
+    // the initial reply is not ours to abort, just stop listening to it
+    if (m_initialReply) {
+        m_initialReply->disconnect(this);
+        m_initialReply = nullptr;
+    }
+    for (auto it = m_fetches.cbegin(); it != m_fetches.cend(); ++it) {
+        QNetworkReply *reply = it.key();
+        reply->disconnect(this);
+        reply->abort();
+        reply->deleteLater();
+    }
+    m_fetches.clear();
+    m_retries.clear();
+
+    const QMutexLocker locker(&m_mutex);
+    m_cancelled = true;
+    m_dataArrived.wakeAll();
+}
+
+void QPdfRangeLoader::readFromInitialReply()
+{
+    if (!m_initialReply)
+        return;
+    const QByteArray data = m_initialReply->readAll();
+    if (data.isEmpty())
+        return;
+    if (m_streamOffset < m_size && !store(m_streamOffset, data.left(m_size - m_streamOffset))) {
+        emit failed(QNetworkReply::UnknownContentError);
+        return;
+    }
+    m_streamOffset += data.size();
+    emit dataAvailable();
+}
+
+void QPdfRangeLoader::initialReplyFinished()
+{
+    if (!m_initialReply)
+        return;
+    readFromInitialReply();
+    if (m_initialReply->error() != QNetworkReply::NoError)
+        qCDebug(qLcRange) << "the initial reply stopped after" << m_streamOffset << "bytes:"
+                          << m_initialReply->errorString();
+    m_initialReply->disconnect(this);
+    m_initialReply = nullptr;
+    // whatever it did not deliver is requested from now on
+    emit dataAvailable();
+}
+
+bool QPdfRangeLoader::isRequested(qint64 offset, qint64 end) const
+{
+    for (const Fetch &fetch : m_fetches) {
+        if (fetch.offset <= offset && end <= fetch.end)
+            return true;
+    }
+    for (const Fetch &fetch : m_retries) {
+        if (fetch.offset <= offset && end <= fetch.end)
+            return true;
+    }
+    return false;
+}
+
+void QPdfRangeLoader::startRequest(qint64 offset, qint64 size)
+{
+    if (!isValid() || isCancelled())
+        return;
+
+    const qint64 start = qBound(qint64(0), offset, m_size) / ChunkSize * ChunkSize;
+    const qint64 end = qMin(m_size, (offset + size + ChunkSize - 1) / ChunkSize * ChunkSize);
+    if (start >= end || isAvailable(offset, size) || isRequested(offset, qMin(offset + size, m_size)))
+        return;
+    if (m_initialReply && offset + size <= m_streamOffset + StreamLookahead)
+        return; // on its way
+
+    fetch(start, end, 0);
+}
+
+void QPdfRangeLoader::fetch(qint64 offset, qint64 end, int attempt)
+{
+    qCDebug(qLcRange) << "requesting" << offset << "to" << end << "of" << m_url;
+    QNetworkRequest request(m_request);
+    request.setRawHeader("Range", "bytes=" + QByteArray::number(offset) + '-' + QByteArray::number(end - 1));
+    if (!m_validator.isEmpty())
+        request.setRawHeader("If-Range", m_validator);
+    QNetworkReply *reply = m_manager->get(request);
+    Fetch pending{ offset, end };
+    pending.attempt = attempt;
+    m_fetches.insert(reply, pending);
+    connect(reply, &QNetworkReply::readyRead, this, [this, reply] { readFrom(reply); });
+    connect(reply, &QNetworkReply::finished, this, [this, reply] { finished(reply); });
+}
+
+void QPdfRangeLoader::readFrom(QNetworkReply *reply)
+{
+    auto it = m_fetches.find(reply);
+    if (it == m_fetches.end())
+        return;
+
+    if (!it->started) {
+        const int statusCode = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+        if (statusCode != 200 && statusCode != 206) {
+            // an error page; finished() retries
+            reply->readAll();
+            return;
+        }
+        it->started = true;
+        if (!isSameFile(reply, statusCode, it->offset)) {
+            qCWarning(qLcRange) << m_url << "changed on the server, not loading any more of it";
+            m_fetches.erase(it);
+            reply->disconnect(this);
+            reply->abort();
+            reply->deleteLater();
+            {
+                const QMutexLocker locker(&m_mutex);
+                ++m_failures;
+                m_dataArrived.wakeAll();
+            }
+            emit failed(QNetworkReply::ContentConflictError);
+            return;
+        }
+        if (statusCode == 200) {
+            // a server may ignore the range and send the whole file instead
+            qCDebug(qLcRange) << m_url << "ignored the range request";
+            it->offset = 0;
+            it->end = m_size;
+        }
+    }
+
+    const QByteArray data = reply->readAll();
+    if (data.isEmpty())
+        return;
+    const qint64 offset = it->offset;
+    it->offset += data.size();
+
+    if (offset < m_size && !store(offset, data.left(m_size - offset))) {
+        emit failed(QNetworkReply::UnknownContentError);
+        return;
+    }
+
+    emit dataAvailable();
+}
+
+/*
+    Returns whether the response \a reply with \a statusCode belongs to the
+    same version of the file as the initial reply, and for a partial response,
+    whether it starts at \a offset.
+*/
+bool QPdfRangeLoader::isSameFile(const QNetworkReply *reply, int statusCode, qint64 offset) const
+{
+    if (statusCode == 200) {
+        // With If-Range, the whole file comes back if it is not the one named
+        const QVariant length = reply->header(QNetworkRequest::ContentLengthHeader);
+        return validator(reply) == m_validator && (!length.isValid() || length.toLongLong() == m_size);
+    }
+
+    // Content-Range: bytes <first>-<last>/<size>
+    const QByteArray contentRange = reply->rawHeader("Content-Range").trimmed();
+    const qsizetype dash = contentRange.indexOf('-');
+    const qsizetype slash = contentRange.indexOf('/');
+    if (!contentRange.startsWith("bytes ") || dash < 0 || slash < dash)
+        return false;
+    bool firstOk = false;
+    bool sizeOk = false;
+    const qint64 first = contentRange.mid(6, dash - 6).trimmed().toLongLong(&firstOk);
+    const qint64 size = contentRange.mid(slash + 1).trimmed().toLongLong(&sizeOk);
+    return firstOk && sizeOk && first == offset && size == m_size;
+}
+
+void QPdfRangeLoader::finished(QNetworkReply *reply)
+{
+    if (reply->error() == QNetworkReply::NoError && reply->bytesAvailable())
+        readFrom(reply);
+    if (!m_fetches.contains(reply))
+        return; // given up on in readFrom()
+
+    const Fetch fetch = m_fetches.take(reply);
+    reply->deleteLater();
+
+    if (reply->error() == QNetworkReply::NoError) {
+        // If the server sent less than asked for, the missing part will be
+        // requested again when pdfium asks for it.
+        if (fetch.offset < fetch.end)
+            qCDebug(qLcRange) << "short response for" << fetch.offset << "to" << fetch.end;
+        return;
+    }
+
+    if (fetch.attempt + 1 < MaxAttempts) {
+        qCDebug(qLcRange) << "fetching" << fetch.offset << "to" << fetch.end << "failed:"
+                          << reply->errorString() << "- retrying";
+        m_retries.append(fetch);
+        QTimer::singleShot(RetryDelay * (fetch.attempt + 1), this, [this, fetch] {
+            for (qsizetype i = 0; i < m_retries.size(); ++i) {
+                const Fetch &retry = m_retries.at(i);
+                if (retry.offset == fetch.offset && retry.end == fetch.end) {
+                    m_retries.removeAt(i);
+                    if (!isAvailable(fetch.offset, fetch.end - fetch.offset))
+                        this->fetch(fetch.offset, fetch.end, fetch.attempt + 1);
+                    return;
+                }
+            }
+        });
+        return;
+    }
+
+    // Only this range failed: pdfium asking for it again starts over.
+    qCWarning(qLcRange) << "fetching" << fetch.offset << "to" << fetch.end << "of" << m_url
+                        << "failed:" << reply->errorString();
+    {
+        const QMutexLocker locker(&m_mutex);
+        ++m_failures;
+        m_dataArrived.wakeAll();
+    }
+    emit failed(reply->error());
+}
+
+bool QPdfRangeLoader::store(qint64 offset, const QByteArray &data)
+{
+    const QMutexLocker locker(&m_mutex);
+    if (!m_cache.seek(offset) || m_cache.write(data) != data.size()) {
+        qCWarning(qLcRange) << "cannot write to the cache file" << m_cache.errorString();
+        ++m_failures;
+        m_dataArrived.wakeAll();
+        return false;
+    }
+
+    // insert [offset, end) and merge it with the ranges it touches
+    qint64 start = offset;
+    qint64 end = offset + data.size();
+    auto it = m_available.upperBound(start);
+    if (it != m_available.begin()) {
+        auto previous = std::prev(it);
+        if (previous.value() >= start) {
+            start = previous.key();
+            end = qMax(end, previous.value());
+            it = m_available.erase(previous);
+        }
+    }
+    while (it != m_available.end() && it.key() <= end) {
+        end = qMax(end, it.value());
+        it = m_available.erase(it);
+    }
+    m_available.insert(start, end);
+
+    ++m_generation;
+    m_dataArrived.wakeAll();
+    return true;
+}
+
+QT_END_NAMESPACE
+
+#include "moc_qpdfrangeloader_p.cpp"
@@ -0,0 +1,153 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtPDF module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QPDFRANGELOADER_P_H
+#define QPDFRANGELOADER_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtPdf/qtpdfglobal.h>
+
+#include <QtCore/qdeadlinetimer.h>
+#include <QtCore/qhash.h>
+#include <QtCore/qmap.h>
+#include <QtCore/qmutex.h>
+#include <QtCore/qobject.h>
+#include <QtCore/qpointer.h>
+#include <QtCore/qtemporaryfile.h>
+#include <QtCore/qurl.h>
+#include <QtCore/qwaitcondition.h>
+#include <QtNetwork/qnetworkreply.h>
+#include <QtNetwork/qnetworkrequest.h>
+
+QT_BEGIN_NAMESPACE
+
+class QNetworkAccessManager;
+
+// Fetches a remote file on demand with HTTP range requests, for the
+// segments pdfium asks for through its download hints, and keeps what has
+// been fetched in a sparse temporary file.
+//
+// The reply the document was loaded with still delivers the file from its
+// beginning; ranges are only requested for data it is not about to deliver.
+// That reply belongs to the application and is never aborted. Ranges are
+// requested with its request, so that they carry the same credentials and
+// headers, and with If-Range, so that a file that changes on the server is
+// not assembled from two versions.
+//
+// The loader lives in the thread of the document. isAvailable(), read(),
+// request() and waitForData() may be called from any thread.
+class QPdfRangeLoader : public QObject
+{
+    Q_OBJECT
+public:
+    QPdfRangeLoader(QNetworkReply *initialReply, qint64 totalSize, QObject *parent = nullptr);
+    ~QPdfRangeLoader() override;
+
+    static bool supportsRanges(const QNetworkReply *reply);
+
+    bool isValid() const { return m_cache.isOpen(); }
+    qint64 size() const { return m_size; }
+    bool isComplete() const;
+    bool isCancelled() const;
+
+    bool isAvailable(qint64 offset, qint64 size) const;
+    qint64 read(qint64 offset, char *data, qint64 size);
+    void request(qint64 offset, qint64 size);
+
+    quint64 generation() const;
+    bool waitForData(quint64 sinceGeneration, QDeadlineTimer deadline);
+    void cancel();
+
+Q_SIGNALS:
+    void dataAvailable();
+    // a range could not be fetched, even after retrying
+    void failed(QNetworkReply::NetworkError error);
+
+private:
+    void readFromInitialReply();
+    void initialReplyFinished();
+    void startRequest(qint64 offset, qint64 size);
+    void fetch(qint64 offset, qint64 end, int attempt);
+    bool isSameFile(const QNetworkReply *reply, int statusCode, qint64 offset) const;
+    void readFrom(QNetworkReply *reply);
+    void finished(QNetworkReply *reply);
+    bool store(qint64 offset, const QByteArray &data);
+    bool isRequested(qint64 offset, qint64 end) const;
+
+    struct Fetch
+    {
+        qint64 offset;      // where the next received byte goes
+        qint64 end;         // end of the requested range
+        int attempt = 0;
+        bool started = false;
+    };
+
+    QNetworkAccessManager *m_manager;
+    const QUrl m_url;
+    const qint64 m_size;
+    QNetworkRequest m_request; // what the ranges are requested with
+    QByteArray m_validator; // strong ETag or Last-Modified of the file
+    QPointer<QNetworkReply> m_initialReply;
+    qint64 m_streamOffset = 0; // how far the initial reply got
+    QHash<QNetworkReply *, Fetch> m_fetches;
+    QList<Fetch> m_retries;
+
+    mutable QMutex m_mutex;
+    QWaitCondition m_dataArrived;
+    QTemporaryFile m_cache;
+    QMap<qint64, qint64> m_available; // disjoint ranges: start -> end
+    quint64 m_generation = 0;
+    quint64 m_failures = 0;
+    bool m_cancelled = false;
+};
+
+QT_END_NAMESPACE
+
+#endif // QPDFRANGELOADER_P_H
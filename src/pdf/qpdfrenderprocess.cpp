@@ -0,0 +1,210 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtPDF module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+
+#include "qpdfrenderprocess_p.h"
+
+#include <QCoreApplication>
+#include <QFileInfo>
+#include <QLibraryInfo>
+#include <QLoggingCategory>
+#include <QThreadStorage>
+
+QT_BEGIN_NAMESPACE
+
+Q_LOGGING_CATEGORY(qLcRenderProcess, "qt.pdf.renderprocess")
+
+// how long a page may take to render before the worker is given up on
+static const int RenderTimeout = 60000;
+
+Q_GLOBAL_STATIC(QThreadStorage<QPdfRenderProcess *>, renderProcesses)
+
+QDataStream &operator<<(QDataStream &out, const QPdfRenderRequest &request)
+{
+    out << request.fileName << request.password << qint32(request.page) << request.imageSize
+        << qint32(request.options.rotation()) << qint32(request.options.renderFlags().toInt())
+        << request.options.scaledClipRect() << request.options.scaledSize();
+    return out;
+}
+
+QDataStream &operator>>(QDataStream &in, QPdfRenderRequest &request)
+{
+    qint32 page, rotation, renderFlags;
+    QRect scaledClipRect;
+    QSize scaledSize;
+    in >> request.fileName >> request.password >> page >> request.imageSize
+       >> rotation >> renderFlags >> scaledClipRect >> scaledSize;
+    request.page = page;
+    request.options.setRotation(QPdf::Rotation(rotation));
+    request.options.setRenderFlags(QPdf::RenderFlags::fromInt(renderFlags));
+    request.options.setScaledClipRect(scaledClipRect);
+    request.options.setScaledSize(scaledSize);
+    return in;
+}
+
+QPdfRenderProcess::~QPdfRenderProcess()
+{
+    // the worker exits when its input is closed
+    m_process.closeWriteChannel();
+    if (!m_process.waitForFinished(1000))
+        m_process.kill();
+}
+
+/*!
+    \internal
+    Returns the path of the worker executable, or an empty string if it
+    cannot be found. QTPDF_RENDERPROCESS_PATH overrides where it is looked
+    for.
+*/
+QString QPdfRenderProcess::executablePath()
+{
+    static const QString path = []() {
+#if defined(Q_OS_WIN)
+        const QString binary = QStringLiteral("QtPdfRenderProcess.exe");
+#else
+        const QString binary = QStringLiteral("QtPdfRenderProcess");
+#endif
+        QStringList candidates;
+        const QString fromEnv = qEnvironmentVariable("QTPDF_RENDERPROCESS_PATH");
+        if (!fromEnv.isEmpty()) {
+            candidates << fromEnv;
+        } else {
+            candidates << QLibraryInfo::path(QLibraryInfo::LibraryExecutablesPath) + QLatin1Char('/') + binary;
+            candidates << QCoreApplication::applicationDirPath() + QLatin1Char('/') + binary;
+        }
+        for (const QString &candidate : qAsConst(candidates)) {
+            if (QFileInfo::exists(candidate))
+                return candidate;
+        }
+        qCWarning(qLcRenderProcess) << "cannot find" << binary << "in" << candidates;
+        return QString();
+    }();
+    return path;
+}
+
+/*!
+    \internal
+    Returns the worker of the calling thread. The worker is started the first
+    time it renders, and stops when the thread finishes.
+*/
+QPdfRenderProcess *QPdfRenderProcess::forCurrentThread()
+{
+    if (!renderProcesses->hasLocalData())
+        renderProcesses->setLocalData(new QPdfRenderProcess);
+    return renderProcesses->localData();
+}
+
+bool QPdfRenderProcess::start()
+{
+    const QString program = executablePath();
+    if (program.isEmpty())
+        return false;
+    m_process.setProcessChannelMode(QProcess::ForwardedErrorChannel);
+    m_process.start(program, QStringList());
+    if (!m_process.waitForStarted()) {
+        qCWarning(qLcRenderProcess) << "cannot start" << program << m_process.errorString();
+        return false;
+    }
+    qCDebug(qLcRenderProcess) << "started" << program << m_process.processId();
+    return true;
+}
+
+/*!
+    \internal
+    Has the worker render \a request into \a result. Returns \c false if the
+    worker cannot be used, in which case the caller renders in process.
+*/
+bool QPdfRenderProcess::render(const QPdfRenderRequest &request, QImage *result)
+{
+    if (m_failed)
+        return false;
+    if (m_process.state() != QProcess::Running && !start()) {
+        m_failed = true;
+        return false;
+    }
+
+    QDataStream out(&m_process);
+    out.setVersion(QDataStream::Qt_6_0);
+    out << request;
+
+    QDataStream in(&m_process);
+    in.setVersion(QDataStream::Qt_6_0);
+    forever {
+        in.startTransaction();
+        QImage image = readImage(in);
+        if (in.commitTransaction()) {
+            *result = image;
+            return true;
+        }
+        if (!m_process.waitForReadyRead(RenderTimeout)) {
+            // started again for the next page
+            qCWarning(qLcRenderProcess) << "the render process failed:" << m_process.errorString();
+            m_process.kill();
+            m_process.waitForFinished();
+            return false;
+        }
+    }
+}
+
+// Images go over the pipe uncompressed: encoding them would cost more than
+// rendering them in process.
+void QPdfRenderProcess::writeImage(QDataStream &out, const QImage &image)
+{
+    out << image.size() << qint32(image.format()) << qint32(image.bytesPerLine());
+    if (!image.isNull())
+        out.writeBytes(reinterpret_cast<const char *>(image.constBits()), image.sizeInBytes());
+}
+
+QImage QPdfRenderProcess::readImage(QDataStream &in)
+{
+    QSize size;
+    qint32 format, bytesPerLine;
+    in >> size >> format >> bytesPerLine;
+    if (in.status() != QDataStream::Ok || size.isEmpty())
+        return QImage();
+    QByteArray bits;
+    in >> bits;
+    if (in.status() != QDataStream::Ok || bits.size() != qsizetype(bytesPerLine) * size.height())
+        return QImage();
+    QImage image(size, QImage::Format(format));
+    if (image.bytesPerLine() != bytesPerLine)
+        return QImage();
+    memcpy(image.bits(), bits.constData(), bits.size());
+    return image;
+}
+
+QT_END_NAMESPACE
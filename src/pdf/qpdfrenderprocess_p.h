@@ -0,0 +1,106 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtPDF module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QPDFRENDERPROCESS_P_H
+#define QPDFRENDERPROCESS_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include "qpdfdocumentrenderoptions.h"
+
+#include <QtCore/qdatastream.h>
+#include <QtCore/qprocess.h>
+#include <QtGui/qimage.h>
+
+QT_BEGIN_NAMESPACE
+
+// What a worker process is asked to render. The worker loads the document
+// from the file itself, so only documents that have a file can be rendered
+// out of process.
+struct QPdfRenderRequest
+{
+    QString fileName;
+    QString password;
+    int page = -1;
+    QSize imageSize;
+    QPdfDocumentRenderOptions options;
+};
+
+Q_PDF_PRIVATE_EXPORT QDataStream &operator<<(QDataStream &out, const QPdfRenderRequest &request);
+Q_PDF_PRIVATE_EXPORT QDataStream &operator>>(QDataStream &in, QPdfRenderRequest &request);
+
+// Renders pages in a QtPdfRenderProcess worker, which has a PDF engine of
+// its own. The engine of this process is serialized by QPdfMutexLocker, so
+// rendering only scales across cores in several processes: every thread
+// that renders gets a worker of its own.
+class Q_PDF_PRIVATE_EXPORT QPdfRenderProcess
+{
+public:
+    ~QPdfRenderProcess();
+
+    static QString executablePath();
+    static QPdfRenderProcess *forCurrentThread();
+
+    bool render(const QPdfRenderRequest &request, QImage *result);
+
+    // how images are sent over the pipe
+    static void writeImage(QDataStream &out, const QImage &image);
+    static QImage readImage(QDataStream &in);
+
+private:
+    QPdfRenderProcess() = default;
+    bool start();
+
+    QProcess m_process;
+    bool m_failed = false; // the worker could not be started, render in process
+};
+
+QT_END_NAMESPACE
+
+#endif // QPDFRENDERPROCESS_P_H
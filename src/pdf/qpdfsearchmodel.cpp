@@ -190,6 +190,69 @@ void QPdfSearchModel::setSearchString(const QString &searchString)
     endResetModel();
 }
 
+/*!
+    \property QPdfSearchModel::textIndexEnabled
+    \since 6.4
+    \brief whether searches use a full-text index of the document
+
+    When enabled, the text and character positions of all pages are extracted
+    once in the background. After that, each new search string is matched
+    against the index on all available cores, and when the search string
+    is extended (as while the user is typing), only the previous matches
+    are checked again. Until the index is ready, pages are searched one by
+    one as usual.
+
+    The default is \c false.
+
+    \sa textIndexFileName
+*/
+bool QPdfSearchModel::isTextIndexEnabled() const
+{
+    Q_D(const QPdfSearchModel);
+    return d->textIndexEnabled;
+}
+
+void QPdfSearchModel::setTextIndexEnabled(bool enabled)
+{
+    Q_D(QPdfSearchModel);
+    if (d->textIndexEnabled == enabled)
+        return;
+
+    d->textIndexEnabled = enabled;
+    beginResetModel();
+    d->clearResults();
+    endResetModel();
+    emit textIndexEnabledChanged();
+}
+
+/*!
+    \property QPdfSearchModel::textIndexFileName
+    \since 6.4
+    \brief the file in which the text index is kept between sessions
+
+    If set, the index is read from this file instead of being extracted
+    again, provided that it was built for the same document; otherwise it is
+    rebuilt and written to the file. The property only takes effect the next
+    time an index is built for the \l document.
+
+    \sa textIndexEnabled
+*/
+QString QPdfSearchModel::textIndexFileName() const
+{
+    Q_D(const QPdfSearchModel);
+    return d->textIndexFileName;
+}
+
+void QPdfSearchModel::setTextIndexFileName(const QString &fileName)
+{
+    Q_D(QPdfSearchModel);
+    if (d->textIndexFileName == fileName)
+        return;
+
+    d->textIndexFileName = fileName;
+    emit textIndexFileNameChanged();
+}
+
 /*!
     Returns the list of all results found on the given \a page.
 */
@@ -231,7 +294,25 @@ void QPdfSearchModel::setDocument(QPdfDocument *document)
     if (d->document == document)
         return;
 
+    QObject::disconnect(d->statusConnection);
+    QObject::disconnect(d->pageAvailableConnection);
     d->document = document;
+    if (document) {
+        d->statusConnection = connect(document, &QPdfDocument::statusChanged, this,
+                                      [d](QPdfDocument::Status status) {
+            if (status == QPdfDocument::Ready)
+                d->updateTextIndex();
+        });
+        // a document that is fetched on demand is only indexed when all its pages are there
+        d->pageAvailableConnection = connect(document, &QPdfDocument::pageAvailable, this,
+                                             [this, d](int page) {
+            d->updateTextIndex();
+            if (page == d->pageToWaitFor) {
+                d->pageToWaitFor = -1;
+                d->updateTimerId = startTimer(UpdateTimerInterval);
+            }
+        });
+    }
     d->clearResults();
     emit documentChanged();
 }
@@ -246,8 +327,17 @@ void QPdfSearchModel::timerEvent(QTimerEvent *event)
             qCDebug(qLcS) << "done updating search results on" << d->searchResults.count() << "pages";
         killTimer(d->updateTimerId);
         d->updateTimerId = -1;
+        return;
+    }
+    const int page = d->nextPageToUpdate++;
+    if (!d->doSearch(page) && d->document->d->isPagePending(page)) {
+        // carry on when pageAvailable() says the page has been fetched
+        qCDebug(qLcS) << "waiting for page" << page << "to be fetched";
+        killTimer(d->updateTimerId);
+        d->updateTimerId = -1;
+        d->pageToWaitFor = page;
+        d->nextPageToUpdate = page;
     }
-    d->doSearch(d->nextPageToUpdate++);
 }
 
 QPdfSearchModelPrivate::QPdfSearchModelPrivate() : QAbstractItemModelPrivate()
@@ -265,30 +355,100 @@ void QPdfSearchModelPrivate::clearResults()
         pagesSearched.resize(document->pageCount());
     }
     nextPageToUpdate = 0;
+    pageToWaitFor = -1;
+    if (updateTimerId >= 0) {
+        q->killTimer(updateTimerId);
+        updateTimerId = -1;
+    }
+    updateTextIndex();
+    if (searchTextIndex())
+        return;
     updateTimerId = q->startTimer(UpdateTimerInterval);
 }
 
+void QPdfSearchModelPrivate::updateTextIndex()
+{
+    Q_Q(QPdfSearchModel);
+    QSharedPointer<QPdfTextIndex> index;
+    // null until every page of the document has been fetched
+    if (textIndexEnabled && document && document->status() == QPdfDocument::Ready)
+        index = document->d->ensureTextIndex(textIndexFileName);
+    if (index == textIndex)
+        return;
+
+    if (textIndex)
+        QObject::disconnect(textIndex.data(), nullptr, q, nullptr);
+    textIndex = index;
+    indexMatches.clear();
+    indexSearchString.clear();
+    if (textIndex && !textIndex->isReady()) {
+        QObject::connect(textIndex.data(), &QPdfTextIndex::ready, q, [this]() {
+            Q_Q(QPdfSearchModel);
+            if (searchString.isEmpty())
+                return;
+            // replace whatever the page-by-page search has found so far
+            q->beginResetModel();
+            clearResults();
+            q->endResetModel();
+        });
+    }
+}
+
+bool QPdfSearchModelPrivate::searchTextIndex()
+{
+    if (!textIndex || !textIndex->isReady() || searchString.isEmpty())
+        return false;
+
+    QElapsedTimer timer;
+    timer.start();
+    // a longer search string can only match where the shorter one did
+    const bool refining = !indexSearchString.isEmpty()
+            && searchString.startsWith(indexSearchString, Qt::CaseInsensitive);
+    indexMatches = refining ? textIndex->refine(indexMatches, searchString)
+                            : textIndex->search(searchString);
+    indexSearchString = searchString;
+
+    const int pageCount = qMin(indexMatches.count(), searchResults.count());
+    for (int page = 0; page < pageCount; ++page) {
+        QList<QPdfLink> results;
+        for (int start : indexMatches.at(page)) {
+            const auto result = textIndex->result(page, start, searchString.length(), ContextChars);
+            if (!result.rects.isEmpty())
+                results << QPdfLink(page, result.rects, result.contextBefore, result.contextAfter);
+        }
+        rowCountSoFar += results.count();
+        searchResults[page] = results;
+        pagesSearched[page] = true;
+    }
+    nextPageToUpdate = pageCount;
+    qCDebug(qLcS) << searchString << (refining ? "refined" : "searched") << "in the text index in"
+                  << timer.elapsed() << "ms:" << rowCountSoFar << "results";
+    return true;
+}
+
 bool QPdfSearchModelPrivate::doSearch(int page)
 {
     if (page < 0 || page >= pagesSearched.count() || searchString.isEmpty())
         return false;
     if (pagesSearched[page])
         return true;
+    // requests the page if it has not been fetched yet
+    if (!document->d->checkPageComplete(page))
+        return false;
     Q_Q(QPdfSearchModel);
 
     const QPdfMutexLocker lock;
     QElapsedTimer timer;
     timer.start();
-    FPDF_PAGE pdfPage = FPDF_LoadPage(document->d->doc, page);
+    FPDF_PAGE pdfPage = document->d->cachedPage(page);
     if (!pdfPage) {
         qWarning() << "failed to load page" << page;
         return false;
     }
     double pageHeight = FPDF_GetPageHeight(pdfPage);
-    FPDF_TEXTPAGE textPage = FPDFText_LoadPage(pdfPage);
+    FPDF_TEXTPAGE textPage = document->d->cachedTextPage(page);
     if (!textPage) {
         qWarning() << "failed to load text of page" << page;
-        FPDF_ClosePage(pdfPage);
         return false;
     }
     FPDF_SCHHANDLE sh = FPDFText_FindStart(textPage, searchString.utf16(), 0, 0);
@@ -341,8 +501,6 @@ bool QPdfSearchModelPrivate::doSearch(int page)
             newSearchResults << QPdfLink(page, rects, contextBefore, contextAfter);
     }
     FPDFText_FindClose(sh);
-    FPDFText_ClosePage(textPage);
-    FPDF_ClosePage(pdfPage);
     qCDebug(qLcS) << searchString << "took" << timer.elapsed() << "ms to find"
                   << newSearchResults.count() << "results on page" << page;
 
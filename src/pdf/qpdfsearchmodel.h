@@ -55,6 +55,8 @@ class Q_PDF_EXPORT QPdfSearchModel : public QAbstractListModel
     Q_OBJECT
     Q_PROPERTY(QPdfDocument *document READ document WRITE setDocument NOTIFY documentChanged)
     Q_PROPERTY(QString searchString READ searchString WRITE setSearchString NOTIFY searchStringChanged)
+    Q_PROPERTY(bool textIndexEnabled READ isTextIndexEnabled WRITE setTextIndexEnabled NOTIFY textIndexEnabledChanged)
+    Q_PROPERTY(QString textIndexFileName READ textIndexFileName WRITE setTextIndexFileName NOTIFY textIndexFileNameChanged)
 
 public:
     enum class Role : int {
@@ -76,6 +78,11 @@ public:
     QPdfDocument *document() const;
     QString searchString() const;
 
+    bool isTextIndexEnabled() const;
+    void setTextIndexEnabled(bool enabled);
+    QString textIndexFileName() const;
+    void setTextIndexFileName(const QString &fileName);
+
     QHash<int, QByteArray> roleNames() const override;
     int rowCount(const QModelIndex &parent) const override;
     QVariant data(const QModelIndex &index, int role) const override;
@@ -87,6 +94,8 @@ public Q_SLOTS:
 Q_SIGNALS:
     void documentChanged();
     void searchStringChanged();
+    void textIndexEnabledChanged();
+    void textIndexFileNameChanged();
 
 protected:
     void updatePage(int page);
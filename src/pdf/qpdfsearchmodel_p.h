@@ -52,6 +52,7 @@
 //
 
 #include "qpdfsearchmodel.h"
+#include "qpdftextindex_p.h"
 #include <private/qabstractitemmodel_p.h>
 
 #include "third_party/pdfium/public/fpdfview.h"
@@ -66,6 +67,8 @@ public:
     QPdfSearchModelPrivate();
     void clearResults();
     bool doSearch(int page);
+    void updateTextIndex();
+    bool searchTextIndex();
 
     struct PageAndIndex {
         int page;
@@ -81,6 +84,15 @@ public:
     int rowCountSoFar = 0;
     int updateTimerId = -1;
     int nextPageToUpdate = 0;
+    int pageToWaitFor = -1; // the update timer is stopped until it has been fetched
+
+    bool textIndexEnabled = false;
+    QString textIndexFileName;
+    QSharedPointer<QPdfTextIndex> textIndex;
+    QMetaObject::Connection statusConnection; // builds the index once the document is ready
+    QMetaObject::Connection pageAvailableConnection; // resumes the search once a page is fetched
+    QPdfTextIndex::Matches indexMatches;
+    QString indexSearchString; // what indexMatches were found for
 };
 
 QT_END_NAMESPACE
@@ -0,0 +1,346 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtPDF module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qpdftextindex_p.h"
+#include "qpdfdocument_p.h"
+
+#include "third_party/pdfium/public/fpdf_doc.h"
+#include "third_party/pdfium/public/fpdf_text.h"
+
+#include <QtCore/qdatastream.h>
+#include <QtCore/qelapsedtimer.h>
+#include <QtCore/qfile.h>
+#include <QtCore/qloggingcategory.h>
+#include <QtCore/qsavefile.h>
+#include <QtCore/qsemaphore.h>
+#include <QtCore/qthread.h>
+#include <QtCore/qthreadpool.h>
+
+QT_BEGIN_NAMESPACE
+
+Q_LOGGING_CATEGORY(qLcIndex, "qt.pdf.textindex")
+
+static const char IndexFileMagic[] = "QPDFIDX1";
+// pages searched by one task of a parallel search
+static const int PagesPerTask = 16;
+
+QDataStream &operator<<(QDataStream &out, const QPdfTextIndex::CharBox &box)
+{
+    return out << box.left << box.top << box.right << box.bottom;
+}
+
+QDataStream &operator>>(QDataStream &in, QPdfTextIndex::CharBox &box)
+{
+    return in >> box.left >> box.top >> box.right >> box.bottom;
+}
+
+QDataStream &operator<<(QDataStream &out, const QPdfTextIndex::Page &page)
+{
+    return out << page.text << page.boxes;
+}
+
+QDataStream &operator>>(QDataStream &in, QPdfTextIndex::Page &page)
+{
+    return in >> page.text >> page.boxes;
+}
+
+static QByteArray fileIdentifier(FPDF_DOCUMENT doc, FPDF_FILEIDTYPE type)
+{
+    const unsigned long len = FPDF_GetFileIdentifier(doc, type, nullptr, 0);
+    if (len <= 1)
+        return QByteArray();
+    QByteArray id(len, 0);
+    FPDF_GetFileIdentifier(doc, type, id.data(), len);
+    id.chop(1); // the terminator
+    return id;
+}
+
+QPdfTextIndex::QPdfTextIndex(QPdfDocumentPrivate *document)
+    : m_document(document)
+{
+}
+
+QPdfTextIndex::~QPdfTextIndex()
+{
+}
+
+/*
+    Makes the index ready: loads it from \a fileName if that holds the index
+    of this very document, and otherwise extracts the text of all pages in a
+    background thread and, if \a fileName is set, saves it there afterwards.
+    Must be called with a completely loaded document; ready() is emitted when
+    done.
+*/
+void QPdfTextIndex::build(const QString &fileName)
+{
+    {
+        const QPdfMutexLocker lock;
+        m_pageCount = FPDF_GetPageCount(m_document->doc);
+        // the identifiers in the trailer change when the file is edited,
+        // the size and page count catch files without them
+        m_fingerprint = fileIdentifier(m_document->doc, FILEIDTYPE_PERMANENT) + '/'
+                + fileIdentifier(m_document->doc, FILEIDTYPE_CHANGING) + '/'
+                + QByteArray::number(qulonglong(m_document->m_FileLen)) + '/'
+                + QByteArray::number(m_pageCount);
+    }
+
+    if (!fileName.isEmpty() && load(fileName)) {
+        m_ready.storeRelease(1);
+        emit ready();
+        return;
+    }
+
+    QSharedPointer<QPdfTextIndex> self = sharedFromThis();
+    QThread *builder = QThread::create([self, fileName]() { self->extract(fileName); });
+    builder->setObjectName(QStringLiteral("QPdfTextIndex"));
+    connect(builder, &QThread::finished, builder, &QObject::deleteLater);
+    builder->start(QThread::LowPriority);
+}
+
+// Called with the pdfium lock held when the document is closed, so that the
+// builder does not touch it anymore.
+void QPdfTextIndex::cancel()
+{
+    m_cancelled = true;
+}
+
+void QPdfTextIndex::extract(const QString &fileName)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    QList<Page> pages(m_pageCount);
+    int failedPages = 0;
+    for (int i = 0; i < m_pageCount; ++i) {
+        Page &page = pages[i];
+
+        // one page at a time, so that rendering is not held up for long
+        const QPdfMutexLocker lock;
+        if (m_cancelled)
+            return;
+
+        // not through the page cache, which would be flushed by this
+        FPDF_PAGE pdfPage = FPDF_LoadPage(m_document->doc, i);
+        if (!pdfPage) {
+            ++failedPages;
+            continue;
+        }
+        const double pageHeight = FPDF_GetPageHeight(pdfPage);
+        FPDF_TEXTPAGE textPage = FPDFText_LoadPage(pdfPage);
+        if (!textPage) {
+            ++failedPages;
+        } else {
+            const int count = FPDFText_CountChars(textPage);
+            page.text.reserve(count);
+            page.boxes.reserve(count);
+            for (int c = 0; c < count; ++c) {
+                double l = 0, r = 0, b = 0, t = 0;
+                FPDFText_GetCharBox(textPage, c, &l, &r, &b, &t);
+                const CharBox box { float(l), float(pageHeight - t), float(r), float(pageHeight - b) };
+                // one box per UTF-16 code unit, so that string and box indices match
+                const auto units = QChar::fromUcs4(FPDFText_GetUnicode(textPage, c));
+                page.text.append(QStringView(units));
+                for (qsizetype u = 0; u < QStringView(units).size(); ++u)
+                    page.boxes.append(box);
+            }
+            FPDFText_ClosePage(textPage);
+        }
+        FPDF_ClosePage(pdfPage);
+    }
+
+    qCDebug(qLcIndex) << "extracted the text of" << m_pageCount << "pages in" << timer.elapsed() << "ms";
+    m_pages = std::move(pages);
+    m_ready.storeRelease(1);
+
+    // the pages that failed would be read back as empty from then on
+    if (failedPages)
+        qCWarning(qLcIndex) << failedPages << "pages could not be loaded, the text index is not saved";
+    else if (!fileName.isEmpty())
+        save(fileName);
+
+    emit ready();
+}
+
+bool QPdfTextIndex::load(const QString &fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_6_0);
+    QByteArray magic;
+    QByteArray fingerprint;
+    in >> magic >> fingerprint;
+    if (magic != IndexFileMagic || fingerprint != m_fingerprint) {
+        qCDebug(qLcIndex) << fileName << "is not an index of this document";
+        return false;
+    }
+
+    QList<Page> pages;
+    in >> pages;
+    if (in.status() != QDataStream::Ok || pages.size() != m_pageCount) {
+        qCWarning(qLcIndex) << "cannot read the text index" << fileName;
+        return false;
+    }
+
+    qCDebug(qLcIndex) << "loaded the text of" << m_pageCount << "pages from" << fileName;
+    m_pages = std::move(pages);
+    return true;
+}
+
+bool QPdfTextIndex::save(const QString &fileName) const
+{
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qCWarning(qLcIndex) << "cannot save the text index to" << fileName << file.errorString();
+        return false;
+    }
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_6_0);
+    out << QByteArray(IndexFileMagic) << m_fingerprint << m_pages;
+    return file.commit();
+}
+
+/*
+    Runs \a searchPage for every page, spread over the global thread pool,
+    and returns the matches it found on each of them.
+*/
+template <typename PageSearch>
+QPdfTextIndex::Matches QPdfTextIndex::searchPages(PageSearch searchPage) const
+{
+    Q_ASSERT(isReady());
+
+    Matches matches(m_pages.size());
+    QList<int> *results = matches.data();
+    std::atomic<int> nextPage = 0;
+    auto work = [&]() {
+        for (int first; (first = nextPage.fetch_add(PagesPerTask)) < m_pages.size();) {
+            const int last = qMin(first + PagesPerTask, int(m_pages.size()));
+            for (int page = first; page < last; ++page)
+                results[page] = searchPage(page);
+        }
+    };
+
+    QThreadPool *pool = QThreadPool::globalInstance();
+    const int helpers = qMin(pool->maxThreadCount(),
+                             int(m_pages.size() + PagesPerTask - 1) / PagesPerTask) - 1;
+    QSemaphore done;
+    int started = 0;
+    for (int i = 0; i < helpers; ++i) {
+        if (!pool->tryStart([&]() { work(); done.release(); }))
+            break;
+        ++started;
+    }
+    work();
+    done.acquire(started);
+    return matches;
+}
+
+QPdfTextIndex::Matches QPdfTextIndex::search(const QString &needle) const
+{
+    QElapsedTimer timer;
+    timer.start();
+    const Matches matches = searchPages([this, &needle](int page) {
+        QList<int> starts;
+        const QString &text = m_pages.at(page).text;
+        for (qsizetype i = 0; (i = text.indexOf(needle, i, Qt::CaseInsensitive)) >= 0; ++i)
+            starts.append(int(i));
+        return starts;
+    });
+    qCDebug(qLcIndex) << "searched" << m_pages.size() << "pages for" << needle
+                      << "in" << timer.nsecsElapsed() / 1000 << "us";
+    return matches;
+}
+
+/*
+    Every match of \a needle starts where a match of a prefix of it started,
+    so when a query is extended only the \a previous matches are checked.
+*/
+QPdfTextIndex::Matches QPdfTextIndex::refine(const Matches &previous, const QString &needle) const
+{
+    Q_ASSERT(previous.size() == m_pages.size());
+    return searchPages([this, &previous, &needle](int page) {
+        QList<int> starts;
+        const QString &text = m_pages.at(page).text;
+        for (int start : previous.at(page)) {
+            if (QStringView(text).mid(start, needle.size()).compare(needle, Qt::CaseInsensitive) == 0)
+                starts.append(start);
+        }
+        return starts;
+    });
+}
+
+QPdfTextIndex::Result QPdfTextIndex::result(int page, int start, int length, int contextChars) const
+{
+    Result ret;
+    const Page &p = m_pages.at(page);
+
+    // one rectangle per line, like FPDFText_GetRect() does
+    QRectF line;
+    for (int i = start; i < start + length && i < p.boxes.size(); ++i) {
+        const CharBox &box = p.boxes.at(i);
+        const QRectF rect(QPointF(box.left, box.top), QPointF(box.right, box.bottom));
+        if (rect.isEmpty())
+            continue;
+        if (!line.isNull() && qAbs(rect.center().y() - line.center().y()) < line.height() / 2) {
+            line = line.united(rect);
+        } else {
+            if (!line.isNull())
+                ret.rects << line;
+            line = rect;
+        }
+    }
+    if (!line.isNull())
+        ret.rects << line;
+
+    auto context = [](QString text) {
+        return text.replace(QLatin1Char('\n'), QStringLiteral("\u23CE")).remove(QLatin1Char('\r'));
+    };
+    const int before = qMax(0, start - contextChars);
+    ret.contextBefore = context(p.text.mid(before, start - before));
+    ret.contextAfter = context(p.text.mid(start + length, contextChars));
+    return ret;
+}
+
+QT_END_NAMESPACE
+
+#include "moc_qpdftextindex_p.cpp"
@@ -0,0 +1,129 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtPDF module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QPDFTEXTINDEX_P_H
+#define QPDFTEXTINDEX_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/qlist.h>
+#include <QtCore/qobject.h>
+#include <QtCore/qrect.h>
+#include <QtCore/qsharedpointer.h>
+#include <QtCore/qstring.h>
+
+#include <atomic>
+
+QT_BEGIN_NAMESPACE
+
+class QPdfDocumentPrivate;
+
+// The text and character boxes of all pages of a document, extracted once
+// in the background, so that searching does not need pdfium at all and can
+// run on all cores.
+class QPdfTextIndex : public QObject, public QEnableSharedFromThis<QPdfTextIndex>
+{
+    Q_OBJECT
+public:
+    struct CharBox
+    {
+        float left;
+        float top;
+        float right;
+        float bottom;
+    };
+
+    struct Page
+    {
+        QString text;
+        QList<CharBox> boxes;
+    };
+
+    // the indices of the characters where matches start, per page
+    using Matches = QList<QList<int>>;
+
+    struct Result
+    {
+        QList<QRectF> rects;
+        QString contextBefore;
+        QString contextAfter;
+    };
+
+    explicit QPdfTextIndex(QPdfDocumentPrivate *document);
+    ~QPdfTextIndex() override;
+
+    void build(const QString &fileName);
+    void cancel();
+    bool isReady() const { return m_ready.loadAcquire(); }
+
+    Matches search(const QString &needle) const;
+    Matches refine(const Matches &previous, const QString &needle) const;
+    Result result(int page, int start, int length, int contextChars) const;
+
+Q_SIGNALS:
+    void ready();
+
+private:
+    void extract(const QString &fileName);
+    bool load(const QString &fileName);
+    bool save(const QString &fileName) const;
+    template <typename PageSearch>
+    Matches searchPages(PageSearch searchPage) const;
+
+    QPdfDocumentPrivate *m_document;
+    QByteArray m_fingerprint;
+    int m_pageCount = 0;
+    QList<Page> m_pages; // immutable once ready
+    QAtomicInt m_ready;
+    std::atomic<bool> m_cancelled = false; // written with the pdfium lock held
+};
+
+QT_END_NAMESPACE
+
+#endif // QPDFTEXTINDEX_P_H
@@ -0,0 +1,290 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtPDF module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qpdftilecache_p.h"
+#include "qpdfdocument.h"
+#include "qpdfdocument_p.h"
+
+#include <QLoggingCategory>
+
+QT_BEGIN_NAMESPACE
+
+Q_LOGGING_CATEGORY(qLcTileCache, "qt.pdf.tilecache")
+Q_GLOBAL_STATIC(QPdfTileCache, tileCache)
+
+static const qsizetype DefaultMaxBytes = 128 * 1024 * 1024;
+
+bool operator==(const QPdfTileCache::Key &lhs, const QPdfTileCache::Key &rhs) noexcept
+{
+    return lhs.document == rhs.document && lhs.page == rhs.page
+            && lhs.scaledSize == rhs.scaledSize && lhs.rect == rhs.rect
+            && lhs.rotation == rhs.rotation && lhs.renderFlags == rhs.renderFlags;
+}
+
+size_t qHash(const QPdfTileCache::Key &key, size_t seed) noexcept
+{
+    return qHashMulti(seed, key.document, key.page,
+                      key.scaledSize.width(), key.scaledSize.height(),
+                      key.rect.x(), key.rect.y(), key.rect.width(), key.rect.height(),
+                      key.rotation, key.renderFlags);
+}
+
+/*!
+    \internal
+    \class QPdfTileCache
+
+    A process-wide, byte-budgeted cache of rendered page areas, shared by
+    QPdfPageRenderer, the PDF image format plugin (and thus PdfPageImage)
+    and QPdfView. Pages are split into tiles of TileSize pixels at a given
+    resolution, so that at high zoom levels only the visible part of a page
+    needs to be rasterized; images of whole pages are cached the same way,
+    as a single tile covering the page.
+*/
+
+QPdfTileCache *QPdfTileCache::instance()
+{
+    return tileCache();
+}
+
+QPdfTileCache::QPdfTileCache()
+    : m_tiles(DefaultMaxBytes)
+{
+}
+
+QPdfTileCache::~QPdfTileCache()
+{
+}
+
+// Tiles are created and deleted with m_mutex locked: QCache deletes them
+// when they are evicted, replaced or removed.
+QPdfTileCache::Tile::Tile(QPdfTileCache *cache, const Key &key, const QImage &image)
+    : cache(cache), key(key), image(image)
+{
+    QList<Level> &levels = cache->m_levels[pageKey(key)];
+    auto it = std::find_if(levels.begin(), levels.end(),
+                           [this](const Level &level) { return level.scaledSize == this->key.scaledSize; });
+    if (it == levels.end())
+        levels.append({ key.scaledSize, 1 });
+    else
+        ++it->tiles;
+}
+
+QPdfTileCache::Tile::~Tile()
+{
+    const auto pageIt = cache->m_levels.find(pageKey(key));
+    if (pageIt == cache->m_levels.end())
+        return;
+    QList<Level> &levels = *pageIt;
+    auto it = std::find_if(levels.begin(), levels.end(),
+                           [this](const Level &level) { return level.scaledSize == key.scaledSize; });
+    if (it == levels.end() || --it->tiles > 0)
+        return;
+    levels.erase(it);
+    if (levels.isEmpty())
+        cache->m_levels.erase(pageIt);
+}
+
+QPdfTileCache::Key QPdfTileCache::tileKey(const QPdfDocument *document, int page, QSize scaledSize,
+                                          int column, int row, QPdfDocumentRenderOptions options)
+{
+    Key key;
+    key.document = document;
+    key.page = page;
+    key.scaledSize = scaledSize;
+    key.rect = QRect(column * TileSize, row * TileSize, TileSize, TileSize)
+            & QRect(QPoint(0, 0), scaledSize);
+    key.rotation = options.rotation();
+    key.renderFlags = quint32(options.renderFlags().toInt());
+    return key;
+}
+
+QPdfTileCache::Key QPdfTileCache::renderKey(const QPdfDocument *document, int page, QSize imageSize,
+                                            QPdfDocumentRenderOptions options)
+{
+    Key key;
+    key.document = document;
+    key.page = page;
+    if (options.scaledClipRect().isValid()) {
+        key.scaledSize = options.scaledSize().isValid() ? options.scaledSize() : imageSize;
+        key.rect = QRect(options.scaledClipRect().topLeft(), imageSize);
+    } else {
+        key.scaledSize = imageSize;
+        key.rect = QRect(QPoint(0, 0), imageSize);
+    }
+    key.rotation = options.rotation();
+    key.renderFlags = quint32(options.renderFlags().toInt());
+    return key;
+}
+
+// The rotation and render flags of the key; its area is rendered by renderTile().
+QPdfDocumentRenderOptions QPdfTileCache::renderOptions(const Key &key)
+{
+    QPdfDocumentRenderOptions options;
+    options.setRotation(QPdf::Rotation(key.rotation));
+    options.setRenderFlags(QPdf::RenderFlags(int(key.renderFlags)));
+    return options;
+}
+
+QPdfTileCache::Key QPdfTileCache::pageKey(const Key &key)
+{
+    Key ret = key;
+    ret.scaledSize = QSize();
+    ret.rect = QRect();
+    return ret;
+}
+
+QImage QPdfTileCache::find(const Key &key) const
+{
+    const QMutexLocker locker(&m_mutex);
+    if (const Tile *tile = m_tiles.object(key))
+        return tile->image;
+    return QImage();
+}
+
+/*
+    Finds a cached image of the same page at another resolution that covers
+    the area of \a key, to be drawn scaled until the tile itself is rendered.
+    Resolutions closest to the requested one are preferred.
+*/
+QPdfTileCache::Placeholder QPdfTileCache::findPlaceholder(const Key &key) const
+{
+    const QMutexLocker locker(&m_mutex);
+
+    QList<QSize> levels;
+    for (const Level &level : m_levels.value(pageKey(key)))
+        levels.append(level.scaledSize);
+    std::sort(levels.begin(), levels.end(), [&key](QSize a, QSize b) {
+        return qAbs(a.width() - key.scaledSize.width()) < qAbs(b.width() - key.scaledSize.width());
+    });
+
+    for (const QSize &level : qAsConst(levels)) {
+        if (level == key.scaledSize || level.isEmpty())
+            continue;
+
+        const qreal fx = qreal(level.width()) / key.scaledSize.width();
+        const qreal fy = qreal(level.height()) / key.scaledSize.height();
+        const QRectF mapped(key.rect.x() * fx, key.rect.y() * fy,
+                            key.rect.width() * fx, key.rect.height() * fy);
+
+        Key candidate = key;
+        candidate.scaledSize = level;
+        // either a whole page image, or the tile of the grid at that resolution
+        candidate.rect = QRect(QPoint(0, 0), level);
+        const Tile *tile = m_tiles.object(candidate);
+        if (!tile) {
+            candidate = tileKey(key.document, key.page, level,
+                                int(mapped.x()) / TileSize, int(mapped.y()) / TileSize,
+                                renderOptions(key));
+            tile = m_tiles.object(candidate);
+        }
+        if (tile && QRectF(candidate.rect).contains(mapped))
+            return { tile->image, mapped.translated(-candidate.rect.topLeft()) };
+    }
+    return {};
+}
+
+void QPdfTileCache::insert(const Key &key, const QImage &image)
+{
+    if (image.isNull())
+        return;
+
+    const QMutexLocker locker(&m_mutex);
+    if (!m_tiles.insert(key, new Tile(this, key, image), image.sizeInBytes())) {
+        qCDebug(qLcTileCache) << "image of" << image.sizeInBytes() << "bytes exceeds the budget of"
+                              << m_tiles.maxCost() << "bytes";
+        return;
+    }
+
+    qCDebug(qLcTileCache) << "page" << key.page << "size" << key.scaledSize << "rect" << key.rect
+                          << "cached;" << m_tiles.totalCost() << "of" << m_tiles.maxCost() << "bytes used";
+}
+
+void QPdfTileCache::removeDocument(const QPdfDocument *document)
+{
+    const QMutexLocker locker(&m_mutex);
+
+    const auto keys = m_tiles.keys();
+    for (const Key &key : keys) {
+        if (key.document == document)
+            m_tiles.remove(key);
+    }
+}
+
+QImage QPdfTileCache::render(QPdfDocument *document, int page, QSize imageSize,
+                             QPdfDocumentRenderOptions options)
+{
+    const Key key = renderKey(document, page, imageSize, options);
+    QImage image = find(key);
+    if (image.isNull()) {
+        image = document->render(page, imageSize, options);
+        insert(key, image);
+    }
+    return image;
+}
+
+QImage QPdfTileCache::renderTile(QPdfDocument *document, const Key &key)
+{
+    QImage image = find(key);
+    if (image.isNull()) {
+        image = document->d->renderTile(key.page, key.scaledSize, key.rect, renderOptions(key));
+        insert(key, image);
+    }
+    return image;
+}
+
+qsizetype QPdfTileCache::maxBytes() const
+{
+    const QMutexLocker locker(&m_mutex);
+    return m_tiles.maxCost();
+}
+
+void QPdfTileCache::setMaxBytes(qsizetype bytes)
+{
+    const QMutexLocker locker(&m_mutex);
+    m_tiles.setMaxCost(bytes);
+}
+
+qsizetype QPdfTileCache::totalBytes() const
+{
+    const QMutexLocker locker(&m_mutex);
+    return m_tiles.totalCost();
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,149 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtPDF module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QPDFTILECACHE_P_H
+#define QPDFTILECACHE_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include "qpdfdocumentrenderoptions.h"
+
+#include <QtCore/qcache.h>
+#include <QtCore/qhash.h>
+#include <QtCore/qmutex.h>
+#include <QtGui/qimage.h>
+
+QT_BEGIN_NAMESPACE
+
+class QPdfDocument;
+
+class Q_PDF_PRIVATE_EXPORT QPdfTileCache
+{
+public:
+    static constexpr int TileSize = 256;
+
+    struct Key
+    {
+        const QPdfDocument *document = nullptr;
+        int page = -1;
+        QSize scaledSize;   // size of the whole page at this resolution
+        QRect rect;         // area of the page covered by the image, in scaledSize coordinates
+        quint32 rotation = 0;
+        quint32 renderFlags = 0;
+    };
+
+    struct Placeholder
+    {
+        QImage image;
+        QRectF sourceRect;
+    };
+
+    static QPdfTileCache *instance();
+
+    QPdfTileCache();
+    ~QPdfTileCache();
+
+    static Key tileKey(const QPdfDocument *document, int page, QSize scaledSize,
+                       int column, int row, QPdfDocumentRenderOptions options = {});
+    static Key renderKey(const QPdfDocument *document, int page, QSize imageSize,
+                         QPdfDocumentRenderOptions options);
+    static QPdfDocumentRenderOptions renderOptions(const Key &key);
+
+    QImage find(const Key &key) const;
+    Placeholder findPlaceholder(const Key &key) const;
+    void insert(const Key &key, const QImage &image);
+    void removeDocument(const QPdfDocument *document);
+
+    // Renders through the cache: returns the cached image if there is one,
+    // otherwise renders it with QPdfDocument::render() and caches the result.
+    QImage render(QPdfDocument *document, int page, QSize imageSize,
+                  QPdfDocumentRenderOptions options);
+    // The same for a tile, which is rendered with an exact mapping of its area
+    // of the page rather than through a scaled clip rect.
+    QImage renderTile(QPdfDocument *document, const Key &key);
+
+    qsizetype maxBytes() const;
+    void setMaxBytes(qsizetype bytes);
+    qsizetype totalBytes() const;
+
+private:
+    // the key of a page regardless of resolution and area
+    static Key pageKey(const Key &key);
+
+    // a cached image, which keeps m_levels up to date when it is evicted
+    struct Tile
+    {
+        Tile(QPdfTileCache *cache, const Key &key, const QImage &image);
+        ~Tile();
+        QPdfTileCache *cache;
+        Key key;
+        QImage image;
+    };
+
+    struct Level
+    {
+        QSize scaledSize;
+        int tiles = 0;
+    };
+
+    mutable QMutex m_mutex;
+    // resolutions that have tiles cached, per page, used to find placeholders;
+    // declared before m_tiles, whose tiles update it as they are deleted
+    QHash<Key, QList<Level>> m_levels;
+    QCache<Key, Tile> m_tiles;
+};
+
+Q_DECLARE_TYPEINFO(QPdfTileCache::Key, Q_RELOCATABLE_TYPE);
+
+bool operator==(const QPdfTileCache::Key &lhs, const QPdfTileCache::Key &rhs) noexcept;
+size_t qHash(const QPdfTileCache::Key &key, size_t seed = 0) noexcept;
+
+QT_END_NAMESPACE
+
+#endif // QPDFTILECACHE_P_H
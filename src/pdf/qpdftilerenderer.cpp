@@ -0,0 +1,129 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtPDF module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qpdftilerenderer_p.h"
+#include "qpdfdocument.h"
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \internal
+    \class QPdfTileRenderer
+
+    Renders the tiles QPdfView asks for into the QPdfTileCache, one at a time
+    on a thread of its own. Unlike QPdfPageRenderer, the queue of tiles is
+    replaced on every paint, and the tiles are rendered with an exact mapping
+    of their area of the page.
+*/
+
+QPdfTileRenderer::QPdfTileRenderer(QObject *parent)
+    : QObject(parent)
+{
+    m_thread.setObjectName(QStringLiteral("QPdfTileRenderer"));
+    m_context.moveToThread(&m_thread);
+    m_thread.start();
+}
+
+QPdfTileRenderer::~QPdfTileRenderer()
+{
+    {
+        const QMutexLocker locker(&m_requestsMutex);
+        m_requests.clear();
+    }
+    m_thread.quit();
+    m_thread.wait();
+}
+
+void QPdfTileRenderer::setDocument(QPdfDocument *document)
+{
+    {
+        const QMutexLocker locker(&m_requestsMutex);
+        m_requests.clear();
+    }
+    const QMutexLocker locker(&m_documentMutex);
+    m_document = document;
+}
+
+void QPdfTileRenderer::setRequests(const QList<QPdfTileCache::Key> &keys)
+{
+    const QMutexLocker locker(&m_requestsMutex);
+    m_requests = keys;
+    if (m_requests.isEmpty() || m_rendering)
+        return;
+    m_rendering = true;
+    QMetaObject::invokeMethod(&m_context, [this]() { renderPending(); }, Qt::QueuedConnection);
+}
+
+QList<QPdfTileCache::Key> QPdfTileRenderer::pendingRequests() const
+{
+    const QMutexLocker locker(&m_requestsMutex);
+    return m_requests;
+}
+
+void QPdfTileRenderer::renderPending()
+{
+    for (;;) {
+        QPdfTileCache::Key key;
+        {
+            const QMutexLocker locker(&m_requestsMutex);
+            if (m_requests.isEmpty()) {
+                m_rendering = false;
+                return;
+            }
+            key = m_requests.takeFirst();
+        }
+
+        QPdfTileCache *cache = QPdfTileCache::instance();
+        if (!cache)
+            continue;
+        if (!cache->find(key).isNull())
+            continue;
+
+        const QMutexLocker locker(&m_documentMutex);
+        if (!m_document || m_document != key.document || m_document->status() != QPdfDocument::Ready)
+            continue;
+        if (!cache->renderTile(m_document, key).isNull())
+            emit tileRendered(key.page);
+    }
+}
+
+QT_END_NAMESPACE
+
+#include "moc_qpdftilerenderer_p.cpp"
@@ -0,0 +1,106 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtPDF module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QPDFTILERENDERER_P_H
+#define QPDFTILERENDERER_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include "qpdftilecache_p.h"
+
+#include <QtCore/qlist.h>
+#include <QtCore/qmutex.h>
+#include <QtCore/qobject.h>
+#include <QtCore/qpointer.h>
+#include <QtCore/qthread.h>
+
+QT_BEGIN_NAMESPACE
+
+class QPdfDocument;
+
+// Renders tiles into the QPdfTileCache on a thread of its own. The tiles
+// waiting to be rendered are replaced by every call to setRequests(), so that
+// tiles that scrolled out of view are never rendered.
+class Q_PDF_PRIVATE_EXPORT QPdfTileRenderer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit QPdfTileRenderer(QObject *parent = nullptr);
+    ~QPdfTileRenderer() override;
+
+    void setDocument(QPdfDocument *document);
+
+    // Renders the tiles that are not cached yet in the given order, after the
+    // one being rendered, and drops the tiles requested before.
+    void setRequests(const QList<QPdfTileCache::Key> &keys);
+    QList<QPdfTileCache::Key> pendingRequests() const;
+
+Q_SIGNALS:
+    // emitted on the renderer's thread once the tile is in the cache
+    void tileRendered(int page);
+
+private:
+    void renderPending();
+
+    QThread m_thread;
+    QObject m_context;
+
+    mutable QMutex m_requestsMutex;
+    QList<QPdfTileCache::Key> m_requests;
+    bool m_rendering = false;
+
+    // held while rendering, so that the document is not replaced meanwhile
+    QMutex m_documentMutex;
+    QPointer<QPdfDocument> m_document;
+};
+
+QT_END_NAMESPACE
+
+#endif // QPDFTILERENDERER_P_H
@@ -0,0 +1,101 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtPDF module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+// A worker that renders pages for QPdfDocument with a PDF engine of its own.
+// It reads QPdfRenderRequests from stdin and writes the images to stdout,
+// until stdin is closed.
+
+#include <QtPdf/private/qpdfrenderprocess_p.h>
+#include <QtPdf/qpdfdocument.h>
+
+#include <QCache>
+#include <QCoreApplication>
+#include <QFile>
+
+#if defined(Q_OS_WIN)
+#include <fcntl.h>
+#include <io.h>
+#endif
+
+#include <stdio.h>
+
+QT_USE_NAMESPACE
+
+// a thumbnailer renders a few pages of one document after another
+static const int MaxOpenDocuments = 4;
+
+int main(int argc, char **argv)
+{
+    QCoreApplication app(argc, argv);
+
+#if defined(Q_OS_WIN)
+    _setmode(_fileno(stdin), _O_BINARY);
+    _setmode(_fileno(stdout), _O_BINARY);
+#endif
+    QFile input;
+    QFile output;
+    if (!input.open(stdin, QIODevice::ReadOnly | QIODevice::Unbuffered)
+            || !output.open(stdout, QIODevice::WriteOnly | QIODevice::Unbuffered)) {
+        return 1;
+    }
+    QDataStream in(&input);
+    in.setVersion(QDataStream::Qt_6_0);
+    QDataStream out(&output);
+    out.setVersion(QDataStream::Qt_6_0);
+
+    QCache<QString, QPdfDocument> documents(MaxOpenDocuments);
+    forever {
+        QPdfRenderRequest request;
+        in >> request;
+        if (in.status() != QDataStream::Ok)
+            return 0; // the application has closed the pipe
+
+        const QString key = request.fileName + QLatin1Char('\n') + request.password;
+        QPdfDocument *document = documents.object(key);
+        if (!document) {
+            document = new QPdfDocument;
+            document->setPassword(request.password);
+            document->load(request.fileName);
+            documents.insert(key, document);
+        }
+        QPdfRenderProcess::writeImage(out, document->render(request.page, request.imageSize,
+                                                            request.options));
+    }
+}
@@ -40,7 +40,10 @@
 #include "qpdfview.h"
 #include "qpdfview_p.h"
 
-#include "qpdfpagerenderer.h"
+
+#include <QtPdf/private/qpdfdocument_p.h>
+#include <QtPdf/private/qpdftilecache_p.h>
+#include <QtPdf/private/qpdftilerenderer_p.h>
 
 #include <QGuiApplication>
 #include <QPainter>
@@ -53,18 +56,20 @@
 
 QT_BEGIN_NAMESPACE
 
+// the size of an A4 page in points, for pages that have not been fetched yet
+static const QSizeF PlaceholderPageSize(595, 842);
+
 QPdfViewPrivate::QPdfViewPrivate(QPdfView *q)
     : q_ptr(q)
     , m_document(nullptr)
     , m_pageNavigation(nullptr)
-    , m_pageRenderer(nullptr)
+    , m_tileRenderer(nullptr)
     , m_pageMode(QPdfView::SinglePage)
     , m_zoomMode(QPdfView::CustomZoom)
     , m_zoomFactor(1.0)
     , m_pageSpacing(3)
     , m_documentMargins(6, 6, 6, 6)
     , m_blockPageScrolling(false)
-    , m_pageCacheLimit(20)
     , m_screenResolution(QGuiApplication::primaryScreen()->logicalDotsPerInch() / 72.0)
 {
 }
@@ -74,8 +79,7 @@ void QPdfViewPrivate::init()
     Q_Q(QPdfView);
 
     m_pageNavigation = new QPdfNavigationStack(q);
-    m_pageRenderer = new QPdfPageRenderer(q);
-    m_pageRenderer->setRenderMode(QPdfPageRenderer::RenderMode::MultiThreaded);
+    m_tileRenderer = new QPdfTileRenderer(q);
 }
 
 void QPdfViewPrivate::documentStatusChanged()
@@ -84,6 +88,13 @@ void QPdfViewPrivate::documentStatusChanged()
     invalidatePageCache();
 }
 
+void QPdfViewPrivate::pageAvailable(int page)
+{
+    // the page was laid out with the size of another one
+    if (m_documentLayout.pageGeometries.contains(page))
+        invalidateDocumentLayout();
+}
+
 void QPdfViewPrivate::currentPageChanged(int currentPage)
 {
     Q_Q(QPdfView);
@@ -163,23 +174,70 @@ void QPdfViewPrivate::updateScrollBars()
     q->verticalScrollBar()->setPageStep(p.height());
 }
 
-void QPdfViewPrivate::pageRendered(int pageNumber, QSize imageSize, const QImage &image, quint64 requestId)
+void QPdfViewPrivate::tileRendered(int page)
 {
     Q_Q(QPdfView);
 
-    Q_UNUSED(imageSize);
-    Q_UNUSED(requestId);
+    Q_UNUSED(page);
+
+    // the renderer has put the tile into the shared tile cache
+    q->viewport()->update();
+}
+
+/*
+    Paints the cached tiles of the page that intersect the viewport, and
+    appends the ones that are missing to \a requests.
+*/
+void QPdfViewPrivate::paintPage(QPainter *painter, int page, QRect pageGeometry,
+                                QList<QPdfTileCache::Key> *requests)
+{
+    Q_Q(QPdfView);
 
-    if (!m_cachedPagesLRU.contains(pageNumber)) {
-        if (m_cachedPagesLRU.length() > m_pageCacheLimit)
-            m_pageCache.remove(m_cachedPagesLRU.takeFirst());
+    QPdfTileCache *cache = QPdfTileCache::instance();
+    const qreal dpr = q->devicePixelRatioF();
+    const QSize scaledSize = pageGeometry.size() * dpr;
+    if (!cache || scaledSize.isEmpty())
+        return;
 
-        m_cachedPagesLRU.append(pageNumber);
+    // A low resolution image of the whole page is rendered first, to be shown
+    // scaled until the tiles at the current resolution are available.
+    const QSize previewSize = scaledSize.boundedTo(scaledSize.scaled(QPdfTileCache::TileSize,
+                                                                     QPdfTileCache::TileSize,
+                                                                     Qt::KeepAspectRatio));
+    if (previewSize != scaledSize) {
+        const auto previewKey = QPdfTileCache::tileKey(m_document, page, previewSize, 0, 0);
+        if (cache->find(previewKey).isNull())
+            requests->append(previewKey);
     }
 
-    m_pageCache.insert(pageNumber, image);
+    // only the tiles that intersect the viewport are painted and rendered
+    const QRect visible = (pageGeometry & m_viewport).translated(-pageGeometry.topLeft());
+    const QRect scaledVisible = QRectF(QPointF(visible.topLeft()) * dpr, QSizeF(visible.size()) * dpr).toAlignedRect()
+            & QRect(QPoint(0, 0), scaledSize);
+    const int firstColumn = scaledVisible.left() / QPdfTileCache::TileSize;
+    const int lastColumn = scaledVisible.right() / QPdfTileCache::TileSize;
+    const int firstRow = scaledVisible.top() / QPdfTileCache::TileSize;
+    const int lastRow = scaledVisible.bottom() / QPdfTileCache::TileSize;
+
+    for (int row = firstRow; row <= lastRow; ++row) {
+        for (int column = firstColumn; column <= lastColumn; ++column) {
+            const auto key = QPdfTileCache::tileKey(m_document, page, scaledSize, column, row);
+            const QRectF target(pageGeometry.topLeft() + QPointF(key.rect.topLeft()) / dpr,
+                                QSizeF(key.rect.size()) / dpr);
+
+            const QImage tile = cache->find(key);
+            if (!tile.isNull()) {
+                painter->drawImage(target, tile);
+                continue;
+            }
 
-    q->viewport()->update();
+            const QPdfTileCache::Placeholder placeholder = cache->findPlaceholder(key);
+            if (!placeholder.image.isNull())
+                painter->drawImage(target, placeholder.image, placeholder.sourceRect);
+
+            requests->append(key);
+        }
+    }
 }
 
 void QPdfViewPrivate::invalidateDocumentLayout()
@@ -192,7 +250,8 @@ void QPdfViewPrivate::invalidatePageCache()
 {
     Q_Q(QPdfView);
 
-    m_pageCache.clear();
+    // Tiles are cached per resolution, so there is nothing to drop here: the
+    // tiles of the previous layout serve as placeholders for the new one.
     q->viewport()->update();
 }
 
@@ -218,19 +277,29 @@ QPdfViewPrivate::DocumentLayout QPdfViewPrivate::calculateDocumentLayout() const
     const int startPage = (m_pageMode == QPdfView::SinglePage ? m_pageNavigation->currentPage() : 0);
     const int endPage = (m_pageMode == QPdfView::SinglePage ? m_pageNavigation->currentPage() + 1 : pageCount);
 
+    // Pages of a document that is fetched on demand are only fetched when
+    // they are painted; until then they take the size of the page before.
+    QSizeF lastPageSize(PlaceholderPageSize);
+
     // calculate page sizes
     for (int page = startPage; page < endPage; ++page) {
+        QSizeF pointSize = lastPageSize;
+        if (m_document->d->isPageAvailable(page)) {
+            pointSize = m_document->pageSize(page);
+            lastPageSize = pointSize;
+        }
+
         QSize pageSize;
         if (m_zoomMode == QPdfView::CustomZoom) {
-            pageSize = QSizeF(m_document->pageSize(page) * m_screenResolution * m_zoomFactor).toSize();
+            pageSize = QSizeF(pointSize * m_screenResolution * m_zoomFactor).toSize();
         } else if (m_zoomMode == QPdfView::FitToWidth) {
-            pageSize = QSizeF(m_document->pageSize(page) * m_screenResolution).toSize();
+            pageSize = QSizeF(pointSize * m_screenResolution).toSize();
             const qreal factor = (qreal(m_viewport.width() - m_documentMargins.left() - m_documentMargins.right()) / qreal(pageSize.width()));
             pageSize *= factor;
         } else if (m_zoomMode == QPdfView::FitInView) {
             const QSize viewportSize(m_viewport.size() + QSize(-m_documentMargins.left() - m_documentMargins.right(), -m_pageSpacing));
 
-            pageSize = QSizeF(m_document->pageSize(page) * m_screenResolution).toSize();
+            pageSize = QSizeF(pointSize * m_screenResolution).toSize();
             pageSize = pageSize.scaled(viewportSize, Qt::KeepAspectRatio);
         }
 
@@ -292,8 +361,7 @@ QPdfView::QPdfView(QWidget *parent)
 
     connect(d->m_pageNavigation, &QPdfNavigationStack::currentPageChanged, this, [d](int page){ d->currentPageChanged(page); });
 
-    connect(d->m_pageRenderer, &QPdfPageRenderer::pageRendered,
-            this, [d](int pageNumber, QSize imageSize, const QImage &image, QPdfDocumentRenderOptions, quint64 requestId){ d->pageRendered(pageNumber, imageSize, image, requestId); });
+    connect(d->m_tileRenderer, &QPdfTileRenderer::tileRendered, this, [d](int page){ d->tileRendered(page); });
 
     verticalScrollBar()->setSingleStep(20);
     horizontalScrollBar()->setSingleStep(20);
@@ -314,16 +382,20 @@ void QPdfView::setDocument(QPdfDocument *document)
     if (d->m_document == document)
         return;
 
-    if (d->m_document)
+    if (d->m_document) {
         disconnect(d->m_documentStatusChangedConnection);
+        disconnect(d->m_pageAvailableConnection);
+    }
 
     d->m_document = document;
     emit documentChanged(d->m_document);
 
-    if (d->m_document)
+    if (d->m_document) {
         d->m_documentStatusChangedConnection = connect(d->m_document.data(), &QPdfDocument::statusChanged, this, [d](){ d->documentStatusChanged(); });
+        d->m_pageAvailableConnection = connect(d->m_document.data(), &QPdfDocument::pageAvailable, this, [d](int page){ d->pageAvailable(page); });
+    }
 
-    d->m_pageRenderer->setDocument(d->m_document);
+    d->m_tileRenderer->setDocument(d->m_document);
 
     d->documentStatusChanged();
 }
@@ -450,21 +522,18 @@ void QPdfView::paintEvent(QPaintEvent *event)
     painter.fillRect(event->rect(), palette().brush(QPalette::Dark));
     painter.translate(-d->m_viewport.x(), -d->m_viewport.y());
 
+    // Tiles requested for an earlier paint that are no longer visible are
+    // dropped, so scrolling quickly does not queue up tiles nobody sees.
+    QList<QPdfTileCache::Key> requests;
     for (auto it = d->m_documentLayout.pageGeometries.cbegin(); it != d->m_documentLayout.pageGeometries.cend(); ++it) {
         const QRect pageGeometry = it.value();
         if (pageGeometry.intersects(d->m_viewport)) { // page needs to be painted
             painter.fillRect(pageGeometry, Qt::white);
 
-            const int page = it.key();
-            const auto pageIt = d->m_pageCache.constFind(page);
-            if (pageIt != d->m_pageCache.cend()) {
-                const QImage &img = pageIt.value();
-                painter.drawImage(pageGeometry, img);
-            } else {
-                d->m_pageRenderer->requestPage(page, pageGeometry.size() * devicePixelRatioF());
-            }
+            d->paintPage(&painter, it.key(), pageGeometry, &requests);
         }
     }
+    d->m_tileRenderer->setRequests(requests);
 }
 
 void QPdfView::resizeEvent(QResizeEvent *event)
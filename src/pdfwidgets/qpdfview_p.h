@@ -53,12 +53,16 @@
 
 #include "qpdfview.h"
 
+#include <QtPdf/private/qpdftilecache_p.h>
+
 #include <QHash>
+#include <QList>
 #include <QPointer>
 
 QT_BEGIN_NAMESPACE
 
-class QPdfPageRenderer;
+class QPainter;
+class QPdfTileRenderer;
 
 class QPdfViewPrivate
 {
@@ -69,12 +73,15 @@ public:
     void init();
 
     void documentStatusChanged();
+    void pageAvailable(int page);
     void currentPageChanged(int currentPage);
     void calculateViewport();
     void setViewport(QRect viewport);
     void updateScrollBars();
 
-    void pageRendered(int pageNumber, QSize imageSize, const QImage &image, quint64 requestId);
+    void tileRendered(int page);
+    void paintPage(QPainter *painter, int page, QRect pageGeometry,
+                   QList<QPdfTileCache::Key> *requests);
     void invalidateDocumentLayout();
     void invalidatePageCache();
 
@@ -92,7 +99,7 @@ public:
     QPdfView *q_ptr;
     QPointer<QPdfDocument> m_document;
     QPdfNavigationStack* m_pageNavigation;
-    QPdfPageRenderer *m_pageRenderer;
+    QPdfTileRenderer *m_tileRenderer;
 
     QPdfView::PageMode m_pageMode;
     QPdfView::ZoomMode m_zoomMode;
@@ -104,13 +111,10 @@ public:
     bool m_blockPageScrolling;
 
     QMetaObject::Connection m_documentStatusChangedConnection;
+    QMetaObject::Connection m_pageAvailableConnection;
 
     QRect m_viewport;
 
-    QHash<int, QImage> m_pageCache;
-    QList<int> m_cachedPagesLRU;
-    int m_pageCacheLimit;
-
     DocumentLayout m_documentLayout;
 
     qreal m_screenResolution; // pixels per point
@@ -454,6 +454,23 @@ bool QQuickWebEngineSettings::pdfViewerEnabled() const
     return d_ptr->testAttribute(QWebEngineSettings::PdfViewerEnabled);
 }
 
+/*!
+    \qmlproperty bool WebEngineSettings::webChannelBinaryTransportEnabled
+    \since QtWebEngine 6.4
+
+    Specifies that messages of the \l{WebEngineView::webChannel}{web channel}
+    are passed to and from the page as CBOR instead of JSON text, and are
+    delivered to JavaScript as ready-made objects. Messages from the page
+    only skip JSON text if they are passed to \c{qt.webChannelTransport.send()}
+    as objects; \c qwebchannel.js sends JSON text, which is accepted as before.
+
+    Disabled by default.
+*/
+bool QQuickWebEngineSettings::webChannelBinaryTransportEnabled() const
+{
+    return d_ptr->testAttribute(QWebEngineSettings::WebChannelBinaryTransportEnabled);
+}
+
 /*!
     \qmlproperty string WebEngineSettings::defaultTextEncoding
     \since QtWebEngine 1.2
@@ -729,6 +746,14 @@ void QQuickWebEngineSettings::setPdfViewerEnabled(bool on)
         Q_EMIT pdfViewerEnabledChanged();
 }
 
+void QQuickWebEngineSettings::setWebChannelBinaryTransportEnabled(bool on)
+{
+    bool wasOn = d_ptr->testAttribute(QWebEngineSettings::WebChannelBinaryTransportEnabled);
+    d_ptr->setAttribute(QWebEngineSettings::WebChannelBinaryTransportEnabled, on);
+    if (wasOn != on)
+        Q_EMIT webChannelBinaryTransportEnabledChanged();
+}
+
 void QQuickWebEngineSettings::setUnknownUrlSchemePolicy(QQuickWebEngineSettings::UnknownUrlSchemePolicy policy)
 {
     QWebEngineSettings::UnknownUrlSchemePolicy oldPolicy = d_ptr->unknownUrlSchemePolicy();
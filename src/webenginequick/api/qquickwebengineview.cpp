@@ -390,6 +390,7 @@ void QQuickWebEngineViewPrivate::titleChanged(const QString &title)
 {
     Q_Q(QQuickWebEngineView);
     Q_UNUSED(title);
+    m_history->reset();
     Q_EMIT q->titleChanged();
 }
 
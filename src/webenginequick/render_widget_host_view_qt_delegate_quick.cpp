@@ -49,6 +49,7 @@
 #include <QtGui/qwindow.h>
 #include <QtQuick/qquickwindow.h>
 #include <QtQuick/qsgimagenode.h>
+#include <QtQuick/qsgrendererinterface.h>
 
 namespace QtWebEngineCore {
 
@@ -323,11 +324,24 @@ QSGNode *RenderWidgetHostViewQtDelegateQuick::updatePaintNode(QSGNode *oldNode,
 
     QQuickWindow *win = QQuickItem::window();
 
-    // Delete old node before swapFrame to decrement refcount of
-    // QImage in software mode.
-    delete oldNode;
-    QSGImageNode *node = win->createImageNode();
-    node->setOwnsTexture(true);
+    // Software frames keep their node and texture, so only the damaged parts
+    // of the frame get uploaded, or copied for the software scene graph.
+    const bool software = comp->type() == Compositor::Type::Software;
+    const bool rhiBased = QSGRendererInterface::isApiRhiBased(win->rendererInterface()->graphicsApi());
+    QSGImageNode *node = static_cast<QSGImageNode *>(oldNode);
+    SoftwareFrameTexture *softwareTexture = nullptr;
+    SoftwareFrameImageTexture *softwareImage = nullptr;
+    if (node && software) {
+        if (rhiBased)
+            softwareTexture = qobject_cast<SoftwareFrameTexture *>(node->texture());
+        else
+            softwareImage = qobject_cast<SoftwareFrameImageTexture *>(node->texture());
+    }
+    if (!softwareTexture && !softwareImage) {
+        delete oldNode;
+        node = win->createImageNode();
+        node->setOwnsTexture(true);
+    }
 
     comp->swapFrame();
 
@@ -335,9 +349,22 @@ QSGNode *RenderWidgetHostViewQtDelegateQuick::updatePaintNode(QSGNode *oldNode,
     QSizeF texSizeInDips = QSizeF(texSize) / comp->devicePixelRatio();
     node->setRect(QRectF(QPointF(0, 0), texSizeInDips));
 
-    if (comp->type() == Compositor::Type::Software) {
-        QImage image = comp->image();
-        node->setTexture(win->createTextureFromImage(image));
+    if (software && rhiBased) {
+        if (!softwareTexture) {
+            softwareTexture = new SoftwareFrameTexture;
+            softwareTexture->setUploadCounter(m_uploadedBytes);
+            node->setTexture(softwareTexture);
+        }
+        softwareTexture->setImage(comp->image(), comp->damage());
+        node->markDirty(QSGNode::DirtyMaterial);
+    } else if (software) {
+        if (!softwareImage) {
+            softwareImage = new SoftwareFrameImageTexture;
+            softwareImage->setUploadCounter(m_uploadedBytes);
+            node->setTexture(softwareImage);
+        }
+        softwareImage->setFrame(comp->image(), comp->damage());
+        node->markDirty(QSGNode::DirtyMaterial);
     } else if (comp->type() == Compositor::Type::OpenGL) {
         QQuickWindow::CreateTextureOptions texOpts;
 #if QT_CONFIG(opengl)
@@ -41,6 +41,7 @@
 #define RENDER_WIDGET_HOST_VIEW_QT_DELEGATE_QUICK_H
 
 #include "compositor/compositor.h"
+#include "compositor/software_frame_texture.h"
 #include "render_widget_host_view_qt_delegate.h"
 
 #include <QtGui/qaccessibleobject.h>
@@ -86,6 +87,9 @@ public:
     void readyToSwap() override;
     void adapterClientChanged(WebContentsAdapterClient *client) override;
 
+    // Bytes of software compositor frames uploaded to the scene graph so far.
+    qint64 uploadedBytes() const { return *m_uploadedBytes; }
+
 protected:
     bool event(QEvent *event) override;
     void focusInEvent(QFocusEvent *event) override;
@@ -117,6 +121,7 @@ private:
     QList<QMetaObject::Connection> m_windowConnections;
     bool m_isPopup;
     QQuickWebEngineView *m_view = nullptr;
+    UploadCounter m_uploadedBytes = std::make_shared<std::atomic<qint64>>(0);
 };
 
 #if QT_CONFIG(accessibility)
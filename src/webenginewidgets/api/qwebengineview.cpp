@@ -539,6 +539,16 @@ void QWebEngineViewPrivate::didPrintPage(QPrinter *&currentPrinter, QSharedPoint
     printerWorker->m_firstPageFirst = currentPrinter->pageOrder() == QPrinter::FirstPageFirst;
     printerWorker->m_documentCopies = currentPrinter->copyCount();
     printerWorker->m_collateCopies = currentPrinter->collateCopies();
+    // The PDF generated for the printer's page layout can be used as it is
+    // when the printer only writes it to a file.
+    if (currentPrinter->outputFormat() == QPrinter::PdfFormat
+        && !currentPrinter->outputFileName().isEmpty()
+        && currentPrinter->pdfVersion() == QPagedPaintDevice::PdfVersion_1_4
+        && currentPrinter->pageRanges().isEmpty()
+        && currentPrinter->pageOrder() == QPrinter::FirstPageFirst
+        && currentPrinter->copyCount() == 1) {
+        printerWorker->m_pdfOutputFileName = currentPrinter->outputFileName();
+    }
 
     QObject::connect(printerWorker, &QtWebEngineCore::PrinterWorker::resultReady, q, [q, &currentPrinter](bool success) {
         currentPrinter = nullptr;
@@ -1054,7 +1064,9 @@ void QWebEngineView::printToPdf(const std::function<void(const QByteArray&)> &re
 
     \note This function rasterizes the result when rendering onto \a printer. Please consider raising
     the default resolution of \a printer to at least 300 DPI or using printToPdf() to produce
-    PDF file output more effectively.
+    PDF file output more effectively. Since Qt 6.4, when \a printer writes a single copy of
+    all pages in order to a PDF file, the generated PDF is written to that file as is,
+    keeping its text and vector graphics.
 
     \since 6.2
 */
@@ -40,6 +40,7 @@
 #include "render_widget_host_view_qt_delegate_widget.h"
 
 #include "render_widget_host_view_qt_delegate_client.h"
+#include "compositor/software_frame_texture.h"
 
 #include <QtWebEngineCore/private/qwebenginepage_p.h>
 #include "qwebengineview.h"
@@ -49,6 +50,7 @@
 #include <QMouseEvent>
 #include <QResizeEvent>
 #include <QSGImageNode>
+#include <QSGRendererInterface>
 #include <QWindow>
 
 namespace QtWebEngineCore {
@@ -107,11 +109,24 @@ protected:
 
         QQuickWindow *win = QQuickItem::window();
 
-        // Delete old node before swapFrame to decrement refcount of
-        // QImage in software mode.
-        delete oldNode;
-        QSGImageNode *node = win->createImageNode();
-        node->setOwnsTexture(true);
+        // Software frames keep their node and texture, so only the damaged parts
+        // of the frame get uploaded, or copied for the software scene graph.
+        const bool software = comp->type() == Compositor::Type::Software;
+        const bool rhiBased = QSGRendererInterface::isApiRhiBased(win->rendererInterface()->graphicsApi());
+        QSGImageNode *node = static_cast<QSGImageNode *>(oldNode);
+        SoftwareFrameTexture *softwareTexture = nullptr;
+        SoftwareFrameImageTexture *softwareImage = nullptr;
+        if (node && software) {
+            if (rhiBased)
+                softwareTexture = qobject_cast<SoftwareFrameTexture *>(node->texture());
+            else
+                softwareImage = qobject_cast<SoftwareFrameImageTexture *>(node->texture());
+        }
+        if (!softwareTexture && !softwareImage) {
+            delete oldNode;
+            node = win->createImageNode();
+            node->setOwnsTexture(true);
+        }
 
         comp->swapFrame();
 
@@ -119,9 +134,20 @@ protected:
         QSizeF texSizeInDips = QSizeF(texSize) / comp->devicePixelRatio();
         node->setRect(QRectF(QPointF(0, 0), texSizeInDips));
 
-        if (comp->type() == Compositor::Type::Software) {
-            QImage image = comp->image();
-            node->setTexture(win->createTextureFromImage(image));
+        if (software && rhiBased) {
+            if (!softwareTexture) {
+                softwareTexture = new SoftwareFrameTexture;
+                node->setTexture(softwareTexture);
+            }
+            softwareTexture->setImage(comp->image(), comp->damage());
+            node->markDirty(QSGNode::DirtyMaterial);
+        } else if (software) {
+            if (!softwareImage) {
+                softwareImage = new SoftwareFrameImageTexture;
+                node->setTexture(softwareImage);
+            }
+            softwareImage->setFrame(comp->image(), comp->damage());
+            node->markDirty(QSGNode::DirtyMaterial);
         } else if (comp->type() == Compositor::Type::OpenGL) {
 #if QT_CONFIG(opengl)
             QQuickWindow::CreateTextureOptions texOpts;
@@ -0,0 +1,298 @@
+/****************************************************************************
+**
+** Copyright (C) 2021 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtWebEngine module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "compositor/compositor.h"
+#include "compositor/software_frame_texture.h"
+
+#include <QtCore/qthread.h>
+#include <QtGui/qimage.h>
+#include <QtGui/private/qrhi_p.h>
+#include <QtGui/private/qrhinull_p.h>
+#include <QtTest/QtTest>
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+using namespace QtWebEngineCore;
+
+class TestCompositor : public Compositor
+{
+public:
+    TestCompositor() : Compositor(Type::Software) { }
+    ~TestCompositor() override = default;
+
+    void swapFrame() override { ++swaps; }
+    float devicePixelRatio() override { return 1; }
+    QSize size() override { return QSize(); }
+    bool hasAlphaChannel() override { return false; }
+
+    std::atomic<int> swaps { 0 };
+};
+
+class TestObserver : public Compositor::Observer
+{
+public:
+    void readyToSwap() override { ++readyCount; }
+
+    std::atomic<int> readyCount { 0 };
+};
+
+class tst_Compositor : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void bindObserverFirst();
+    void bindCompositorFirst();
+    void unbindWhileInUse();
+    void concurrentBindings_data();
+    void concurrentBindings();
+    void softwareFrameTexture();
+    void softwareFrameImageTexture();
+};
+
+void tst_Compositor::bindObserverFirst()
+{
+    TestObserver observer;
+    observer.bind(Compositor::Id(1, 1));
+    QVERIFY(!observer.compositor());
+
+    {
+        TestCompositor compositor;
+        compositor.bind(Compositor::Id(1, 1));
+        auto handle = observer.compositor();
+        QVERIFY(handle);
+        handle->swapFrame();
+        QCOMPARE(compositor.swaps.load(), 1);
+    }
+
+    QVERIFY(!observer.compositor());
+    observer.unbind();
+}
+
+void tst_Compositor::bindCompositorFirst()
+{
+    TestCompositor compositor;
+    compositor.bind(Compositor::Id(2, 1));
+    QVERIFY(!compositor.observer());
+
+    TestObserver other;
+    other.bind(Compositor::Id(2, 2));
+    QVERIFY(!compositor.observer());
+
+    TestObserver observer;
+    observer.bind(Compositor::Id(2, 1));
+    if (auto handle = compositor.observer())
+        handle->readyToSwap();
+    QCOMPARE(observer.readyCount.load(), 1);
+    QCOMPARE(other.readyCount.load(), 0);
+
+    observer.unbind();
+    other.unbind();
+    QVERIFY(!compositor.observer());
+}
+
+void tst_Compositor::unbindWhileInUse()
+{
+    TestObserver observer;
+    observer.bind(Compositor::Id(3, 1));
+    auto compositor = std::make_unique<TestCompositor>();
+    compositor->bind(Compositor::Id(3, 1));
+
+    std::atomic<bool> unbound { false };
+    QThread *thread = nullptr;
+    {
+        auto handle = observer.compositor();
+        QVERIFY(handle);
+        thread = QThread::create([&] {
+            compositor->unbind();
+            unbound = true;
+        });
+        thread->start();
+        QTest::qWait(50);
+        // Unbinding has to wait for the handle to go away.
+        QVERIFY(!unbound);
+        handle->swapFrame();
+    }
+    QVERIFY(thread->wait());
+    delete thread;
+    QVERIFY(unbound);
+    QVERIFY(!observer.compositor());
+    QCOMPARE(compositor->swaps.load(), 1);
+}
+
+void tst_Compositor::concurrentBindings_data()
+{
+    QTest::addColumn<int>("threadCount");
+
+    QTest::newRow("1 thread") << 1;
+    QTest::newRow("4 threads") << 4;
+    QTest::newRow("16 threads") << 16;
+}
+
+// Every thread binds a few thousand compositor/observer pairs, swaps
+// frames through them and unbinds them again.
+void tst_Compositor::concurrentBindings()
+{
+    QFETCH(int, threadCount);
+    const int bindingCount = 2000;
+    const int swapCount = 10;
+
+    std::atomic<int> missed { 0 };
+    std::vector<std::unique_ptr<QThread>> threads;
+    for (int t = 0; t < threadCount; ++t) {
+        threads.emplace_back(QThread::create([t, bindingCount, swapCount, &missed] {
+            std::vector<std::unique_ptr<TestObserver>> observers;
+            std::vector<std::unique_ptr<TestCompositor>> compositors;
+            for (int i = 0; i < bindingCount; ++i) {
+                Compositor::Id id(t + 1000, i);
+                observers.emplace_back(new TestObserver);
+                observers.back()->bind(id);
+                compositors.emplace_back(new TestCompositor);
+                compositors.back()->bind(id);
+            }
+            for (int s = 0; s < swapCount; ++s) {
+                for (int i = 0; i < bindingCount; ++i) {
+                    if (auto observer = compositors[i]->observer())
+                        observer->readyToSwap();
+                    if (auto compositor = observers[i]->compositor())
+                        compositor->swapFrame();
+                }
+            }
+            for (int i = 0; i < bindingCount; ++i) {
+                if (observers[i]->readyCount != swapCount || compositors[i]->swaps != swapCount)
+                    ++missed;
+                observers[i]->unbind();
+            }
+        }));
+        threads.back()->start();
+    }
+    for (auto &thread : threads)
+        QVERIFY(thread->wait());
+    QCOMPARE(missed.load(), 0);
+}
+
+static QImage filledImage(const QSize &size, Qt::GlobalColor color)
+{
+    QImage image(size, QImage::Format_ARGB32_Premultiplied);
+    image.fill(color);
+    return image;
+}
+
+void tst_Compositor::softwareFrameTexture()
+{
+    QRhiNullInitParams params;
+    QScopedPointer<QRhi> rhi(QRhi::create(QRhi::Null, &params));
+    QVERIFY(rhi);
+    UploadCounter counter = std::make_shared<std::atomic<qint64>>(0);
+    SoftwareFrameTexture texture;
+    texture.setUploadCounter(counter);
+    auto upload = [&](const QImage &image, const QRegion &damage) {
+        texture.setImage(image, damage);
+        QRhiResourceUpdateBatch *batch = rhi->nextResourceUpdateBatch();
+        texture.commitTextureOperations(rhi.data(), batch);
+        batch->release();
+        return texture.uploadedBytes();
+    };
+    const QSize size(64, 64);
+    const qint64 frameBytes = size.width() * size.height() * 4;
+
+    // the first frame is uploaded as a whole, whatever its damage
+    QCOMPARE(upload(filledImage(size, Qt::red), QRect(0, 0, 1, 1)), frameBytes);
+    QVERIFY(texture.rhiTexture());
+    QCOMPARE(texture.textureSize(), size);
+
+    // later ones only where damaged
+    QCOMPARE(upload(filledImage(size, Qt::blue), QRect(8, 8, 10, 10)), qint64(10 * 10 * 4));
+    QRegion twoRects = QRegion(0, 0, 4, 4) + QRegion(32, 32, 8, 2);
+    QCOMPARE(upload(filledImage(size, Qt::green), twoRects), qint64((4 * 4 + 8 * 2) * 4));
+    QCOMPARE(upload(filledImage(size, Qt::green), QRegion()), qint64(0));
+
+    // damage left outside of the frame is not uploaded
+    QCOMPARE(upload(filledImage(size, Qt::green), QRect(60, 60, 10, 10)), qint64(4 * 4 * 4));
+
+    // too fragmented damage is uploaded as its bounding rect
+    QRegion fragmented;
+    for (int i = 0; i < 20; ++i)
+        fragmented += QRect(i * 3, i * 3, 1, 1);
+    QCOMPARE(upload(filledImage(size, Qt::red), fragmented), qint64(58 * 58 * 4));
+
+    // as is everything once the frame is resized
+    const QSize newSize(32, 48);
+    QCOMPARE(upload(filledImage(newSize, Qt::red), QRect(0, 0, 1, 1)),
+             qint64(newSize.width() * newSize.height() * 4));
+    QCOMPARE(texture.textureSize(), newSize);
+
+    QCOMPARE(counter->load(), frameBytes + (10 * 10 + 4 * 4 + 8 * 2 + 4 * 4 + 58 * 58) * 4
+                                      + newSize.width() * newSize.height() * 4);
+}
+
+void tst_Compositor::softwareFrameImageTexture()
+{
+    UploadCounter counter = std::make_shared<std::atomic<qint64>>(0);
+    SoftwareFrameImageTexture texture;
+    texture.setUploadCounter(counter);
+    const QSize size(32, 32);
+
+    // the first frame is copied as a whole, whatever its damage
+    QImage frame = filledImage(size, Qt::red);
+    texture.setFrame(frame, QRect(0, 0, 1, 1));
+    QCOMPARE(texture.uploadedBytes(), qint64(size.width() * size.height() * 4));
+    QCOMPARE(texture.image(), frame);
+
+    // no reference to the frame is kept, it can be painted over right away
+    frame.fill(Qt::blue);
+    QCOMPARE(texture.image().pixel(0, 0), QColor(Qt::red).rgba());
+
+    // later frames are only copied where damaged
+    texture.setFrame(frame, QRegion(4, 4, 8, 8) + QRegion(20, 0, 2, 32));
+    QCOMPARE(texture.uploadedBytes(), qint64((8 * 8 + 2 * 32) * 4));
+    QCOMPARE(texture.image().pixel(5, 5), QColor(Qt::blue).rgba());
+    QCOMPARE(texture.image().pixel(21, 31), QColor(Qt::blue).rgba());
+    QCOMPARE(texture.image().pixel(0, 0), QColor(Qt::red).rgba());
+    QCOMPARE(texture.image().pixel(31, 31), QColor(Qt::red).rgba());
+
+    // damage left outside of the frame is not copied
+    texture.setFrame(filledImage(size, Qt::green), QRect(28, 28, 10, 10));
+    QCOMPARE(texture.uploadedBytes(), qint64(4 * 4 * 4));
+    QCOMPARE(texture.image().pixel(31, 31), QColor(Qt::green).rgba());
+    QCOMPARE(texture.image().pixel(27, 27), QColor(Qt::red).rgba());
+
+    // everything is once the frame is resized
+    const QImage resized = filledImage(QSize(16, 8), Qt::green);
+    texture.setFrame(resized, QRegion());
+    QCOMPARE(texture.uploadedBytes(), qint64(16 * 8 * 4));
+    QCOMPARE(texture.image(), resized);
+
+    QCOMPARE(counter->load(), qint64((32 * 32 + 8 * 8 + 2 * 32 + 4 * 4 + 16 * 8) * 4));
+}
+
+QTEST_MAIN(tst_Compositor)
+#include "tst_compositor.moc"
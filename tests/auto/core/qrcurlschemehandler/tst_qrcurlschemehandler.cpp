@@ -0,0 +1,86 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtWebEngine module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <util.h>
+
+#include <QtTest/QtTest>
+#include <QtWebEngineCore/qwebenginepage.h>
+#include <QtWebEngineCore/qwebengineprofile.h>
+
+class tst_QrcUrlSchemeHandler : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void precompressedVariants();
+    void notFound();
+    void manyAssets();
+};
+
+void tst_QrcUrlSchemeHandler::precompressedVariants()
+{
+    QWebEngineProfile profile;
+    QWebEnginePage page(&profile);
+    QVERIFY(loadSync(&page, QUrl("qrc:/resources/precompressed.html")));
+
+    // Only precompressed.js.gz exists.
+    QCOMPARE(evaluateJavaScriptSync(&page, "window.precompressedScript").toString(), QString("gzip"));
+
+    // Only precompressed.txt.br exists.
+    evaluateJavaScriptSync(&page, "window.text = null;"
+                                  "fetch('precompressed.txt').then(r => r.text()).then(t => { window.text = t; });");
+    QTRY_COMPARE(evaluateJavaScriptSync(&page, "window.text").toString(), QString("brotli\n"));
+}
+
+void tst_QrcUrlSchemeHandler::notFound()
+{
+    QWebEngineProfile profile;
+    QWebEnginePage page(&profile);
+    QVERIFY(loadSync(&page, QUrl("qrc:/resources/precompressed.html")));
+
+    // Neither the resource nor any variant of it exists. Misses are not cached,
+    // so a repeated request looks the resource up again and fails the same way.
+    for (int i = 0; i < 2; ++i) {
+        evaluateJavaScriptSync(&page, "window.failed = false;"
+                                      "fetch('missing.txt').catch(() => { window.failed = true; });");
+        QTRY_VERIFY(evaluateJavaScriptSync(&page, "window.failed").toBool());
+    }
+}
+
+void tst_QrcUrlSchemeHandler::manyAssets()
+{
+    QWebEngineProfile profile;
+    QWebEnginePage page(&profile);
+
+    QVERIFY(loadSync(&page, QUrl("qrc:/assets/index.html")));
+    QCOMPARE(evaluateJavaScriptSync(&page, "window.loadedAssets").toInt(), ASSET_COUNT);
+}
+
+QTEST_MAIN(tst_QrcUrlSchemeHandler)
+#include "tst_qrcurlschemehandler.moc"
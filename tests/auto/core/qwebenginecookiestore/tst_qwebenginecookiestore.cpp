@@ -61,7 +61,11 @@ private Q_SLOTS:
 
     void cookieSignals();
     void batchCookieTasks();
+    void bulkCookies();
     void basicFilter();
+    void cookieRules();
+    void cookieRuleParties();
+    void sessionOnlyCookieRule();
     void basicFilterOverHTTP();
     void html5featureFilter();
 
@@ -214,6 +218,69 @@ void tst_QWebEngineCookieStore::batchCookieTasks()
     QWE_TRY_COMPARE(cookieRemovedSpy.count(), 4);
 }
 
+void tst_QWebEngineCookieStore::bulkCookies()
+{
+    QWebEnginePage page(m_profile);
+    QWebEngineCookieStore *client = m_profile->cookieStore();
+
+    QSignalSpy loadSpy(&page, SIGNAL(loadFinished(bool)));
+    QSignalSpy cookieAddedSpy(client, SIGNAL(cookieAdded(const QNetworkCookie &)));
+    QSignalSpy cookiesChangedSpy(client, &QWebEngineCookieStore::cookiesChanged);
+
+    const int count = 5000;
+    QList<QNetworkCookie> cookies;
+    for (int i = 0; i < count; ++i)
+        cookies.append(QNetworkCookie("cookie" + QByteArray::number(i), "value"));
+
+    client->setBatchedChangeNotificationsEnabled(true);
+    QVERIFY(client->isBatchedChangeNotificationsEnabled());
+    // cookies set before and after loading are handed over alike
+    client->setCookies(cookies.mid(0, count / 2), QUrl("http://example.com/"));
+    page.load(QUrl("about:blank"));
+    QWE_TRY_COMPARE(loadSpy.count(), 1);
+    client->setCookies(cookies.mid(count / 2), QUrl("http://example.com/"));
+
+    int added = 0;
+    int removed = 0;
+    auto countChanges = [&]() {
+        for (const QList<QVariant> &arguments : qAsConst(cookiesChangedSpy)) {
+            added += arguments.at(0).value<QList<QNetworkCookie>>().size();
+            removed += arguments.at(1).value<QList<QNetworkCookie>>().size();
+        }
+        cookiesChangedSpy.clear();
+    };
+    QWE_TRY_VERIFY((countChanges(), added == count));
+    QCOMPARE(removed, 0);
+    QVERIFY(cookieAddedSpy.isEmpty());
+
+    QList<QNetworkCookie> allCookies;
+    bool called = false;
+    client->getAllCookies([&](const QList<QNetworkCookie> &result) {
+        allCookies = result;
+        called = true;
+    });
+    QWE_TRY_VERIFY(called);
+    QCOMPARE(allCookies.size(), count);
+
+    // overwriting a cookie is reported once
+    QNetworkCookie changed = cookies.first();
+    changed.setValue("other");
+    client->setCookie(changed, QUrl("http://example.com/"));
+    QWE_TRY_COMPARE(cookiesChangedSpy.count(), 1);
+    QList<QNetworkCookie> changedCookies = cookiesChangedSpy.at(0).at(0).value<QList<QNetworkCookie>>();
+    QCOMPARE(changedCookies.size(), 1);
+    QCOMPARE(changedCookies.first().value(), QByteArray("other"));
+    cookiesChangedSpy.clear();
+
+    added = 0;
+    client->deleteAllCookies();
+    QWE_TRY_VERIFY((countChanges(), removed == count));
+    QCOMPARE(added, 0);
+
+    client->setBatchedChangeNotificationsEnabled(false);
+    QVERIFY(cookieAddedSpy.isEmpty());
+}
+
 void tst_QWebEngineCookieStore::basicFilter()
 {
     QWebEnginePage page(m_profile);
@@ -246,6 +313,194 @@ void tst_QWebEngineCookieStore::basicFilter()
     QCOMPARE(cookieAddedSpy.count(), 2);
 }
 
+void tst_QWebEngineCookieStore::cookieRules()
+{
+    QWebEnginePage page(m_profile);
+    QWebEngineCookieStore *client = m_profile->cookieStore();
+
+    QAtomicInt accessTested = 0;
+    client->setCookieFilter([&](const QWebEngineCookieStore::FilterRequest &){ ++accessTested; return true;});
+
+    QSignalSpy loadSpy(&page, SIGNAL(loadFinished(bool)));
+    QSignalSpy cookieAddedSpy(client, SIGNAL(cookieAdded(const QNetworkCookie &)));
+
+    // rules for other domains are neither consulted nor in the way
+    QList<QWebEngineCookieRule> rules;
+    for (int i = 0; i < 100000; ++i)
+        rules.append(QWebEngineCookieRule(QWebEngineCookieRule::Block, QStringLiteral("site%1.example.com").arg(i)));
+    rules.append(QWebEngineCookieRule(QWebEngineCookieRule::Block));
+    client->setCookieRules(rules);
+    QCOMPARE(client->cookieRules().size(), rules.size());
+
+    const quint64 blocked = client->blockedCookieAccessCount();
+    page.load(QUrl("qrc:///resources/index.html"));
+    QWE_TRY_COMPARE(loadSpy.count(), 1);
+    QVERIFY(loadSpy.takeFirst().takeFirst().toBool());
+    QWE_TRY_VERIFY(client->blockedCookieAccessCount() > blocked);
+    QTest::qWait(100);
+    QCOMPARE(cookieAddedSpy.count(), 0);
+    QCOMPARE(accessTested.loadAcquire(), 0);
+
+    // without a matching rule the filter decides again
+    rules.removeLast();
+    client->setCookieRules(rules);
+    const quint64 allowed = client->allowedCookieAccessCount();
+    page.triggerAction(QWebEnginePage::ReloadAndBypassCache);
+    QWE_TRY_COMPARE(loadSpy.count(), 1);
+    QVERIFY(loadSpy.takeFirst().takeFirst().toBool());
+    QWE_TRY_COMPARE(cookieAddedSpy.count(), 2);
+    QVERIFY(accessTested.loadAcquire() > 0);
+    QVERIFY(client->allowedCookieAccessCount() > allowed);
+
+    client->setCookieRules({});
+    QVERIFY(client->cookieRules().isEmpty());
+    client->setCookieFilter(nullptr);
+}
+
+void tst_QWebEngineCookieStore::cookieRuleParties()
+{
+    QWebEnginePage page(m_profile);
+    QWebEngineCookieStore *client = m_profile->cookieStore();
+
+    HttpServer httpServer;
+    httpServer.setHostDomain(QString("first.localhost"));
+    QVERIFY(httpServer.start());
+    auto urlOnHost = [&httpServer](const QString &host, const QString &path) {
+        QUrl url = httpServer.url(path);
+        url.setHost(host);
+        return url;
+    };
+    // every page embeds an image from third.localhost
+    const QUrl imageUrl = urlOnHost("third.localhost", "/image.png");
+    connect(&httpServer, &HttpServer::newRequest, [&imageUrl](HttpReqRep *rr) {
+        if (rr->requestPath() == "/page.html") {
+            rr->setResponseHeader(QByteArrayLiteral("content-type"), QByteArrayLiteral("text/html"));
+            rr->setResponseBody("<html><body><img src='" + imageUrl.toEncoded() + "'></body></html>");
+            rr->sendResponse();
+        } else if (rr->requestPath() == "/image.png") {
+            rr->setResponseHeader(QByteArrayLiteral("set-cookie"), QByteArrayLiteral("Image=1"));
+            rr->sendResponse();
+        }
+    });
+
+    // the filter only sees the accesses no rule decided
+    QStringList filteredHosts;
+    client->setCookieFilter([&](const QWebEngineCookieStore::FilterRequest &request) {
+        filteredHosts.append(request.origin.host());
+        return true;
+    });
+    QSignalSpy loadSpy(&page, SIGNAL(loadFinished(bool)));
+    auto loadPage = [&](const QString &host) {
+        filteredHosts.clear();
+        page.load(urlOnHost(host, "/page.html"));
+    };
+
+    QWebEngineCookieRule thirdParty(QWebEngineCookieRule::Block, "third.localhost");
+    thirdParty.setParty(QWebEngineCookieRule::ThirdParty);
+    client->setCookieRules({ thirdParty });
+    quint64 blocked = client->blockedCookieAccessCount();
+    loadPage("first.localhost");
+    QWE_TRY_COMPARE(loadSpy.count(), 1);
+    QVERIFY(loadSpy.takeFirst().takeFirst().toBool());
+    QWE_TRY_VERIFY(client->blockedCookieAccessCount() > blocked);
+    QVERIFY(filteredHosts.contains("first.localhost"));
+    QVERIFY(!filteredHosts.contains("third.localhost"));
+    loadPage("third.localhost");
+    QWE_TRY_COMPARE(loadSpy.count(), 1);
+    QVERIFY(loadSpy.takeFirst().takeFirst().toBool());
+    QWE_TRY_VERIFY(filteredHosts.contains("third.localhost"));
+
+    QWebEngineCookieRule firstParty(QWebEngineCookieRule::Block, "third.localhost");
+    firstParty.setParty(QWebEngineCookieRule::FirstParty);
+    client->setCookieRules({ firstParty });
+    loadPage("first.localhost");
+    QWE_TRY_COMPARE(loadSpy.count(), 1);
+    QVERIFY(loadSpy.takeFirst().takeFirst().toBool());
+    QWE_TRY_VERIFY(filteredHosts.contains("third.localhost"));
+    blocked = client->blockedCookieAccessCount();
+    loadPage("third.localhost");
+    QWE_TRY_COMPARE(loadSpy.count(), 1);
+    QVERIFY(loadSpy.takeFirst().takeFirst().toBool());
+    QWE_TRY_VERIFY(client->blockedCookieAccessCount() > blocked);
+    QVERIFY(!filteredHosts.contains("third.localhost"));
+
+    // only when embedded in pages from first.localhost
+    QWebEngineCookieRule embedded(QWebEngineCookieRule::Block, "third.localhost");
+    embedded.setFirstPartyDomain("first.localhost");
+    client->setCookieRules({ embedded });
+    blocked = client->blockedCookieAccessCount();
+    loadPage("first.localhost");
+    QWE_TRY_COMPARE(loadSpy.count(), 1);
+    QVERIFY(loadSpy.takeFirst().takeFirst().toBool());
+    QWE_TRY_VERIFY(client->blockedCookieAccessCount() > blocked);
+    QVERIFY(!filteredHosts.contains("third.localhost"));
+    loadPage("other.localhost");
+    QWE_TRY_COMPARE(loadSpy.count(), 1);
+    QVERIFY(loadSpy.takeFirst().takeFirst().toBool());
+    QWE_TRY_VERIFY(filteredHosts.contains("third.localhost"));
+
+    client->setCookieRules({});
+    client->setCookieFilter(nullptr);
+    (void) httpServer.stop();
+}
+
+void tst_QWebEngineCookieStore::sessionOnlyCookieRule()
+{
+    QTemporaryDir dataDir;
+    QVERIFY(dataDir.isValid());
+    const QDateTime tomorrow = QDateTime::currentDateTime().addDays(1);
+    auto cookieNames = [](const QSignalSpy &spy) {
+        QList<QByteArray> names;
+        for (const QList<QVariant> &args : spy)
+            names.append(args.at(0).value<QNetworkCookie>().name());
+        return names;
+    };
+
+    {
+        QWebEngineProfile profile(QStringLiteral("sessionOnlyCookieRule"));
+        profile.setPersistentStoragePath(dataDir.path());
+        profile.setPersistentCookiesPolicy(QWebEngineProfile::ForcePersistentCookies);
+        QWebEngineCookieStore *client = profile.cookieStore();
+        client->setCookieRules({ QWebEngineCookieRule(QWebEngineCookieRule::SessionOnly, "session.example.com") });
+        QSignalSpy cookieAddedSpy(client, SIGNAL(cookieAdded(const QNetworkCookie &)));
+
+        QWebEnginePage page(&profile);
+        QSignalSpy loadSpy(&page, SIGNAL(loadFinished(bool)));
+        page.load(QUrl("about:blank"));
+        QWE_TRY_COMPARE(loadSpy.count(), 1);
+
+        QNetworkCookie sessionOnly("SessionOnly", "1");
+        sessionOnly.setExpirationDate(tomorrow);
+        client->setCookie(sessionOnly, QUrl("https://session.example.com/"));
+        QNetworkCookie subdomain("Subdomain", "1");
+        subdomain.setExpirationDate(tomorrow);
+        client->setCookie(subdomain, QUrl("https://www.session.example.com/"));
+        QNetworkCookie other("Other", "1");
+        other.setExpirationDate(tomorrow);
+        client->setCookie(other, QUrl("https://other.example.com/"));
+        QWE_TRY_COMPARE(cookieAddedSpy.count(), 3);
+
+        // the cookies are left as they are for the session
+        for (const QList<QVariant> &args : qAsConst(cookieAddedSpy))
+            QVERIFY(!args.at(0).value<QNetworkCookie>().isSessionCookie());
+    }
+
+    // but only the ones of other sites are still there in the next one
+    QWebEngineProfile profile(QStringLiteral("sessionOnlyCookieRule"));
+    profile.setPersistentStoragePath(dataDir.path());
+    profile.setPersistentCookiesPolicy(QWebEngineProfile::ForcePersistentCookies);
+    QWebEngineCookieStore *client = profile.cookieStore();
+    QSignalSpy cookieAddedSpy(client, SIGNAL(cookieAdded(const QNetworkCookie &)));
+    client->loadAllCookies();
+    QWebEnginePage page(&profile);
+    QSignalSpy loadSpy(&page, SIGNAL(loadFinished(bool)));
+    page.load(QUrl("about:blank"));
+    QWE_TRY_COMPARE(loadSpy.count(), 1);
+    QWE_TRY_VERIFY(cookieNames(cookieAddedSpy).contains("Other"));
+    QVERIFY(!cookieNames(cookieAddedSpy).contains("SessionOnly"));
+    QVERIFY(!cookieNames(cookieAddedSpy).contains("Subdomain"));
+}
+
 void tst_QWebEngineCookieStore::basicFilterOverHTTP()
 {
     QWebEnginePage page(m_profile);
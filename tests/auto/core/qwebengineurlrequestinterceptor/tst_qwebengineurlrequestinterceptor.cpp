@@ -30,6 +30,7 @@
 #include <QtTest/QtTest>
 #include <QtWebEngineCore/qwebengineurlrequestinfo.h>
 #include <QtWebEngineCore/qwebengineurlrequestinterceptor.h>
+#include <QtWebEngineCore/qwebengineurlrequestrule.h>
 #include <QtWebEngineCore/qwebenginesettings.h>
 #include <QtWebEngineCore/qwebengineprofile.h>
 #include <QtWebEngineCore/qwebenginepage.h>
@@ -70,6 +71,8 @@ private Q_SLOTS:
     void replaceInterceptor_data();
     void replaceInterceptor();
     void replaceOnIntercept();
+    void requestRules();
+    void manyRequestRules();
 };
 
 tst_QWebEngineUrlRequestInterceptor::tst_QWebEngineUrlRequestInterceptor()
@@ -869,5 +872,130 @@ void tst_QWebEngineUrlRequestInterceptor::replaceOnIntercept()
     QCOMPARE(profileInterceptor.requestInfos.size(), pageInterceptor2.requestInfos.size());
 }
 
+void tst_QWebEngineUrlRequestInterceptor::requestRules()
+{
+    HttpServer httpServer;
+    httpServer.setResourceDirs({ QDir(QT_TESTCASE_SOURCEDIR).canonicalPath() + "/resources" });
+    QVERIFY(httpServer.start());
+    const QString host = httpServer.url().host();
+
+    QList<QByteArray> requestedPaths;
+    QByteArray fromHeader;
+    connect(&httpServer, &HttpServer::newRequest, [&] (HttpReqRep *rr) {
+        requestedPaths.append(rr->requestPath());
+        if (rr->requestPath() == "/content.html")
+            fromHeader = rr->requestHeader("from");
+    });
+
+    QWebEngineProfile profile;
+    TestRequestInterceptor interceptor;
+    profile.setUrlRequestInterceptor(&interceptor);
+    QWebEnginePage page(&profile);
+    QSignalSpy loadSpy(&page, SIGNAL(loadFinished(bool)));
+
+    // header modification
+    QWebEngineUrlRequestRule header(QWebEngineUrlRequestRule::ModifyHeaders, host);
+    header.setHeader("from", "rules@example.com");
+    profile.setUrlRequestRules({ header });
+    QCOMPARE(profile.urlRequestRules(), QList<QWebEngineUrlRequestRule>({ header }));
+    page.load(httpServer.url("/content.html"));
+    QTRY_COMPARE(loadSpy.count(), 1);
+    QVERIFY(loadSpy.takeFirst().at(0).toBool());
+    QCOMPARE(fromHeader, QByteArray("rules@example.com"));
+    QCOMPARE(interceptor.requestInfos.count(), 1);
+
+    // blocked requests do not reach the interceptor
+    interceptor.requestInfos.clear();
+    requestedPaths.clear();
+    QWebEngineUrlRequestRule block(QWebEngineUrlRequestRule::Block);
+    block.setUrlPattern("*/content2.html");
+    profile.setUrlRequestRules({ block });
+    page.load(httpServer.url("/content2.html"));
+    QTRY_COMPARE(loadSpy.count(), 1);
+    QVERIFY(!loadSpy.takeFirst().at(0).toBool());
+    QVERIFY(interceptor.requestInfos.isEmpty());
+    QVERIFY(!requestedPaths.contains("/content2.html"));
+
+    // an allow rule overrides the block
+    QWebEngineUrlRequestRule allow(QWebEngineUrlRequestRule::Allow, host);
+    allow.setResourceTypes({ QWebEngineUrlRequestInfo::ResourceTypeMainFrame });
+    profile.setUrlRequestRules({ block, allow });
+    page.load(httpServer.url("/content2.html"));
+    QTRY_COMPARE(loadSpy.count(), 1);
+    QVERIFY(loadSpy.takeFirst().at(0).toBool());
+
+    // redirect
+    QWebEngineUrlRequestRule redirect(QWebEngineUrlRequestRule::Redirect);
+    redirect.setUrlPattern("*/content2.html");
+    redirect.setRedirectUrl(httpServer.url("/content.html"));
+    profile.setUrlRequestRules({ redirect });
+    page.load(httpServer.url("/content2.html"));
+    QTRY_COMPARE(loadSpy.count(), 1);
+    QVERIFY(loadSpy.takeFirst().at(0).toBool());
+    QCOMPARE(page.url(), httpServer.url("/content.html"));
+
+    // a redirect rule matching its own target does not loop
+    requestedPaths.clear();
+    QWebEngineUrlRequestRule redirectAll(QWebEngineUrlRequestRule::Redirect, host);
+    redirectAll.setRedirectUrl(httpServer.url("/content.html"));
+    profile.setUrlRequestRules({ redirectAll });
+    page.load(httpServer.url("/content.html"));
+    QTRY_COMPARE(loadSpy.count(), 1);
+    QVERIFY(loadSpy.takeFirst().at(0).toBool());
+    QCOMPARE(page.url(), httpServer.url("/content.html"));
+    QCOMPARE(requestedPaths.count("/content.html"), 1);
+
+    // nor does one matching the target of another redirect rule
+    requestedPaths.clear();
+    QWebEngineUrlRequestRule redirectBack(QWebEngineUrlRequestRule::Redirect);
+    redirectBack.setUrlPattern("*/content.html");
+    redirectBack.setRedirectUrl(httpServer.url("/content2.html"));
+    profile.setUrlRequestRules({ redirect, redirectBack });
+    page.load(httpServer.url("/content2.html"));
+    QTRY_COMPARE(loadSpy.count(), 1);
+    QVERIFY(loadSpy.takeFirst().at(0).toBool());
+    QCOMPARE(page.url(), httpServer.url("/content.html"));
+    QVERIFY(!requestedPaths.contains("/content2.html"));
+
+    // a rule restricted to types it cannot match is dropped, not applied to all types
+    QWebEngineUrlRequestRule unknown(QWebEngineUrlRequestRule::Block);
+    unknown.setResourceTypes({ QWebEngineUrlRequestInfo::ResourceTypeUnknown });
+    QTest::ignoreMessage(QtWarningMsg, "URL request rules cannot match resource type 255, ignoring it.");
+    QTest::ignoreMessage(QtWarningMsg, "Ignoring URL request rule that matches none of its resource types.");
+    profile.setUrlRequestRules({ unknown });
+    page.load(httpServer.url("/content2.html"));
+    QTRY_COMPARE(loadSpy.count(), 1);
+    QVERIFY(loadSpy.takeFirst().at(0).toBool());
+
+    profile.setUrlRequestRules({});
+    QVERIFY(profile.urlRequestRules().isEmpty());
+    (void) httpServer.stop();
+}
+
+// Rules keep applying with a block list of the size of common ad blocking lists.
+void tst_QWebEngineUrlRequestInterceptor::manyRequestRules()
+{
+    const int ruleCount = 100000;
+    QList<QWebEngineUrlRequestRule> rules;
+    rules.reserve(ruleCount + 1);
+    for (int i = 0; i < ruleCount; ++i)
+        rules.append(QWebEngineUrlRequestRule(QWebEngineUrlRequestRule::Block,
+                                              QStringLiteral("ads%1.example.com").arg(i)));
+    QWebEngineUrlRequestRule style(QWebEngineUrlRequestRule::Block);
+    style.setUrlPattern("*/style.css");
+    style.setResourceTypes({ QWebEngineUrlRequestInfo::ResourceTypeStylesheet });
+    rules.append(style);
+
+    QWebEngineProfile profile;
+    profile.setUrlRequestRules(rules);
+    TestRequestInterceptor interceptor;
+    profile.setUrlRequestInterceptor(&interceptor);
+    QWebEnginePage page(&profile);
+
+    QVERIFY(loadSync(&page, QUrl("qrc:///resources/resource.html")));
+    QVERIFY(interceptor.hasUrlRequestForType(QWebEngineUrlRequestInfo::ResourceTypeMainFrame));
+    QVERIFY(!interceptor.hasUrlRequestForType(QWebEngineUrlRequestInfo::ResourceTypeStylesheet));
+}
+
 QTEST_MAIN(tst_QWebEngineUrlRequestInterceptor)
 #include "tst_qwebengineurlrequestinterceptor.moc"
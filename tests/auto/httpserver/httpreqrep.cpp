@@ -36,6 +36,15 @@ HttpReqRep::HttpReqRep(QTcpSocket *socket, QObject *parent)
 }
 
 void HttpReqRep::sendResponse(int statusCode)
+{
+    if (m_state != State::REQUEST_RECEIVED)
+        return;
+    sendResponseHeaders(statusCode);
+    sendResponseData(m_responseBody);
+    finishResponse();
+}
+
+void HttpReqRep::sendResponseHeaders(int statusCode)
 {
     if (m_state != State::REQUEST_RECEIVED)
         return;
@@ -51,10 +60,23 @@ void HttpReqRep::sendResponse(int statusCode)
     }
     m_socket->write("Connection: close\r\n");
     m_socket->write("\r\n");
-    m_socket->write(m_responseBody);
+    m_state = State::SENDING_RESPONSE;
+    Q_EMIT responseSent();
+}
+
+void HttpReqRep::sendResponseData(const QByteArray &data)
+{
+    if (m_state != State::SENDING_RESPONSE)
+        return;
+    m_socket->write(data);
+}
+
+void HttpReqRep::finishResponse()
+{
+    if (m_state != State::SENDING_RESPONSE)
+        return;
     m_state = State::DISCONNECTING;
     m_socket->disconnectFromHost();
-    Q_EMIT responseSent();
 }
 
 void HttpReqRep::sendResponse(const QByteArray &response)
@@ -133,6 +155,7 @@ void HttpReqRep::handleDisconnected()
     case State::REQUEST_RECEIVED:
         Q_EMIT error(QStringLiteral("unexpected disconnect"));
         break;
+    case State::SENDING_RESPONSE: // the client may stop reading a streamed body
     case State::DISCONNECTING:
         break;
     case State::DISCONNECTED:
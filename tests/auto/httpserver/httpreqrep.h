@@ -42,6 +42,11 @@ public:
 
     Q_INVOKABLE void sendResponse(int statusCode = 200);
     void sendResponse(const QByteArray &response);
+    // Streams the body: sends status line and headers, then each piece of data
+    // as it is passed in, until finishResponse().
+    void sendResponseHeaders(int statusCode = 200);
+    void sendResponseData(const QByteArray &data);
+    void finishResponse();
     void close();
     bool isClosed() const { return m_state == State::DISCONNECTED; }
 
@@ -90,7 +95,9 @@ private:
         // Waiting for header lines.
         RECEIVING_HEADERS,      // Next: REQUEST_RECEIVED or DISCONNECTING.
         // Request parsing succeeded, waiting for sendResponse() or close().
-        REQUEST_RECEIVED,       // Next: DISCONNECTING.
+        REQUEST_RECEIVED,       // Next: SENDING_RESPONSE or DISCONNECTING.
+        // Headers sent, waiting for more of the body or finishResponse().
+        SENDING_RESPONSE,       // Next: DISCONNECTING or DISCONNECTED.
         // Waiting for network.
         DISCONNECTING,          // Next: DISCONNECTED.
         // Connection is dead.
@@ -39,11 +39,20 @@
 
 
 #include <QtTest/QtTest>
+#include <QtPdf/private/qpdfdocument_p.h>
+#include <QtPdf/private/qpdfrenderprocess_p.h>
+#include <QtPdf/private/qpdftilecache_p.h>
+#include <QtPdf/private/qpdftilerenderer_p.h>
+
+#include <httpserver.h>
 
 #include <QPainter>
 #include <QPdfDocument>
+#include <QPdfPageRenderer>
+#include <QPdfSelection>
 #include <QPrinter>
 #include <QTemporaryFile>
+#include <QThread>
 #include <QNetworkAccessManager>
 #include <QNetworkRequest>
 #include <QNetworkReply>
@@ -62,6 +71,8 @@ private slots:
     void pageCount();
     void loadFromIODevice();
     void loadAsync();
+    void loadWithRangeRequests_data();
+    void loadWithRangeRequests();
     void password();
     void close();
     void loadAfterClose();
@@ -69,6 +80,17 @@ private slots:
     void status();
     void passwordClearedOnClose();
     void metaData();
+    void pageSizeCached();
+    void textOfCachedPages();
+    void renderClipped();
+    void renderTiles_data();
+    void renderTiles();
+    void tileRendererDropsStaleRequests();
+    void renderConcurrently_data();
+    void renderConcurrently();
+    void renderInWorkerProcess();
+    void loadAndRenderAll_data();
+    void loadAndRenderAll();
 
 private:
     void consistencyCheck(QPdfDocument &doc) const;
@@ -181,6 +203,146 @@ void tst_QPdfDocument::loadAsync()
     consistencyCheck(doc);
 }
 
+void tst_QPdfDocument::loadWithRangeRequests_data()
+{
+    QTest::addColumn<int>("failingRangeRequests");
+    QTest::addColumn<bool>("changedOnServer");
+    QTest::addColumn<QPdfDocument::Status>("expectedStatus");
+    QTest::newRow("all succeed") << 0 << false << QPdfDocument::Ready;
+    QTest::newRow("retried") << 1 << false << QPdfDocument::Ready;
+    QTest::newRow("server down") << 1000 << false << QPdfDocument::Error;
+    QTest::newRow("changed on the server") << 0 << true << QPdfDocument::Error;
+}
+
+void tst_QPdfDocument::loadWithRangeRequests()
+{
+    QFETCH(int, failingRangeRequests);
+    QFETCH(bool, changedOnServer);
+    QFETCH(QPdfDocument::Status, expectedStatus);
+
+    // a document large enough that most of it has to be fetched with range requests
+    QTemporaryFile largePdf;
+    QVERIFY(largePdf.open());
+    const int pageCount = 30;
+    {
+        QPrinter printer;
+        printer.setOutputFormat(QPrinter::PdfFormat);
+        printer.setOutputFileName(largePdf.fileName());
+        QPainter painter(&printer);
+        QImage noise(256, 256, QImage::Format_RGB32);
+        for (int page = 0; page < pageCount; ++page) {
+            if (page)
+                printer.newPage();
+            for (int y = 0; y < noise.height(); ++y) {
+                for (int x = 0; x < noise.width(); ++x)
+                    noise.setPixel(x, y, QRandomGenerator::global()->generate());
+            }
+            painter.drawImage(QPoint(50, 50), noise);
+            painter.drawText(50, 400, QStringLiteral("Page %1").arg(page + 1));
+        }
+    }
+    const QByteArray data = largePdf.readAll();
+
+    HttpServer server;
+    int rangeRequests = 0;
+    int rangeRequestsWithoutToken = 0;
+    QByteArrayList ifRanges;
+    qint64 rangeBytes = 0;
+    connect(&server, &HttpServer::newRequest, [&](HttpReqRep *rr) {
+        if (rr->requestPath() != "/large.pdf")
+            return;
+        const QByteArray range = rr->requestHeader("range");
+        if (!range.startsWith("bytes=")) {
+            // the connection drops early, the rest has to come from range requests
+            rr->sendResponse("HTTP/1.1 200 OK\r\n"
+                             "Content-Type: application/pdf\r\n"
+                             "Accept-Ranges: bytes\r\n"
+                             "ETag: \"v1\"\r\n"
+                             "Content-Length: " + QByteArray::number(data.size()) + "\r\n"
+                             "Connection: close\r\n\r\n"
+                             + data.left(256 * 1024));
+            return;
+        }
+        ++rangeRequests;
+        if (rr->requestHeader("x-test-token") != "secret")
+            ++rangeRequestsWithoutToken;
+        ifRanges.append(rr->requestHeader("if-range"));
+        if (failingRangeRequests > 0) {
+            --failingRangeRequests;
+            rr->sendResponse(503);
+            return;
+        }
+        rr->setResponseHeader("content-type", "application/pdf");
+        rr->setResponseHeader("accept-ranges", "bytes");
+        if (changedOnServer) {
+            // If-Range does not match any more, so the whole new file is sent
+            QByteArray changed = data;
+            changed.replace("Page", "Side");
+            rr->setResponseHeader("etag", "\"v2\"");
+            rr->setResponseBody(changed);
+            rr->sendResponse(200);
+            return;
+        }
+        const QList<QByteArray> bounds = range.mid(6).split('-');
+        const qint64 first = bounds.value(0).toLongLong();
+        const qint64 last = qMin(bounds.value(1).toLongLong(), qint64(data.size()) - 1);
+        rr->setResponseHeader("etag", "\"v1\"");
+        rr->setResponseHeader("content-range", "bytes " + QByteArray::number(first) + '-'
+                              + QByteArray::number(last) + '/' + QByteArray::number(data.size()));
+        rr->setResponseBody(data.mid(first, last - first + 1));
+        rangeBytes += last - first + 1;
+        rr->sendResponse(206);
+    });
+    QVERIFY(server.start());
+
+    QNetworkAccessManager nam;
+    QNetworkRequest request(server.url("/large.pdf"));
+    request.setRawHeader("x-test-token", "secret");
+    QScopedPointer<QNetworkReply> reply(nam.get(request));
+    QSignalSpy replyFinishedSpy(reply.data(), &QNetworkReply::finished);
+
+    QPdfDocument doc;
+    QSignalSpy statusChangedSpy(&doc, &QPdfDocument::statusChanged);
+    QSignalSpy pageAvailableSpy(&doc, &QPdfDocument::pageAvailable);
+    doc.load(reply.data());
+    QTRY_COMPARE_WITH_TIMEOUT(doc.status(), expectedStatus, 10000);
+    QVERIFY(rangeRequests > 0);
+
+    // range requests are sent like the application's request, for the same file
+    QCOMPARE(rangeRequestsWithoutToken, 0);
+    for (const QByteArray &ifRange : qAsConst(ifRanges))
+        QCOMPARE(ifRange, QByteArray("\"v1\""));
+
+    // the application's reply is left alone, not aborted
+    QTRY_COMPARE(replyFinishedSpy.count(), 1);
+    QVERIFY(reply->error() != QNetworkReply::OperationCanceledError);
+
+    if (expectedStatus == QPdfDocument::Error) {
+        QCOMPARE(doc.error(), QPdfDocument::UnknownError);
+    } else {
+        QCOMPARE(statusChangedSpy.count(), 2);
+        QCOMPARE(doc.pageCount(), pageCount);
+
+        // asking for a page that has not been fetched yet fetches it
+        const int lastPage = pageCount - 1;
+        if (!doc.pageSize(lastPage).isValid()) {
+            QTRY_VERIFY_WITH_TIMEOUT(std::any_of(pageAvailableSpy.cbegin(), pageAvailableSpy.cend(),
+                    [lastPage](const QList<QVariant> &args) { return args.first().toInt() == lastPage; }),
+                    10000);
+        }
+        QCOMPARE(doc.getAllText(lastPage).text().trimmed(), QStringLiteral("Page %1").arg(pageCount));
+        QVERIFY(!doc.render(lastPage, QSize(100, 140)).isNull());
+
+        // the pages in between were never asked for
+        QVERIFY2(rangeBytes < data.size() / 2,
+                 qPrintable(QStringLiteral("fetched %1 of %2 bytes").arg(rangeBytes).arg(data.size())));
+    }
+
+    doc.close();
+    // the range requests still running when the document closed are aborted
+    Q_UNUSED(server.stop());
+}
+
 void tst_QPdfDocument::password()
 {
     QPdfDocument doc;
@@ -415,6 +577,296 @@ void tst_QPdfDocument::metaData()
     QCOMPARE(doc.metaData(QPdfDocument::ModificationDate).toDateTime(), QDateTime(QDate(2016, 8, 8), QTime(8, 3, 6), Qt::UTC));
 }
 
+void tst_QPdfDocument::pageSizeCached()
+{
+    TemporaryPdf tempPdf;
+    QPdfDocument doc;
+    doc.load(&tempPdf);
+    QCOMPARE(doc.pageCount(), 2);
+
+    const QSizeF size = doc.pageSize(0);
+    QCOMPARE(size.toSize(), tempPdf.pageLayout.fullRectPoints().size());
+    // answered from the cache the second time around
+    QCOMPARE(doc.pageSize(0), size);
+    QCOMPARE(doc.pageSize(1), size);
+    QCOMPARE(doc.pageSize(2), QSizeF());
+
+    doc.close();
+    QCOMPARE(doc.pageSize(0), QSizeF());
+}
+
+void tst_QPdfDocument::textOfCachedPages()
+{
+    TemporaryPdf tempPdf;
+    QPdfDocument doc;
+    doc.load(&tempPdf);
+    QCOMPARE(doc.pageCount(), 2);
+
+    // Alternate between the pages and between rendering and text queries,
+    // so that both fresh and cached page handles are used.
+    for (int i = 0; i < 3; ++i) {
+        for (int page = 0; page < doc.pageCount(); ++page) {
+            QVERIFY(!doc.render(page, QSize(100, 100)).isNull());
+            QCOMPARE(doc.getAllText(page).text().trimmed(), TemporaryPdf::pageText(page));
+            const QPdfSelection selection = doc.getSelectionAtIndex(page, 0, 5);
+            QCOMPARE(selection.text(), TemporaryPdf::pageText(page).left(5));
+        }
+    }
+
+    // Each page and its text are loaded once. The first round takes the page
+    // from the cache four times, in getAllText() and getSelectionAtIndex(),
+    // and its text once; the later rounds five times and twice.
+    const QPdfDocumentPrivate::PageCacheStatistics statistics =
+            QPdfDocumentPrivate::get(&doc)->cacheStatistics();
+    QCOMPARE(statistics.pageMisses, quint64(2));
+    QCOMPARE(statistics.pageHits, quint64(2 * 4 + 4 * 5));
+    QCOMPARE(statistics.textPageMisses, quint64(2));
+    QCOMPARE(statistics.textPageHits, quint64(2 * 1 + 4 * 2));
+
+    // closing drops the cached pages along with the document
+    doc.close();
+    QVERIFY(doc.getAllText(0).text().isEmpty());
+    QVERIFY(doc.render(0, QSize(100, 100)).isNull());
+
+    tempPdf.seek(0);
+    doc.load(&tempPdf);
+    QCOMPARE(doc.getAllText(1).text().trimmed(), TemporaryPdf::pageText(1));
+}
+
+void tst_QPdfDocument::renderClipped()
+{
+    QPdfDocument doc;
+    QCOMPARE(doc.load(QFINDTESTDATA("pdf-sample.metadata.pdf")), QPdfDocument::NoError);
+    const QSize scaledSize = (doc.pageSize(0) * 2).toSize();
+    const QImage page = doc.render(0, scaledSize);
+    QVERIFY(!page.isNull());
+
+    // The inclusive edges of the clip rect are mapped onto those of the image,
+    // so a clip rect one pixel larger than the image maps it 1:1 onto the page.
+    const QRect area(scaledSize.width() / 4, scaledSize.height() / 4, 100, 80);
+    QPdfDocumentRenderOptions options;
+    options.setScaledSize(scaledSize);
+    options.setScaledClipRect(area.adjusted(0, 0, 1, 1));
+    const QImage clipped = doc.render(0, area.size(), options);
+    QCOMPARE(clipped.size(), area.size());
+
+    const QImage expected = page.copy(area).convertToFormat(clipped.format());
+    int differentPixels = 0;
+    for (int y = 0; y < area.height(); ++y) {
+        for (int x = 0; x < area.width(); ++x) {
+            const QRgb a = clipped.pixel(x, y);
+            const QRgb b = expected.pixel(x, y);
+            if (qAbs(qRed(a) - qRed(b)) > 32 || qAbs(qGreen(a) - qGreen(b)) > 32
+                    || qAbs(qBlue(a) - qBlue(b)) > 32 || qAbs(qAlpha(a) - qAlpha(b)) > 32)
+                ++differentPixels;
+        }
+    }
+    // antialiasing may differ a little, but nothing is shifted or scaled
+    QVERIFY2(differentPixels < area.width() * area.height() / 100,
+             qPrintable(QStringLiteral("%1 pixels differ").arg(differentPixels)));
+}
+
+void tst_QPdfDocument::renderTiles_data()
+{
+    QTest::addColumn<QPdf::Rotation>("rotation");
+    QTest::newRow("0") << QPdf::Rotate0;
+    QTest::newRow("90") << QPdf::Rotate90;
+    QTest::newRow("180") << QPdf::Rotate180;
+    QTest::newRow("270") << QPdf::Rotate270;
+}
+
+void tst_QPdfDocument::renderTiles()
+{
+    QFETCH(QPdf::Rotation, rotation);
+    QPdfDocument doc;
+    QCOMPARE(doc.load(QFINDTESTDATA("pdf-sample.metadata.pdf")), QPdfDocument::NoError);
+    QSize scaledSize = (doc.pageSize(0) * 2).toSize();
+    if (rotation == QPdf::Rotate90 || rotation == QPdf::Rotate270)
+        scaledSize.transpose();
+    QPdfDocumentRenderOptions options;
+    options.setRotation(rotation);
+    const QImage page = doc.render(0, scaledSize, options);
+    QVERIFY(!page.isNull());
+
+    // the tiles of the cache are rendered with an exact mapping of their area,
+    // so put together they are the page
+    QPdfTileCache cache;
+    QImage tiled(scaledSize, page.format());
+    tiled.fill(Qt::transparent);
+    QPainter painter(&tiled);
+    painter.setCompositionMode(QPainter::CompositionMode_Source);
+    for (int row = 0; row * QPdfTileCache::TileSize < scaledSize.height(); ++row) {
+        for (int column = 0; column * QPdfTileCache::TileSize < scaledSize.width(); ++column) {
+            const auto key = QPdfTileCache::tileKey(&doc, 0, scaledSize, column, row, options);
+            const QImage tile = cache.renderTile(&doc, key);
+            QCOMPARE(tile.size(), key.rect.size());
+            QCOMPARE(cache.find(key), tile);
+            painter.drawImage(key.rect.topLeft(), tile);
+        }
+    }
+    painter.end();
+
+    int differentPixels = 0;
+    for (int y = 0; y < scaledSize.height(); ++y) {
+        for (int x = 0; x < scaledSize.width(); ++x) {
+            const QRgb a = tiled.pixel(x, y);
+            const QRgb b = page.pixel(x, y);
+            if (qAbs(qRed(a) - qRed(b)) > 32 || qAbs(qGreen(a) - qGreen(b)) > 32
+                    || qAbs(qBlue(a) - qBlue(b)) > 32 || qAbs(qAlpha(a) - qAlpha(b)) > 32)
+                ++differentPixels;
+        }
+    }
+    // at most some antialiasing along the tile edges differs
+    QVERIFY2(differentPixels < scaledSize.width() + scaledSize.height(),
+             qPrintable(QStringLiteral("%1 pixels differ").arg(differentPixels)));
+}
+
+void tst_QPdfDocument::tileRendererDropsStaleRequests()
+{
+    QPdfDocument doc;
+    QCOMPARE(doc.load(QFINDTESTDATA("pdf-sample.metadata.pdf")), QPdfDocument::NoError);
+    const QSize scaledSize = (doc.pageSize(0) * 4).toSize();
+    QList<QPdfTileCache::Key> hidden;
+    for (int row = 0; row * QPdfTileCache::TileSize < scaledSize.height(); ++row) {
+        for (int column = 0; column * QPdfTileCache::TileSize < scaledSize.width(); ++column)
+            hidden.append(QPdfTileCache::tileKey(&doc, 0, scaledSize, column, row));
+    }
+    QVERIFY(hidden.size() > 4);
+    const auto visible = QPdfTileCache::tileKey(&doc, 0, scaledSize / 2, 0, 0);
+
+    QPdfTileRenderer renderer;
+    renderer.setDocument(&doc);
+    QSignalSpy tileRenderedSpy(&renderer, &QPdfTileRenderer::tileRendered);
+    renderer.setRequests(hidden);
+    renderer.setRequests({ visible });
+    QTRY_VERIFY(!QPdfTileCache::instance()->find(visible).isNull());
+    QTRY_VERIFY(renderer.pendingRequests().isEmpty());
+
+    // at most the tile in progress when the requests were replaced is rendered
+    int renderedHidden = 0;
+    for (const auto &key : qAsConst(hidden))
+        renderedHidden += QPdfTileCache::instance()->find(key).isNull() ? 0 : 1;
+    QVERIFY(renderedHidden <= 1);
+    QTRY_COMPARE(tileRenderedSpy.count(), renderedHidden + 1);
+}
+
+void tst_QPdfDocument::renderConcurrently_data()
+{
+    QTest::addColumn<int>("threadCount");
+
+    QTest::newRow("1 thread") << 1;
+    QTest::newRow("2 threads") << 2;
+    QTest::newRow("4 threads") << 4;
+    QTest::newRow("8 threads") << 8;
+}
+
+void tst_QPdfDocument::renderConcurrently()
+{
+    QFETCH(int, threadCount);
+
+    // Every thread renders its own document, as a thumbnailer would.
+    const int pagesPerThread = 8;
+    const QString fileName = QFINDTESTDATA("pdf-sample.metadata.pdf");
+
+    QAtomicInt rendered;
+    QList<QThread *> threads;
+    for (int i = 0; i < threadCount; ++i) {
+        threads.append(QThread::create([&fileName, &rendered, pagesPerThread] {
+            QPdfDocument doc;
+            if (doc.load(fileName) != QPdfDocument::NoError)
+                return;
+            for (int i = 0; i < pagesPerThread; ++i) {
+                const int page = i % doc.pageCount();
+                const QSize size = doc.pageSize(page).toSize();
+                const QImage image = doc.render(page, size);
+                if (!image.isNull() && image.size() == size)
+                    ++rendered;
+            }
+        }));
+    }
+    for (QThread *thread : threads)
+        thread->start();
+    for (QThread *thread : threads) {
+        QVERIFY(thread->wait());
+        delete thread;
+    }
+    QCOMPARE(rendered.loadRelaxed(), threadCount * pagesPerThread);
+}
+
+void tst_QPdfDocument::renderInWorkerProcess()
+{
+    if (QPdfRenderProcess::executablePath().isEmpty())
+        QSKIP("QtPdfRenderProcess is not available");
+
+    QPdfDocument doc;
+    QCOMPARE(doc.load(QFINDTESTDATA("pdf-sample.metadata.pdf")), QPdfDocument::NoError);
+    const QSize size = doc.pageSize(0).toSize();
+    QPdfDocumentRenderOptions clipped;
+    clipped.setScaledSize(size * 2);
+    clipped.setScaledClipRect(QRect(QPoint(size.width() / 2, size.height() / 2), size));
+    const QImage expected = doc.render(0, size);
+    const QImage expectedClipped = doc.render(0, size, clipped);
+    QVERIFY(!expected.isNull());
+
+    QVERIFY(!doc.isRenderWorkerProcessEnabled());
+    doc.setRenderWorkerProcessEnabled(true);
+    QVERIFY(doc.isRenderWorkerProcessEnabled());
+    QCOMPARE(doc.render(0, size), expected);
+    QCOMPARE(doc.render(0, size, clipped), expectedClipped);
+    QVERIFY(doc.render(doc.pageCount(), size).isNull());
+
+    // another thread has a worker of its own
+    QImage fromThread;
+    QScopedPointer<QThread> thread(QThread::create([&doc, &fromThread, size] {
+        fromThread = doc.render(0, size);
+    }));
+    thread->start();
+    QVERIFY(thread->wait());
+    QCOMPARE(fromThread, expected);
+}
+
+void tst_QPdfDocument::loadAndRenderAll_data()
+{
+    QTest::addColumn<bool>("mapped");
+
+    // load(QString) maps the file, load(QIODevice *) reads from the device
+    QTest::newRow("mapped file") << true;
+    QTest::newRow("file device") << false;
+}
+
+void tst_QPdfDocument::loadAndRenderAll()
+{
+    QFETCH(bool, mapped);
+
+    // many pages with lots of small text objects, so that pdfium does a lot of small reads
+    QTemporaryFile largePdf;
+    QVERIFY(largePdf.open());
+    {
+        QPrinter printer;
+        printer.setOutputFormat(QPrinter::PdfFormat);
+        printer.setOutputFileName(largePdf.fileName());
+        QPainter painter(&printer);
+        for (int page = 0; page < 100; ++page) {
+            if (page)
+                printer.newPage();
+            for (int line = 0; line < 60; ++line)
+                painter.drawText(20, 20 + line * 12, QStringLiteral("Page %1, line %2").arg(page).arg(line));
+        }
+    }
+
+    QPdfDocument doc;
+    QFile file(largePdf.fileName());
+    if (mapped) {
+        QCOMPARE(doc.load(largePdf.fileName()), QPdfDocument::NoError);
+    } else {
+        QVERIFY(file.open(QIODevice::ReadOnly));
+        doc.load(&file);
+    }
+    QCOMPARE(doc.pageCount(), 100);
+    for (int page = 0; page < doc.pageCount(); ++page)
+        QVERIFY(!doc.render(page, QSize(200, 280)).isNull());
+}
+
 QTEST_MAIN(tst_QPdfDocument)
 
 #include "tst_qpdfdocument.moc"
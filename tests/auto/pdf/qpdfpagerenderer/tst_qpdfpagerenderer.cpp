@@ -41,6 +41,7 @@
 #include <QPdfPageRenderer>
 
 #include <QtTest/QtTest>
+#include <QPainter>
 
 class tst_QPdfPageRenderer: public QObject
 {
@@ -53,6 +54,7 @@ private slots:
     void withLoadedDocumentSingleThreaded();
     void withLoadedDocumentMultiThreaded();
     void switchingRenderMode();
+    void renderTiles();
 };
 
 void tst_QPdfPageRenderer::defaultValues()
@@ -182,6 +184,62 @@ void tst_QPdfPageRenderer::switchingRenderMode()
     QCOMPARE(pageRenderedSpy[0][4].toULongLong(), thirdRequestId);
 }
 
+void tst_QPdfPageRenderer::renderTiles()
+{
+    QPdfDocument document;
+    QPdfPageRenderer pageRenderer;
+    pageRenderer.setDocument(&document);
+    pageRenderer.setRenderMode(QPdfPageRenderer::RenderMode::MultiThreaded);
+
+    QCOMPARE(document.load(QFINDTESTDATA("pdf-sample.pagerenderer.pdf")), QPdfDocument::NoError);
+
+    QSignalSpy pageRenderedSpy(&pageRenderer, &QPdfPageRenderer::pageRendered);
+
+    const QSize pageSize(512, 512);
+    const int tileSize = 256;
+    pageRenderer.requestPage(0, pageSize);
+    QTRY_COMPARE(pageRenderedSpy.count(), 1);
+    const QImage page = pageRenderedSpy[0][2].value<QImage>();
+    QCOMPARE(page.size(), pageSize);
+    pageRenderedSpy.clear();
+
+    // render the same page in four tiles and put them together again
+    for (int row = 0; row < 2; ++row) {
+        for (int column = 0; column < 2; ++column) {
+            QPdfDocumentRenderOptions options;
+            options.setScaledSize(pageSize);
+            options.setScaledClipRect(QRect(column * tileSize, row * tileSize, tileSize, tileSize));
+            pageRenderer.requestPage(0, QSize(tileSize, tileSize), options);
+        }
+    }
+    QTRY_COMPARE(pageRenderedSpy.count(), 4);
+
+    QImage tiled(pageSize, page.format());
+    tiled.fill(Qt::transparent);
+    QPainter painter(&tiled);
+    painter.setCompositionMode(QPainter::CompositionMode_Source);
+    for (const auto &arguments : qAsConst(pageRenderedSpy)) {
+        const auto options = arguments[3].value<QPdfDocumentRenderOptions>();
+        const QImage tile = arguments[2].value<QImage>();
+        QCOMPARE(tile.size(), QSize(tileSize, tileSize));
+        painter.drawImage(options.scaledClipRect().topLeft(), tile);
+    }
+    painter.end();
+
+    // anti-aliasing may differ along the tile edges, but nothing else
+    int differentPixels = 0;
+    for (int y = 0; y < pageSize.height(); ++y) {
+        for (int x = 0; x < pageSize.width(); ++x) {
+            const QRgb a = page.pixel(x, y);
+            const QRgb b = tiled.pixel(x, y);
+            if (qAbs(qGray(a) - qGray(b)) > 32 || qAbs(qAlpha(a) - qAlpha(b)) > 32)
+                ++differentPixels;
+        }
+    }
+    QVERIFY2(differentPixels < pageSize.width() * pageSize.height() / 100,
+             qPrintable(QString::number(differentPixels)));
+}
+
 QTEST_MAIN(tst_QPdfPageRenderer)
 
 #include "tst_qpdfpagerenderer.moc"
@@ -42,6 +42,7 @@
 
 #include <QPdfDocument>
 #include <QPdfSearchModel>
+#include <QTemporaryDir>
 
 class tst_QPdfSearchModel: public QObject
 {
@@ -52,6 +53,7 @@ public:
 
 private slots:
     void findText();
+    void findTextWithIndex();
 };
 
 void tst_QPdfSearchModel::findText()
@@ -67,6 +69,75 @@ void tst_QPdfSearchModel::findText()
     QCOMPARE(matches.count(), 3);
 }
 
+void tst_QPdfSearchModel::findTextWithIndex()
+{
+    QPdfDocument document;
+    QCOMPARE(document.load(QFINDTESTDATA("test.pdf")), QPdfDocument::NoError);
+
+    QPdfSearchModel plain;
+    plain.setDocument(&document);
+    plain.setSearchString(QLatin1String("ai"));
+    QList<QPdfLink> expected;
+    for (int page = 0; page < document.pageCount(); ++page)
+        expected << plain.resultsOnPage(page);
+    QVERIFY(!expected.isEmpty());
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString indexFile = dir.filePath(QLatin1String("test.pdfindex"));
+
+    QPdfSearchModel model;
+    QSignalSpy resetSpy(&model, &QAbstractItemModel::modelReset);
+    model.setTextIndexFileName(indexFile);
+    model.setTextIndexEnabled(true);
+    model.setDocument(&document);
+    model.setSearchString(QLatin1String("ai"));
+    // once the index is ready, the results are replaced in one reset
+    QTRY_VERIFY(resetSpy.count() >= 3);
+    QTRY_VERIFY(QFile::exists(indexFile));
+    QCOMPARE(model.rowCount(QModelIndex()), expected.count());
+    for (int i = 0; i < expected.count(); ++i) {
+        const QPdfLink link = model.resultAtIndex(i);
+        QCOMPARE(link.page(), expected.at(i).page());
+        QCOMPARE(link.rectangles().count(), expected.at(i).rectangles().count());
+        QVERIFY(link.rectangles().first().intersects(expected.at(i).rectangles().first()));
+    }
+
+    // extending the search string refines the previous matches
+    model.setSearchString(QLatin1String("ain"));
+    plain.setSearchString(QLatin1String("ain"));
+    int plainCount = 0;
+    for (int page = 0; page < document.pageCount(); ++page)
+        plainCount += plain.resultsOnPage(page).count();
+    QCOMPARE(model.rowCount(QModelIndex()), plainCount);
+
+    // reopening the document reads the index back from the file
+    document.close();
+    QCOMPARE(document.load(QFINDTESTDATA("test.pdf")), QPdfDocument::NoError);
+    QPdfSearchModel reloaded;
+    reloaded.setTextIndexFileName(indexFile);
+    reloaded.setTextIndexEnabled(true);
+    reloaded.setDocument(&document);
+    reloaded.setSearchString(QLatin1String("ai"));
+    QCOMPARE(reloaded.rowCount(QModelIndex()), expected.count());
+
+    // a document that is not loaded yet is indexed once it becomes ready
+    document.close();
+    QFile::remove(indexFile);
+    QPdfSearchModel early;
+    QSignalSpy earlyResetSpy(&early, &QAbstractItemModel::modelReset);
+    early.setTextIndexFileName(indexFile);
+    early.setTextIndexEnabled(true);
+    early.setDocument(&document);
+    early.setSearchString(QLatin1String("ai"));
+    QVERIFY(!QFile::exists(indexFile));
+    const int resetsBeforeLoad = earlyResetSpy.count();
+    QCOMPARE(document.load(QFINDTESTDATA("test.pdf")), QPdfDocument::NoError);
+    QTRY_VERIFY(QFile::exists(indexFile));
+    QTRY_VERIFY(earlyResetSpy.count() > resetsBeforeLoad);
+    QCOMPARE(early.rowCount(QModelIndex()), expected.count());
+}
+
 QTEST_MAIN(tst_QPdfSearchModel)
 
 #include "tst_qpdfsearchmodel.moc"
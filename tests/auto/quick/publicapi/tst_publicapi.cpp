@@ -263,6 +263,8 @@ static const QStringList expectedAPI = QStringList()
     << "QWebEngineDownloadRequest.downloadDirectoryChanged() --> void"
     << "QWebEngineDownloadRequest.downloadFileName --> QString"
     << "QWebEngineDownloadRequest.downloadFileNameChanged() --> void"
+    << "QWebEngineDownloadRequest.progressUpdateInterval --> int"
+    << "QWebEngineDownloadRequest.progressUpdateIntervalChanged() --> void"
     << "QQuickWebEngineDownloadRequest.view --> QQuickWebEngineView*"
     << "QQuickWebEngineFileDialogRequest.FileModeOpen --> FileMode"
     << "QQuickWebEngineFileDialogRequest.FileModeOpenMultiple --> FileMode"
@@ -442,6 +444,8 @@ static const QStringList expectedAPI = QStringList()
     << "QQuickWebEngineSettings.touchIconsEnabledChanged() --> void"
     << "QQuickWebEngineSettings.unknownUrlSchemePolicy --> QQuickWebEngineSettings::UnknownUrlSchemePolicy"
     << "QQuickWebEngineSettings.unknownUrlSchemePolicyChanged() --> void"
+    << "QQuickWebEngineSettings.webChannelBinaryTransportEnabled --> bool"
+    << "QQuickWebEngineSettings.webChannelBinaryTransportEnabledChanged() --> void"
     << "QQuickWebEngineSettings.webGLEnabled --> bool"
     << "QQuickWebEngineSettings.webGLEnabledChanged() --> void"
     << "QQuickWebEngineSettings.webRTCPublicInterfacesOnly --> bool"
@@ -50,6 +50,8 @@ private Q_SLOTS:
     void roles();
     void objectName();
     void crossTreeParent();
+    void hitTestManyChildren();
+    void mergedEvents();
 };
 
 // This will be called before the first test function is executed.
@@ -605,6 +607,108 @@ void tst_Accessibility::crossTreeParent()
     QCOMPARE(p->object()->objectName(), QStringLiteral("my_id"));
 }
 
+void tst_Accessibility::hitTestManyChildren()
+{
+    const int columns = 40;
+    const int rows = 25;
+    QString cells;
+    for (int i = 0; i < columns * rows; ++i)
+        cells += QStringLiteral("<div role='button' id='cell%1' aria-label='%1' style='width:16px;height:16px'></div>").arg(i);
+
+    QWebEngineView webView;
+    webView.resize(800, 600);
+    QSignalSpy spyFinished(&webView, &QWebEngineView::loadFinished);
+    webView.setHtml("<html><body style='margin:0'><div style='display:grid;grid-template-columns:repeat("
+                    + QString::number(columns) + ",16px)'>" + cells + "</div></body></html>");
+    webView.show();
+    QVERIFY(spyFinished.wait());
+    QAccessibleInterface *view = QAccessible::queryAccessibleInterface(&webView);
+    QAccessibleInterface *document = view->child(0);
+    QTRY_COMPARE(document->childCount(), 1);
+    QAccessibleInterface *grid = document->child(0);
+    QVERIFY(grid);
+    QTRY_COMPARE(grid->childCount(), columns * rows);
+
+    auto hitTest = [view](const QPoint &point) {
+        QAccessibleInterface *hit = view;
+        QAccessibleInterface *child = nullptr;
+        while (hit) {
+            child = hit;
+            hit = hit->childAt(point.x(), point.y());
+        }
+        return child;
+    };
+
+    const QPoint origin = grid->child(0)->rect().topLeft();
+    for (int i : { 0, columns - 1, columns * 12 + 7, columns * rows - 1 }) {
+        QAccessibleInterface *cell = grid->child(i);
+        QVERIFY(cell);
+        QCOMPARE(cell->rect().topLeft(), origin + QPoint(i % columns, i / columns) * 16);
+        QAccessibleInterface *hit = hitTest(cell->rect().center());
+        QVERIFY(hit);
+        QVERIFY(hit->object());
+        QCOMPARE(hit->object()->objectName(), QStringLiteral("cell%1").arg(i));
+    }
+
+    // Every cell is found, not only the ones whose rects were queried first.
+    for (int y = 0; y < rows; ++y) {
+        for (int x = 0; x < columns; ++x) {
+            QAccessibleInterface *hit = hitTest(origin + QPoint(x * 16 + 8, y * 16 + 8));
+            QVERIFY(hit);
+            QVERIFY(hit->object());
+            QCOMPARE(hit->object()->objectName(), QStringLiteral("cell%1").arg(y * columns + x));
+        }
+    }
+}
+
+static QList<QPair<QString, QAccessible::Event>> deliveredEvents;
+
+static void recordEvent(QAccessibleEvent *event)
+{
+    QAccessibleInterface *iface = event->accessibleInterface();
+    if (iface && iface->object())
+        deliveredEvents.append(qMakePair(iface->object()->objectName(), event->type()));
+}
+
+void tst_Accessibility::mergedEvents()
+{
+    QWebEngineView webView;
+    webView.settings()->setAttribute(QWebEngineSettings::FocusOnNavigationEnabled, true);
+    QSignalSpy spyFinished(&webView, &QWebEngineView::loadFinished);
+    webView.setHtml("<html><body>"
+                    "<div id='slider' role='slider' aria-valuenow='1' aria-valuemin='0' aria-valuemax='100'></div>"
+                    "<p><input id='input1' type='text'/><input id='input2' type='text'/><input id='input3' type='text'/></p>"
+                    "</body></html>");
+    webView.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&webView));
+    QVERIFY(spyFinished.wait());
+    QAccessibleInterface *view = QAccessible::queryAccessibleInterface(&webView);
+    QTRY_COMPARE(view->child(0)->childCount(), 2);
+
+    const bool wasActive = QAccessible::isActive();
+    QAccessible::setActive(true);
+    deliveredEvents.clear();
+    QAccessible::UpdateHandler previousHandler = QAccessible::installUpdateHandler(recordEvent);
+
+    // All of these end up in the same tree update.
+    evaluateJavaScriptSync(webView.page(),
+                           "var slider = document.getElementById('slider');"
+                           "for (var i = 2; i <= 10; ++i)"
+                           "    slider.setAttribute('aria-valuenow', i);"
+                           "document.getElementById('input1').focus();"
+                           "document.getElementById('input2').focus();"
+                           "document.getElementById('input3').focus();");
+    QTRY_VERIFY(deliveredEvents.contains(qMakePair(QStringLiteral("input3"), QAccessible::Focus)));
+
+    QAccessible::installUpdateHandler(previousHandler);
+    QAccessible::setActive(wasActive);
+
+    QCOMPARE(deliveredEvents.count(qMakePair(QStringLiteral("slider"), QAccessible::ValueChanged)), 1);
+    QCOMPARE(deliveredEvents.count(qMakePair(QStringLiteral("input1"), QAccessible::Focus)), 0);
+    QCOMPARE(deliveredEvents.count(qMakePair(QStringLiteral("input2"), QAccessible::Focus)), 0);
+    QCOMPARE(deliveredEvents.count(qMakePair(QStringLiteral("input3"), QAccessible::Focus)), 1);
+}
+
 static QByteArrayList params = QByteArrayList()
     << "--force-renderer-accessibility"
     << "--enable-features=AccessibilityExposeARIAAnnotations";
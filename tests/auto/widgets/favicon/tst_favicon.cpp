@@ -27,6 +27,7 @@
 ****************************************************************************/
 
 #include <QtTest/QtTest>
+#include <httpserver.h>
 #include <util.h>
 
 #include <QWebEnginePage>
@@ -69,6 +70,8 @@ private Q_SLOTS:
     void requestIconForPageURL_data();
     void requestIconForPageURL();
     void desiredSize();
+    void iconCache();
+    void iconCacheChangedImage();
 
 private:
     QWebEngineView *m_view;
@@ -852,6 +855,99 @@ void tst_Favicon::desiredSize()
     }
 }
 
+void tst_Favicon::iconCache()
+{
+    QTemporaryDir tmpDir;
+    QWebEngineProfile profile("iconDatabase-cache");
+    profile.setPersistentStoragePath(tmpDir.path());
+
+    QWebEngineView view;
+    QWebEnginePage *page = new QWebEnginePage(&profile, &view);
+    view.setPage(page);
+
+    QSignalSpy iconChangedSpy(page, SIGNAL(iconChanged(QIcon)));
+    page->load(QUrl("qrc:/resources/favicon-single.html"));
+    QTRY_COMPARE_WITH_TIMEOUT(iconChangedSpy.count(), 1, 30000);
+    const QIcon icon = page->icon();
+    QVERIFY(!icon.isNull());
+    QVERIFY(profile.iconCacheMissCount() >= 1);
+
+    // A second page with the same icon gets the already converted icon.
+    QWebEnginePage secondPage(&profile);
+    QSignalSpy secondIconChangedSpy(&secondPage, SIGNAL(iconChanged(QIcon)));
+    const qint64 hits = profile.iconCacheHitCount();
+    secondPage.load(QUrl("qrc:/resources/favicon-single.html"));
+    QTRY_COMPARE_WITH_TIMEOUT(secondIconChangedSpy.count(), 1, 30000);
+    QVERIFY(profile.iconCacheHitCount() > hits);
+    QCOMPARE(secondPage.icon().cacheKey(), icon.cacheKey());
+
+    // Repeated requests for an icon URL are answered from the cache.
+    QIcon requestedIcon;
+    profile.requestIconForIconURL(QUrl("qrc:/resources/icons/qt32.ico"), 32,
+                                  [&requestedIcon](const QIcon &icon, const QUrl &) { requestedIcon = icon; });
+    QTRY_VERIFY(!requestedIcon.isNull());
+    const qint64 misses = profile.iconCacheMissCount();
+    QIcon cachedIcon;
+    profile.requestIconForIconURL(QUrl("qrc:/resources/icons/qt32.ico"), 32,
+                                  [&cachedIcon](const QIcon &icon, const QUrl &) { cachedIcon = icon; });
+    QVERIFY(cachedIcon.isNull()); // still answered asynchronously
+    QTRY_VERIFY(!cachedIcon.isNull());
+    QCOMPARE(profile.iconCacheMissCount(), misses);
+    QCOMPARE(cachedIcon.cacheKey(), requestedIcon.cacheKey());
+
+    QVERIFY(profile.iconCacheMaximumSize() > 0);
+    profile.setIconCacheMaximumSize(1024 * 1024);
+    QCOMPARE(profile.iconCacheMaximumSize(), 1024 * 1024);
+
+    profile.clearIconCache();
+    QVERIFY(page->icon().cacheKey() != icon.cacheKey());
+}
+
+void tst_Favicon::iconCacheChangedImage()
+{
+    auto png = [](const QColor &color) {
+        QImage image(32, 32, QImage::Format_ARGB32);
+        image.fill(color);
+        QByteArray data;
+        QBuffer buffer(&data);
+        buffer.open(QIODevice::WriteOnly);
+        image.save(&buffer, "PNG");
+        return data;
+    };
+    QByteArray icon = png(Qt::red);
+
+    HttpServer server;
+    connect(&server, &HttpServer::newRequest, [&](HttpReqRep *rr) {
+        if (rr->requestPath() == "/page.html") {
+            rr->setResponseHeader(QByteArrayLiteral("content-type"), QByteArrayLiteral("text/html"));
+            rr->setResponseBody(QByteArrayLiteral("<html><head><link rel='icon' href='/icon.png'></head></html>"));
+            rr->sendResponse();
+        } else if (rr->requestPath() == "/icon.png") {
+            rr->setResponseHeader(QByteArrayLiteral("content-type"), QByteArrayLiteral("image/png"));
+            rr->setResponseBody(icon);
+            rr->sendResponse();
+        }
+    });
+    QVERIFY(server.start());
+
+    QTemporaryDir tmpDir;
+    QWebEngineProfile profile("iconDatabase-changedImage");
+    profile.setPersistentStoragePath(tmpDir.path());
+    profile.setHttpCacheType(QWebEngineProfile::NoCache);
+    QWebEnginePage page(&profile);
+
+    auto iconColor = [&page]() { return page.icon().pixmap(16).toImage().pixelColor(8, 8); };
+    page.load(server.url("/page.html"));
+    QTRY_COMPARE_WITH_TIMEOUT(iconColor(), QColor(Qt::red), 30000);
+
+    // The site changes the image behind the same URL, which the reload downloads again.
+    icon = png(Qt::blue);
+    page.triggerAction(QWebEnginePage::Reload);
+    QTRY_COMPARE_WITH_TIMEOUT(iconColor(), QColor(Qt::blue), 30000);
+    QCOMPARE(page.iconUrl(), server.url("/icon.png"));
+    QVERIFY(server.stop());
+}
+
 QTEST_MAIN(tst_Favicon)
 
 #include "tst_favicon.moc"
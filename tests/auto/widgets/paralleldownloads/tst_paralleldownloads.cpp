@@ -0,0 +1,147 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtWebEngine module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <util.h>
+
+#include <QDir>
+#include <QFile>
+#include <QPointer>
+#include <QTemporaryDir>
+#include <QTest>
+#include <QTimer>
+#include <QWebEngineDownloadRequest>
+#include <QWebEnginePage>
+#include <QWebEngineProfile>
+#include <httpserver.h>
+
+#include <memory>
+
+class tst_ParallelDownloads : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void downloadRangesWithProgressInterval();
+};
+
+void tst_ParallelDownloads::initTestCase()
+{
+    const QString fromEnv = qEnvironmentVariable("QTWEBENGINE_CHROMIUM_FLAGS");
+    if (!fromEnv.contains("ParallelDownloading"))
+        qFatal("--enable-features=ParallelDownloading argument is not passed. Use ctest or set QTWEBENGINE_CHROMIUM_FLAGS");
+}
+
+void tst_ParallelDownloads::downloadRangesWithProgressInterval()
+{
+    QByteArray fileContents(8 * 1024 * 1024, Qt::Uninitialized);
+    for (int i = 0; i < fileContents.size(); ++i)
+        fileContents[i] = char(i * 7 % 251);
+
+    // Set up HTTP server answering range requests. The initial response is
+    // trickled out, so that Chromium estimates enough remaining time to split
+    // the rest of the file over another connection.
+    HttpServer server;
+    int connections = 0;
+    int rangeResponses = 0;
+    connect(&server, &HttpServer::newRequest, [&](HttpReqRep *rr) {
+        if (rr->requestMethod() != "GET" || rr->requestPath() != "/large.bin")
+            return;
+        ++connections;
+        rr->setResponseHeader(QByteArrayLiteral("content-type"), QByteArrayLiteral("application/octet-stream"));
+        rr->setResponseHeader(QByteArrayLiteral("content-disposition"), QByteArrayLiteral("attachment"));
+        rr->setResponseHeader(QByteArrayLiteral("accept-ranges"), QByteArrayLiteral("bytes"));
+        rr->setResponseHeader(QByteArrayLiteral("etag"), QByteArrayLiteral("\"large\""));
+        const QByteArray range = rr->requestHeader(QByteArrayLiteral("range"));
+        if (!range.startsWith("bytes=")) {
+            rr->setResponseHeader(QByteArrayLiteral("content-length"), QByteArray::number(fileContents.size()));
+            rr->sendResponseHeaders();
+            auto timer = new QTimer(rr);
+            auto offset = std::make_shared<qsizetype>(0);
+            connect(timer, &QTimer::timeout, rr, [&fileContents, rr, timer, offset]() {
+                rr->sendResponseData(fileContents.mid(*offset, 32 * 1024));
+                *offset += 32 * 1024;
+                if (*offset >= fileContents.size()) {
+                    timer->stop();
+                    rr->finishResponse();
+                }
+            });
+            connect(rr, &HttpReqRep::closed, timer, &QTimer::stop);
+            timer->start(20);
+            return;
+        }
+        const QList<QByteArray> bounds = range.mid(6).split('-');
+        const qsizetype first = bounds.value(0).toLongLong();
+        const qsizetype last = bounds.value(1).isEmpty() ? fileContents.size() - 1
+                                                         : qMin<qsizetype>(bounds.value(1).toLongLong(), fileContents.size() - 1);
+        rr->setResponseHeader(QByteArrayLiteral("content-range"),
+                              "bytes " + QByteArray::number(first) + '-' + QByteArray::number(last)
+                              + '/' + QByteArray::number(fileContents.size()));
+        rr->setResponseBody(fileContents.mid(first, last - first + 1));
+        rr->sendResponse(206);
+        ++rangeResponses;
+    });
+    QVERIFY(server.start());
+
+    // Set up profile and download handler
+    QTemporaryDir tmpDir;
+    QVERIFY(tmpDir.isValid());
+    QWebEngineProfile profile;
+    profile.setHttpCacheType(QWebEngineProfile::NoCache);
+    profile.setDownloadPath(tmpDir.path());
+    QWebEnginePage page(&profile);
+
+    QPointer<QWebEngineDownloadRequest> downloadItem;
+    int progressUpdates = 0;
+    connect(&profile, &QWebEngineProfile::downloadRequested, [&](QWebEngineDownloadRequest *item) {
+        // long enough that only state changes get through
+        item->setProgressUpdateInterval(60000);
+        connect(item, &QWebEngineDownloadRequest::receivedBytesChanged, [&]() { ++progressUpdates; });
+        downloadItem = item;
+        item->accept();
+    });
+
+    page.download(server.url("/large.bin"));
+    QTRY_VERIFY(downloadItem);
+    QTRY_COMPARE_WITH_TIMEOUT(downloadItem->state(), QWebEngineDownloadRequest::DownloadCompleted, 30000);
+    QVERIFY(downloadItem->isFinished());
+    QCOMPARE(downloadItem->receivedBytes(), qint64(fileContents.size()));
+    QVERIFY(progressUpdates <= 2);
+
+    // By default Chromium opens one range request next to the initial request
+    QVERIFY(rangeResponses >= 1);
+    QCOMPARE(connections, rangeResponses + 1);
+
+    QFile file(QDir(downloadItem->downloadDirectory()).filePath(downloadItem->downloadFileName()));
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QVERIFY(file.readAll() == fileContents);
+    QVERIFY(server.stop());
+}
+
+QTEST_MAIN(tst_ParallelDownloads)
+#include "tst_paralleldownloads.moc"
@@ -29,6 +29,9 @@
 #include <QtWebEngineCore/private/qtwebenginecoreglobal_p.h>
 #include <QtWebEngineCore/qtwebenginecore-config.h>
 #include <QWebEngineView>
+#if QT_CONFIG(webengine_printing_and_pdf)
+#include <QPrinter>
+#endif
 #include <QTemporaryDir>
 #include <QTest>
 #include <QSignalSpy>
@@ -45,6 +48,11 @@ class tst_Printing : public QObject
 private slots:
     void printToPdfBasic();
     void printRequest();
+#if QT_CONFIG(webengine_printing_and_pdf)
+    void printToPdfPrinter();
+    void printToRasterizedPdf_data();
+    void printToRasterizedPdf();
+#endif
 #if QT_CONFIG(webengine_system_poppler)
     void printToPdfPoppler();
 #endif
@@ -111,6 +119,87 @@ void tst_Printing::printRequest()
      QVERIFY(data.length() > 0);
 }
 
+#if QT_CONFIG(webengine_printing_and_pdf)
+void tst_Printing::printToPdfPrinter()
+{
+    QTemporaryDir tempDir(QDir::tempPath() + "/tst_qwebengineview-XXXXXX");
+    QVERIFY(tempDir.isValid());
+    QWebEngineView view;
+    QSignalSpy loadFinishedSpy(&view, &QWebEngineView::loadFinished);
+    QSignalSpy printFinishedSpy(&view, &QWebEngineView::printFinished);
+    view.load(QUrl("qrc:///resources/basic_printing_page.html"));
+    QTRY_VERIFY(loadFinishedSpy.count() == 1);
+
+    // a printer writing to a PDF file gets the generated PDF as it is
+    QPrinter printer;
+    printer.setOutputFormat(QPrinter::PdfFormat);
+    printer.setOutputFileName(tempDir.path() + "/printer.pdf");
+    view.print(&printer);
+    QTRY_COMPARE(printFinishedSpy.count(), 1);
+    QVERIFY(printFinishedSpy.takeFirst().at(0).toBool());
+
+    QFile file(printer.outputFileName());
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    const QByteArray data = file.readAll();
+    QVERIFY(data.startsWith("%PDF"));
+
+#if QT_CONFIG(webengine_system_poppler)
+    // the text is still there, rather than an image of it
+    using namespace poppler;
+    QScopedPointer<document> pdf(document::load_from_raw_data(data.constData(), data.length()));
+    QVERIFY(pdf);
+    QScopedPointer<page> pdfPage(pdf->create_page(0));
+    rectf rect;
+    QVERIFY2(pdfPage->search(ustring::from_latin1("Hello Paper World"), rect, page::search_from_top,
+                     case_sensitive ), "Could not find text");
+#endif
+}
+
+void tst_Printing::printToRasterizedPdf_data()
+{
+    QTest::addColumn<bool>("collateCopies");
+    QTest::newRow("collated") << true;
+    QTest::newRow("uncollated") << false;
+}
+
+void tst_Printing::printToRasterizedPdf()
+{
+    QFETCH(bool, collateCopies);
+    QTemporaryDir tempDir(QDir::tempPath() + "/tst_qwebengineview-XXXXXX");
+    QVERIFY(tempDir.isValid());
+    QWebEngineView view;
+    QSignalSpy loadFinishedSpy(&view, &QWebEngineView::loadFinished);
+    QSignalSpy printFinishedSpy(&view, &QWebEngineView::printFinished);
+    view.load(QUrl("qrc:///resources/basic_printing_page.html"));
+    QTRY_VERIFY(loadFinishedSpy.count() == 1);
+
+    // With copies, the pages are rasterized onto the printer. At this
+    // resolution a page is too large for one image and is painted in bands.
+    QPrinter printer;
+    printer.setOutputFormat(QPrinter::PdfFormat);
+    printer.setOutputFileName(tempDir.path() + "/printer.pdf");
+    printer.setPageSize(QPageSize(QPageSize::A4));
+    printer.setResolution(600);
+    printer.setCopyCount(2);
+    printer.setCollateCopies(collateCopies);
+    view.print(&printer);
+    QTRY_COMPARE_WITH_TIMEOUT(printFinishedSpy.count(), 1, 30000);
+    QVERIFY(printFinishedSpy.takeFirst().at(0).toBool());
+
+    QFile file(printer.outputFileName());
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    const QByteArray data = file.readAll();
+    QVERIFY(data.startsWith("%PDF"));
+
+#if QT_CONFIG(webengine_system_poppler)
+    using namespace poppler;
+    QScopedPointer<document> pdf(document::load_from_raw_data(data.constData(), data.length()));
+    QVERIFY(pdf);
+    QCOMPARE(pdf->pages(), 2);
+#endif
+}
+#endif
+
 #if QT_CONFIG(webengine_system_poppler)
 void tst_Printing::printToPdfPoppler()
 {
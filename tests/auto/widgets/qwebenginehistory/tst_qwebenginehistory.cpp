@@ -74,6 +74,7 @@ private Q_SLOTS:
     void clear();
     void historyItemFromDeletedPage();
     void restoreIncompatibleVersion1();
+    void modelUpdates();
 
 
 private:
@@ -602,5 +603,49 @@ void tst_QWebEngineHistory::restoreIncompatibleVersion1()
     QVERIFY(stream.status() == QDataStream::ReadCorruptData);
 }
 
+void tst_QWebEngineHistory::modelUpdates()
+{
+    QAbstractItemModel *items = hist->itemsModel();
+    QAbstractItemModel *backItems = hist->backItemsModel();
+    QAbstractItemModel *forwardItems = hist->forwardItemsModel();
+    QCOMPARE(items->rowCount(), histsize);
+    QCOMPARE(backItems->rowCount(), histsize - 1);
+    QCOMPARE(forwardItems->rowCount(), 0);
+    QCOMPARE(backItems->index(0, 0).data(QWebEngineHistoryModel::TitleRole).toString(), QString("page4"));
+
+    QSignalSpy itemsResetSpy(items, &QAbstractItemModel::modelReset);
+    QSignalSpy backItemsResetSpy(backItems, &QAbstractItemModel::modelReset);
+    QSignalSpy forwardItemsResetSpy(forwardItems, &QAbstractItemModel::modelReset);
+    QSignalSpy itemsChangedSpy(items, &QAbstractItemModel::dataChanged);
+    QSignalSpy backItemsRemovedSpy(backItems, &QAbstractItemModel::rowsRemoved);
+    QSignalSpy forwardItemsInsertedSpy(forwardItems, &QAbstractItemModel::rowsInserted);
+
+    hist->back();
+    QTRY_COMPARE(loadFinishedSpy->count(), 1);
+    QCOMPARE(items->rowCount(), histsize);
+    QCOMPARE(backItems->rowCount(), histsize - 2);
+    QCOMPARE(forwardItems->rowCount(), 1);
+    QCOMPARE(backItemsRemovedSpy.count(), 1);
+    QCOMPARE(forwardItemsInsertedSpy.count(), 1);
+    QCOMPARE(forwardItems->index(0, 0).data(QWebEngineHistoryModel::TitleRole).toString(), QString("page5"));
+    // Only the offsets of the full list change.
+    QVERIFY(!itemsChangedSpy.isEmpty());
+    QCOMPARE(items->index(histsize - 1, 0).data(QWebEngineHistoryModel::OffsetRole).toInt(), 1);
+
+    // Navigating to a new page drops the forward entries and appends the new one.
+    QSignalSpy itemsRemovedSpy(items, &QAbstractItemModel::rowsRemoved);
+    QSignalSpy itemsInsertedSpy(items, &QAbstractItemModel::rowsInserted);
+    loadPage(6);
+    QCOMPARE(items->rowCount(), histsize);
+    QCOMPARE(forwardItems->rowCount(), 0);
+    QCOMPARE(itemsRemovedSpy.count(), 1);
+    QCOMPARE(itemsInsertedSpy.count(), 1);
+    QTRY_COMPARE(items->index(histsize - 1, 0).data(QWebEngineHistoryModel::TitleRole).toString(), QString("page6"));
+
+    QCOMPARE(itemsResetSpy.count(), 0);
+    QCOMPARE(backItemsResetSpy.count(), 0);
+    QCOMPARE(forwardItemsResetSpy.count(), 0);
+}
+
 QTEST_MAIN(tst_QWebEngineHistory)
 #include "tst_qwebenginehistory.moc"
@@ -29,6 +29,7 @@
 #include <util.h>
 #include <QtCore/qbuffer.h>
 #include <QtCore/qmimedatabase.h>
+#include <QtCore/qtemporaryfile.h>
 #include <QtTest/QtTest>
 #include <QtWebEngineCore/qwebengineurlrequestinterceptor.h>
 #include <QtWebEngineCore/qwebengineurlrequestjob.h>
@@ -71,6 +72,11 @@ private Q_SLOTS:
     void urlSchemeHandlerXhrStatus();
     void urlSchemeHandlerScriptModule();
     void urlSchemeHandlerLongReply();
+    void urlSchemeHandlerLargeReply_data();
+    void urlSchemeHandlerLargeReply();
+    void urlSchemeHandlerLargeReplyRange_data();
+    void urlSchemeHandlerLargeReplyRange();
+    void urlSchemeHandlerThreadSafe();
     void customUserAgent();
     void httpAcceptLanguage();
     void downloadItem();
@@ -90,17 +96,21 @@ void tst_QWebEngineProfile::initTestCase()
     QWebEngineUrlScheme letterto("letterto");
     QWebEngineUrlScheme aviancarrier("aviancarrier");
     QWebEngineUrlScheme myscheme("myscheme");
+    QWebEngineUrlScheme threadsafe("threadsafe");
     foo.setSyntax(QWebEngineUrlScheme::Syntax::Host);
     stream.setSyntax(QWebEngineUrlScheme::Syntax::HostAndPort);
     stream.setDefaultPort(8080);
     letterto.setSyntax(QWebEngineUrlScheme::Syntax::Path);
     aviancarrier.setSyntax(QWebEngineUrlScheme::Syntax::Path);
     aviancarrier.setFlags(QWebEngineUrlScheme::CorsEnabled);
+    threadsafe.setSyntax(QWebEngineUrlScheme::Syntax::Host);
+    threadsafe.setFlags(QWebEngineUrlScheme::ThreadSafeHandler);
     QWebEngineUrlScheme::registerScheme(foo);
     QWebEngineUrlScheme::registerScheme(stream);
     QWebEngineUrlScheme::registerScheme(letterto);
     QWebEngineUrlScheme::registerScheme(aviancarrier);
     QWebEngineUrlScheme::registerScheme(myscheme);
+    QWebEngineUrlScheme::registerScheme(threadsafe);
 }
 
 static QString StandardCacheLocation() { static auto p = QStandardPaths::writableLocation(QStandardPaths::CacheLocation); return p; }
@@ -757,6 +767,247 @@ void tst_QWebEngineProfile::urlSchemeHandlerLongReply()
     QTRY_COMPARE(page.title(), QString("Minify this!"));
 }
 
+// Serves the same data as a QBuffer would, but without being one.
+class PlainIODevice : public QIODevice
+{
+public:
+    PlainIODevice(const QByteArray &data, QObject *parent) : QIODevice(parent), m_data(data)
+    {
+        open(QIODevice::ReadOnly);
+    }
+
+    qint64 size() const override { return m_data.size(); }
+
+    qint64 readData(char *data, qint64 maxSize) override
+    {
+        const qint64 size = qMin(maxSize, m_data.size() - pos());
+        memcpy(data, m_data.constData() + pos(), size);
+        return size;
+    }
+    qint64 writeData(const char *, qint64) override { return -1; }
+
+private:
+    QByteArray m_data;
+};
+
+class LargeReplyUrlSchemeHandler : public QWebEngineUrlSchemeHandler
+{
+public:
+    enum Mode { Device, Buffer, Data, File };
+
+    LargeReplyUrlSchemeHandler(Mode mode, const QByteArray &payload, const QString &fileName)
+        : m_mode(mode), m_payload(payload), m_fileName(fileName)
+    {
+    }
+
+    void requestStarted(QWebEngineUrlRequestJob *job) override
+    {
+        if (job->requestUrl().path() != QLatin1String("/payload")) {
+            job->reply("text/html", QByteArrayLiteral("<html><body>Large reply</body></html>"));
+            return;
+        }
+        switch (m_mode) {
+        case Device:
+            job->reply("application/octet-stream", new PlainIODevice(m_payload, job));
+            break;
+        case Buffer: {
+            QBuffer *buffer = new QBuffer(job);
+            buffer->setData(m_payload);
+            job->reply("application/octet-stream", buffer);
+            break;
+        }
+        case Data:
+            job->reply("application/octet-stream", m_payload);
+            break;
+        case File:
+            job->reply("application/octet-stream", new QFile(m_fileName, job));
+            break;
+        }
+    }
+
+private:
+    Mode m_mode;
+    QByteArray m_payload;
+    QString m_fileName;
+};
+
+void tst_QWebEngineProfile::urlSchemeHandlerLargeReply_data()
+{
+    QTest::addColumn<int>("mode");
+    QTest::newRow("QIODevice") << int(LargeReplyUrlSchemeHandler::Device);
+    QTest::newRow("QBuffer") << int(LargeReplyUrlSchemeHandler::Buffer);
+    QTest::newRow("QByteArray") << int(LargeReplyUrlSchemeHandler::Data);
+    QTest::newRow("QFile") << int(LargeReplyUrlSchemeHandler::File);
+}
+
+// Bytes that differ from one position to the next, so that data read from
+// the wrong offset does not go unnoticed.
+static QByteArray largePayload()
+{
+    QByteArray payload(8 * 1024 * 1024, Qt::Uninitialized);
+    for (int i = 0; i < payload.size(); ++i)
+        payload[i] = char((i * 7 + i / 251) % 256);
+    return payload;
+}
+
+// FNV-1a, the same as fnv1a() in startFetchingPayload() below.
+static quint32 fnv1a(const QByteArray &data)
+{
+    quint32 hash = 2166136261u;
+    for (char c : data) {
+        hash ^= quint8(c);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// Fetches foo://host/payload, with the given Range header if not empty. Once
+// done, window.received is the status, the length and the hash of the body
+// as "status length hash".
+static void startFetchingPayload(QWebEnginePage *page, const QString &range = QString())
+{
+    const QString headers = range.isEmpty() ? QStringLiteral("{}")
+                                            : QStringLiteral("{ headers: { Range: '%1' } }").arg(range);
+    evaluateJavaScriptSync(page, QStringLiteral(
+            "window.received = '';"
+            "function fnv1a(bytes) {"
+            "    let hash = 2166136261;"
+            "    for (let i = 0; i < bytes.length; ++i) {"
+            "        hash ^= bytes[i];"
+            "        hash = Math.imul(hash, 16777619) >>> 0;"
+            "    }"
+            "    return hash;"
+            "}"
+            "fetch('foo://host/payload', %1).then(r => r.arrayBuffer().then(b => {"
+            "    window.received = r.status + ' ' + b.byteLength + ' ' + fnv1a(new Uint8Array(b));"
+            "}));").arg(headers));
+}
+
+static QString expectedPayload(int status, const QByteArray &data)
+{
+    return QStringLiteral("%1 %2 %3").arg(status).arg(data.size()).arg(fnv1a(data));
+}
+
+void tst_QWebEngineProfile::urlSchemeHandlerLargeReply()
+{
+    QFETCH(int, mode);
+    const QByteArray payload = largePayload();
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    QCOMPARE(file.write(payload), payload.size());
+    file.close();
+
+    LargeReplyUrlSchemeHandler handler(LargeReplyUrlSchemeHandler::Mode(mode), payload, file.fileName());
+    QWebEngineProfile profile;
+    profile.installUrlSchemeHandler("foo", &handler);
+    QWebEnginePage page(&profile);
+    QSignalSpy loadFinishedSpy(&page, SIGNAL(loadFinished(bool)));
+    page.load(QUrl("foo://host/"));
+    QTRY_COMPARE_WITH_TIMEOUT(loadFinishedSpy.count(), 1, 30000);
+
+    startFetchingPayload(&page);
+    QTRY_COMPARE_WITH_TIMEOUT(evaluateJavaScriptSync(&page, QStringLiteral("window.received")).toString(),
+                              expectedPayload(200, payload), 30000);
+}
+
+void tst_QWebEngineProfile::urlSchemeHandlerLargeReplyRange_data()
+{
+    QTest::addColumn<int>("mode");
+    QTest::addColumn<int>("first");
+    QTest::addColumn<int>("last");
+    // the buffer is mapped instead of read, the file is read from an offset
+    for (int mode : { LargeReplyUrlSchemeHandler::Buffer, LargeReplyUrlSchemeHandler::File }) {
+        const char *name = mode == LargeReplyUrlSchemeHandler::Buffer ? "QBuffer" : "QFile";
+        QTest::addRow("%s, start", name) << mode << 0 << 999;
+        QTest::addRow("%s, middle", name) << mode << 1000001 << 5000000;
+        QTest::addRow("%s, end", name) << mode << 8 * 1024 * 1024 - 4097 << 8 * 1024 * 1024 - 1;
+    }
+}
+
+void tst_QWebEngineProfile::urlSchemeHandlerLargeReplyRange()
+{
+    QFETCH(int, mode);
+    QFETCH(int, first);
+    QFETCH(int, last);
+    const QByteArray payload = largePayload();
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    QCOMPARE(file.write(payload), payload.size());
+    file.close();
+
+    LargeReplyUrlSchemeHandler handler(LargeReplyUrlSchemeHandler::Mode(mode), payload, file.fileName());
+    QWebEngineProfile profile;
+    profile.installUrlSchemeHandler("foo", &handler);
+    QWebEnginePage page(&profile);
+    QSignalSpy loadFinishedSpy(&page, SIGNAL(loadFinished(bool)));
+    page.load(QUrl("foo://host/"));
+    QTRY_COMPARE_WITH_TIMEOUT(loadFinishedSpy.count(), 1, 30000);
+
+    startFetchingPayload(&page, QStringLiteral("bytes=%1-%2").arg(first).arg(last));
+    QTRY_COMPARE_WITH_TIMEOUT(evaluateJavaScriptSync(&page, QStringLiteral("window.received")).toString(),
+                              expectedPayload(206, payload.mid(first, last - first + 1)), 30000);
+}
+
+class ThreadSafeUrlSchemeHandler : public QWebEngineUrlSchemeHandler
+{
+public:
+    QAtomicInt requests;
+    QAtomicInt requestsOnMainThread;
+    QSemaphore blocked;
+    QSemaphore unblock;
+    void requestStarted(QWebEngineUrlRequestJob *job) override
+    {
+        ++requests;
+        if (QThread::currentThread() == QCoreApplication::instance()->thread())
+            ++requestsOnMainThread;
+        if (job->requestUrl().path() == QLatin1String("/blocking")) {
+            blocked.release();
+            unblock.acquire();
+        }
+        // the job lives on a thread with an event loop, so replies can be deferred
+        QTimer::singleShot(0, job, [job]() {
+            job->reply("text/html", QByteArrayLiteral("<html><body>thread-safe</body></html>"));
+        });
+    }
+};
+
+void tst_QWebEngineProfile::urlSchemeHandlerThreadSafe()
+{
+    ThreadSafeUrlSchemeHandler handler;
+    QWebEngineProfile profile;
+    profile.installUrlSchemeHandler("threadsafe", &handler);
+    QWebEnginePage page(&profile);
+    QSignalSpy loadFinishedSpy(&page, SIGNAL(loadFinished(bool)));
+    page.load(QUrl("threadsafe://host/"));
+    QTRY_COMPARE(loadFinishedSpy.count(), 1);
+    QVERIFY(loadFinishedSpy.at(0).at(0).toBool());
+    QCOMPARE(toPlainTextSync(&page), QString("thread-safe"));
+    QVERIFY(handler.requests.loadRelaxed() > 0);
+    QCOMPARE(handler.requestsOnMainThread.loadRelaxed(), 0);
+    QVERIFY(QWebEngineUrlScheme::schemeByName("threadsafe").flags().testFlag(QWebEngineUrlScheme::ThreadSafeHandler));
+
+    // a request held up in the handler does not hold up the others
+    QWebEnginePage blockingPage(&profile);
+    QSignalSpy blockingLoadFinishedSpy(&blockingPage, SIGNAL(loadFinished(bool)));
+    blockingPage.load(QUrl("threadsafe://host/blocking"));
+    QVERIFY(handler.blocked.tryAcquire(1, 10000));
+    page.load(QUrl("threadsafe://host/other"));
+    QTRY_COMPARE(loadFinishedSpy.count(), 2);
+    QVERIFY(loadFinishedSpy.at(1).at(0).toBool());
+    QCOMPARE(blockingLoadFinishedSpy.count(), 0);
+    handler.unblock.release();
+    QTRY_COMPARE(blockingLoadFinishedSpy.count(), 1);
+    QVERIFY(blockingLoadFinishedSpy.at(0).at(0).toBool());
+
+    // a removed handler is not called anymore
+    profile.removeUrlSchemeHandler(&handler);
+    const int requests = handler.requests.loadRelaxed();
+    page.load(QUrl("threadsafe://host/again"));
+    QTRY_COMPARE(loadFinishedSpy.count(), 3);
+    QVERIFY(!loadFinishedSpy.at(2).at(0).toBool());
+    QCOMPARE(handler.requests.loadRelaxed(), requests);
+}
+
 void tst_QWebEngineProfile::customUserAgent()
 {
     QString defaultUserAgent = QWebEngineProfile::defaultProfile()->httpUserAgent();
@@ -71,11 +71,18 @@ private Q_SLOTS:
     void navigation();
     void webChannelWithBadString();
     void webChannelWithJavaScriptDisabled();
+    void webChannelBinaryTransport();
+    void webChannelManySignals_data();
+    void webChannelManySignals();
+    void webChannelBatching_data();
+    void webChannelBatching();
 #endif
     void noTransportWithoutWebChannel();
     void scriptsInNestedIframes();
     void matchQrcUrl();
+    void matchManyScripts();
     void injectionOrder();
+    void codeCache();
 };
 
 void tst_QWebEngineScript::domEditing()
@@ -348,6 +355,7 @@ public:
 
 signals:
     void textChanged(const QString &text);
+    void ping(int count);
 
 private:
     QString m_text;
@@ -623,6 +631,165 @@ void tst_QWebEngineScript::webChannelWithJavaScriptDisabled()
     QVERIFY(spyTextChanged.wait());
     QCOMPARE(testObject.text(), QStringLiteral("test"));
 }
+
+void tst_QWebEngineScript::webChannelBinaryTransport()
+{
+    QWebEnginePage page;
+    page.settings()->setAttribute(QWebEngineSettings::WebChannelBinaryTransportEnabled, true);
+    TestObject testObject;
+    QWebChannel channel;
+    channel.registerObject(QStringLiteral("object"), &testObject);
+    page.setWebChannel(&channel);
+    page.scripts().insert(webChannelScript());
+    QVERIFY(loadSync(&page, QUrl("about:blank")));
+
+    // qwebchannel.js as shipped: messages to the page arrive as objects,
+    // while the page still sends JSON text, which keeps working.
+    QSignalSpy spyTextChanged(&testObject, &TestObject::textChanged);
+    page.runJavaScript(QLatin1String(
+                               "window.binaryMessages = 0;"
+                               "window.textMessages = 0;"
+                               "new QWebChannel(qt.webChannelTransport, channel => {"
+                               "  window.channel = channel;"
+                               "  const onmessage = qt.webChannelTransport.onmessage;"
+                               "  qt.webChannelTransport.onmessage = message => {"
+                               "    if (typeof message.data === 'object')"
+                               "      ++window.binaryMessages;"
+                               "    else"
+                               "      ++window.textMessages;"
+                               "    onmessage(message);"
+                               "  };"
+                               "  channel.objects.object.text = 'test \\u00e6\\u00f8\\u00e5';"
+                               "});"));
+    QVERIFY(spyTextChanged.wait());
+    QCOMPARE(testObject.text(), QStringLiteral("test \u00e6\u00f8\u00e5"));
+    QTRY_COMPARE(evaluateJavaScriptSync(&page, "channel.objects.object.text").toString(),
+                 QStringLiteral("test \u00e6\u00f8\u00e5"));
+    QVERIFY(evaluateJavaScriptSync(&page, "window.binaryMessages").toInt() > 0);
+    QCOMPARE(evaluateJavaScriptSync(&page, "window.textMessages").toInt(), 0);
+
+    // Transports that pass objects to send() skip JSON text towards the host as well.
+    page.runJavaScript(QLatin1String(
+                               "window.objectsSent = 0;"
+                               "channel.transport = {"
+                               "  send: message => {"
+                               "    ++window.objectsSent;"
+                               "    qt.webChannelTransport.send(JSON.parse(message));"
+                               "  }"
+                               "};"
+                               "channel.objects.object.text = 'binary \\u00e6\\u00f8\\u00e5';"));
+    QVERIFY(spyTextChanged.wait());
+    QCOMPARE(testObject.text(), QStringLiteral("binary \u00e6\u00f8\u00e5"));
+    QVERIFY(evaluateJavaScriptSync(&page, "window.objectsSent").toInt() > 0);
+}
+
+void tst_QWebEngineScript::webChannelManySignals_data()
+{
+    QTest::addColumn<bool>("binary");
+    QTest::newRow("json") << false;
+    QTest::newRow("binary") << true;
+}
+
+void tst_QWebEngineScript::webChannelManySignals()
+{
+    QFETCH(bool, binary);
+    QWebEnginePage page;
+    page.settings()->setAttribute(QWebEngineSettings::WebChannelBinaryTransportEnabled, binary);
+    TestObject testObject;
+    QWebChannel channel;
+    channel.registerObject(QStringLiteral("object"), &testObject);
+    page.setWebChannel(&channel);
+    page.scripts().insert(webChannelScript());
+    QVERIFY(loadSync(&page, QUrl("about:blank")));
+
+    page.runJavaScript(QLatin1String(
+                               "window.pings = 0;"
+                               "new QWebChannel(qt.webChannelTransport, channel => {"
+                               "  channel.objects.object.ping.connect(count => { window.pings = count; });"
+                               "  channel.objects.object.text = 'ready';"
+                               "});"));
+    // Messages arrive in order, so the signal is connected once the text is set.
+    QTRY_COMPARE(testObject.text(), QStringLiteral("ready"));
+
+    const int count = 1000;
+    for (int i = 1; i <= count; ++i)
+        Q_EMIT testObject.ping(i);
+    QTRY_COMPARE(evaluateJavaScriptSync(&page, "window.pings").toInt(), count);
+}
+
+void tst_QWebEngineScript::webChannelBatching_data()
+{
+    QTest::addColumn<bool>("binary");
+    QTest::newRow("json") << false;
+    QTest::newRow("binary") << true;
+}
+
+void tst_QWebEngineScript::webChannelBatching()
+{
+    QFETCH(bool, binary);
+    QWebEnginePage page;
+    page.settings()->setAttribute(QWebEngineSettings::WebChannelBinaryTransportEnabled, binary);
+    TestObject testObject;
+    QWebChannel channel;
+    channel.registerObject(QStringLiteral("object"), &testObject);
+    page.setWebChannel(&channel);
+    page.scripts().insert(webChannelScript());
+    QVERIFY(loadSync(&page, QUrl("about:blank")));
+
+    // Every IPC is delivered in a task of its own, so counting the tasks in
+    // which messages arrive counts the IPCs.
+    page.runJavaScript(QLatin1String(
+                               "window.pings = [];"
+                               "window.messages = 0;"
+                               "window.deliveries = 0;"
+                               "new QWebChannel(qt.webChannelTransport, channel => {"
+                               "  window.channel = channel;"
+                               "  const onmessage = qt.webChannelTransport.onmessage;"
+                               "  let inDelivery = false;"
+                               "  qt.webChannelTransport.onmessage = message => {"
+                               "    ++window.messages;"
+                               "    if (!inDelivery) {"
+                               "      inDelivery = true;"
+                               "      ++window.deliveries;"
+                               "      setTimeout(() => { inDelivery = false; }, 0);"
+                               "    }"
+                               "    onmessage(message);"
+                               "  };"
+                               "  channel.objects.object.ping.connect(count => { window.pings.push(count); });"
+                               "  channel.objects.object.text = 'ready';"
+                               "});"));
+    QTRY_COMPARE(testObject.text(), QStringLiteral("ready"));
+    // once the property update has come back, nothing else is on its way
+    QTRY_COMPARE(evaluateJavaScriptSync(&page, "channel.objects.object.text").toString(), QStringLiteral("ready"));
+    evaluateJavaScriptSync(&page, "window.messages = 0; window.deliveries = 0;");
+
+    // Signals emitted in one go are batched, but never reordered.
+    const int count = 100;
+    for (int i = 1; i <= count; ++i)
+        Q_EMIT testObject.ping(i);
+    QTRY_COMPARE(evaluateJavaScriptSync(&page, "window.pings.length").toInt(), count);
+    QVERIFY(evaluateJavaScriptSync(&page, "window.pings.every((count, i) => count === i + 1)").toBool());
+    QCOMPARE(evaluateJavaScriptSync(&page, "window.messages").toInt(), count);
+    QCOMPARE(evaluateJavaScriptSync(&page, "window.deliveries").toInt(), 1);
+
+    // A handler replaced within a batch receives the rest of the batch.
+    evaluateJavaScriptSync(&page, QLatin1String(
+                                   "window.afterSwap = 0;"
+                                   "channel.objects.object.ping.connect(count => {"
+                                   "  if (count !== 150) return;"
+                                   "  const onmessage = qt.webChannelTransport.onmessage;"
+                                   "  qt.webChannelTransport.onmessage = message => { ++window.afterSwap; onmessage(message); };"
+                                   "});"));
+    for (int i = count + 1; i <= 2 * count; ++i)
+        Q_EMIT testObject.ping(i);
+    QTRY_COMPARE(evaluateJavaScriptSync(&page, "window.pings.length").toInt(), 2 * count);
+    QCOMPARE(evaluateJavaScriptSync(&page, "window.afterSwap").toInt(), 50);
+
+    // Property updates end up with the latest value.
+    for (int i = 1; i <= count; ++i)
+        testObject.setText(QString::number(i));
+    QTRY_COMPARE(evaluateJavaScriptSync(&page, "channel.objects.object.text").toString(), QString::number(count));
+}
 #endif
 
 void tst_QWebEngineScript::matchQrcUrl()
@@ -646,6 +813,56 @@ document.title = 'New title';
     QCOMPARE(page.title(), "New title");
 }
 
+// Load frames with a corpus of greasemonkey scripts of which few apply.
+void tst_QWebEngineScript::matchManyScripts()
+{
+    QWebEngineProfile profile;
+    QWebEnginePage page(&profile);
+    const int scriptCount = 150;
+    for (int i = 0; i < scriptCount; ++i) {
+        QString header;
+        switch (i % 3) {
+        case 0:
+            header = QStringLiteral("// @match *://*.site%1.example.com/*\n").arg(i);
+            break;
+        case 1:
+            header = QStringLiteral("// @include /^https?://(www\\.)?site%1\\.example\\.org/.*$/\n"
+                                    "// @exclude *logout*\n").arg(i);
+            break;
+        default:
+            header = QStringLiteral("// @match https://site%1.example.net/*\n"
+                                    "// @include *example.net/app/*\n").arg(i);
+            break;
+        }
+        QWebEngineScript s;
+        s.setName(QStringLiteral("script%1").arg(i));
+        s.setInjectionPoint(QWebEngineScript::DocumentReady);
+        s.setWorldId(QWebEngineScript::MainWorld);
+        s.setRunsOnSubFrames(true);
+        s.setSourceCode(QStringLiteral("// ==UserScript==\n") + header
+                        + QStringLiteral("// ==/UserScript==\ndocument.title = 'wrong';\n"));
+        page.scripts().insert(s);
+    }
+    QWebEngineScript match;
+    match.setInjectionPoint(QWebEngineScript::DocumentReady);
+    match.setWorldId(QWebEngineScript::MainWorld);
+    match.setSourceCode(QStringLiteral(R"(
+// ==UserScript==
+// @match qrc:/*title_b.html
+// @include /title_b/
+// ==/UserScript==
+
+document.title = 'New title';
+    )"));
+    page.scripts().insert(match);
+
+    QVERIFY(loadSync(&page, QUrl("qrc:/resources/title_b.html")));
+    QCOMPARE(page.title(), "New title");
+
+    QVERIFY(loadSync(&page, QUrl("qrc:/resources/test_iframe_main.html")));
+    QVERIFY(page.title() != "wrong");
+}
+
 // Add many scripts and check order of execution.
 void tst_QWebEngineScript::injectionOrder()
 {
@@ -694,6 +911,49 @@ void tst_QWebEngineScript::injectionOrder()
     QTRY_COMPARE(page.log, expected);
 }
 
+// The compiled code of profile-wide scripts is persisted in the profile and
+// used by the next render process.
+void tst_QWebEngineScript::codeCache()
+{
+    QTemporaryDir dataDir;
+    QVERIFY(dataDir.isValid());
+    const QDir cacheDir(dataDir.path() + QStringLiteral("/UserScriptCodeCache"));
+
+    class Page : public QWebEnginePage
+    {
+    public:
+        Page(QWebEngineProfile *profile) : QWebEnginePage(profile) {}
+        QStringList log;
+
+    protected:
+        void javaScriptConsoleMessage(JavaScriptConsoleMessageLevel, const QString &message, int,
+                                      const QString &) override
+        {
+            log.append(message);
+        }
+    };
+
+    for (int run = 0; run < 2; ++run) {
+        QWebEngineProfile profile(QStringLiteral("CodeCache"));
+        profile.setPersistentStoragePath(dataDir.path());
+        QWebEngineScript script;
+        script.setInjectionPoint(QWebEngineScript::DocumentReady);
+        script.setWorldId(run ? QWebEngineScript::ApplicationWorld : QWebEngineScript::MainWorld);
+        script.setSourceCode(QStringLiteral(
+                "function cached() { return 'New title'; }\n"
+                "document.title = cached();\n"
+                "throw new Error('reported');\n"));
+        profile.scripts()->insert(script);
+
+        Page page(&profile);
+        QVERIFY(loadSync(&page, QUrl("qrc:/resources/title_a.html")));
+        QTRY_COMPARE(page.title(), QStringLiteral("New title"));
+        // running it with V8 directly still reports uncaught exceptions
+        QTRY_VERIFY(page.log.contains(QStringLiteral("Uncaught Error: reported")));
+        QTRY_COMPARE(cacheDir.entryList(QDir::Files).count(), 1);
+    }
+}
+
 QTEST_MAIN(tst_QWebEngineScript)
 
 #include "tst_qwebenginescript.moc"
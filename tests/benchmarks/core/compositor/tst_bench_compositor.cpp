@@ -0,0 +1,121 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtWebEngine module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "compositor/compositor.h"
+
+#include <QtCore/qthread.h>
+#include <QtTest/QtTest>
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+using namespace QtWebEngineCore;
+
+class TestCompositor : public Compositor
+{
+public:
+    TestCompositor() : Compositor(Type::Software) { }
+    ~TestCompositor() override = default;
+
+    void swapFrame() override { ++swaps; }
+    float devicePixelRatio() override { return 1; }
+    QSize size() override { return QSize(); }
+    bool hasAlphaChannel() override { return false; }
+
+    std::atomic<int> swaps { 0 };
+};
+
+class TestObserver : public Compositor::Observer
+{
+public:
+    void readyToSwap() override { ++readyCount; }
+
+    std::atomic<int> readyCount { 0 };
+};
+
+class tst_bench_Compositor : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void concurrentBindings_data();
+    void concurrentBindings();
+};
+
+void tst_bench_Compositor::concurrentBindings_data()
+{
+    QTest::addColumn<int>("threadCount");
+
+    QTest::newRow("1 thread") << 1;
+    QTest::newRow("4 threads") << 4;
+    QTest::newRow("16 threads") << 16;
+}
+
+// Every thread binds a few thousand compositor/observer pairs, swaps
+// frames through them and unbinds them again.
+void tst_bench_Compositor::concurrentBindings()
+{
+    QFETCH(int, threadCount);
+    const int bindingCount = 2000;
+    const int swapCount = 10;
+
+    QBENCHMARK {
+        std::vector<std::unique_ptr<QThread>> threads;
+        for (int t = 0; t < threadCount; ++t) {
+            threads.emplace_back(QThread::create([t, bindingCount, swapCount] {
+                std::vector<std::unique_ptr<TestObserver>> observers;
+                std::vector<std::unique_ptr<TestCompositor>> compositors;
+                for (int i = 0; i < bindingCount; ++i) {
+                    Compositor::Id id(t + 1000, i);
+                    observers.emplace_back(new TestObserver);
+                    observers.back()->bind(id);
+                    compositors.emplace_back(new TestCompositor);
+                    compositors.back()->bind(id);
+                }
+                for (int s = 0; s < swapCount; ++s) {
+                    for (int i = 0; i < bindingCount; ++i) {
+                        if (auto observer = compositors[i]->observer())
+                            observer->readyToSwap();
+                        if (auto compositor = observers[i]->compositor())
+                            compositor->swapFrame();
+                    }
+                }
+                for (int i = 0; i < bindingCount; ++i)
+                    observers[i]->unbind();
+            }));
+            threads.back()->start();
+        }
+        for (auto &thread : threads)
+            QVERIFY(thread->wait());
+    }
+}
+
+QTEST_MAIN(tst_bench_Compositor)
+#include "tst_bench_compositor.moc"
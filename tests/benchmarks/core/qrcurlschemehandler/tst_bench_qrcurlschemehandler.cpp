@@ -0,0 +1,56 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtWebEngine module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <util.h>
+
+#include <QtTest/QtTest>
+#include <QtWebEngineCore/qwebenginepage.h>
+#include <QtWebEngineCore/qwebengineprofile.h>
+
+class tst_bench_QrcUrlSchemeHandler : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void manyAssets();
+};
+
+void tst_bench_QrcUrlSchemeHandler::manyAssets()
+{
+    QWebEngineProfile profile;
+    QWebEnginePage page(&profile);
+
+    QBENCHMARK {
+        QVERIFY(loadSync(&page, QUrl("qrc:/assets/index.html")));
+        QCOMPARE(evaluateJavaScriptSync(&page, "window.loadedAssets").toInt(), ASSET_COUNT);
+    }
+}
+
+QTEST_MAIN(tst_bench_QrcUrlSchemeHandler)
+#include "tst_bench_qrcurlschemehandler.moc"
@@ -0,0 +1,3 @@
+var request = new XMLHttpRequest();
+request.open('GET', 'test', /* async = */ false);
+request.send();
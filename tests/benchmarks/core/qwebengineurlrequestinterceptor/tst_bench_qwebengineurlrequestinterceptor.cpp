@@ -0,0 +1,69 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtWebEngine module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <util.h>
+
+#include <QtTest/QtTest>
+#include <QtWebEngineCore/qwebenginepage.h>
+#include <QtWebEngineCore/qwebengineprofile.h>
+#include <QtWebEngineCore/qwebengineurlrequestrule.h>
+
+class tst_bench_QWebEngineUrlRequestInterceptor : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void manyRequestRules();
+};
+
+// Loading with a block list of the size of common ad blocking lists.
+void tst_bench_QWebEngineUrlRequestInterceptor::manyRequestRules()
+{
+    const int ruleCount = 100000;
+    QList<QWebEngineUrlRequestRule> rules;
+    rules.reserve(ruleCount + 1);
+    for (int i = 0; i < ruleCount; ++i)
+        rules.append(QWebEngineUrlRequestRule(QWebEngineUrlRequestRule::Block,
+                                              QStringLiteral("ads%1.example.com").arg(i)));
+    QWebEngineUrlRequestRule style(QWebEngineUrlRequestRule::Block);
+    style.setUrlPattern("*/style.css");
+    style.setResourceTypes({ QWebEngineUrlRequestInfo::ResourceTypeStylesheet });
+    rules.append(style);
+
+    QWebEngineProfile profile;
+    profile.setUrlRequestRules(rules);
+    QWebEnginePage page(&profile);
+
+    QBENCHMARK {
+        QVERIFY(loadSync(&page, QUrl("qrc:///resources/resource.html")));
+    }
+}
+
+QTEST_MAIN(tst_bench_QWebEngineUrlRequestInterceptor)
+#include "tst_bench_qwebengineurlrequestinterceptor.moc"
@@ -0,0 +1,144 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtWebEngine module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtTest/QtTest>
+
+#include <QPainter>
+#include <QPdfDocument>
+#include <QPrinter>
+#include <QTemporaryFile>
+#include <QThread>
+
+class tst_bench_QPdfDocument : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void renderConcurrently_data();
+    void renderConcurrently();
+    void loadAndRenderAll_data();
+    void loadAndRenderAll();
+};
+
+void tst_bench_QPdfDocument::renderConcurrently_data()
+{
+    QTest::addColumn<int>("threadCount");
+    QTest::addColumn<bool>("workerProcess");
+
+    for (int threadCount : { 1, 2, 4, 8 }) {
+        const QByteArray threads = QByteArray::number(threadCount)
+                + (threadCount > 1 ? " threads" : " thread");
+        QTest::newRow(threads + ", in process") << threadCount << false;
+        QTest::newRow(threads + ", worker processes") << threadCount << true;
+    }
+}
+
+void tst_bench_QPdfDocument::renderConcurrently()
+{
+    QFETCH(int, threadCount);
+    QFETCH(bool, workerProcess);
+
+    // Every thread renders its own document, as a thumbnailer would.
+    // The total amount of work is the same for each row, so the reported
+    // time is inversely proportional to the pages per second achieved.
+    const int pagesPerRow = 64;
+    const QString fileName = QFINDTESTDATA("../../../auto/pdf/qpdfdocument/pdf-sample.metadata.pdf");
+    QVERIFY(!fileName.isEmpty());
+
+    QBENCHMARK {
+        QList<QThread *> threads;
+        for (int i = 0; i < threadCount; ++i) {
+            threads.append(QThread::create([&fileName, workerProcess, pages = pagesPerRow / threadCount] {
+                QPdfDocument doc;
+                doc.setRenderWorkerProcessEnabled(workerProcess);
+                if (doc.load(fileName) != QPdfDocument::NoError)
+                    return;
+                for (int i = 0; i < pages; ++i) {
+                    const int page = i % doc.pageCount();
+                    const QSize size = doc.pageSize(page).toSize();
+                    doc.render(page, size);
+                }
+            }));
+        }
+        for (QThread *thread : threads)
+            thread->start();
+        for (QThread *thread : threads) {
+            thread->wait();
+            delete thread;
+        }
+    }
+}
+
+void tst_bench_QPdfDocument::loadAndRenderAll_data()
+{
+    QTest::addColumn<bool>("mapped");
+
+    // load(QString) maps the file, load(QIODevice *) reads from the device
+    QTest::newRow("mapped file") << true;
+    QTest::newRow("file device") << false;
+}
+
+void tst_bench_QPdfDocument::loadAndRenderAll()
+{
+    QFETCH(bool, mapped);
+
+    // many pages with lots of small text objects, so that pdfium does a lot of small reads
+    QTemporaryFile largePdf;
+    QVERIFY(largePdf.open());
+    {
+        QPrinter printer;
+        printer.setOutputFormat(QPrinter::PdfFormat);
+        printer.setOutputFileName(largePdf.fileName());
+        QPainter painter(&printer);
+        for (int page = 0; page < 100; ++page) {
+            if (page)
+                printer.newPage();
+            for (int line = 0; line < 60; ++line)
+                painter.drawText(20, 20 + line * 12, QStringLiteral("Page %1, line %2").arg(page).arg(line));
+        }
+    }
+
+    QBENCHMARK {
+        QPdfDocument doc;
+        QFile file(largePdf.fileName());
+        if (mapped) {
+            QCOMPARE(doc.load(largePdf.fileName()), QPdfDocument::NoError);
+        } else {
+            QVERIFY(file.open(QIODevice::ReadOnly));
+            doc.load(&file);
+        }
+        QCOMPARE(doc.pageCount(), 100);
+        for (int page = 0; page < doc.pageCount(); ++page)
+            doc.render(page, QSize(200, 280));
+    }
+}
+
+QTEST_MAIN(tst_bench_QPdfDocument)
+
+#include "tst_bench_qpdfdocument.moc"
@@ -0,0 +1,89 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtWebEngine module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <qtest.h>
+#include <widgetutil.h>
+
+#include <qaccessible.h>
+#include <qwebengineview.h>
+
+class tst_bench_Accessibility : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void hitTestManyChildren();
+};
+
+void tst_bench_Accessibility::hitTestManyChildren()
+{
+    const int columns = 40;
+    const int rows = 25;
+    QString cells;
+    for (int i = 0; i < columns * rows; ++i)
+        cells += QStringLiteral("<div role='button' id='cell%1' aria-label='%1' style='width:16px;height:16px'></div>").arg(i);
+
+    QWebEngineView webView;
+    webView.resize(800, 600);
+    QSignalSpy spyFinished(&webView, &QWebEngineView::loadFinished);
+    webView.setHtml("<html><body style='margin:0'><div style='display:grid;grid-template-columns:repeat("
+                    + QString::number(columns) + ",16px)'>" + cells + "</div></body></html>");
+    webView.show();
+    QVERIFY(spyFinished.wait());
+    QAccessibleInterface *view = QAccessible::queryAccessibleInterface(&webView);
+    QAccessibleInterface *document = view->child(0);
+    QTRY_COMPARE(document->childCount(), 1);
+    QAccessibleInterface *grid = document->child(0);
+    QVERIFY(grid);
+    QTRY_COMPARE(grid->childCount(), columns * rows);
+
+    auto hitTest = [view](const QPoint &point) {
+        QAccessibleInterface *hit = view;
+        QAccessibleInterface *child = nullptr;
+        while (hit) {
+            child = hit;
+            hit = hit->childAt(point.x(), point.y());
+        }
+        return child;
+    };
+
+    const QPoint origin = grid->child(0)->rect().topLeft();
+    QBENCHMARK {
+        for (int y = 0; y < rows; ++y) {
+            for (int x = 0; x < columns; ++x)
+                hitTest(origin + QPoint(x * 16 + 8, y * 16 + 8));
+        }
+    }
+}
+
+static QByteArrayList params = QByteArrayList()
+    << "--force-renderer-accessibility";
+
+W_QTEST_MAIN(tst_bench_Accessibility, params)
+#include "tst_bench_accessibility.moc"
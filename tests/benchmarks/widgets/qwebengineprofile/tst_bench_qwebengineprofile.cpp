@@ -0,0 +1,158 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtWebEngine module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <util.h>
+#include <QtCore/qbuffer.h>
+#include <QtCore/qtemporaryfile.h>
+#include <QtTest/QtTest>
+#include <QtWebEngineCore/qwebengineurlrequestjob.h>
+#include <QtWebEngineCore/qwebengineurlscheme.h>
+#include <QtWebEngineCore/qwebengineurlschemehandler.h>
+#include <QtWebEngineCore/qwebengineprofile.h>
+#include <QtWebEngineCore/qwebenginepage.h>
+
+class tst_bench_QWebEngineProfile : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void urlSchemeHandlerReplyThroughput_data();
+    void urlSchemeHandlerReplyThroughput();
+};
+
+void tst_bench_QWebEngineProfile::initTestCase()
+{
+    QWebEngineUrlScheme foo("foo");
+    foo.setSyntax(QWebEngineUrlScheme::Syntax::Host);
+    QWebEngineUrlScheme::registerScheme(foo);
+}
+
+// Serves the same data as a QBuffer would, but without being one.
+class PlainIODevice : public QIODevice
+{
+public:
+    PlainIODevice(const QByteArray &data, QObject *parent) : QIODevice(parent), m_data(data)
+    {
+        open(QIODevice::ReadOnly);
+    }
+
+    qint64 size() const override { return m_data.size(); }
+
+    qint64 readData(char *data, qint64 maxSize) override
+    {
+        const qint64 size = qMin(maxSize, m_data.size() - pos());
+        memcpy(data, m_data.constData() + pos(), size);
+        return size;
+    }
+    qint64 writeData(const char *, qint64) override { return -1; }
+
+private:
+    QByteArray m_data;
+};
+
+class ThroughputUrlSchemeHandler : public QWebEngineUrlSchemeHandler
+{
+public:
+    enum Mode { Device, Buffer, Data, File };
+
+    ThroughputUrlSchemeHandler(Mode mode, const QByteArray &payload, const QString &fileName)
+        : m_mode(mode), m_payload(payload), m_fileName(fileName)
+    {
+    }
+
+    void requestStarted(QWebEngineUrlRequestJob *job) override
+    {
+        if (job->requestUrl().path() != QLatin1String("/payload")) {
+            job->reply("text/html", QByteArrayLiteral("<html><body>Throughput</body></html>"));
+            return;
+        }
+        switch (m_mode) {
+        case Device:
+            job->reply("application/octet-stream", new PlainIODevice(m_payload, job));
+            break;
+        case Buffer: {
+            QBuffer *buffer = new QBuffer(job);
+            buffer->setData(m_payload);
+            job->reply("application/octet-stream", buffer);
+            break;
+        }
+        case Data:
+            job->reply("application/octet-stream", m_payload);
+            break;
+        case File:
+            job->reply("application/octet-stream", new QFile(m_fileName, job));
+            break;
+        }
+    }
+
+private:
+    Mode m_mode;
+    QByteArray m_payload;
+    QString m_fileName;
+};
+
+void tst_bench_QWebEngineProfile::urlSchemeHandlerReplyThroughput_data()
+{
+    QTest::addColumn<int>("mode");
+    QTest::newRow("QIODevice") << int(ThroughputUrlSchemeHandler::Device);
+    QTest::newRow("QBuffer") << int(ThroughputUrlSchemeHandler::Buffer);
+    QTest::newRow("QByteArray") << int(ThroughputUrlSchemeHandler::Data);
+    QTest::newRow("QFile") << int(ThroughputUrlSchemeHandler::File);
+}
+
+void tst_bench_QWebEngineProfile::urlSchemeHandlerReplyThroughput()
+{
+    QFETCH(int, mode);
+    QByteArray payload(32 * 1024 * 1024, 'x');
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    QCOMPARE(file.write(payload), payload.size());
+    file.close();
+
+    ThroughputUrlSchemeHandler handler(ThroughputUrlSchemeHandler::Mode(mode), payload, file.fileName());
+    QWebEngineProfile profile;
+    profile.installUrlSchemeHandler("foo", &handler);
+    QWebEnginePage page(&profile);
+    QSignalSpy loadFinishedSpy(&page, SIGNAL(loadFinished(bool)));
+    page.load(QUrl("foo://host/"));
+    QTRY_COMPARE_WITH_TIMEOUT(loadFinishedSpy.count(), 1, 30000);
+
+    QBENCHMARK {
+        evaluateJavaScriptSync(&page, QStringLiteral(
+                "window.received = -1;"
+                "fetch('foo://host/payload').then(r => r.arrayBuffer())"
+                ".then(b => { window.received = b.byteLength; });"));
+        QTRY_COMPARE_WITH_TIMEOUT(evaluateJavaScriptSync(&page, QStringLiteral("window.received")).toInt(),
+                                  payload.size(), 30000);
+    }
+}
+
+QTEST_MAIN(tst_bench_QWebEngineProfile)
+#include "tst_bench_qwebengineprofile.moc"
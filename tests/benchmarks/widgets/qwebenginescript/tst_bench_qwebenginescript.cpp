@@ -0,0 +1,185 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtWebEngine module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <util.h>
+
+#include <QtTest/QtTest>
+#include <QtWebEngineCore/qtwebenginecore-config.h>
+#include <QtWebEngineCore/qwebenginepage.h>
+#include <QtWebEngineCore/qwebengineprofile.h>
+#include <QtWebEngineCore/qwebenginescript.h>
+#include <QtWebEngineCore/qwebenginescriptcollection.h>
+#include <QtWebEngineCore/qwebenginesettings.h>
+#if QT_CONFIG(webengine_webchannel)
+#include <QWebChannel>
+#endif
+
+class tst_bench_QWebEngineScript : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+#if QT_CONFIG(webengine_webchannel)
+    void webChannelThroughput_data();
+    void webChannelThroughput();
+#endif
+    void matchManyScripts();
+};
+
+#if QT_CONFIG(webengine_webchannel)
+class TestObject : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(QString text READ text WRITE setText NOTIFY textChanged)
+public:
+    TestObject(QObject *parent = nullptr) : QObject(parent) { }
+
+    void setText(const QString &text)
+    {
+        if (text == m_text)
+            return;
+        m_text = text;
+        emit textChanged(text);
+    }
+
+    QString text() const { return m_text; }
+
+signals:
+    void textChanged(const QString &text);
+    void ping(int count);
+
+private:
+    QString m_text;
+};
+
+static QWebEngineScript webChannelScript()
+{
+    QFile file(QStringLiteral(":/qtwebchannel/qwebchannel.js"));
+    file.open(QFile::ReadOnly);
+    QString sourceCode = file.readAll();
+    Q_ASSERT(!sourceCode.isEmpty());
+
+    QWebEngineScript script;
+    script.setSourceCode(sourceCode);
+    script.setInjectionPoint(QWebEngineScript::DocumentCreation);
+    script.setWorldId(QWebEngineScript::MainWorld);
+    return script;
+}
+
+void tst_bench_QWebEngineScript::webChannelThroughput_data()
+{
+    QTest::addColumn<bool>("binary");
+    QTest::newRow("json") << false;
+    QTest::newRow("binary") << true;
+}
+
+void tst_bench_QWebEngineScript::webChannelThroughput()
+{
+    QFETCH(bool, binary);
+    QWebEnginePage page;
+    page.settings()->setAttribute(QWebEngineSettings::WebChannelBinaryTransportEnabled, binary);
+    TestObject testObject;
+    QWebChannel channel;
+    channel.registerObject(QStringLiteral("object"), &testObject);
+    page.setWebChannel(&channel);
+    page.scripts().insert(webChannelScript());
+    QVERIFY(loadSync(&page, QUrl("about:blank")));
+
+    page.runJavaScript(QLatin1String(
+                               "window.pings = 0;"
+                               "new QWebChannel(qt.webChannelTransport, channel => {"
+                               "  channel.objects.object.ping.connect(count => { window.pings = count; });"
+                               "  channel.objects.object.text = 'ready';"
+                               "});"));
+    // Messages arrive in order, so the signal is connected once the text is set.
+    QTRY_COMPARE(testObject.text(), QStringLiteral("ready"));
+
+    const int count = 1000;
+    QBENCHMARK {
+        for (int i = 1; i <= count; ++i)
+            Q_EMIT testObject.ping(i);
+        QTRY_COMPARE(evaluateJavaScriptSync(&page, "window.pings").toInt(), count);
+        evaluateJavaScriptSync(&page, "window.pings = 0");
+    }
+}
+#endif
+
+// Load frames with a corpus of greasemonkey scripts of which few apply.
+void tst_bench_QWebEngineScript::matchManyScripts()
+{
+    QWebEngineProfile profile;
+    QWebEnginePage page(&profile);
+    const int scriptCount = 150;
+    for (int i = 0; i < scriptCount; ++i) {
+        QString header;
+        switch (i % 3) {
+        case 0:
+            header = QStringLiteral("// @match *://*.site%1.example.com/*\n").arg(i);
+            break;
+        case 1:
+            header = QStringLiteral("// @include /^https?://(www\\.)?site%1\\.example\\.org/.*$/\n"
+                                    "// @exclude *logout*\n").arg(i);
+            break;
+        default:
+            header = QStringLiteral("// @match https://site%1.example.net/*\n"
+                                    "// @include *example.net/app/*\n").arg(i);
+            break;
+        }
+        QWebEngineScript s;
+        s.setName(QStringLiteral("script%1").arg(i));
+        s.setInjectionPoint(QWebEngineScript::DocumentReady);
+        s.setWorldId(QWebEngineScript::MainWorld);
+        s.setRunsOnSubFrames(true);
+        s.setSourceCode(QStringLiteral("// ==UserScript==\n") + header
+                        + QStringLiteral("// ==/UserScript==\ndocument.title = 'wrong';\n"));
+        page.scripts().insert(s);
+    }
+    QWebEngineScript match;
+    match.setInjectionPoint(QWebEngineScript::DocumentReady);
+    match.setWorldId(QWebEngineScript::MainWorld);
+    match.setSourceCode(QStringLiteral(R"(
+// ==UserScript==
+// @match qrc:/*title_b.html
+// @include /title_b/
+// ==/UserScript==
+
+document.title = 'New title';
+    )"));
+    page.scripts().insert(match);
+
+    QVERIFY(loadSync(&page, QUrl("qrc:/resources/title_b.html")));
+    QCOMPARE(page.title(), "New title");
+
+    QBENCHMARK {
+        QVERIFY(loadSync(&page, QUrl("qrc:/resources/test_iframe_main.html")));
+    }
+}
+
+QTEST_MAIN(tst_bench_QWebEngineScript)
+#include "tst_bench_qwebenginescript.moc"